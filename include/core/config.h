@@ -1,17 +1,47 @@
 #pragma once
 
+#include "core/config_snapshot.h"
+#include "core/idle_strategy.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <map>
+#include <thread>
+#include <vector>
 
 class Config {
 public:
     static Config& getInstance();
 
+    // Merges the file into the loaded values and publishes a new snapshot. Returns false if
+    // the file cannot be read or its values do not validate (the old snapshot then stays).
     bool loadFromFile(const std::string& filename = "config.txt");
 
+    // Hot path: the current snapshot in one atomic load. Never null; built-in defaults until
+    // the first successful load. Published snapshots are never freed, so a pointer read once
+    // stays valid and pointer inequality means "parameters changed".
+    static const ConfigSnapshot* snapshot() {
+        const ConfigSnapshot* current = snapshot_.load(std::memory_order_acquire);
+        return HFT_LIKELY(current != nullptr) ? current : &defaults();
+    }
+
+    // Re-reads every file loaded so far, in order. All-or-nothing: on a read or validation
+    // error the running values and snapshot are kept and the error is returned.
+    bool reload(std::string& error);
+    // Async-signal-safe (SIGHUP): the watcher reloads on its next wakeup.
+    void requestReload();
+    // Background thread reloading on requestReload() or when a loaded file's mtime changes.
+    void startWatcher(std::chrono::milliseconds poll_interval = std::chrono::seconds(1));
+    void stopWatcher();
+
     std::string getCoinbaseApiKey() const;
     std::string getCoinbaseSecretKey() const;
     std::string getCoinbaseWsUrl() const;
+    // sim, replay or coinbase; the URL is the REST base for coinbase (or a mock gateway).
+    std::string getOrderGateway() const;
+    std::string getOrderGatewayUrl() const;
 
     double getOrderSize() const;
     double getMaxInventory() const;
@@ -24,16 +54,50 @@ public:
     double getInventoryCeiling() const;
     int getOrderLadderLevels() const;
     int getOrderEngineHz() const;
+    std::string getEngineMode() const;
+    std::string getStrategy() const;
+    int getEngineShards() const;
+    std::string getOrderEngineIdle() const;
+    // TRADING_SYMBOLS=ETH-USD,BTC-USD,...; falls back to TRADING_SYMBOL.
+    std::vector<std::string> getTradingSymbols() const;
+
+    int getLogMaxFileMb() const;
+    int getLogRotateHours() const;
+    bool getLogCompress() const;
+    int getLogRetainSegments() const;
+
+    int getMetricsHttpPort() const;
+    std::string getMetricsHttpBind() const;
+    std::string getMetricsShmName() const;
+
+    int getFlightRecorderEvents() const;
+    int getFlightRecorderWindowSeconds() const;
+    std::string getFlightRecorderDir() const;
 
     std::string getConfig(const std::string& key, const std::string& default_val = "") const;
 
 private:
     Config() = default;
-    ~Config() = default;
+    ~Config();
     Config(const Config&) = delete;
     Config& operator=(const Config&) = delete;
 
+    mutable std::mutex mutex_;  // config_map_, files_, snapshots_
     std::map<std::string, std::string> config_map_;
+    std::vector<std::string> files_;
+    std::vector<std::unique_ptr<ConfigSnapshot>> snapshots_;
+    inline static std::atomic<const ConfigSnapshot*> snapshot_{nullptr};
+
+    std::atomic<bool> reload_requested_{false};
+    std::atomic<bool> watcher_running_{false};
+    WakeSignal reload_wake_;
+    std::thread watcher_thread_;
+
+    static const ConfigSnapshot& defaults();
+    static bool readFile(const std::string& filename, std::map<std::string, std::string>& values);
+    // Validates `values` and, if they pass, installs them and publishes a snapshot; mutex_ held.
+    bool publish(std::map<std::string, std::string> values, std::string& error);
+    void watcherLoop(std::chrono::milliseconds poll_interval);
 
     std::string getString(const std::string& key, const std::string& default_val = "") const;
     double getDouble(const std::string& key, double default_val = 0.0) const;
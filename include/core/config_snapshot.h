@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+
+// LADDER_SPACING: how far level i sits from the quote.
+enum class LadderSpacing : uint8_t {
+    LINEAR,     // i * LADDER_STEP_TICKS
+    GEOMETRIC,  // gaps start at LADDER_STEP_TICKS and grow by LADDER_STEP_GROWTH per level
+    LIST        // LADDER_OFFSETS_TICKS, then its last gap repeated
+};
+
+// LADDER_SIZE_CURVE: level i's size as a share of the signal's, never below LADDER_SIZE_FLOOR.
+enum class LadderSizeCurve : uint8_t {
+    LINEAR,       // 1 - i * LADDER_SIZE_STEP
+    EXPONENTIAL,  // LADDER_SIZE_DECAY^i
+    LIST          // LADDER_SIZES, then its last entry repeated
+};
+
+// Typed, validated copy of the parameters that can change while trading. Built once per
+// (re)load and never modified after it is published, so a reader can hold the pointer for a
+// whole tick and see one consistent set of values.
+struct ConfigSnapshot {
+    uint64_t version = 0;  // 0 for built-in defaults, then 1, 2, ... per successful load
+
+    // Sizing
+    double order_size = 0.01;
+    double max_inventory = 0.1;
+
+    // Strategy (spread_offset and min_spread are in price units: ticks x tick_size)
+    double tick_size = 0.01;
+    double spread_offset = 0.0025;
+    double min_spread = 0.005;
+    double max_neutral_position = 0.01;
+    double inventory_ceiling = 0.02;
+    uint32_t order_ladder_levels = 5;
+
+    // Ladder shape as per-level tables, computed here so placing a ladder only reads them.
+    // Offsets are in price units: whole ticks, strictly increasing with the level.
+    static constexpr uint32_t kMaxLadderLevels = 64;
+    LadderSpacing ladder_spacing = LadderSpacing::LINEAR;
+    LadderSizeCurve ladder_size_curve = LadderSizeCurve::LINEAR;
+    alignas(16) std::array<double, kMaxLadderLevels> ladder_offset{};
+    alignas(16) std::array<double, kMaxLadderLevels> ladder_size_factor{};
+
+    // Fair value quotes are centered on (see FairValue)
+    double fair_value_level_decay = 0.5;   // weight of depth level i is decay^i
+    double fair_value_depth_weight = 0.5;  // 0 = top-level microprice, 1 = depth pressure price
+    double fair_value_skew = 1.0;          // 0 centers on the mid
+
+    // Avellaneda-Stoikov (STRATEGY=avellaneda_stoikov)
+    double as_risk_aversion = 0.1;      // gamma
+    double as_horizon_seconds = 1.0;    // T - t, held constant (rolling horizon)
+    double as_half_life_seconds = 30.0; // volatility/intensity estimator memory
+
+    // Risk (magnitudes; 0 disables the notional caps)
+    uint64_t order_rate_limit = 100;
+    double max_daily_loss = 100.0;
+    double max_drawdown = 50.0;
+    double max_gross_notional = 0.0;
+    double max_net_notional = 0.0;
+
+    // Parses and range-checks every field; on the first bad value returns false and names it.
+    static bool build(const std::map<std::string, std::string>& values, ConfigSnapshot& snapshot,
+                      std::string& error);
+};
@@ -13,6 +13,26 @@
 #  define HFT_CPU_RELAX() std::this_thread::yield()
 #endif
 
+#include <cstdint>
+
+// Raw cycle counter read (~7-25 ns, no syscall). Units are CPU-specific ticks: callers that
+// need wall time must calibrate against a real clock.
+#if defined(__x86_64__) || defined(_M_X64)
+#  include <x86intrin.h>
+inline uint64_t hft_read_tsc() { return __rdtsc(); }
+#elif defined(__aarch64__) || defined(__arm64__)
+inline uint64_t hft_read_tsc() {
+    uint64_t ticks;
+    __asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+}
+#else
+#  include <chrono>
+inline uint64_t hft_read_tsc() {
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+}
+#endif
+
 // Spin-wait tuning constants for the order engine idle path.
 static constexpr int kIdleSpinCount = 32;
 static constexpr int kIdleSpinFallbackThreshold = 1000;
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "core/cpu_hints.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+// Hot-path clock. now() returns raw invariant-TSC ticks (one instruction, no syscall); ticks
+// are only converted to nanoseconds on reporting paths. Calibrated against CLOCK_MONOTONIC
+// at construction and refined by an optional background thread (start()/stop()).
+// If the CPU does not advertise an invariant TSC, ticks fall back to steady_clock
+// nanoseconds and every conversion becomes the identity.
+class FastClock {
+public:
+    static FastClock& getInstance();
+
+    static uint64_t now() {
+        if (HFT_LIKELY(use_tsc_)) return hft_read_tsc();
+        return steadyNanos();
+    }
+
+    // Tick delta -> nanoseconds, and back (for intervals compared against now() deltas).
+    uint64_t ticksToNanos(uint64_t ticks) const;
+    uint64_t nanosToTicks(uint64_t nanos) const;
+    double nanosPerTick() const;
+
+    // Absolute tick stamp -> CLOCK_MONOTONIC / CLOCK_REALTIME nanoseconds.
+    uint64_t toMonotonicNanos(uint64_t ticks) const;
+    uint64_t toWallNanos(uint64_t ticks) const;
+
+    static bool usesTsc() { return use_tsc_; }
+
+    // Background recalibration; the hot path never waits on it.
+    void start(std::chrono::milliseconds interval = std::chrono::milliseconds(1000));
+    void stop();
+
+private:
+    struct Calibration {
+        uint64_t ticks = 0;
+        uint64_t mono_ns = 0;
+        uint64_t wall_ns = 0;
+        double ns_per_tick = 1.0;
+    };
+
+    FastClock();
+    ~FastClock();
+    FastClock(const FastClock&) = delete;
+    FastClock& operator=(const FastClock&) = delete;
+
+    static bool detectInvariantTsc();
+    static uint64_t steadyNanos();
+    static uint64_t wallNanos();
+
+    Calibration load() const;
+    void publish(const Calibration& calibration);
+    void recalibrate();
+    void recalibrationLoop(std::chrono::milliseconds interval);
+
+    inline static const bool use_tsc_ = detectInvariantTsc();
+
+    // Seqlock: odd while the recalibration thread is writing.
+    alignas(64) std::atomic<uint64_t> sequence_{0};
+    std::atomic<uint64_t> ticks_{0};
+    std::atomic<uint64_t> mono_ns_{0};
+    std::atomic<uint64_t> wall_ns_{0};
+    std::atomic<double> ns_per_tick_{1.0};
+
+    // First sample; the rate is measured over the whole interval since then.
+    uint64_t anchor_ticks_ = 0;
+    uint64_t anchor_mono_ns_ = 0;
+
+    std::thread recalibration_thread_;
+    std::atomic<bool> running_{false};
+};
@@ -0,0 +1,142 @@
+#pragma once
+
+#include "core/cpu_hints.h"
+#include "core/fast_clock.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+enum class FlightEventType : uint8_t {
+    BBO = 1,          // a = bid, b = ask, id = feed sequence
+    SIGNAL,           // a = bid price, b = ask price, aux = place_bid | place_ask << 1 | levels << 2
+    ORDER_SENT,       // a = price, b = quantity, id = order id, aux = side ('B'/'S')
+    FILL,             // a = price, b = filled quantity, id = order id, aux = side
+    RISK,             // a = value, b = limit, id = RiskMessage, aux = RiskEventType | RiskLevel << 8
+    CIRCUIT_BREAKER,  // id = RiskMessage
+    EMERGENCY_STOP,
+    ORDER_REJECT,     // a = price, b = quantity, id = order id, aux = side
+    CANCEL_ALL        // aux = side ('B'/'S', 0 = both)
+};
+
+const char* to_string(FlightEventType type);
+
+// One recorded event: 32 bytes, two per cache line. Field meaning depends on the type.
+struct FlightEvent {
+    uint64_t tsc = 0;       // FastClock ticks
+    double a = 0.0;
+    double b = 0.0;
+    uint32_t id = 0;
+    FlightEventType type = FlightEventType::BBO;
+    uint8_t thread = 0;     // index into FlightDumpHeader::thread_names (set when dumping)
+    uint16_t aux = 0;
+};
+static_assert(sizeof(FlightEvent) == 32, "FlightEvent should stay two per cache line");
+
+// Dump file: FlightDumpHeader followed by event_count FlightEvents sorted by tsc.
+constexpr char FLIGHT_DUMP_MAGIC[8] = {'H', 'F', 'T', 'F', 'L', 'I', 'T', '1'};
+constexpr uint32_t FLIGHT_DUMP_VERSION = 1;
+constexpr size_t FLIGHT_MAX_THREADS = 32;
+constexpr size_t FLIGHT_NAME_LEN = 16;
+
+struct FlightDumpHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t event_size;
+    uint32_t thread_count;
+    uint64_t event_count;
+    uint64_t trigger_tsc;       // when the dump was requested
+    uint64_t anchor_tsc;        // tsc/wall pair for converting stamps to wall time
+    uint64_t anchor_wall_ns;
+    double ns_per_tick;
+    uint64_t window_ns;
+    uint32_t truncated_threads; // rings that wrapped inside the window (raise FLIGHT_RECORDER_EVENTS)
+    uint32_t reserved;
+    char reason[32];
+    char thread_names[FLIGHT_MAX_THREADS][FLIGHT_NAME_LEN];
+};
+
+// Always-on flight recorder. Each thread appends to its own overwrite ring (single writer:
+// a plain slot store plus a release store of the head, no lock prefix), so recording costs
+// little more than the FastClock read and never blocks. A dump copies the last window_s seconds of every ring,
+// merges them by timestamp and writes one binary file; tools/flight_decode prints it.
+//
+// Dumps run on the recorder's own thread. requestDump() only stores two atomics, so it is
+// safe to call from the risk path and from signal handlers.
+class FlightRecorder {
+public:
+    static FlightRecorder& getInstance();
+
+    static void record(FlightEventType type, double a = 0.0, double b = 0.0,
+                       uint32_t id = 0, uint16_t aux = 0) {
+        FlightRing* ring = tls_ring_;
+        if (HFT_UNLIKELY(ring == nullptr)) ring = getInstance().registerThread(nullptr);
+        const uint64_t head = ring->head.load(std::memory_order_relaxed);
+        FlightEvent& event = ring->events[head & ring->mask];
+        event.tsc = FastClock::now();
+        event.a = a;
+        event.b = b;
+        event.id = id;
+        event.type = type;
+        event.aux = aux;
+        ring->head.store(head + 1, std::memory_order_release);
+    }
+
+    // Names the calling thread's ring in dumps (e.g. "order_engine"); call at thread start.
+    static void setThreadName(const char* name);
+
+    // Per-thread ring size (rounded up to a power of two) applies to threads that register
+    // afterwards; call before the worker threads start.
+    void configure(size_t events_per_thread, std::chrono::seconds window, const std::string& dump_dir);
+
+    void start();
+    void stop();  // writes a pending dump before returning
+
+    void requestDump(const char* reason);
+
+    // Synchronous dump; returns the file path or an empty string on failure.
+    std::string dumpNow(const char* reason);
+
+    uint64_t dumps() const { return dumps_.load(std::memory_order_relaxed); }
+
+private:
+    struct FlightRing {
+        alignas(64) std::atomic<uint64_t> head{0};
+        char pad_[64 - sizeof(std::atomic<uint64_t>)];
+        std::unique_ptr<FlightEvent[]> events;
+        uint64_t mask = 0;
+        char name[FLIGHT_NAME_LEN] = {};
+        std::atomic<bool> retired{false};
+    };
+
+    FlightRecorder() = default;
+    ~FlightRecorder();
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    FlightRing* registerThread(const char* name);
+    void dumpLoop();
+    std::string writeDump(const char* reason, uint64_t trigger_tsc);
+
+    inline static thread_local FlightRing* tls_ring_ = nullptr;
+
+    size_t ring_capacity_ = 1u << 16;
+    std::chrono::seconds window_{30};
+    std::string dump_dir_ = "logs";
+
+    std::mutex registry_mutex_;
+    std::vector<std::shared_ptr<FlightRing>> rings_;
+
+    std::mutex dump_mutex_;
+    alignas(64) std::atomic<const char*> pending_reason_{nullptr};
+    std::atomic<uint64_t> pending_tsc_{0};
+    std::atomic<uint64_t> dumps_{0};
+
+    std::thread dump_thread_;
+    std::atomic<bool> running_{false};
+};
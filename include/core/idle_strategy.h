@@ -0,0 +1,84 @@
+#pragma once
+
+#include "core/cpu_hints.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+// Futex-backed wakeup (an event count). Producers call notify() after publishing work; a
+// consumer takes epoch() *before* checking for work and passes it to wait(), which returns at
+// once if anything was notified since, so a wakeup cannot be lost between check and sleep.
+// notify() costs one atomic add plus a load when nobody sleeps and is async-signal-safe.
+class WakeSignal {
+public:
+    uint32_t epoch() const { return seq_.load(std::memory_order_acquire); }
+
+    void notify() {
+        seq_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_seq_cst) != 0) wakeAll();
+    }
+
+    // Sleeps until notified after `epoch` or until the timeout; true if notified.
+    bool wait(uint32_t epoch, std::chrono::nanoseconds timeout);
+
+private:
+    void wakeAll();
+
+    alignas(64) std::atomic<uint32_t> seq_{0};
+    std::atomic<uint32_t> waiters_{0};
+};
+
+enum class IdleMode : uint8_t {
+    BUSY_SPIN,   // PAUSE only: lowest wake latency, owns the core
+    SPIN_YIELD,  // PAUSE, then sched_yield once idle for a while
+    SPIN_PARK    // PAUSE, then yield, then sleep on a WakeSignal until notified or timed out
+};
+
+const char* to_string(IdleMode mode);
+// "busy_spin", "spin_yield", "spin_park"
+bool parseIdleMode(const std::string& text, IdleMode& mode);
+
+// Backoff for a worker loop: call idle(did_work) once per iteration. Without a WakeSignal,
+// SPIN_PARK degrades to SPIN_YIELD. The park timeout bounds how late timer work can run.
+class IdleStrategy {
+public:
+    static constexpr int kYieldIterations = 64;  // after the spin phase, before parking
+
+    explicit IdleStrategy(IdleMode mode = IdleMode::SPIN_YIELD, WakeSignal* signal = nullptr,
+                          std::chrono::nanoseconds park_timeout = std::chrono::milliseconds(1))
+        : mode_(signal == nullptr && mode == IdleMode::SPIN_PARK ? IdleMode::SPIN_YIELD : mode)
+        , signal_(mode_ == IdleMode::SPIN_PARK ? signal : nullptr)
+        , park_timeout_(park_timeout)
+        , epoch_(signal_ ? signal_->epoch() : 0)
+    {
+    }
+
+    void idle(bool did_work) {
+        if (did_work) {
+            idle_count_ = 0;
+        } else if (mode_ == IdleMode::BUSY_SPIN || ++idle_count_ < kIdleSpinFallbackThreshold) {
+            for (int i = 0; i < kIdleSpinCount; ++i) HFT_CPU_RELAX();
+        } else if (mode_ == IdleMode::SPIN_YIELD || idle_count_ < kIdleSpinFallbackThreshold + kYieldIterations) {
+            std::this_thread::yield();
+        } else {
+            ++parks_;
+            signal_->wait(epoch_, park_timeout_);
+            idle_count_ = 0;
+        }
+        // Taken before the caller's next work check (see WakeSignal).
+        if (signal_) epoch_ = signal_->epoch();
+    }
+
+    IdleMode mode() const { return mode_; }
+    uint64_t parks() const { return parks_; }
+
+private:
+    IdleMode mode_;
+    WakeSignal* signal_;
+    std::chrono::nanoseconds park_timeout_;
+    uint32_t epoch_;
+    int idle_count_ = 0;
+    uint64_t parks_ = 0;
+};
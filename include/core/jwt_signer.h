@@ -0,0 +1,97 @@
+#pragma once
+
+#include "core/idle_strategy.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+
+typedef struct evp_pkey_st EVP_PKEY;
+
+// ES256 JWTs for the Advanced Trade API (WebSocket subscriptions and REST requests).
+// The PEM key is parsed once into an EVP_PKEY. Each tracked uri keeps a signed token that a
+// background thread re-signs before it expires, so callers read a ready token with one
+// atomic load and never sign on their own thread.
+//
+// Tokens live in a small ring of fixed buffers per uri: a token read once stays intact for at
+// least (kBuffersPerUri - 1) refresh periods, far longer than it takes to copy into a request.
+class JwtSigner {
+public:
+    static constexpr std::chrono::seconds kLifetime{120};
+    static constexpr std::chrono::seconds kRefreshAhead{30};  // re-signed with this much life left
+    static constexpr size_t kMaxUris = 8;
+    static constexpr size_t kBuffersPerUri = 4;
+    static constexpr size_t kMaxTokenBytes = 1536;
+
+    struct Token {
+        std::array<char, kMaxTokenBytes> text{};
+        uint32_t length = 0;
+        int64_t expires_at = 0;  // unix seconds
+        std::string_view view() const { return {text.data(), length}; }
+    };
+
+    JwtSigner() = default;
+    ~JwtSigner();
+
+    JwtSigner(const JwtSigner&) = delete;
+    JwtSigner& operator=(const JwtSigner&) = delete;
+
+    // api_key is the key name ("organizations/.../apiKeys/..."); pem_key the EC private key,
+    // real or "\n"-escaped newlines. Call before track().
+    bool setKey(const std::string& api_key, const std::string& pem_key);
+    bool hasKey() const { return pkey_ != nullptr; }
+
+    // Keeps a fresh token for `uri`: "GET api.coinbase.com" for subscriptions, "POST
+    // api.coinbase.com/api/v3/brokerage/orders" for a REST call. Signs the first token on the
+    // calling thread. The same uri returns the same handle; -1 without a key or when full.
+    int track(const std::string& uri);
+
+    // Hot path: the current token for a handle from track(), in one atomic load.
+    std::string_view token(int handle) const {
+        return slots_[static_cast<size_t>(handle)].current.load(std::memory_order_acquire)->view();
+    }
+
+    // Cold path: a token for any uri, signed now on the calling thread. Empty on failure.
+    std::string sign(const std::string& uri) const;
+
+    // Background refresher: wakes every second and re-signs tokens within kRefreshAhead of
+    // expiry.
+    void start();
+    void stop();
+    // Re-signs due tokens now (the refresher's work; also usable without the thread).
+    // force re-signs every tracked token.
+    void refreshDue(bool force = false);
+
+    uint64_t signatures() const { return signatures_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::string uri;
+        std::array<Token, kBuffersPerUri> buffers{};
+        std::atomic<const Token*> current{nullptr};
+        uint32_t next = 0;
+    };
+
+    EVP_PKEY* pkey_ = nullptr;
+    std::string api_key_;
+
+    std::mutex mutex_;  // slot table changes vs the refresher
+    std::array<Slot, kMaxUris> slots_{};
+    size_t slot_count_ = 0;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    WakeSignal wake_;
+
+    mutable std::atomic<uint64_t> signatures_{0};
+
+    // Writes a token into `out`; returns its length, 0 on failure.
+    size_t signInto(const std::string& uri, int64_t now, char* out, size_t capacity) const;
+    bool resign(Slot& slot, int64_t now);
+    void refreshLoop();
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+
+struct LogRotationPolicy {
+    uint64_t max_file_bytes = 256ULL * 1024 * 1024;            // 0 disables size rotation
+    std::chrono::seconds max_file_age{std::chrono::hours(24)};  // 0 disables time rotation
+    bool compress = true;                                       // gzip rotated segments
+    size_t max_segments = 14;                                   // rotated segments kept on disk
+};
+
+// Append-only log file with size/time based rotation. Rotated segments are gzip-compressed
+// incrementally (a bounded slice per maintenance() call) so the owning logger thread keeps
+// draining records while a large segment is being compressed.
+// Thread safety: single owner thread.
+class RotatingLogFile {
+public:
+    RotatingLogFile(std::string dir, std::string base_name, LogRotationPolicy policy);
+    ~RotatingLogFile();
+
+    RotatingLogFile(const RotatingLogFile&) = delete;
+    RotatingLogFile& operator=(const RotatingLogFile&) = delete;
+
+    bool open();
+    void close();
+    bool isOpen() const { return fd_ >= 0; }
+
+    bool write(const char* data, size_t len);
+
+    // Time-based rotation, one slice of pending compression, retention. Returns true while
+    // compression work remains.
+    bool maintenance();
+
+    const std::string& path() const { return path_; }
+
+private:
+    struct CompressionJob;
+
+    std::string dir_;
+    std::string base_name_;
+    std::string path_;
+    LogRotationPolicy policy_;
+
+    int fd_ = -1;
+    uint64_t file_bytes_ = 0;
+    std::chrono::system_clock::time_point opened_at_;
+
+    std::deque<std::string> pending_compression_;
+    std::unique_ptr<CompressionJob> active_job_;
+
+    void rotate();
+    std::string nextSegmentPath() const;
+    bool compressSlice(size_t budget_bytes);
+    void enforceRetention();
+};
@@ -1,9 +1,20 @@
 #pragma once
 
+#include "core/cpu_hints.h"
+#include "core/fast_clock.h"
+#include "core/log_rotation.h"
+#include "core/spsc_queue.h"
 #include <string>
-#include <fstream>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <memory>
 #include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
 
 enum class LogLevel {
     DEBUG = 0,
@@ -13,26 +24,151 @@ enum class LogLevel {
     CRITICAL = 4
 };
 
+// Files owned by the logger thread. Each one rotates, compresses and expires independently.
+enum class LogStream {
+    MAIN,             // logs/main.log
+    SESSION_SUMMARY,  // logs/session_summary.log
+    RISK_EVENTS       // logs/risk_events.log
+};
+
+// Compact binary log record: a registered format id, the raw argument bytes and a TSC
+// timestamp. Formatting happens on the logger thread, never on the caller.
+struct alignas(64) LogRecord {
+    static constexpr size_t PAYLOAD_SIZE = 114;
+    static constexpr uint8_t FLAG_CONTINUED = 0x1;  // next record of this thread extends the line
+
+    uint64_t tsc = 0;
+    uint16_t format_id = 0;
+    uint8_t level = 0;
+    uint8_t flags = 0;
+    uint16_t payload_size = 0;
+    char payload[PAYLOAD_SIZE];
+};
+static_assert(sizeof(LogRecord) == 128, "LogRecord should span exactly two cache lines");
+
+namespace log_detail {
+
+enum class ArgType : uint8_t { INT64, UINT64, DOUBLE, BOOL, CHAR, STRING };
+
+inline bool put_bytes(LogRecord& record, const void* data, size_t len) {
+    if (HFT_UNLIKELY(record.payload_size + len > LogRecord::PAYLOAD_SIZE)) return false;
+    std::memcpy(record.payload + record.payload_size, data, len);
+    record.payload_size = static_cast<uint16_t>(record.payload_size + len);
+    return true;
+}
+
+template<typename V>
+inline void put_scalar(LogRecord& record, ArgType type, V value) {
+    if (record.payload_size + 1 + sizeof(V) > LogRecord::PAYLOAD_SIZE) return;
+    put_bytes(record, &type, 1);
+    put_bytes(record, &value, sizeof(V));
+}
+
+inline void put_string(LogRecord& record, const char* str, size_t len) {
+    const size_t header = 2;
+    if (record.payload_size + header >= LogRecord::PAYLOAD_SIZE) return;
+    size_t room = LogRecord::PAYLOAD_SIZE - record.payload_size - header;
+    auto n = static_cast<uint8_t>(std::min<size_t>({len, room, 255}));
+    const auto type = ArgType::STRING;
+    put_bytes(record, &type, 1);
+    put_bytes(record, &n, 1);
+    put_bytes(record, str, n);
+}
+
+template<typename T>
+inline void encode_arg(LogRecord& record, const T& arg) {
+    using U = std::decay_t<T>;
+    if constexpr (std::is_same_v<U, bool>) {
+        put_scalar(record, ArgType::BOOL, static_cast<uint8_t>(arg));
+    } else if constexpr (std::is_same_v<U, char>) {
+        put_scalar(record, ArgType::CHAR, arg);
+    } else if constexpr (std::is_integral_v<U> && std::is_signed_v<U>) {
+        put_scalar(record, ArgType::INT64, static_cast<int64_t>(arg));
+    } else if constexpr (std::is_integral_v<U>) {
+        put_scalar(record, ArgType::UINT64, static_cast<uint64_t>(arg));
+    } else if constexpr (std::is_enum_v<U>) {
+        put_scalar(record, ArgType::INT64, static_cast<int64_t>(arg));
+    } else if constexpr (std::is_floating_point_v<U>) {
+        put_scalar(record, ArgType::DOUBLE, static_cast<double>(arg));
+    } else if constexpr (std::is_same_v<U, std::string>) {
+        put_string(record, arg.data(), arg.size());
+    } else if constexpr (std::is_same_v<U, const char*> || std::is_same_v<U, char*>) {
+        put_string(record, arg, std::strlen(arg));
+    } else {
+        static_assert(std::is_same_v<U, std::array<char, 16>>, "Unsupported log argument type");
+        put_string(record, arg.data(), ::strnlen(arg.data(), arg.size()));
+    }
+}
+
+}  // namespace log_detail
+
 class Logger {
 public:
+    static constexpr size_t THREAD_BUFFER_RECORDS = 8192;
+    static constexpr size_t MAX_FORMATS = 4096;
+
     static Logger& getInstance();
 
     bool initialize(const std::string& log_dir = "logs");
+    void shutdown();
 
+    // Call before initialize(); the logger thread reads these without synchronization.
+    void setConsoleOutput(bool enabled) { console_output_ = enabled; }
+    void setRotationPolicy(const LogRotationPolicy& policy) { rotation_policy_ = policy; }
+
+    // Cold-path pre-formatted text (reports, summaries) written by the logger thread.
+    // Returns false if the logger thread is not running; the caller keeps ownership of I/O.
+    bool writeBlock(LogStream stream, std::string text);
+
+    // Cold-path string API: the message is copied into one or more records.
     void debug(const std::string& message);
     void info(const std::string& message);
     void warning(const std::string& message);
     void error(const std::string& message);
     void critical(const std::string& message);
 
+    // Registers a "{}"-style format string once per call site (see HFT_LOG_*).
+    uint16_t registerFormat(const char* format);
+
+    // Hot-path API: encodes raw arguments into the calling thread's ring. Never blocks,
+    // never allocates after the thread's first call; drops the record if the ring is full.
+    template<typename... Args>
+    void write(LogLevel level, uint16_t format_id, const char* /*format*/, const Args&... args) {
+        if (level < current_level_) return;
+        LogRecord record;
+        record.tsc = FastClock::now();
+        record.format_id = format_id;
+        record.level = static_cast<uint8_t>(level);
+        (log_detail::encode_arg(record, args), ...);
+        enqueue(record);
+    }
+
+    uint64_t droppedRecords() const { return dropped_records_.load(std::memory_order_relaxed); }
+
 private:
-    Logger() = default;
+    struct ThreadBuffer {
+        SPSCQueue<LogRecord, THREAD_BUFFER_RECORDS> queue;
+        std::atomic<bool> retired{false};
+        // Logger thread only.
+        bool line_open = false;     // a continued line is in progress
+        bool reclaimable = false;   // retired and fully drained
+    };
+
+    Logger();
     ~Logger();
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
     void log(LogLevel level, const std::string& message);
-    static std::string getCurrentTimestamp();
+    void enqueue(const LogRecord& record);
+    ThreadBuffer& threadBuffer();
+
+    void backendLoop();
+    bool drainBuffers();
+    void formatRecord(ThreadBuffer& buffer, const LogRecord& record);
+    void appendTimestamp(uint64_t tsc);
+    void flushOutput();
+    bool writePendingBlocks();
     static std::string logLevelToString(LogLevel level);
 
     LogLevel current_level_ = LogLevel::INFO;
@@ -40,9 +176,48 @@ private:
     bool file_output_ = true;
     std::string log_dir_;
 
-    std::unique_ptr<std::ofstream> main_log_file_;
-    std::mutex log_mutex_;
+    // Format registry: append-only, readable by the logger thread without locking.
+    std::array<std::atomic<const char*>, MAX_FORMATS> formats_{};
+    std::atomic<uint16_t> format_count_{0};
+    std::mutex format_mutex_;
 
-    bool openLogFile();
-    void closeLogFile();
+    // Per-thread rings; the registry mutex is only taken when a thread logs for the first time.
+    std::mutex registry_mutex_;
+    std::vector<std::shared_ptr<ThreadBuffer>> buffers_;
+    std::atomic<uint64_t> registry_version_{0};
+
+    alignas(64) std::atomic<uint64_t> dropped_records_{0};
+
+    // Logger thread state.
+    std::thread backend_thread_;
+    std::atomic<bool> backend_running_{false};
+    std::vector<std::shared_ptr<ThreadBuffer>> backend_buffers_;
+    uint64_t backend_registry_version_ = 0;
+    std::string write_buffer_;
+    LogRotationPolicy rotation_policy_;
+    std::unique_ptr<RotatingLogFile> main_log_;
+    std::unique_ptr<RotatingLogFile> session_log_;
+    std::unique_ptr<RotatingLogFile> risk_log_;
+
+    std::mutex block_mutex_;
+    bool accepting_blocks_ = false;
+    std::vector<std::pair<LogStream, std::string>> pending_blocks_;
+    std::vector<std::pair<LogStream, std::string>> backend_blocks_;
+
+    bool openLogFiles();
+    void closeLogFiles();
 };
+
+#define HFT_LOG_FIRST_ARG(first, ...) first
+#define HFT_LOG(level, ...)                                                                  \
+    do {                                                                                     \
+        static const uint16_t hft_log_format_id_ =                                           \
+            Logger::getInstance().registerFormat(HFT_LOG_FIRST_ARG(__VA_ARGS__, unused));    \
+        Logger::getInstance().write(level, hft_log_format_id_, __VA_ARGS__);                 \
+    } while (0)
+
+#define HFT_LOG_DEBUG(...)    HFT_LOG(LogLevel::DEBUG, __VA_ARGS__)
+#define HFT_LOG_INFO(...)     HFT_LOG(LogLevel::INFO, __VA_ARGS__)
+#define HFT_LOG_WARNING(...)  HFT_LOG(LogLevel::WARNING, __VA_ARGS__)
+#define HFT_LOG_ERROR(...)    HFT_LOG(LogLevel::ERROR, __VA_ARGS__)
+#define HFT_LOG_CRITICAL(...) HFT_LOG(LogLevel::CRITICAL, __VA_ARGS__)
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded Multi-Producer Single-Consumer lock-free ring buffer.
+// Each slot carries a sequence number so producers claim slots with a single CAS on tail_
+// and publish them independently; the consumer never blocks a producer.
+// Thread safety: any number of threads may call push(), exactly one thread may call pop().
+template<typename T, size_t Size>
+class MPSCQueue {
+    static_assert(Size > 1, "MPSCQueue size must be greater than one");
+    static_assert((Size & (Size - 1)) == 0, "MPSCQueue size must be a power of two");
+
+public:
+    MPSCQueue() {
+        for (size_t i = 0; i < Size; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    bool push(const T& item) {
+        size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = slots_[pos & (Size - 1)];
+            const size_t seq = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.value = item;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool pop(T& item) {
+        const size_t pos = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[pos & (Size - 1)];
+        const size_t seq = slot.sequence.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+        item = slot.value;
+        slot.sequence.store(pos + Size, std::memory_order_release);
+        head_.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        T value{};
+    };
+
+    static_assert(sizeof(std::atomic<size_t>) <= 64,
+        "std::atomic<size_t> is unexpectedly large; MPSC padding calculation would wrap");
+
+    alignas(64) std::atomic<size_t> head_{0};
+    char pad_head_[64 - sizeof(std::atomic<size_t>)];
+
+    alignas(64) std::atomic<size_t> tail_{0};
+    char pad_tail_[64 - sizeof(std::atomic<size_t>)];
+
+    alignas(64) std::array<Slot, Size> slots_;
+};
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Sliding-window event counter built from Buckets fixed-width time buckets.
+// Each bucket packs (epoch << 32 | count) into one atomic word, so record() is a single
+// lock-free CAS from any thread and stale buckets reset themselves on first reuse.
+// count() reads a fixed number of buckets: its cost does not depend on how many events
+// were recorded.
+template<size_t Buckets>
+class RollingCounter {
+    static_assert(Buckets > 0, "RollingCounter needs at least one bucket");
+
+public:
+    explicit RollingCounter(uint64_t bucket_width_ns) : bucket_width_ns_(bucket_width_ns) {}
+
+    void record(uint64_t now_ns) {
+        const auto epoch = static_cast<uint32_t>(now_ns / bucket_width_ns_);
+        auto& bucket = buckets_[epoch % Buckets];
+        uint64_t current = bucket.load(std::memory_order_relaxed);
+        uint64_t next;
+        do {
+            next = (static_cast<uint32_t>(current >> 32) == epoch)
+                ? current + 1
+                : (static_cast<uint64_t>(epoch) << 32) | 1u;
+        } while (!bucket.compare_exchange_weak(current, next, std::memory_order_relaxed));
+    }
+
+    uint64_t count(uint64_t now_ns) const {
+        const auto epoch = static_cast<uint32_t>(now_ns / bucket_width_ns_);
+        uint64_t total = 0;
+        for (const auto& bucket : buckets_) {
+            const uint64_t packed = bucket.load(std::memory_order_relaxed);
+            const auto age = epoch - static_cast<uint32_t>(packed >> 32);
+            if (age < Buckets) {
+                total += packed & 0xffffffffu;
+            }
+        }
+        return total;
+    }
+
+private:
+    const uint64_t bucket_width_ns_;
+    std::array<std::atomic<uint64_t>, Buckets> buckets_{};
+};
@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <array>
+#include <cstddef>
 
 // Single-Producer Single-Consumer lock-free ring buffer.
 // Thread safety: exactly one thread may call push(), exactly one thread may call pop().
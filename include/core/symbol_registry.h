@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Interns products ("ETH-USD") and their base/quote assets ("ETH", "USD") to small dense ids,
+// so per-symbol and per-asset state can live in flat arrays indexed by id. Interning locks and
+// belongs at startup; id -> name/asset lookups are lock-free once the id has been handed out.
+class SymbolRegistry {
+public:
+    static constexpr uint32_t kMaxSymbols = 256;
+    static constexpr uint32_t kMaxAssets = 2 * kMaxSymbols;
+    static constexpr uint32_t kInvalidId = UINT32_MAX;
+
+    static SymbolRegistry& getInstance();
+
+    // Existing or new id; kInvalidId once kMaxSymbols are taken.
+    uint32_t intern(const std::string& symbol);
+    uint32_t find(const std::string& symbol) const;
+    uint32_t findAsset(const std::string& asset) const;
+
+    uint32_t symbolCount() const { return symbol_count_.load(std::memory_order_acquire); }
+    uint32_t assetCount() const { return asset_count_.load(std::memory_order_acquire); }
+    const std::string& symbolName(uint32_t symbol_id) const { return symbols_[symbol_id].name; }
+    uint32_t baseAsset(uint32_t symbol_id) const { return symbols_[symbol_id].base_asset; }
+    uint32_t quoteAsset(uint32_t symbol_id) const { return symbols_[symbol_id].quote_asset; }
+    const std::string& assetName(uint32_t asset_id) const { return asset_names_[asset_id]; }
+
+    // "ETH-USD" -> "ETH" + "USD" ('-', '/' or '_'); no separator -> the whole name, empty quote.
+    static void splitSymbol(const std::string& symbol, std::string& base, std::string& quote);
+    // "eth-usd" -> "ETHUSD", the suffix used by per-symbol config keys.
+    static std::string configKey(const std::string& symbol);
+
+private:
+    SymbolRegistry() = default;
+    SymbolRegistry(const SymbolRegistry&) = delete;
+    SymbolRegistry& operator=(const SymbolRegistry&) = delete;
+
+    struct Entry {
+        std::string name;
+        uint32_t base_asset = kInvalidId;
+        uint32_t quote_asset = kInvalidId;  // kInvalidId when the symbol has no quote part
+    };
+
+    uint32_t internAsset(const std::string& asset);  // mutex_ held
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, uint32_t> symbol_ids_;
+    std::unordered_map<std::string, uint32_t> asset_ids_;
+    std::array<Entry, kMaxSymbols> symbols_;
+    std::array<std::string, kMaxAssets> asset_names_;
+    std::atomic<uint32_t> symbol_count_{0};
+    std::atomic<uint32_t> asset_count_{0};
+};
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+// Where a worker thread runs. Configured per thread in config.txt, NAME being the upper-case
+// thread name (ORDER_ENGINE, MARKET_DATA, RISK, METRICS, SHARD0, SHARD1, ...):
+//   THREAD_<NAME>_CPUS=2-3,6    CPU list; empty inherits the process mask
+//   THREAD_<NAME>_PRIORITY=80   SCHED_FIFO priority 1-99; 0 keeps SCHED_OTHER
+//   THREAD_<NAME>_NUMA=0        preferred memory node (and CPUs, if none are given); -1 = none
+struct ThreadPlacement {
+    std::string name;
+    std::vector<int> cpus;
+    int fifo_priority = 0;
+    int numa_node = -1;
+    bool latency_critical = false;  // on the tick path; wants an isolated, sibling-free core
+
+    bool pinned() const { return !cpus.empty(); }
+};
+
+// sysfs view of the machine (/sys/devices/system/cpu, /sys/devices/system/node).
+// Per-CPU vectors are indexed by CPU id; -1 means unknown.
+struct CpuTopology {
+    std::vector<int> online;
+    std::vector<int> allowed;       // process affinity mask at startup
+    std::vector<int> isolated;      // isolcpus=
+    std::vector<int> nohz_full;
+    std::vector<int> package;
+    std::vector<int> node;
+    std::vector<std::vector<int>> siblings;  // SMT siblings, including the CPU itself
+
+    static CpuTopology detect();
+
+    bool isOnline(int cpu) const;
+    bool isAllowed(int cpu) const;
+    bool isIsolated(int cpu) const;
+    bool isNohzFull(int cpu) const;
+    int packageOf(int cpu) const;
+    int nodeOf(int cpu) const;
+    std::vector<int> siblingsOf(int cpu) const;
+    std::vector<int> nodeCpus(int node) const;
+};
+
+class ThreadPlacer {
+public:
+    // Linux cpulist syntax: "0-3,8,10-11". An empty string is an empty list.
+    static bool parseCpuList(const std::string& text, std::vector<int>& cpus);
+    static std::string formatCpuList(const std::vector<int>& cpus);
+
+    static ThreadPlacement fromConfig(const std::string& name, bool latency_critical);
+
+    // Startup checks against isolcpus/nohz_full, SMT siblings and sockets. Returns one
+    // human-readable warning per problem; an empty result means the layout is sound.
+    static std::vector<std::string> validate(const std::vector<ThreadPlacement>& placements,
+                                             const CpuTopology& topology);
+
+    // Applies the placement to the calling thread, names it, and prints what it actually got.
+    // Failures (e.g. EPERM for SCHED_FIFO) are reported and the thread keeps running.
+    static bool applyToCurrentThread(const ThreadPlacement& placement);
+
+    // "cpus 2 | SCHED_FIFO 80 | on cpu 2" for the calling thread.
+    static std::string describeCurrentThread();
+};
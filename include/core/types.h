@@ -5,6 +5,7 @@
 #include <array>
 #include <cstring>
 #include <algorithm>
+#include <cstdint>
 #include "core/cpu_hints.h"
 
 enum class Side { BUY, SELL };
@@ -22,11 +23,22 @@ struct Order {
     double quantity;
     double filled_quantity = 0.0;
     OrderStatus status = OrderStatus::PENDING;
-    std::chrono::system_clock::time_point create_time;
-    std::chrono::system_clock::time_point update_time;
+    uint64_t create_tsc = 0;   // FastClock ticks
+    uint64_t update_tsc = 0;
     std::string client_order_id;
 };
 
+// Pipeline timestamps (FastClock ticks) carried with a tick from socket receive to order send.
+// Zero means the stage was not reached, e.g. timer-driven requotes have no receive stamp.
+struct LatencyTrace {
+    uint64_t recv_tsc = 0;           // first websocket fragment (lwsCallback)
+    uint64_t parsed_tsc = 0;         // JSON parse complete
+    uint64_t book_updated_tsc = 0;   // order book applied, BBO extracted
+    uint64_t enqueued_tsc = 0;       // pushed to the market data queue
+    uint64_t dequeued_tsc = 0;       // popped by the order engine
+    uint64_t signal_tsc = 0;         // strategy signal generated
+};
+
 inline const char* to_string(Side s) {
     return s == Side::BUY ? "BUY" : "SELL";
 }
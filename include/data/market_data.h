@@ -1,54 +1,107 @@
 #pragma once
 
+#include "core/types.h"
 #include <atomic>
 #include <array>
 #include <chrono>
 #include <map>
+#include <memory>
 #include <functional>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 struct AtomicHFTMetrics;
+class WakeSignal;
 class WebSocketClient;
 
 template<typename T, size_t Size>
 class SPSCQueue;
 
+// Top levels of one book, best first; levels past bid_levels/ask_levels are zero. Struct of
+// arrays so FairValue can run its weighted sums two levels per SSE2 instruction.
+struct DepthSnapshot {
+    static constexpr size_t kLevels = 8;
+
+    alignas(16) std::array<double, kLevels> bid_price{};
+    alignas(16) std::array<double, kLevels> bid_quantity{};
+    alignas(16) std::array<double, kLevels> ask_price{};
+    alignas(16) std::array<double, kLevels> ask_quantity{};
+    uint8_t bid_levels = 0;
+    uint8_t ask_levels = 0;
+};
+
 struct HFTMarketData {
     std::array<char, 16> symbol{};
     double bid_price = 0.0;
     double ask_price = 0.0;
     double bid_quantity = 0.0;
     double ask_quantity = 0.0;
-    std::chrono::high_resolution_clock::time_point timestamp;
+    DepthSnapshot depth;
+    LatencyTrace trace;
     uint64_t sequence_number = 0;
+    uint32_t symbol_index = 0;  // position in the feed's symbol list
 };
 
 class MarketDataFeed {
 public:
+    // Receives every new BBO on the websocket thread, trace stamped up to book_updated_tsc.
+    using TickHandler = std::function<void(HFTMarketData&)>;
+
     MarketDataFeed(WebSocketClient& ws_client, AtomicHFTMetrics& metrics);
 
+    // Pipeline mode: ticks are handed to the order engine thread through the queue; `wake`
+    // is notified after each push when the consumer parks.
     void start(const std::string& trading_symbol,
-               SPSCQueue<HFTMarketData, 1024>& queue);
+               SPSCQueue<HFTMarketData, 1024>& queue, WakeSignal* wake = nullptr);
+    // Hot-loop mode: ticks are handled inline on the thread servicing the socket.
+    void start(const std::string& trading_symbol, TickHandler on_tick);
+    // One book per symbol; each tick carries the symbol's index in this list.
+    void start(const std::vector<std::string>& symbols, TickHandler on_tick);
 
-    double bid() const { return current_bid_.load(); }
-    double ask() const { return current_ask_.load(); }
-    double spread_bps() const { return current_spread_bps_.load(); }
+    // Per-symbol BBO by index; the overloads without one refer to the first symbol.
+    double bid(size_t index = 0) const { return book(index).bid.load(); }
+    double ask(size_t index = 0) const { return book(index).ask.load(); }
+    double spread_bps(size_t index = 0) const { return book(index).spread_bps.load(); }
+    uint64_t updates(size_t index) const { return book(index).updates.load(std::memory_order_relaxed); }
+    uint64_t last_update_tsc(size_t index = 0) const {
+        return book(index).last_update_tsc.load(std::memory_order_relaxed);
+    }
+    const std::string& symbol(size_t index = 0) const { return book(index).symbol; }
+    size_t symbol_count() const { return books_.size(); }
+
+    // All symbols together.
+    uint64_t updates() const { return sequence_counter_.load(std::memory_order_relaxed); }
 
 private:
+    struct SymbolBook {
+        std::string symbol;
+        std::map<double, double, std::greater<>> bids;
+        std::map<double, double> asks;
+
+        std::atomic<double> bid{0.0};
+        std::atomic<double> ask{0.0};
+        std::atomic<double> spread_bps{0.0};
+        std::atomic<uint64_t> last_update_tsc{0};
+        std::atomic<uint64_t> updates{0};
+    };
+
     WebSocketClient& ws_client_;
     AtomicHFTMetrics& metrics_;
-    std::string trading_symbol_;
+    TickHandler on_tick_;
 
-    std::map<double, double, std::greater<>> bid_book_;
-    std::map<double, double> ask_book_;
+    // Built once in start(), before the websocket delivers anything; read-only afterwards.
+    std::vector<std::unique_ptr<SymbolBook>> books_;
+    std::unordered_map<std::string, uint32_t> book_index_;
+    SymbolBook empty_book_;
 
-    std::atomic<double> current_bid_{0.0};
-    std::atomic<double> current_ask_{0.0};
-    std::atomic<double> current_spread_bps_{0.0};
-    std::atomic<uint64_t> last_market_update_{0};
-    std::chrono::high_resolution_clock::time_point last_ws_message_time_;
     std::atomic<uint64_t> sequence_counter_{0};
 
     static constexpr size_t MAX_BOOK_LEVELS = 25;
-    void trimBook();
+
+    const SymbolBook& book(size_t index) const {
+        return HFT_LIKELY(index < books_.size()) ? *books_[index] : empty_book_;
+    }
+    static void trimBook(SymbolBook& book);
+    static void snapshotDepth(const SymbolBook& book, DepthSnapshot& depth);
 };
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "core/types.h"
 #include <string>
 #include <thread>
 #include <atomic>
@@ -9,24 +10,42 @@
 #include <nlohmann/json.hpp>
 #include <libwebsockets.h>
 
+class JwtSigner;
+
 class WebSocketClient {
 public:
-    using MessageCallback = std::function<void(const nlohmann::json&)>;
+    // trace carries recv_tsc (first fragment) and parsed_tsc (JSON parse complete).
+    using MessageCallback = std::function<void(const nlohmann::json&, const LatencyTrace&)>;
+    // Runs first on the lws worker thread (CPU pinning, scheduling policy).
+    using WorkerInitHook = std::function<void()>;
 
     WebSocketClient();
     ~WebSocketClient();
 
-    void setApiCredentials(const std::string& api_key, const std::string& secret_key);
+    // Subscriptions are authenticated with tokens from this signer (owned by the caller).
+    void setJwtSigner(JwtSigner* signer) { jwt_signer_ = signer; }
 
     bool connect(const std::string& url);
     void disconnect();
 
+    // Polled mode: no worker thread. connectPolled() opens the connection on the calling
+    // thread; afterwards exactly one thread drives it with poll(), which services the socket
+    // without blocking, runs the message callback inline and flushes pending sends.
+    // Returns the number of messages delivered, or -1 on a fatal lws error.
+    bool connectPolled(const std::string& url);
+    int poll();
+
     void setMessageCallback(MessageCallback callback);
+    // Messages whose "channel" matches go to this handler instead of the message callback.
+    // Set before connecting; runs on whichever thread delivers messages.
+    void setChannelHandler(const std::string& channel, MessageCallback handler);
+    void setWorkerInitHook(WorkerInitHook hook);
     bool subscribeOrderBook(const std::string& symbol, int depth = 10, int update_speed_ms = 100);
+    // Our own orders and fills for these products.
+    bool subscribeUser(const std::vector<std::string>& symbols);
 
 private:
-    std::string api_key_;
-    std::string secret_key_;
+    JwtSigner* jwt_signer_ = nullptr;
 
     std::atomic<bool> connected_{false};
     std::atomic<bool> running_{false};
@@ -40,6 +59,8 @@ private:
     std::thread worker_thread_;
 
     MessageCallback message_callback_;
+    std::vector<std::pair<std::string, MessageCallback>> channel_handlers_;
+    WorkerInitHook worker_init_hook_;
 
     std::atomic<uint64_t> message_count_{0};
     std::atomic<uint64_t> error_count_{0};
@@ -50,15 +71,17 @@ private:
     struct lws_context_creation_info info_;
 
     std::string rx_buffer_;
+    uint64_t rx_started_tsc_ = 0;
     std::vector<std::string> tx_queue_;
     std::mutex tx_mutex_;
 
+    bool openConnection();
     void workerLoop();
     void stop();
 
     void handleConnect();
     void handleDisconnect();
-    void handleMessage(const std::string& message);
+    void handleMessage(const std::string& message, uint64_t recv_tsc);
     void handleError(const std::string& error);
 
     bool parseUrl(const std::string& url, std::string& host, std::string& path, int& port);
@@ -69,5 +92,5 @@ private:
     void sendMessage(const std::string& message);
     void flushTxQueue();
 
-    std::string createJwtToken() const;
+    bool subscribe(const std::string& channel, const std::vector<std::string>& symbols);
 };
@@ -1,20 +1,38 @@
 #pragma once
 
+#include "core/idle_strategy.h"
 #include "core/spsc_queue.h"
+#include "core/thread_placement.h"
 #include "data/market_data.h"
+#include "engine_shard.h"
+#include "execution/order_gateway.h"
+#include "strategy/fair_value.h"
+#include "strategy/strategy_registry.h"
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 class WebSocketClient;
 class RiskManager;
+struct ConfigSnapshot;
 class OrderManager;
-class MarketMakingStrategy;
 class OrderExecutor;
 class MetricsCollector;
+class MetricsExporter;
+class CoinbaseGateway;
+class JwtSigner;
 class Logger;
 
+// ENGINE_MODE in config.txt.
+enum class EngineMode {
+    PIPELINE,  // websocket thread parses and queues ticks; the order engine thread trades them
+    HOT_LOOP,  // one thread polls the socket, parses, updates the book, quotes and sends inline
+    SHARDED    // TRADING_SYMBOLS split over ENGINE_SHARDS order engines, one thread and queue each
+};
+
 class HFTEngine {
 public:
     HFTEngine();
@@ -24,18 +42,26 @@ public:
     void start();
     void stop();
     bool is_running() const { return running_.load(); }
+    // Notified when the engine stops itself (emergency stop) or stop() begins.
+    WakeSignal& stop_signal() { return stop_wake_; }
 
 private:
+    std::unique_ptr<JwtSigner> jwt_signer_;  // market data subscriptions and order requests
     std::unique_ptr<WebSocketClient> websocket_client_;
     std::unique_ptr<RiskManager> risk_manager_;
     std::unique_ptr<OrderManager> order_manager_;
-    std::unique_ptr<MarketMakingStrategy> strategy_;
+    StrategyVariant strategy_;  // STRATEGY; used by the order engine thread (or the hot loop)
+    FairValue fair_value_;  // order engine thread (or the hot loop)
     std::unique_ptr<OrderExecutor> executor_;
     std::unique_ptr<MetricsCollector> metrics_;
     std::unique_ptr<MarketDataFeed> market_data_feed_;
+    std::unique_ptr<MetricsExporter> metrics_exporter_;
+    CoinbaseGateway* coinbase_gateway_ = nullptr;  // owned by executor_ when ORDER_GATEWAY=coinbase
     Logger* logger_ = nullptr;
 
     std::string trading_symbol_;
+    std::vector<std::string> trading_symbols_;
+    std::vector<uint32_t> trading_symbol_ids_;  // SymbolRegistry ids, parallel to trading_symbols_
 
     alignas(64) std::atomic<bool> running_{false};
 
@@ -48,6 +74,7 @@ private:
     // Rarely written — can share a cache line
     std::atomic<double> order_size_{0.005};
     std::atomic<double> max_position_{0.1};
+    const ConfigSnapshot* applied_config_ = nullptr;  // risk thread: last snapshot sizing came from
 
     // Written by order engine thread, read by risk thread — must be isolated
     alignas(64) std::atomic<double> current_position_{0.0};
@@ -56,8 +83,35 @@ private:
     alignas(64) std::atomic<bool> risk_breach_{false};
 
     int order_engine_hz_ = 2000;
+    EngineMode engine_mode_ = EngineMode::PIPELINE;
+    StrategyKind strategy_kind_ = StrategyKind::FIXED_SPREAD;
+    GatewayKind gateway_kind_ = GatewayKind::SIMULATED;
+    IdleMode order_engine_idle_ = IdleMode::SPIN_YIELD;
+
+    WakeSignal order_engine_wake_;  // market data published (pipeline mode, when parking)
+    WakeSignal risk_wake_;          // fills processed, shutdown
+    WakeSignal stop_wake_;          // shutdown
+
+    ThreadPlacement order_engine_placement_;
+    ThreadPlacement market_data_placement_;
+    ThreadPlacement risk_placement_;
+    ThreadPlacement metrics_placement_;
+
+    std::vector<std::unique_ptr<EngineShard>> shards_;
+    std::vector<ThreadPlacement> shard_placements_;
+    std::chrono::system_clock::time_point session_start_;  // sharded session summary
 
-    void order_engine_worker();
+    // Instantiated per strategy type; start() visits strategy_ once to pick the instantiation.
+    template<typename StrategyT> void order_engine_worker(StrategyT& strategy);
+    template<typename StrategyT> void hot_loop_worker(StrategyT& strategy);
+    template<typename StrategyT>
+    void handle_tick(StrategyT& strategy, HFTMarketData& market_data, uint64_t strategy_start_tsc);
+    template<typename StrategyT>
+    bool requote_on_timer(StrategyT& strategy, uint64_t now_tsc, uint64_t& last_order_tsc,
+                          uint64_t interval_ticks);
+    bool drain_order_responses();
+    ShardSnapshot aggregate_shards() const;
+    void write_shard_session_summary() const;
     void risk_management_worker();
     void metrics_worker();
     void emergency_stop();
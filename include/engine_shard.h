@@ -0,0 +1,131 @@
+#pragma once
+
+#include "core/idle_strategy.h"
+#include "core/seqlock.h"
+#include "core/spsc_queue.h"
+#include "core/thread_placement.h"
+#include "data/market_data.h"
+#include "risk/risk_delta.h"
+#include "strategy/fair_value.h"
+#include "strategy/strategy_registry.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct AtomicHFTMetrics;
+class OrderExecutor;
+class OrderManager;
+
+// Totals one shard publishes for the risk and metrics threads.
+struct ShardSnapshot {
+    double pnl = 0.0;
+    double net_position = 0.0;
+    double gross_position = 0.0;  // sum of |position| over the shard's symbols
+    uint64_t ticks = 0;
+    uint64_t orders_placed = 0;
+    uint64_t fills = 0;
+    uint64_t quotes_marketable = 0;
+    uint64_t quotes_self_cross = 0;
+    uint64_t published_tsc = 0;
+
+    void add(const ShardSnapshot& other) {
+        pnl += other.pnl;
+        net_position += other.net_position;
+        gross_position += other.gross_position;
+        ticks += other.ticks;
+        orders_placed += other.orders_placed;
+        fills += other.fills;
+        quotes_marketable += other.quotes_marketable;
+        quotes_self_cross += other.quotes_self_cross;
+        published_tsc = std::max(published_tsc, other.published_tsc);
+    }
+};
+
+// One order engine on its own thread for a disjoint set of symbols. Symbols are dealt
+// round-robin over the feed's symbol list: feed index i goes to shard i % N, slot i / N.
+// Each symbol has its own order manager, executor and position; the shard has its own
+// strategy, tick queue and metrics block, so shards share no written cache lines with each
+// other. Cross-shard readers use snapshot() and position() only.
+class EngineShard {
+public:
+    EngineShard(uint32_t id, uint32_t shard_count, std::vector<std::string> symbols,
+                std::atomic<bool>& risk_breach, std::atomic<double>& max_position,
+                std::atomic<double>& order_size, int order_engine_hz,
+                StrategyKind strategy = StrategyKind::FIXED_SPREAD);
+    ~EngineShard();
+
+    static uint32_t shard_of(uint32_t symbol_index, uint32_t shard_count) { return symbol_index % shard_count; }
+    static uint32_t slot_of(uint32_t symbol_index, uint32_t shard_count) { return symbol_index / shard_count; }
+
+    // Symbols owned by shard `id` out of the feed's list, in slot order.
+    static std::vector<std::string> partition(const std::vector<std::string>& symbols,
+                                              uint32_t id, uint32_t shard_count);
+
+    // Feed side, single producer. Stamps enqueued_tsc; false if the queue is full.
+    bool publish(HFTMarketData& market_data);
+
+    // Fills of every symbol are published to risk_deltas. Call before start().
+    void set_risk_deltas(RiskDeltaQueue* risk_deltas);
+
+    // fill_signal (e.g. the risk thread's) is notified whenever the shard processed fills.
+    void start(const ThreadPlacement& placement, IdleMode idle_mode = IdleMode::SPIN_YIELD,
+               WakeSignal* fill_signal = nullptr);
+    void request_stop() {
+        running_.store(false, std::memory_order_relaxed);
+        wake_.notify();
+    }
+    void stop();
+
+    uint32_t id() const { return id_; }
+    const std::vector<std::string>& symbols() const { return symbols_; }
+    double position(size_t slot) const { return books_[slot]->position.load(std::memory_order_relaxed); }
+    ShardSnapshot snapshot() const { return snapshot_.load(); }
+    AtomicHFTMetrics& metrics() { return *metrics_; }
+
+private:
+    struct SymbolSlot {
+        std::string symbol;
+        std::atomic<double> position{0.0};
+        std::unique_ptr<OrderManager> order_manager;
+        std::unique_ptr<OrderExecutor> executor;
+        FairValue fair_value;
+        double last_bid = 0.0;
+        double last_ask = 0.0;
+    };
+
+    uint32_t id_;
+    uint32_t shard_count_;
+    std::vector<std::string> symbols_;
+    std::vector<std::unique_ptr<SymbolSlot>> books_;
+    std::unique_ptr<AtomicHFTMetrics> metrics_;
+    // One strategy per slot (strategies may keep per-symbol state), all of the configured type.
+    RegisteredStrategies::VariantOf<std::vector> strategies_;
+    std::atomic<double>& order_size_;
+    std::chrono::microseconds requote_interval_;
+
+    std::unique_ptr<SPSCQueue<HFTMarketData, 1024>> queue_;
+    uint64_t ticks_ = 0;
+
+    alignas(64) SeqLock<ShardSnapshot> snapshot_;
+
+    alignas(64) std::atomic<bool> running_{false};
+    bool parking_ = false;
+    WakeSignal wake_;
+    WakeSignal* fill_signal_ = nullptr;
+    IdleMode idle_mode_ = IdleMode::SPIN_YIELD;
+    std::thread thread_;
+    ThreadPlacement placement_;
+
+    void run();
+    // Instantiated per strategy type; run() visits strategies_ once to pick the instantiation.
+    template<typename StrategyT> void run_loop(std::vector<StrategyT>& strategies);
+    template<typename StrategyT> void handle_tick(std::vector<StrategyT>& strategies, HFTMarketData& market_data);
+    template<typename StrategyT> void requote_all(std::vector<StrategyT>& strategies);
+    bool drain_order_responses();
+    void publish_snapshot();
+};
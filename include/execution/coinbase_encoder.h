@@ -0,0 +1,47 @@
+#pragma once
+
+#include "execution/hft_order.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Advanced Trade order bodies written straight into a caller's buffer from pieces built once
+// per product: no JSON DOM, no allocation per order. Only the id, side, size and price are
+// formatted per order. Orders are limit GTC, post-only unless configured otherwise.
+//
+// client_order_id is "<session prefix><HFTOrder::client_order_id>": the exchange keeps
+// client ids unique across sessions, and the prefix keeps our counter restarting at 1 from
+// colliding with a previous run's orders.
+class CoinbaseOrderEncoder {
+public:
+    static constexpr size_t kMaxBodyBytes = 512;
+    static constexpr int kSizeDecimals = 8;
+
+    CoinbaseOrderEncoder(const std::string& product_id, double tick_size, const std::string& session_prefix,
+                         bool post_only = true);
+
+    // POST /api/v3/brokerage/orders body. `out` holds kMaxBodyBytes; returns the length.
+    size_t encode_create(const HFTOrder& order, char* out) const;
+    // POST /api/v3/brokerage/orders/batch_cancel body for exchange order ids.
+    void encode_cancel(const std::string* order_ids, size_t count, std::string& out) const;
+
+    // Our counter back out of a client_order_id; 0 if it is not one of this session's.
+    uint64_t parse_client_order_id(const char* text, size_t length) const;
+
+    const std::string& product_id() const { return product_id_; }
+    int price_decimals() const { return price_decimals_; }
+
+    // Rounds to `decimals` places (at most 12) and writes without exponent; returns the length.
+    static size_t format_fixed(double value, int decimals, char* out);
+    static size_t format_uint(uint64_t value, char* out);
+
+private:
+    std::string product_id_;
+    std::string session_prefix_;
+    int price_decimals_;
+    std::string head_;        // {"client_order_id":"<prefix>
+    std::string buy_side_;    // ","product_id":"<P>","side":"BUY","order_configuration":{..."base_size":"
+    std::string sell_side_;
+    std::string price_key_;   // ","limit_price":"
+    std::string tail_;        // ","post_only":true}}}
+};
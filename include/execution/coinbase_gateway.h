@@ -0,0 +1,158 @@
+#pragma once
+
+#include "core/idle_strategy.h"
+#include "core/jwt_signer.h"
+#include "core/spsc_queue.h"
+#include "execution/coinbase_encoder.h"
+#include "execution/https_connection.h"
+#include "execution/order_gateway.h"
+#include "execution/order_ladder.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+struct CoinbaseGatewayOptions {
+    std::string url = "https://api.coinbase.com";
+    std::string product_id;
+    double tick_size = 0.01;
+    bool post_only = true;
+    std::string session_prefix;  // client_order_id prefix; empty = "hft<unix seconds>-"
+};
+
+struct CoinbaseGatewayStats {
+    uint64_t requests = 0;           // HTTP requests sent
+    uint64_t orders_sent = 0;
+    uint64_t orders_acked = 0;
+    uint64_t orders_rejected = 0;
+    uint64_t cancels_sent = 0;       // order ids in batch_cancel requests
+    uint64_t skipped_unchanged = 0;  // replacements identical to the working order
+    uint64_t coalesced = 0;          // orders superseded before they were sent
+    uint64_t cancel_alls = 0;        // cancel_all() calls handled
+    uint64_t fills = 0;
+    uint64_t send_errors = 0;
+    uint64_t connects = 0;
+};
+
+// Coinbase Advanced Trade order entry. send() only queues: a sender thread owns one
+// keep-alive HTTPS connection and turns each burst of ladder orders into one batch_cancel of
+// the working orders being replaced followed by one create per new order. Acks and rejects
+// come from the REST responses; fills come from the `user` WebSocket channel, which the
+// engine's WebSocketClient forwards to on_user_message().
+//
+// Per ladder slot (side and level) the sender keeps only the newest queued order, and an
+// order identical in price and size to the one already working there is not resent: the
+// working order keeps its place in the queue and its fills arrive under its original id.
+// A replacing batch also cancels the working orders at levels it leaves out, in the same
+// batch_cancel. cancel_all() goes through the same queue, so it is ordered with the orders
+// around it, but the sender acts on it as soon as it is read: the batch_cancel goes out
+// before anything queued behind it is looked at.
+//
+// Request JWTs (one per method and path) come ready-signed from a JwtSigner: sending an order
+// reads a token, it never signs one. stop() cancels everything still working.
+class CoinbaseGateway : public OrderGateway {
+public:
+    static constexpr const char* kOrdersPath = "/api/v3/brokerage/orders";
+    static constexpr const char* kBatchCancelPath = "/api/v3/brokerage/orders/batch_cancel";
+
+    // Without a signer (or one without a key), requests carry no Authorization header.
+    CoinbaseGateway(CoinbaseGatewayOptions options, JwtSigner* signer);
+    ~CoinbaseGateway() override;
+
+    CoinbaseGateway(const CoinbaseGateway&) = delete;
+    CoinbaseGateway& operator=(const CoinbaseGateway&) = delete;
+
+    bool start();
+    void stop();
+
+    const char* name() const override { return "coinbase"; }
+    bool send(const HFTOrder& order) override;
+    bool submit(const OrderBatch& batch) override;
+    bool cancel_all(char side) override;
+    bool poll(HFTOrder& response) override;
+
+    // A `user` channel message; called on the WebSocket thread.
+    void on_user_message(const nlohmann::json& message);
+
+    CoinbaseGatewayStats stats() const;
+    const CoinbaseOrderEncoder& encoder() const { return encoder_; }
+
+private:
+    static constexpr size_t kSlots = 2 * OrderLadder::kMaxLevels;
+    static constexpr auto kIdleWake = std::chrono::seconds(1);
+    // Control entries in outbound_, told apart from orders by status.
+    static constexpr char kReplaceMarker = 'L';  // order_id: first id of the replacing batch
+    static constexpr char kCancelMarker = 'X';   // side: 'B', 'S' or 0 for both
+
+    struct WorkingOrder {
+        HFTOrder order;
+        std::string exchange_id;
+        bool live = false;
+    };
+
+    CoinbaseGatewayOptions options_;
+    JwtSigner* signer_;
+    int orders_token_ = -1;  // JwtSigner handles
+    int cancel_token_ = -1;
+    CoinbaseOrderEncoder encoder_;
+
+    // Executor -> sender: new orders. Sender -> executor: acks and rejects.
+    SPSCQueue<HFTOrder, 1024> outbound_;
+    SPSCQueue<HFTOrder, 1024> acks_;
+    // WebSocket thread -> executor: fills. WebSocket thread -> sender: ids no longer working.
+    SPSCQueue<HFTOrder, 1024> fills_;
+    SPSCQueue<uint64_t, 1024> closed_;
+    WakeSignal wake_;
+
+    std::thread sender_thread_;
+    std::atomic<bool> running_{false};
+
+    // Sender thread only.
+    HttpsConnection connection_;
+    std::array<HFTOrder, kSlots> pending_{};
+    std::array<bool, kSlots> has_pending_{};
+    std::array<uint64_t, kSlots> last_queued_{};  // id of the newest order read per slot
+    std::array<bool, kSlots> cancel_mark_{};      // cancel what works here at the next flush
+    std::array<WorkingOrder, kSlots> working_{};
+    std::array<uint64_t, 64> recently_closed_{};  // closed before their ack; 0 = empty
+    uint64_t closed_count_ = 0;
+    std::vector<std::string> cancel_ids_;
+    std::string cancel_body_;
+    HttpResponse response_;
+
+    // WebSocket thread only: cumulative filled size and notional per client_order_id.
+    struct FillState {
+        double quantity = 0.0;
+        double notional = 0.0;
+    };
+    std::unordered_map<std::string, FillState> fill_state_;
+
+    std::atomic<uint64_t> requests_{0};
+    std::atomic<uint64_t> orders_sent_{0};
+    std::atomic<uint64_t> orders_acked_{0};
+    std::atomic<uint64_t> orders_rejected_{0};
+    std::atomic<uint64_t> cancels_sent_{0};
+    std::atomic<uint64_t> skipped_unchanged_{0};
+    std::atomic<uint64_t> coalesced_{0};
+    std::atomic<uint64_t> cancel_alls_{0};
+    std::atomic<uint64_t> fills_count_{0};
+    std::atomic<uint64_t> send_errors_{0};
+    std::atomic<uint64_t> connects_{0};
+
+    void sender_loop();
+    bool drain_outbound();
+    void flush_pending();
+    void drop_slots(char side, uint64_t older_than);
+    void drain_closed();
+    std::string_view authorization(int token) const;
+    void send_cancels();  // cancel_ids_, one batch_cancel request
+    void send_create(const HFTOrder& order, size_t slot);
+    void push_ack(HFTOrder order, char status);
+    void on_order_update(const nlohmann::json& update, bool snapshot);
+};
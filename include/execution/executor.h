@@ -1,10 +1,13 @@
 #pragma once
 
-#include "core/spsc_queue.h"
+#include "core/types.h"
+#include "execution/hft_order.h"
+#include "execution/order_gateway.h"
+#include "execution/order_ladder.h"
+#include "risk/risk_delta.h"
 #include <array>
 #include <atomic>
-#include <chrono>
-#include <random>
+#include <memory>
 #include <string>
 #include <cstdint>
 
@@ -12,21 +15,6 @@ struct HFTSignal;
 struct AtomicHFTMetrics;
 class OrderManager;
 
-struct HFTOrder {
-    uint64_t order_id = 0;
-    uint64_t client_order_id = 0;
-    std::array<char, 16> symbol{};
-    char side = 0;
-    double price = 0.0;
-    double quantity = 0.0;
-    double filled_quantity = 0.0;
-    char status = 0;
-    std::chrono::high_resolution_clock::time_point timestamp;
-    std::chrono::high_resolution_clock::time_point order_sent_time;
-    std::chrono::high_resolution_clock::time_point fill_time;
-    uint32_t priority = 0;
-};
-
 class OrderExecutor {
 public:
     OrderExecutor(const std::string& trading_symbol,
@@ -36,30 +24,89 @@ public:
                   std::atomic<bool>& risk_breach,
                   std::atomic<double>& max_position);
 
-    void place_order_ladder(const HFTSignal& signal);
+    // Replaces the working ladder with this one in one gateway call: levels it leaves out
+    // (or all of them, when risk is breached) are cancelled.
+    void place_order_ladder(const HFTSignal& signal, const LatencyTrace& trace = LatencyTrace{});
+    // The ladder as one batch on top of what is working; only the levels it quotes change.
+    void submit_ladder(const HFTSignal& signal, const LatencyTrace& trace = LatencyTrace{});
+    // Cancels this symbol's working orders on one side ('B' or 'S') or both (0).
+    bool cancel_all(char side = 0);
+    // Once per loop pass: the first pass after risk_breach goes up cancels everything.
+    // True if it cancelled.
+    bool check_breach();
+    // Builds the ladder's orders without sending them and returns how many passed the checks:
+    // ladder_order(level, side) for each bit set in ladder(). Ids run nearest level first,
+    // bid before ask, the order they are sent in. Levels are kept off the last book seen and,
+    // unless the ladder replaces them, off our own working orders.
+    uint32_t build_ladder(const HFTSignal& signal, bool replace = true);
+    const OrderLadder& ladder() const { return ladder_builder_.ladder(); }
+    const HFTOrder& ladder_order(uint32_t level, char side) const {
+        return ladder_orders_[2 * level + (side == 'S' ? 1 : 0)];
+    }
     void process_order_response(const HFTOrder& response);
     bool pop_response(HFTOrder& response);
 
+    // Orders go to a SimulatedGateway unless another is set before trading starts.
+    void set_gateway(std::unique_ptr<OrderGateway> gateway);
+    OrderGateway& gateway() { return *gateway_; }
+    // Each book update, before the strategy sees it; the replay gateway matches on it.
+    void on_book(double bid, double ask) {
+        book_bid_ = bid;
+        book_ask_ = ask;
+        gateway_->on_book(bid, ask);
+    }
+    // Our best working bid and ask (0 = none), as far as the responses so far tell.
+    double working_bid() const;
+    double working_ask() const;
+    uint64_t rejected_orders() const { return rejected_orders_; }
+    uint64_t cancelled_orders() const { return cancelled_orders_; }
+
+    // Each processed fill is published here for the risk thread; the caller wakes it.
+    void set_risk_deltas(RiskDeltaQueue* risk_deltas) { risk_deltas_ = risk_deltas; }
+    uint64_t dropped_risk_deltas() const { return dropped_risk_deltas_; }
+
 private:
     std::string trading_symbol_;
+    uint32_t symbol_id_;  // SymbolRegistry id, for risk deltas
     OrderManager& order_manager_;
     AtomicHFTMetrics& metrics_;
     std::atomic<double>& current_position_;
     std::atomic<bool>& risk_breach_;
     std::atomic<double>& max_position_;
+    RiskDeltaQueue* risk_deltas_ = nullptr;
+    uint64_t dropped_risk_deltas_ = 0;
 
-    SPSCQueue<HFTOrder, 2048> inbound_order_queue_;
+    std::unique_ptr<OrderGateway> gateway_;
     std::atomic<uint64_t> next_order_id_{1};
+    uint64_t rejected_orders_ = 0;
+    uint64_t cancelled_orders_ = 0;
+    bool breach_cancelled_ = false;  // risk_breach_ as check_breach() last acted on it
+    double book_bid_ = 0.0;
+    double book_ask_ = 0.0;
 
-    std::mt19937 rng_;
-    std::uniform_real_distribution<> fill_distribution_{0.0, 1.0};
-
-    double tick_size_;
     static constexpr double MIN_ORDER_QTY = 0.001;
 
-    bool check_position_limit(const HFTOrder& order, double current_pos, double max_pos) const;
-    HFTOrder build_order(char side, double price, double quantity, uint32_t level);
-    bool send_order(HFTOrder& order);
-    uint64_t generate_order_id();
-    void update_latency_metrics(uint64_t latency_ns);
+    // Prices and sizes are built as arrays, then copied into one order slot per level and side.
+    // Slots are stamped once at construction (symbol, side, status, level) and a ladder only
+    // writes ids, prices, sizes and its one build timestamp.
+    LadderBuilder ladder_builder_;
+    std::array<HFTOrder, 2 * OrderLadder::kMaxLevels> ladder_orders_{};
+    OrderBatch batch_;
+
+    // Our working orders by slot, the same [2 * level + side] layout: set when a batch is
+    // taken, cleared by cancels, rejects and complete fills. remaining 0 = nothing working.
+    struct WorkingQuote {
+        uint64_t order_id = 0;
+        double price = 0.0;
+        double remaining = 0.0;
+    };
+    std::array<WorkingQuote, 2 * OrderLadder::kMaxLevels> working_{};
+    uint32_t working_levels_ = 0;
+
+    void track_batch(bool replace);
+    void track_response(const HFTOrder& response);
+    void clear_working(char side);
+    void dispatch_ladder(const HFTSignal& signal, const LatencyTrace& trace, bool replace);
+    void stamp_sent(HFTOrder& order, const LatencyTrace& trace);
+    void record_send_latency(const HFTOrder& order);
 };
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "core/types.h"
+#include <array>
+#include <cstdint>
+
+// An order on its way to a gateway, or a gateway's response about one. status:
+//   'N' new (outbound)   'A' acknowledged, working   'R' rejected
+//   'C' cancelled        'F' fill; filled_quantity is this fill only
+struct HFTOrder {
+    uint64_t order_id = 0;
+    uint64_t client_order_id = 0;
+    std::array<char, 16> symbol{};
+    char side = 0;
+    double price = 0.0;
+    double quantity = 0.0;
+    double filled_quantity = 0.0;
+    char status = 0;
+    LatencyTrace trace;         // stamps of the tick that produced this order, set when sent
+    uint64_t built_tsc = 0;     // one stamp per ladder, when it is sent
+    uint64_t sent_tsc = 0;
+    uint64_t fill_tsc = 0;
+    uint32_t priority = 0;      // ladder level
+};
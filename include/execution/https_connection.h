@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+typedef struct ssl_ctx_st SSL_CTX;
+typedef struct ssl_st SSL;
+
+struct HttpResponse {
+    int status = 0;
+    std::string body;
+};
+
+// One persistent HTTP/1.1 connection for request/response order entry: connected once,
+// kept alive between requests and reopened only after the peer closes it or an I/O error.
+// https:// URLs use TLS with peer and host name verification; http:// is plain TCP (the local
+// mock gateway). TCP_NODELAY is set so small request bodies go out at once. Not thread-safe:
+// one thread (a gateway's sender) owns it.
+class HttpsConnection {
+public:
+    HttpsConnection() = default;
+    ~HttpsConnection();
+
+    HttpsConnection(const HttpsConnection&) = delete;
+    HttpsConnection& operator=(const HttpsConnection&) = delete;
+
+    // Parses scheme://host[:port]; connects lazily on the first request.
+    bool open(const std::string& url);
+    void close();
+
+    // Sends one request and reads its response. A request that fails on a connection that was
+    // already open (the peer timed it out) is retried once on a fresh one.
+    bool request(const char* method, const std::string& path, std::string_view authorization,
+                 const char* body, size_t body_length, HttpResponse& response);
+
+    const std::string& host() const { return host_; }
+    bool connected() const { return fd_ >= 0; }
+    uint64_t connects() const { return connects_; }
+    uint64_t requests() const { return requests_; }
+
+private:
+    std::string host_;
+    int port_ = 443;
+    bool tls_ = true;
+
+    int fd_ = -1;
+    SSL_CTX* ssl_ctx_ = nullptr;
+    SSL* ssl_ = nullptr;
+    bool keep_alive_ = true;
+    uint64_t connects_ = 0;
+    uint64_t requests_ = 0;
+
+    std::string tx_;
+    std::string rx_;  // bytes read past the previous response
+
+    bool connect();
+    bool exchange(const char* method, const std::string& path, std::string_view authorization,
+                  const char* body, size_t body_length, HttpResponse& response);
+    bool write_all(const char* data, size_t length);
+    bool read_more();
+    bool read_response(HttpResponse& response);
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Local stand-in for the Advanced Trade order endpoints, for running a CoinbaseGateway
+// offline (ORDER_GATEWAY_URL=http://127.0.0.1:<port>). Plain HTTP/1.1 with keep-alive, one
+// connection at a time. Every create is accepted with a "mock-N" order id, or rejected in
+// reject mode; batch_cancel reports success for each id. Fills are not simulated.
+class MockGatewayServer {
+public:
+    MockGatewayServer(std::string bind_address, int port);
+    ~MockGatewayServer();
+
+    MockGatewayServer(const MockGatewayServer&) = delete;
+    MockGatewayServer& operator=(const MockGatewayServer&) = delete;
+
+    bool start();
+    void stop();
+
+    // Actual listening port (useful with port 0).
+    int port() const { return bound_port_; }
+    void set_reject(bool reject) { reject_.store(reject); }
+
+    uint64_t orders() const { return orders_.load(); }
+    uint64_t cancels() const { return cancels_.load(); }          // ids, across all batches
+    uint64_t cancel_requests() const { return cancel_requests_.load(); }
+    uint64_t connections() const { return connections_.load(); }
+    std::string last_order_body() const;
+    std::string last_authorization() const;
+
+private:
+    std::string bind_address_;
+    int port_;
+    int bound_port_ = 0;
+
+    int listen_fd_ = -1;
+    std::thread server_thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> reject_{false};
+
+    std::atomic<uint64_t> orders_{0};
+    std::atomic<uint64_t> cancels_{0};
+    std::atomic<uint64_t> cancel_requests_{0};
+    std::atomic<uint64_t> connections_{0};
+
+    mutable std::mutex last_mutex_;
+    std::string last_order_body_;
+    std::string last_authorization_;
+
+    void server_loop();
+    void handle_connection(int fd);
+    // Response body for one request; false for an unknown path.
+    bool respond(const std::string& request_line, const std::string& authorization,
+                 const std::string& body, std::string& out);
+};
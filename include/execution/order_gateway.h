@@ -0,0 +1,56 @@
+#pragma once
+
+#include "execution/hft_order.h"
+#include "execution/order_ladder.h"
+#include <array>
+#include <cstdint>
+#include <string>
+
+// ORDER_GATEWAY in config.txt; read once at startup.
+enum class GatewayKind : uint8_t {
+    SIMULATED,  // random fills on send (SimulatedGateway)
+    REPLAY,     // orders rest and fill when the book trades through them (ReplayGateway)
+    COINBASE    // Advanced Trade REST order entry, fills from the user channel (CoinbaseGateway)
+};
+
+const char* to_string(GatewayKind kind);
+// "sim", "replay", "coinbase"
+bool parseGatewayKind(const std::string& text, GatewayKind& kind);
+
+// One ladder handed to a gateway in one call, at most one order per side and level. Ids
+// ascend from orders[0]. With `replace` the batch is everything that should be working:
+// orders at levels it leaves out are cancelled.
+struct OrderBatch {
+    std::array<const HFTOrder*, 2 * OrderLadder::kMaxLevels> orders{};
+    uint32_t count = 0;
+    bool replace = false;
+};
+
+// Where an executor's orders go and where their acks and fills come back from. send(),
+// poll() and on_book() are called on the executor's thread only; a gateway that talks to a
+// venue does its I/O on its own threads and hands results back through poll(). One virtual
+// call per order is noise next to the send itself, so this is a plain interface.
+class OrderGateway {
+public:
+    virtual ~OrderGateway() = default;
+
+    virtual const char* name() const = 0;
+    // Takes a new order (status 'N'); false if it could not be taken (full, disconnected).
+    // The order replaces whatever this gateway still has working at its side and level.
+    virtual bool send(const HFTOrder& order) = 0;
+    // A whole ladder; a gateway that can puts it on the wire in as few messages as the venue
+    // allows. False if any order could not be taken. The default suits gateways whose orders
+    // do not rest.
+    virtual bool submit(const OrderBatch& batch) {
+        bool taken = true;
+        for (uint32_t i = 0; i < batch.count; ++i) taken &= send(*batch.orders[i]);
+        return taken;
+    }
+    // Cancels everything working on one side ('B' or 'S'), or both (0), including orders
+    // taken but not yet on the wire. Ahead of anything else the gateway has queued.
+    virtual bool cancel_all(char side) = 0;
+    // Next response: an ack, reject, cancel or fill (see HFTOrder::status).
+    virtual bool poll(HFTOrder& response) = 0;
+    // Each book update, for gateways that match orders themselves.
+    virtual void on_book(double /*bid*/, double /*ask*/) {}
+};
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "core/config_snapshot.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+struct HFTSignal;
+
+// One two-sided ladder as structure-of-arrays: level i of each side at index i, so prices,
+// sizes and the checks on them run over whole arrays instead of one order at a time.
+// Masks hold one bit per level that passed the minimum-size and position-limit checks.
+struct OrderLadder {
+    static constexpr size_t kMaxLevels = ConfigSnapshot::kMaxLadderLevels;
+
+    alignas(16) std::array<double, kMaxLevels> bid_price;
+    alignas(16) std::array<double, kMaxLevels> bid_quantity;
+    alignas(16) std::array<double, kMaxLevels> ask_price;
+    alignas(16) std::array<double, kMaxLevels> ask_quantity;
+    uint64_t bid_mask = 0;
+    uint64_t ask_mask = 0;
+    uint32_t levels = 0;
+    uint32_t marketable = 0;    // levels clamped behind the touch by the last build
+    uint32_t self_crosses = 0;  // levels dropped against our own orders by the last build
+
+    bool bid_at(uint32_t level) const { return (bid_mask >> level) & 1u; }
+    bool ask_at(uint32_t level) const { return (ask_mask >> level) & 1u; }
+    uint32_t order_count() const;
+};
+
+// What a ladder must not trade against: the book's best bid and ask, and our own best bid and
+// ask that stay working alongside it. 0 = nothing on that side.
+struct QuoteBounds {
+    double book_bid = 0.0;
+    double book_ask = 0.0;
+    double own_bid = 0.0;
+    double own_ask = 0.0;
+};
+
+// Fills an OrderLadder from a signal and the snapshot's ladder shape tables. The signal's
+// prices are snapped to the tick grid first (bid down, ask up), so every level is on it.
+// Each level is checked against the position as it stands before the ladder. One per executor.
+//
+// Then the guard, one pass over the levels: a level that would take liquidity (a bid at or
+// above the book's ask, an ask at or below its bid) is clamped one tick behind the touch, and
+// a level at or through our own opposite order is dropped. Clamped levels can share a price.
+class LadderBuilder {
+public:
+    // A breached executor passes place = false: the ladder comes back empty.
+    const OrderLadder& build(const HFTSignal& signal, const ConfigSnapshot& config, bool place,
+                             double position, double max_position, double min_quantity,
+                             const QuoteBounds& bounds = QuoteBounds{});
+
+    const OrderLadder& ladder() const { return ladder_; }
+
+private:
+    OrderLadder ladder_;
+
+    void guard(const QuoteBounds& bounds, double tick_size);
+};
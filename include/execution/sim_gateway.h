@@ -0,0 +1,55 @@
+#pragma once
+
+#include "core/spsc_queue.h"
+#include "execution/order_gateway.h"
+#include "execution/order_ladder.h"
+#include <array>
+#include <atomic>
+#include <random>
+
+// The original fill simulator: each order fills in full at once with a probability that
+// rises when it would reduce the position and falls when it would add to it.
+class SimulatedGateway : public OrderGateway {
+public:
+    explicit SimulatedGateway(const std::atomic<double>& position);
+
+    const char* name() const override { return "sim"; }
+    bool send(const HFTOrder& order) override;
+    bool cancel_all(char /*side*/) override { return true; }  // nothing rests
+    bool poll(HFTOrder& response) override { return responses_.pop(response); }
+
+private:
+    const std::atomic<double>& position_;
+    SPSCQueue<HFTOrder, 2048> responses_;
+    std::mt19937 rng_;
+    std::uniform_real_distribution<> fill_distribution_{0.0, 1.0};
+};
+
+// Backtest/paper matching against the book it is shown: one resting order per side and
+// ladder level (a new order at a level replaces the old one). A bid fills in full at its own
+// price once the ask trades down to it, an ask once the bid trades up to it. Queue position
+// is ignored, so fills are optimistic for orders that only just touch. Cancelled orders come
+// back as 'C'.
+class ReplayGateway : public OrderGateway {
+public:
+    const char* name() const override { return "replay"; }
+    bool send(const HFTOrder& order) override;
+    bool submit(const OrderBatch& batch) override;
+    bool cancel_all(char side) override;
+    bool poll(HFTOrder& response) override { return responses_.pop(response); }
+    void on_book(double bid, double ask) override;
+
+    uint32_t resting() const;
+
+private:
+    struct Slot {
+        HFTOrder order;
+        bool live = false;
+    };
+
+    std::array<Slot, 2 * OrderLadder::kMaxLevels> slots_{};  // [2 * level + (ask ? 1 : 0)]
+    uint32_t levels_used_ = 0;
+    SPSCQueue<HFTOrder, 2048> responses_;
+
+    void cancel(Slot& slot);
+};
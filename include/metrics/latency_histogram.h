@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+// Log-linear (HDR-style) latency histogram. Values below 32 are counted exactly; every
+// power of two above that is split into 16 linear sub-buckets, so any recorded value is
+// reported within ~6% (upper bucket edge). Range: 1 to 2^36 (~68 s of ns, ~20 s of 3 GHz TSC
+// ticks); larger values land in the top bucket. Units are the caller's.
+//
+// Single writer: record() is a relaxed load + store of one counter -- a plain increment,
+// no lock prefix or CAS -- so each histogram must be owned by exactly one thread.
+// Readers never write: they capture cumulative snapshots and subtract the previous one,
+// which "resets" the interval without touching the writer's cache lines.
+class alignas(64) LatencyHistogram {
+public:
+    static constexpr uint32_t SUB_BUCKET_BITS = 5;
+    static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+    static constexpr uint32_t SUB_BUCKET_HALF = SUB_BUCKET_COUNT / 2;
+    static constexpr uint32_t MAX_VALUE_BITS = 36;
+    static constexpr size_t BUCKET_COUNT =
+        SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF;
+
+    static size_t bucket_index(uint64_t value) {
+        if (value < SUB_BUCKET_COUNT) return static_cast<size_t>(value);
+        const uint32_t msb = 63u - static_cast<uint32_t>(__builtin_clzll(value));
+        if (msb >= MAX_VALUE_BITS) return BUCKET_COUNT - 1;
+        const uint32_t shift = msb - (SUB_BUCKET_BITS - 1);
+        const auto sub = static_cast<size_t>((value >> shift) - SUB_BUCKET_HALF);
+        return SUB_BUCKET_COUNT + (msb - SUB_BUCKET_BITS) * SUB_BUCKET_HALF + sub;
+    }
+
+    // Highest value that maps to the bucket.
+    static uint64_t bucket_upper_bound(size_t index) {
+        if (index < SUB_BUCKET_COUNT) return index;
+        const size_t offset = index - SUB_BUCKET_COUNT;
+        const auto msb = static_cast<uint32_t>(offset / SUB_BUCKET_HALF) + SUB_BUCKET_BITS;
+        const uint32_t shift = msb - (SUB_BUCKET_BITS - 1);
+        const uint64_t lower = (SUB_BUCKET_HALF + offset % SUB_BUCKET_HALF) << shift;
+        return lower + (uint64_t{1} << shift) - 1;
+    }
+
+    void record(uint64_t value) {
+        auto& bucket = counts_[bucket_index(value)];
+        bucket.store(bucket.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        sum_.store(sum_.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+        if (value > max_.load(std::memory_order_relaxed)) {
+            max_.store(value, std::memory_order_relaxed);
+        }
+    }
+
+    uint64_t count_at(size_t index) const { return counts_[index].load(std::memory_order_relaxed); }
+    uint64_t sum() const { return sum_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+
+    // Member offsets for out-of-process readers (see shm_metrics.h).
+    static constexpr size_t sum_offset() { return offsetof(LatencyHistogram, sum_); }
+    static constexpr size_t max_offset() { return offsetof(LatencyHistogram, max_); }
+
+private:
+    std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts_{};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Plain-memory copy of one or more histograms, owned by the reader.
+struct HistogramSnapshot {
+    std::array<uint64_t, LatencyHistogram::BUCKET_COUNT> counts{};
+    uint64_t total = 0;
+    uint64_t sum = 0;
+    uint64_t max = 0;
+
+    void clear() { *this = HistogramSnapshot{}; }
+
+    // Adds the histogram's cumulative counts (one pass over the writer's buckets).
+    void accumulate(const LatencyHistogram& histogram) {
+        for (size_t i = 0; i < counts.size(); ++i) {
+            const uint64_t c = histogram.count_at(i);
+            counts[i] += c;
+            total += c;
+        }
+        sum += histogram.sum();
+        if (histogram.max() > max) max = histogram.max();
+    }
+
+    void merge(const HistogramSnapshot& other) {
+        for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+        total += other.total;
+        sum += other.sum;
+        if (other.max > max) max = other.max;
+    }
+
+    // this = current - previous (both cumulative). The interval max is the upper edge of
+    // the highest bucket that moved, capped by the exact cumulative max.
+    void set_interval(const HistogramSnapshot& current, const HistogramSnapshot& previous) {
+        total = 0;
+        max = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            counts[i] = current.counts[i] - previous.counts[i];
+            total += counts[i];
+            if (counts[i] > 0) max = LatencyHistogram::bucket_upper_bound(i);
+        }
+        sum = current.sum - previous.sum;
+        if (max > current.max) max = current.max;
+    }
+
+    uint64_t percentile(double pct) const {
+        if (total == 0) return 0;
+        auto rank = static_cast<uint64_t>(pct / 100.0 * static_cast<double>(total) + 0.5);
+        if (rank == 0) rank = 1;
+        uint64_t seen = 0;
+        for (size_t i = 0; i < counts.size(); ++i) {
+            seen += counts[i];
+            if (seen >= rank) {
+                uint64_t bound = LatencyHistogram::bucket_upper_bound(i);
+                return bound < max ? bound : max;
+            }
+        }
+        return max;
+    }
+
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+};
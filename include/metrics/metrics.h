@@ -1,47 +1,123 @@
 #pragma once
 
+#include "metrics/latency_histogram.h"
 #include <atomic>
+#include <array>
 #include <chrono>
 #include <cstdint>
 #include <climits>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
 
 class OrderManager;
+class ShmMetricsSegment;
+
+// Latency stages. Each stage histogram has exactly one writer thread (noted per stage).
+enum class LatencyStage : uint8_t {
+    WS_PARSE,       // websocket: first fragment received -> JSON parsed
+    BOOK_UPDATE,    // websocket: JSON parsed -> book applied, BBO extracted
+    QUEUE_PUBLISH,  // websocket: book updated -> pushed to market data queue
+    QUEUE_WAIT,     // order engine: queue push -> pop
+    SIGNAL,         // order engine: pop -> strategy signal generated
+    ORDER_BUILD,    // order engine: signal -> first order built
+    ORDER_SEND,     // order engine: first order built -> sent
+    ORDER_LADDER,   // order engine: place_order_ladder() start -> end
+    TICK_TO_TRADE,  // order engine: first fragment received -> first order sent
+    COUNT
+};
+
+constexpr size_t LATENCY_STAGE_COUNT = static_cast<size_t>(LatencyStage::COUNT);
+
+inline const char* to_string(LatencyStage stage) {
+    switch (stage) {
+        case LatencyStage::WS_PARSE:      return "ws_parse";
+        case LatencyStage::BOOK_UPDATE:   return "book_update";
+        case LatencyStage::QUEUE_PUBLISH: return "queue_publish";
+        case LatencyStage::QUEUE_WAIT:    return "queue_wait";
+        case LatencyStage::SIGNAL:        return "signal";
+        case LatencyStage::ORDER_BUILD:   return "order_build";
+        case LatencyStage::ORDER_SEND:    return "order_send";
+        case LatencyStage::ORDER_LADDER:  return "order_ladder";
+        case LatencyStage::TICK_TO_TRADE: return "tick_to_trade";
+        case LatencyStage::COUNT:         break;
+    }
+    return "unknown";
+}
 
 struct AtomicHFTMetrics {
     // Written by order engine / executor thread
     alignas(64) std::atomic<uint64_t> orders_placed{0};
     std::atomic<uint64_t> orders_filled{0};
     std::atomic<double> total_pnl{0.0};
+    std::atomic<uint64_t> quotes_marketable{0};  // ladder levels clamped behind the touch
+    std::atomic<uint64_t> quotes_self_cross{0};  // ladder levels dropped against our own orders
 
     // Written by risk management thread
     alignas(64) std::atomic<double> current_position{0.0};
 
     // Written by WebSocket / market data thread
     alignas(64) std::atomic<uint64_t> market_data_updates{0};
-    std::atomic<uint64_t> websocket_latency_ns{0};
-
-    // Written by order engine thread (latency tracking)
-    alignas(64) std::atomic<uint64_t> avg_order_latency_ns{0};
-    std::atomic<uint64_t> min_order_latency_ns{UINT64_MAX};
-    std::atomic<uint64_t> max_order_latency_ns{0};
+    std::atomic<uint64_t> websocket_latency_ticks{0};  // last receive -> hand-off to the strategy (FastClock ticks)
 
     // Written by metrics thread
     alignas(64) std::atomic<uint64_t> orders_per_second{0};
+
+    // Per-stage latency histograms in FastClock ticks, single writer each -- see LatencyStage.
+    alignas(64) std::array<LatencyHistogram, LATENCY_STAGE_COUNT> stage_latency{};
+
+    LatencyHistogram& latency(LatencyStage stage) { return stage_latency[static_cast<size_t>(stage)]; }
+    const LatencyHistogram& latency(LatencyStage stage) const { return stage_latency[static_cast<size_t>(stage)]; }
 };
 
 class MetricsCollector {
 public:
-    explicit MetricsCollector(OrderManager& order_manager);
+    struct TradingTotals {
+        uint64_t trades = 0;
+        double pnl = 0.0;
+        double position = 0.0;
+    };
+
+    // With a non-empty shm_name the metrics block lives in a POSIX shared-memory segment
+    // (see shm_metrics.h) readable by hft_top; otherwise, or if creation fails, on the heap.
+    explicit MetricsCollector(OrderManager& order_manager,
+                              const std::string& shm_name = "",
+                              const std::string& symbol = "");
+    ~MetricsCollector();
 
-    AtomicHFTMetrics& metrics() { return metrics_; }
-    const AtomicHFTMetrics& metrics() const { return metrics_; }
+    AtomicHFTMetrics& metrics() { return *metrics_; }
+    const AtomicHFTMetrics& metrics() const { return *metrics_; }
+    bool shared_memory_enabled() const { return shm_segment_ != nullptr; }
 
     void tick();
     void print_performance_stats() const;
+    double uptime_seconds() const;
+
+    // Additional per-thread histograms merged into a stage (e.g. one per worker thread).
+    void register_latency_source(LatencyStage stage, const LatencyHistogram& histogram);
+
+    // Trade totals for the console summaries; the OrderManager passed in unless replaced
+    // (the sharded engine sums its shard snapshots).
+    void set_totals_source(std::function<TradingTotals()> source);
+
+    // Merged cumulative snapshot of a stage since engine start.
+    void capture_latency(LatencyStage stage, HistogramSnapshot& out) const;
+    // Interval snapshot produced by the last roll_latency_windows().
+    const HistogramSnapshot& latency_window(LatencyStage stage) const {
+        return latency_window_[static_cast<size_t>(stage)];
+    }
+    void roll_latency_windows();
 
 private:
-    AtomicHFTMetrics metrics_;
+    std::unique_ptr<ShmMetricsSegment> shm_segment_;
+    std::unique_ptr<AtomicHFTMetrics> heap_metrics_;
+    AtomicHFTMetrics* metrics_ = nullptr;
     OrderManager& order_manager_;
+    std::function<TradingTotals()> totals_source_;
+    std::array<std::vector<const LatencyHistogram*>, LATENCY_STAGE_COUNT> latency_sources_;
+    std::array<HistogramSnapshot, LATENCY_STAGE_COUNT> latency_cumulative_{};
+    std::array<HistogramSnapshot, LATENCY_STAGE_COUNT> latency_window_{};
     std::chrono::high_resolution_clock::time_point engine_start_time_;
 
     uint64_t last_rate_orders_ = 0;
@@ -53,4 +129,5 @@ private:
     std::chrono::steady_clock::time_point last_print_;
 
     void update_trading_rate();
+    TradingTotals totals() const;
 };
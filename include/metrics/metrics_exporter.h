@@ -0,0 +1,85 @@
+#pragma once
+
+#include "metrics/metrics.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct SymbolFeedStats {
+    std::string symbol;
+    double bid = 0.0;
+    double ask = 0.0;
+    double spread_bps = 0.0;
+    uint64_t updates = 0;
+    double last_update_age_seconds = 0.0;
+};
+
+// Plain-value copy of everything the exporter serves. Filled once per scrape by the
+// snapshot provider, so each scrape reads the trading threads' atomics exactly once.
+struct MetricsSnapshot {
+    // Counters
+    uint64_t orders_placed = 0;
+    uint64_t orders_filled = 0;
+    uint64_t quotes_marketable = 0;
+    uint64_t quotes_self_cross = 0;
+    uint64_t market_data_updates = 0;
+    uint64_t total_trades = 0;
+    uint64_t dropped_log_records = 0;
+    uint64_t dropped_risk_events = 0;
+
+    // Gauges
+    double pnl = 0.0;
+    double position = 0.0;
+    uint64_t orders_per_second = 0;
+    double websocket_latency_seconds = 0.0;
+    bool circuit_breaker_active = false;
+    int risk_status = 0;
+    double uptime_seconds = 0.0;
+
+    std::vector<SymbolFeedStats> feeds;
+    std::array<HistogramSnapshot, LATENCY_STAGE_COUNT> stage_latency{};  // FastClock ticks
+};
+
+// Minimal HTTP/1.0 server for GET /metrics in OpenMetrics text format. Runs on its own thread
+// at idle scheduling priority; one connection at a time, closed after each response.
+class MetricsExporter {
+public:
+    using SnapshotProvider = std::function<void(MetricsSnapshot&)>;
+
+    MetricsExporter(std::string bind_address, int port, SnapshotProvider provider);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    bool start();
+    void stop();
+
+    // Actual listening port (useful with port 0).
+    int port() const { return bound_port_; }
+    uint64_t scrapes() const { return scrapes_.load(std::memory_order_relaxed); }
+
+    static void render(const MetricsSnapshot& snapshot, std::string& out);
+
+private:
+    std::string bind_address_;
+    int port_;
+    int bound_port_ = 0;
+    SnapshotProvider provider_;
+
+    int listen_fd_ = -1;
+    std::thread server_thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> scrapes_{0};
+
+    // Server thread only.
+    MetricsSnapshot snapshot_;
+    std::string body_;
+
+    void server_loop();
+    void handle_connection(int fd);
+};
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "metrics/metrics.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Layout of the shared-memory metrics segment (POSIX shm, e.g. /dev/shm/hft_metrics):
+//
+//   [ShmMetricsHeader][padding to 64][AtomicHFTMetrics]
+//
+// The engine writes AtomicHFTMetrics in place exactly as it would on the heap; the header
+// describes where every field and histogram lives so readers never depend on the engine's
+// struct definition. Readers map the segment read-only and pay the whole read cost.
+constexpr uint32_t SHM_METRICS_MAGIC = 0x4D544648;  // "HFTM"
+constexpr uint32_t SHM_METRICS_VERSION = 1;         // bump on any incompatible layout change
+constexpr size_t SHM_METRICS_MAX_FIELDS = 16;
+constexpr size_t SHM_METRICS_MAX_STAGES = 16;
+constexpr size_t SHM_METRICS_NAME_LEN = 32;
+
+enum class ShmFieldType : uint32_t { U64 = 1, F64 = 2 };
+
+struct ShmFieldDesc {
+    char name[SHM_METRICS_NAME_LEN];
+    uint32_t offset;        // from the start of the metrics block
+    ShmFieldType type;
+};
+
+struct ShmMetricsHeader {
+    std::atomic<uint32_t> magic;    // written last; readers wait for SHM_METRICS_MAGIC
+    uint32_t version;
+    uint32_t header_size;
+    uint32_t segment_size;
+    uint32_t metrics_offset;        // from the start of the segment
+    uint32_t metrics_size;
+    int32_t writer_pid;
+    uint32_t field_count;
+    ShmFieldDesc fields[SHM_METRICS_MAX_FIELDS];
+
+    // Histogram geometry (see LatencyHistogram).
+    uint32_t stage_count;
+    uint32_t histogram_offset;      // first histogram, from the start of the metrics block
+    uint32_t histogram_stride;
+    uint32_t histogram_bucket_count;
+    uint32_t histogram_sum_offset;  // within one histogram
+    uint32_t histogram_max_offset;
+    uint32_t sub_bucket_bits;
+    uint32_t max_value_bits;
+    char stage_names[SHM_METRICS_MAX_STAGES][SHM_METRICS_NAME_LEN];
+
+    char symbol[SHM_METRICS_NAME_LEN];
+    uint64_t start_wall_ns;
+
+    // Refreshed by the metrics thread.
+    std::atomic<double> ns_per_tick;
+    std::atomic<uint64_t> heartbeat_wall_ns;
+};
+
+// Writer side: creates /name, places the header and an AtomicHFTMetrics in it.
+class ShmMetricsSegment {
+public:
+    ShmMetricsSegment() = default;
+    ~ShmMetricsSegment();
+
+    ShmMetricsSegment(const ShmMetricsSegment&) = delete;
+    ShmMetricsSegment& operator=(const ShmMetricsSegment&) = delete;
+
+    bool create(const std::string& name, const std::string& symbol);
+    void destroy();
+
+    AtomicHFTMetrics* metrics() const { return metrics_; }
+    ShmMetricsHeader* header() const { return header_; }
+    const std::string& name() const { return name_; }
+
+private:
+    std::string name_;
+    void* base_ = nullptr;
+    size_t size_ = 0;
+    ShmMetricsHeader* header_ = nullptr;
+    AtomicHFTMetrics* metrics_ = nullptr;
+};
+
+// Reader side: maps an existing segment read-only and validates the layout.
+class ShmMetricsReader {
+public:
+    ShmMetricsReader() = default;
+    ~ShmMetricsReader();
+
+    ShmMetricsReader(const ShmMetricsReader&) = delete;
+    ShmMetricsReader& operator=(const ShmMetricsReader&) = delete;
+
+    bool attach(const std::string& name, std::string& error);
+    void detach();
+
+    const ShmMetricsHeader& header() const { return *header_; }
+
+    // Field lookup by name; returns false if the writer does not publish it.
+    bool read_u64(const char* field, uint64_t& value) const;
+    bool read_f64(const char* field, double& value) const;
+
+    uint32_t stage_count() const { return header_->stage_count; }
+    const char* stage_name(uint32_t stage) const { return header_->stage_names[stage]; }
+    uint64_t bucket_count(uint32_t stage, uint32_t bucket) const;
+    uint64_t histogram_sum(uint32_t stage) const;
+    uint64_t histogram_max(uint32_t stage) const;
+    uint64_t bucket_upper_bound(uint32_t bucket) const;
+
+private:
+    const void* base_ = nullptr;
+    size_t size_ = 0;
+    const ShmMetricsHeader* header_ = nullptr;
+    const char* metrics_ = nullptr;
+
+    const ShmFieldDesc* find(const char* field) const;
+};
@@ -23,6 +23,11 @@ public:
 
     bool initialize();
     void shutdown();
+    // Off for order managers whose totals are reported by an owner (e.g. engine shard slots).
+    void setSessionSummary(bool enabled) { session_summary_ = enabled; }
+
+    // Appends a formatted summary block to session_summary.log.
+    static void writeSessionSummary(const std::string& summary);
 
     OrderResponse placeOrder(const std::string& symbol, Side side, double price, double quantity);
 
@@ -48,6 +53,7 @@ private:
     std::atomic<uint64_t> orders_filled_{0};
 
     bool shutdown_called_ = false;
+    bool session_summary_ = true;
 
     std::string generateClientOrderId();
 
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "core/mpsc_queue.h"
+#include <cstdint>
+
+// One fill as the risk thread sees it. Values are absolute per symbol (position and realized
+// PnL after the fill), so a dropped delta is healed by the next one for the same symbol and
+// applying them never double counts.
+struct RiskDelta {
+    uint32_t symbol_id = 0;   // SymbolRegistry id
+    double position = 0.0;
+    double price = 0.0;       // fill price; marks the position for notional limits
+    double realized_pnl = 0.0;
+    uint64_t fill_tsc = 0;
+};
+
+// Every thread that processes fills (order engine, shards) pushes; the risk thread pops.
+using RiskDeltaQueue = MPSCQueue<RiskDelta, 4096>;
@@ -1,14 +1,25 @@
 #pragma once
 
+#include "core/config_snapshot.h"
+#include "core/mpsc_queue.h"
+#include "core/rolling_counter.h"
+#include "core/symbol_registry.h"
+#include "core/types.h"
+#include "risk/risk_delta.h"
 #include <string>
+#include <array>
 #include <chrono>
 #include <atomic>
 #include <mutex>
-#include <map>
+#include <thread>
 #include <vector>
+#include <cstdint>
 
 enum class RiskEventType {
     POSITION_LIMIT_EXCEEDED,
+    NOTIONAL_LIMIT_EXCEEDED,
+    SYMBOL_LOSS_LIMIT_EXCEEDED,
+    EXPOSURE_LIMIT_EXCEEDED,
     DAILY_LOSS_LIMIT_EXCEEDED,
     DRAWDOWN_LIMIT_EXCEEDED,
     ORDER_RATE_LIMIT_EXCEEDED,
@@ -25,14 +36,41 @@ enum class RiskLevel {
     EMERGENCY
 };
 
+// Interned risk messages: events carry a code instead of a formatted string so they can be
+// recorded without allocating. The drainer thread turns codes back into text.
+enum class RiskMessage : uint16_t {
+    NONE,
+    RISK_MANAGER_INITIALIZED,
+    RISK_MANAGER_SHUTDOWN,
+    ORDER_REJECTED_POSITION_LIMIT,
+    ORDER_REJECTED_RATE_LIMIT,
+    DAILY_LOSS_LIMIT_EXCEEDED,
+    DRAWDOWN_LIMIT_EXCEEDED,
+    APPROACHING_DAILY_LOSS_LIMIT,
+    FILL_EXCEEDED_POSITION_LIMIT,
+    ORDER_REJECTED_NOTIONAL_LIMIT,
+    ORDER_REJECTED_EXPOSURE_LIMIT,
+    ORDER_REJECTED_SYMBOL_HALTED,
+    FILL_EXCEEDED_NOTIONAL_LIMIT,
+    FILL_EXCEEDED_ASSET_LIMIT,
+    FILL_EXCEEDED_GROSS_NOTIONAL,
+    FILL_EXCEEDED_NET_NOTIONAL,
+    SYMBOL_LOSS_LIMIT_EXCEEDED
+};
+
+const char* to_string(RiskMessage message);
+const char* to_string(RiskEventType type);
+const char* to_string(RiskLevel level);
+
+// Trivially copyable so it can live in a fixed-size lock-free ring.
 struct RiskEvent {
-    RiskEventType type;
-    RiskLevel level;
-    std::string message;
-    std::chrono::system_clock::time_point timestamp;
-    std::string symbol;
-    double value;
-    double limit;
+    RiskEventType type = RiskEventType::SYSTEM_INFO;
+    RiskLevel level = RiskLevel::INFO;
+    RiskMessage message = RiskMessage::NONE;
+    uint64_t timestamp_ns = 0;
+    std::array<char, 16> symbol{};
+    double value = 0.0;
+    double limit = 0.0;
 };
 
 enum class RiskStatus {
@@ -50,19 +88,73 @@ public:
     bool initialize(const std::string& config_file);
     void shutdown();
 
+    // Interns the symbol and loads its limits. Per-symbol keys use SymbolRegistry::configKey:
+    // POSITION_LIMIT_ETHUSD (base units), NOTIONAL_LIMIT_ETHUSD and LOSS_LIMIT_ETHUSD (quote);
+    // per asset ASSET_LIMIT_ETH (|net| in that asset). 0 or missing means no limit.
+    uint32_t registerSymbol(const std::string& symbol);
+
     bool canPlaceOrder(const std::string& symbol, const std::string& side,
                        double price, double quantity, std::string& rejection_reason);
+    bool canPlaceOrder(uint32_t symbol_id, Side side, double price, double quantity,
+                       std::string& rejection_reason);
+    // The position, halt and financial checks of canPlaceOrder without its side effects: no
+    // order counted against the rate limit and no risk event. For the risk thread's periodic
+    // "can anything still trade" probe.
+    bool canTrade(uint32_t symbol_id, Side side, double price, double quantity,
+                  std::string& rejection_reason);
 
     void updatePnL(double pnl_change);
     void updatePosition(const std::string& symbol, double position);
 
+    double getPosition(uint32_t symbol_id) const;
+    double getSymbolPnL(uint32_t symbol_id) const;
+    double getAssetExposure(uint32_t asset_id) const;
+    // Sums of position * last fill price over all symbols, in quote units (assumes one quote
+    // currency). Maintained incrementally per fill.
+    double getGrossNotional() const;
+    double getNetNotional() const;
+
+    // Fill path: producers push into riskDeltas() and wake the risk thread, which calls
+    // processRiskDeltas(). Limits are checked per delta: a fill past a position, notional or
+    // exposure limit, or past the daily loss or drawdown limit, trips the circuit breaker (and
+    // the breach flag) on that fill. A symbol's own loss limit halts only that symbol.
+    RiskDeltaQueue& riskDeltas() { return risk_deltas_; }
+    size_t processRiskDeltas();
+    void setBreachFlag(std::atomic<bool>* breach_flag) { breach_flag_ = breach_flag; }
+
+    // Delta that tripped the circuit breaker: 1-based count of deltas applied, and ticks from
+    // its fill to the trip. Zero when the breaker has not been tripped by a fill.
+    uint64_t getBreachDeltaIndex() const { return breach_delta_index_.load(std::memory_order_acquire); }
+    uint64_t getBreachLatencyTicks() const { return breach_latency_ticks_.load(std::memory_order_relaxed); }
+
     RiskStatus getCurrentRiskStatus() const;
     bool isCircuitBreakerActive() const;
+    uint64_t getDroppedRiskEvents() const { return dropped_risk_events_.load(std::memory_order_relaxed); }
 
 private:
+    // Dense per-symbol / per-asset state indexed by SymbolRegistry ids.
+    struct SymbolRisk {
+        double position = 0.0;
+        double mark_price = 0.0;      // last fill price
+        double realized_pnl = 0.0;    // as last reported by the symbol's fills
+        double position_limit = 0.0;  // 0 = none
+        double notional_limit = 0.0;
+        double loss_limit = 0.0;
+        bool halted = false;          // hit its loss limit; no new orders
+    };
+
+    struct AssetRisk {
+        double exposure = 0.0;  // base: sum of positions; quote: minus the notional held
+        double limit = 0.0;
+    };
+
     mutable std::mutex position_mutex_;
-    std::map<std::string, double> positions_;
-    std::map<std::string, double> position_limits_;
+    std::array<SymbolRisk, SymbolRegistry::kMaxSymbols> symbol_risk_{};
+    std::array<AssetRisk, SymbolRegistry::kMaxAssets> asset_risk_{};
+    double gross_notional_ = 0.0;
+    double net_notional_ = 0.0;
+    double max_gross_notional_ = 0.0;  // 0 = none
+    double max_net_notional_ = 0.0;
 
     mutable std::mutex financial_mutex_;
     double current_pnl_ = 0.0;
@@ -73,21 +165,55 @@ private:
     std::chrono::system_clock::time_point daily_reset_time_;
 
     mutable std::mutex operational_mutex_;
-    std::vector<std::chrono::system_clock::time_point> recent_orders_;
+    std::vector<uint64_t> recent_orders_;  // FastClock ticks
     uint64_t max_orders_per_second_ = 10;
     std::atomic<bool> circuit_breaker_active_{false};
-    std::string circuit_breaker_reason_;
+    std::atomic<RiskMessage> circuit_breaker_reason_{RiskMessage::NONE};
+    std::atomic<bool>* breach_flag_ = nullptr;
+    std::atomic<const ConfigSnapshot*> applied_config_{nullptr};
+
+    // Owned by the risk thread (processRiskDeltas).
+    RiskDeltaQueue risk_deltas_;
+    uint64_t deltas_applied_ = 0;
+    std::atomic<uint64_t> breach_delta_index_{0};
+    std::atomic<uint64_t> breach_latency_ticks_{0};
 
-    mutable std::mutex events_mutex_;
-    std::vector<RiskEvent> risk_events_;
-    static constexpr size_t MAX_RISK_EVENTS = 1000;
+    // Risk events: producers push PODs into the ring and bump the per-level rolling counters;
+    // the drainer thread formats and persists them to logs/risk_events.log.
+    static constexpr size_t MAX_RISK_EVENTS = 1024;
+    static constexpr size_t STATUS_WINDOW_BUCKETS = 60;
+    static constexpr uint64_t STATUS_BUCKET_WIDTH_NS = 5ULL * 1000000000ULL;  // 60 x 5s = 5 min
+
+    MPSCQueue<RiskEvent, MAX_RISK_EVENTS> risk_events_;
+    std::array<RollingCounter<STATUS_WINDOW_BUCKETS>, 4> recent_events_by_level_{{
+        RollingCounter<STATUS_WINDOW_BUCKETS>(STATUS_BUCKET_WIDTH_NS),
+        RollingCounter<STATUS_WINDOW_BUCKETS>(STATUS_BUCKET_WIDTH_NS),
+        RollingCounter<STATUS_WINDOW_BUCKETS>(STATUS_BUCKET_WIDTH_NS),
+        RollingCounter<STATUS_WINDOW_BUCKETS>(STATUS_BUCKET_WIDTH_NS)
+    }};
+    std::atomic<uint64_t> dropped_risk_events_{0};
+
+    std::thread event_drain_thread_;
+    std::atomic<bool> event_drain_running_{false};
+    bool shutdown_called_ = false;
 
     void loadConfiguration();
-    bool checkPositionLimits(const std::string& symbol, const std::string& side, double quantity) const;
+    // Picks up a newly published ConfigSnapshot; one atomic load when nothing changed.
+    void refreshConfig();
+    void loadSymbolLimits(uint32_t symbol_id);  // per-symbol and asset keys; cold
+    // Moves a symbol to a new position/mark and adjusts asset and aggregate exposure; position_mutex_ held.
+    void setPosition(uint32_t symbol_id, double position, double mark_price);
+    RiskMessage checkPositionLimits(uint32_t symbol_id, Side side, double price, double quantity) const;
     bool checkFinancialLimits(double estimated_pnl_impact) const;
     bool checkOperationalLimits();
-    void triggerCircuitBreaker(const std::string& reason);
-    void recordRiskEvent(RiskEventType type, RiskLevel level, const std::string& message,
+    void applyRiskDelta(const RiskDelta& delta);
+    void triggerCircuitBreaker(RiskMessage reason);
+    void recordRiskEvent(RiskEventType type, RiskLevel level, RiskMessage message,
                          const std::string& symbol = "", double value = 0.0, double limit = 0.0);
-    void cleanupOldOrders();
+    void cleanupOldOrders(uint64_t now);  // FastClock ticks
+
+    void startEventDrainer();
+    void stopEventDrainer();
+    void eventDrainWorker();
+    static void formatRiskEvent(const RiskEvent& event, std::string& out);
 };
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "strategy/market_maker.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// Online estimates from the BBO stream, O(1) per tick. Every sum decays exponentially with the
+// time since the previous tick, so the estimates cover roughly the last half-life of wall time
+// however bursty the feed is:
+//   variance_rate  price^2 per second of mid changes (realized volatility squared)
+//   intensity      mid changes per second
+//   kappa          1 / mean |mid change|; the per-price-unit decay of the chance that a quote
+//                  that far from the mid gets hit, as in lambda(delta) = A * exp(-kappa * delta)
+class MarketEstimator {
+public:
+    static constexpr uint64_t kWarmupMoves = 32;  // mid changes before estimates are used
+
+    MarketEstimator();
+
+    void update(double bid, double ask, uint64_t tsc, double half_life_seconds);
+
+    bool warm() const { return moves_seen_ >= kWarmupMoves; }
+    double variance_rate() const { return elapsed_ > 0.0 ? squared_moves_ / elapsed_ : 0.0; }
+    double intensity() const { return elapsed_ > 0.0 ? moves_ / elapsed_ : 0.0; }
+    double kappa() const { return absolute_moves_ > 0.0 ? moves_ / absolute_moves_ : 0.0; }
+    uint64_t moves_seen() const { return moves_seen_; }
+
+private:
+    double seconds_per_tick_;
+    double last_mid_ = 0.0;
+    uint64_t last_tsc_ = 0;
+    bool primed_ = false;
+    uint64_t moves_seen_ = 0;
+
+    // Decayed sums
+    double elapsed_ = 0.0;         // seconds
+    double squared_moves_ = 0.0;   // sum of (mid change)^2
+    double absolute_moves_ = 0.0;  // sum of |mid change|
+    double moves_ = 0.0;           // count of non-zero mid changes
+};
+
+// Avellaneda & Stoikov (2008) quoting around a reservation price:
+//   r      = fair - q * gamma * sigma^2 * tau
+//   spread = gamma * sigma^2 * tau + (2 / gamma) * ln(1 + gamma / kappa)
+// fair is the fair value (the mid without depth), q the position in ORDER_SIZE lots, gamma
+// AS_RISK_AVERSION, tau AS_HORIZON_SECONDS (a rolling horizon, so quotes do not collapse
+// towards a session end); sigma^2 and kappa come from the estimator. Quotes are kept at or behind the touch and at least MIN_SPREAD_TICKS
+// apart. Until the estimator is warm it quotes like MarketMakingStrategy.
+// One instance per symbol: the estimator state belongs to that symbol's book.
+class AvellanedaStoikovStrategy : public Strategy<AvellanedaStoikovStrategy> {
+public:
+    const MarketEstimator& estimator() const { return estimator_; }
+
+private:
+    friend class Strategy<AvellanedaStoikovStrategy>;
+    // New BBO (book_tsc): updates the estimator, then quotes.
+    HFTSignal on_book(const StrategyInput& input);
+    HFTSignal quote(const StrategyInput& input) const;
+
+    MarketEstimator estimator_;
+    MarketMakingStrategy fallback_;
+};
+
+inline HFTSignal AvellanedaStoikovStrategy::on_book(const StrategyInput& input) {
+    estimator_.update(input.bid, input.ask, input.book_tsc, input.config->as_half_life_seconds);
+    return quote(input);
+}
+
+inline HFTSignal AvellanedaStoikovStrategy::quote(const StrategyInput& input) const {
+    const double bid = input.bid;
+    const double ask = input.ask;
+    const double current_position = input.position;
+    const double order_size = input.order_size;
+    if (!estimator_.warm() || order_size <= 0.0) {
+        return fallback_.requote(input);
+    }
+    const ConfigSnapshot& config = *input.config;
+    HFTSignal signal{};
+    signal.num_levels = config.order_ladder_levels;
+
+    const double gamma = config.as_risk_aversion;
+    const double inventory_risk = gamma * estimator_.variance_rate() * config.as_horizon_seconds;
+    const double kappa = estimator_.kappa();
+    const double lots = current_position / order_size;
+
+    const double reservation = input.fair_value - lots * inventory_risk;
+    double spread = inventory_risk;
+    if (kappa > 0.0) spread += (2.0 / gamma) * std::log1p(gamma / kappa);
+    spread = std::max(spread, config.min_spread);
+
+    // Post-only: never through the touch.
+    signal.bid_price = std::min(reservation - spread * 0.5, bid);
+    signal.ask_price = std::max(reservation + spread * 0.5, ask);
+    signal.place_bid = signal.bid_price > 0.0;
+    signal.place_ask = true;
+
+    // Size down the side that adds to the position as it approaches INVENTORY_CEILING.
+    const double penalty = 1.0 - std::min(0.8, std::abs(current_position) / config.inventory_ceiling);
+    signal.bid_quantity = current_position > 0.0 ? order_size * penalty : order_size;
+    signal.ask_quantity = current_position < 0.0 ? order_size * penalty : order_size;
+
+    return signal;
+}
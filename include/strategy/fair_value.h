@@ -0,0 +1,41 @@
+#pragma once
+
+#include "data/market_data.h"
+#include <array>
+#include <cstddef>
+
+// Fair value of one symbol from its depth snapshot:
+//   microprice  (bid * ask_qty + ask * bid_qty) / (bid_qty + ask_qty) at the top level
+//   imbalance   sum w_i (bid_qty_i - ask_qty_i) / sum w_i (bid_qty_i + ask_qty_i), in [-1, 1]
+//   pressure    the microprice formula summed over levels with weights w_i = decay^i
+// over the levels both sides have. value() blends the microprice and the pressure price
+// (FAIR_VALUE_DEPTH_WEIGHT) and scales the result's offset from the mid (FAIR_VALUE_SKEW).
+// One instance per symbol, updated on the thread that trades it.
+class FairValue {
+public:
+    static constexpr size_t kLevels = DepthSnapshot::kLevels;
+
+    // New book state; returns the fair value. Ticks without depth fall back to the mid.
+    double update(const HFTMarketData& market_data);
+
+    // The last fair value carried onto a BBO seen since (timer requotes): mid + offset().
+    double center(double bid, double ask) const { return (bid + ask) * 0.5 + offset_; }
+
+    double value() const { return value_; }
+    double offset() const { return offset_; }
+    double microprice() const { return microprice_; }
+    double imbalance() const { return imbalance_; }
+    double pressure() const { return pressure_; }
+
+private:
+    void rebuildWeights(double decay);
+
+    alignas(16) std::array<double, kLevels> weights_{};
+    double weights_decay_ = -1.0;
+
+    double value_ = 0.0;
+    double offset_ = 0.0;
+    double microprice_ = 0.0;
+    double imbalance_ = 0.0;
+    double pressure_ = 0.0;
+};
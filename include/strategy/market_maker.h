@@ -1,29 +1,63 @@
 #pragma once
 
-#include <cstdint>
-
-struct HFTSignal {
-    bool place_bid = false;
-    bool place_ask = false;
-    double bid_price = 0.0;
-    double ask_price = 0.0;
-    double bid_quantity = 0.0;
-    double ask_quantity = 0.0;
-    uint32_t num_levels = 0;
+#include "strategy/strategy.h"
+#include <algorithm>
+#include <cmath>
+
+// Quotes are offset from the BBO and shifted by the fair value's distance from the mid, but
+// never through the touch; the inventory skew steps in past MAX_NEUTRAL_POSITION. Stateless.
+// Defined here so the engine loops instantiated for it inline the whole quote.
+class MarketMakingStrategy : public Strategy<MarketMakingStrategy> {
+private:
+    friend class Strategy<MarketMakingStrategy>;
+    HFTSignal quote(const StrategyInput& input) const;
 };
 
-class MarketMakingStrategy {
-public:
-    MarketMakingStrategy();
+inline HFTSignal MarketMakingStrategy::quote(const StrategyInput& input) const {
+    const ConfigSnapshot& config = *input.config;
+    const double bid = input.bid;
+    const double ask = input.ask;
+    const double fair_value = input.fair_value;
+    const double current_position = input.position;
+    const double order_size = input.order_size;
+    HFTSignal signal{};
 
-    HFTSignal generate_signal(double bid, double ask,
-                              double current_position, double order_size) const;
+    signal.place_bid = true;
+    signal.place_ask = true;
+    signal.num_levels = config.order_ladder_levels;
 
-private:
-    double tick_size_;
-    double spread_offset_;
-    double min_spread_;
-    double max_neutral_pos_;
-    double inventory_ceiling_;
-    uint32_t num_levels_;
-};
+    const double shift = fair_value - (bid + ask) / 2.0;
+    signal.bid_price = bid - config.spread_offset + shift;
+    signal.ask_price = ask + config.spread_offset + shift;
+
+    if ((signal.ask_price - signal.bid_price) < config.min_spread) {
+        signal.bid_price = fair_value - (config.min_spread / 2.0);
+        signal.ask_price = fair_value + (config.min_spread / 2.0);
+    }
+
+    signal.bid_quantity = order_size;
+    signal.ask_quantity = order_size;
+
+    if (std::abs(current_position) > config.max_neutral_position) {
+        if (current_position > config.max_neutral_position) {
+            signal.bid_quantity *= 0.5;
+            signal.ask_quantity *= 1.5;
+            signal.ask_price = ask + (config.tick_size * 1.5) + shift;
+        } else {
+            signal.ask_quantity *= 0.5;
+            signal.bid_quantity *= 1.5;
+            signal.bid_price = bid - (config.tick_size * 1.5) + shift;
+        }
+    }
+    // Post-only: the fair value shift never takes a quote through the touch.
+    signal.bid_price = std::min(signal.bid_price, bid);
+    signal.ask_price = std::max(signal.ask_price, ask);
+
+    double inventory_penalty = std::min(0.8, std::abs(current_position) / config.inventory_ceiling);
+    if (inventory_penalty > 0.2) {
+        signal.bid_quantity *= (1.0 - inventory_penalty);
+        signal.ask_quantity *= (1.0 - inventory_penalty);
+    }
+
+    return signal;
+}
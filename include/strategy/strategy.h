@@ -0,0 +1,78 @@
+#pragma once
+
+#include "core/config.h"
+#include "core/config_snapshot.h"
+#include <cstdint>
+
+struct HFTSignal {
+    bool place_bid = false;
+    bool place_ask = false;
+    double bid_price = 0.0;
+    double ask_price = 0.0;
+    double bid_quantity = 0.0;
+    double ask_quantity = 0.0;
+    uint32_t num_levels = 0;
+};
+
+// Everything a strategy sees for one quote, by value: book view, position and parameters.
+struct StrategyInput {
+    double bid = 0.0;
+    double ask = 0.0;
+    double fair_value = 0.0;  // what to center on; the mid when there is no depth
+    double position = 0.0;
+    double order_size = 0.0;
+    uint64_t book_tsc = 0;    // when the book changed (FastClock); unused by requotes
+    const ConfigSnapshot* config = nullptr;  // loaded once by the caller for the whole tick
+};
+
+// CRTP strategy interface. Engine loops are templates over the concrete strategy, so both
+// calls below resolve at compile time and inline into the tick path: no vtable, and no
+// branch on the strategy kind per tick. A strategy derives from Strategy<Self>, befriends
+// it, and provides
+//   HFTSignal quote(const StrategyInput&) const    quotes for the given book and position
+//   HFTSignal on_book(const StrategyInput&)        optional: learn from a new book, then quote
+template<typename Derived>
+class Strategy {
+public:
+    // A new book state.
+    HFTSignal on_tick(const StrategyInput& input) { return self().on_book(input); }
+    // Requote (timer) without a new book; strategy state is left alone.
+    HFTSignal requote(const StrategyInput& input) const { return self().quote(input); }
+
+    // Convenience for tests and tools: fills the input from the current config snapshot.
+    HFTSignal generate_signal(double bid, double ask, double fair_value,
+                              double current_position, double order_size) const {
+        return requote(make_input(bid, ask, fair_value, 0, current_position, order_size));
+    }
+    HFTSignal generate_signal(double bid, double ask, double current_position, double order_size) const {
+        return generate_signal(bid, ask, (bid + ask) * 0.5, current_position, order_size);
+    }
+    HFTSignal on_tick(double bid, double ask, double fair_value, uint64_t tsc,
+                      double current_position, double order_size) {
+        return on_tick(make_input(bid, ask, fair_value, tsc, current_position, order_size));
+    }
+    HFTSignal on_tick(double bid, double ask, uint64_t tsc, double current_position, double order_size) {
+        return on_tick(bid, ask, (bid + ask) * 0.5, tsc, current_position, order_size);
+    }
+
+    static StrategyInput make_input(double bid, double ask, double fair_value, uint64_t tsc,
+                                    double current_position, double order_size) {
+        StrategyInput input;
+        input.bid = bid;
+        input.ask = ask;
+        input.fair_value = fair_value;
+        input.position = current_position;
+        input.order_size = order_size;
+        input.book_tsc = tsc;
+        input.config = Config::snapshot();
+        return input;
+    }
+
+protected:
+    // Default for strategies without state: a new book is just a quote.
+    HFTSignal on_book(const StrategyInput& input) { return self().quote(input); }
+
+private:
+    Derived& self() { return static_cast<Derived&>(*this); }
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
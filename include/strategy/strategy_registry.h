@@ -0,0 +1,50 @@
+#pragma once
+
+#include "strategy/avellaneda_stoikov.h"
+#include "strategy/market_maker.h"
+#include <cstdint>
+#include <string>
+#include <variant>
+
+// STRATEGY in config.txt; read once at startup. Values index StrategyVariant.
+enum class StrategyKind : uint8_t {
+    FIXED_SPREAD,       // MarketMakingStrategy
+    AVELLANEDA_STOIKOV  // AvellanedaStoikovStrategy
+};
+
+template<typename... Strategies>
+struct StrategyList {
+    using Variant = std::variant<Strategies...>;
+    // The same alternatives, each wrapped, e.g. VariantOf<std::vector> for one per symbol.
+    template<template<typename...> class Container>
+    using VariantOf = std::variant<Container<Strategies>...>;
+};
+
+// Every strategy an engine can run, in StrategyKind order. Engines keep theirs in one of
+// these variants and std::visit it once, at thread start, into a loop instantiated for that
+// type.
+using RegisteredStrategies = StrategyList<MarketMakingStrategy, AvellanedaStoikovStrategy>;
+using StrategyVariant = RegisteredStrategies::Variant;
+
+template<typename T>
+struct StrategyTag {
+    using type = T;
+};
+
+const char* to_string(StrategyKind kind);
+// "fixed_spread", "avellaneda_stoikov"
+bool parseStrategyKind(const std::string& text, StrategyKind& kind);
+
+// fn(StrategyTag<T>{}) for the strategy type registered under `kind`.
+template<typename Fn>
+decltype(auto) withStrategyType(StrategyKind kind, Fn&& fn) {
+    switch (kind) {
+        case StrategyKind::AVELLANEDA_STOIKOV: return fn(StrategyTag<AvellanedaStoikovStrategy>{});
+        case StrategyKind::FIXED_SPREAD:       break;
+    }
+    return fn(StrategyTag<MarketMakingStrategy>{});
+}
+
+inline StrategyVariant makeStrategy(StrategyKind kind) {
+    return withStrategyType(kind, [](auto tag) -> StrategyVariant { return typename decltype(tag)::type{}; });
+}
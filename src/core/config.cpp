@@ -3,18 +3,48 @@
 #include <iostream>
 #include <algorithm>
 #include <cctype>
+#include <sys/stat.h>
 
 Config& Config::getInstance() {
     static Config instance;
     return instance;
 }
 
+Config::~Config() {
+    stopWatcher();
+}
+
+const ConfigSnapshot& Config::defaults() {
+    // Built from no keys so the derived tables (ladder shape) are filled in too.
+    static const ConfigSnapshot instance = [] {
+        ConfigSnapshot snapshot;
+        std::string error;
+        ConfigSnapshot::build({}, snapshot, error);
+        return snapshot;
+    }();
+    return instance;
+}
+
 bool Config::loadFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, std::string> values = config_map_;
+    if (!readFile(filename, values)) {
         std::cerr << "Could not open config file: " << filename << std::endl;
         return false;
     }
+    if (std::find(files_.begin(), files_.end(), filename) == files_.end()) files_.push_back(filename);
+
+    std::string error;
+    if (!publish(std::move(values), error)) {
+        std::cerr << "Invalid config in " << filename << ": " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool Config::readFile(const std::string& filename, std::map<std::string, std::string>& values) {
+    std::ifstream file(filename);
+    if (!file.is_open()) return false;
 
     std::string line;
     while (std::getline(file, line)) {
@@ -29,13 +59,95 @@ bool Config::loadFromFile(const std::string& filename) {
             std::string value = line.substr(pos + 1);
             trim(key);
             trim(value);
-            config_map_[key] = value;
+            values[key] = value;
         }
     }
+    return true;
+}
+
+bool Config::publish(std::map<std::string, std::string> values, std::string& error) {
+    auto snapshot = std::make_unique<ConfigSnapshot>();
+    if (!ConfigSnapshot::build(values, *snapshot, error)) return false;
 
+    snapshot->version = snapshots_.size() + 1;
+    config_map_ = std::move(values);
+    snapshot_.store(snapshot.get(), std::memory_order_release);
+    // Kept for the life of the process: readers may still hold older snapshots.
+    snapshots_.push_back(std::move(snapshot));
     return true;
 }
 
+bool Config::reload(std::string& error) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::map<std::string, std::string> values;
+    for (const auto& file : files_) {
+        if (!readFile(file, values)) {
+            error = "could not open " + file;
+            return false;
+        }
+    }
+    return publish(std::move(values), error);
+}
+
+void Config::requestReload() {
+    reload_requested_.store(true);
+    reload_wake_.notify();
+}
+
+void Config::startWatcher(std::chrono::milliseconds poll_interval) {
+    if (watcher_running_.exchange(true)) return;
+    watcher_thread_ = std::thread(&Config::watcherLoop, this, poll_interval);
+}
+
+void Config::stopWatcher() {
+    if (!watcher_running_.exchange(false)) return;
+    reload_wake_.notify();
+    if (watcher_thread_.joinable()) watcher_thread_.join();
+}
+
+void Config::watcherLoop(std::chrono::milliseconds poll_interval) {
+    // mtime + size per file; an editor that replaces the file also changes it.
+    const auto stamp = [this] {
+        std::string result;
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& file : files_) {
+            struct stat info{};
+            if (stat(file.c_str(), &info) == 0) {
+#if defined(__APPLE__)
+                const struct timespec& mtime = info.st_mtimespec;
+#else
+                const struct timespec& mtime = info.st_mtim;
+#endif
+                result += std::to_string(mtime.tv_sec) + "." + std::to_string(mtime.tv_nsec) +
+                          ":" + std::to_string(info.st_size) + ";";
+            } else {
+                result += "missing;";
+            }
+        }
+        return result;
+    };
+
+    std::string last_stamp = stamp();
+    uint32_t wake_epoch = reload_wake_.epoch();
+    while (watcher_running_.load()) {
+        reload_wake_.wait(wake_epoch, poll_interval);
+        wake_epoch = reload_wake_.epoch();
+        if (!watcher_running_.load()) break;
+
+        const std::string current_stamp = stamp();
+        const bool requested = reload_requested_.exchange(false);
+        if (!requested && current_stamp == last_stamp) continue;
+        last_stamp = current_stamp;
+
+        std::string error;
+        if (reload(error)) {
+            std::cout << "Config reloaded (snapshot v" << snapshot()->version << ")" << std::endl;
+        } else {
+            std::cerr << "Config reload rejected, keeping v" << snapshot()->version << ": " << error << std::endl;
+        }
+    }
+}
+
 std::string Config::getCoinbaseApiKey() const {
     return getString("COINBASE_API_KEY");
 }
@@ -48,6 +160,14 @@ std::string Config::getCoinbaseWsUrl() const {
     return getString("COINBASE_WS_URL", "wss://advanced-trade-ws.coinbase.com");
 }
 
+std::string Config::getOrderGateway() const {
+    return getString("ORDER_GATEWAY", "sim");
+}
+
+std::string Config::getOrderGatewayUrl() const {
+    return getString("ORDER_GATEWAY_URL", "https://api.coinbase.com");
+}
+
 double Config::getOrderSize() const {
     return getDouble("ORDER_SIZE", 0.01);
 }
@@ -88,16 +208,91 @@ int Config::getOrderEngineHz() const {
     return getInt("ORDER_ENGINE_HZ", 2000);
 }
 
+std::string Config::getEngineMode() const {
+    return getString("ENGINE_MODE", "pipeline");
+}
+
+int Config::getEngineShards() const {
+    return getInt("ENGINE_SHARDS", 2);
+}
+
+std::string Config::getStrategy() const {
+    return getString("STRATEGY", "fixed_spread");
+}
+
+std::string Config::getOrderEngineIdle() const {
+    return getString("ORDER_ENGINE_IDLE", "spin_yield");
+}
+
+std::vector<std::string> Config::getTradingSymbols() const {
+    std::vector<std::string> symbols;
+    std::string list = getString("TRADING_SYMBOLS", getString("TRADING_SYMBOL", "ETH-USD"));
+    size_t start = 0;
+    while (start <= list.size()) {
+        size_t end = list.find(',', start);
+        if (end == std::string::npos) end = list.size();
+        std::string symbol = list.substr(start, end - start);
+        trim(symbol);
+        if (!symbol.empty() && std::find(symbols.begin(), symbols.end(), symbol) == symbols.end()) {
+            symbols.push_back(symbol);
+        }
+        start = end + 1;
+    }
+    return symbols;
+}
+
+int Config::getLogMaxFileMb() const {
+    return getInt("LOG_MAX_FILE_MB", 256);
+}
+
+int Config::getLogRotateHours() const {
+    return getInt("LOG_ROTATE_HOURS", 24);
+}
+
+bool Config::getLogCompress() const {
+    return getInt("LOG_COMPRESS", 1) != 0;
+}
+
+int Config::getLogRetainSegments() const {
+    return getInt("LOG_RETAIN_SEGMENTS", 14);
+}
+
+int Config::getMetricsHttpPort() const {
+    return getInt("METRICS_HTTP_PORT", 9464);
+}
+
+std::string Config::getMetricsHttpBind() const {
+    return getString("METRICS_HTTP_BIND", "127.0.0.1");
+}
+
+std::string Config::getMetricsShmName() const {
+    return getString("METRICS_SHM_NAME", "");
+}
+
+int Config::getFlightRecorderEvents() const {
+    return getInt("FLIGHT_RECORDER_EVENTS", 262144);
+}
+
+int Config::getFlightRecorderWindowSeconds() const {
+    return getInt("FLIGHT_RECORDER_WINDOW_S", 30);
+}
+
+std::string Config::getFlightRecorderDir() const {
+    return getString("FLIGHT_RECORDER_DIR", "logs");
+}
+
 std::string Config::getConfig(const std::string& key, const std::string& default_val) const {
     return getString(key, default_val);
 }
 
 std::string Config::getString(const std::string& key, const std::string& default_val) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = config_map_.find(key);
     return (it != config_map_.end()) ? it->second : default_val;
 }
 
 double Config::getDouble(const std::string& key, double default_val) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = config_map_.find(key);
     if (it != config_map_.end()) {
         try {
@@ -110,6 +305,7 @@ double Config::getDouble(const std::string& key, double default_val) const {
 }
 
 int Config::getInt(const std::string& key, int default_val) const {
+    std::lock_guard<std::mutex> lock(mutex_);
     auto it = config_map_.find(key);
     if (it != config_map_.end()) {
         try {
@@ -0,0 +1,214 @@
+#include "core/config_snapshot.h"
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+// Missing keys keep the default; present ones must parse completely and be finite.
+bool readNumber(const std::map<std::string, std::string>& values, const char* key, double& out,
+                std::string& error) {
+    auto it = values.find(key);
+    if (it == values.end()) return true;
+    const char* text = it->second.c_str();
+    char* end = nullptr;
+    errno = 0;
+    const double value = std::strtod(text, &end);
+    if (end == text || *end != '\0' || errno == ERANGE || !std::isfinite(value)) {
+        error = std::string(key) + ": '" + it->second + "' is not a number";
+        return false;
+    }
+    out = value;
+    return true;
+}
+
+bool check(bool ok, const char* key, const char* requirement, std::string& error) {
+    if (!ok) error = std::string(key) + " must be " + requirement;
+    return ok;
+}
+
+// Comma-separated numbers, e.g. "0,1,3,6"; at most kMaxLadderLevels of them.
+bool readList(const std::map<std::string, std::string>& values, const char* key, std::vector<double>& out,
+              std::string& error) {
+    auto it = values.find(key);
+    if (it == values.end()) return true;
+    out.clear();
+    const std::string& text = it->second;
+    size_t start = 0;
+    while (start <= text.size()) {
+        const size_t comma = std::min(text.find(',', start), text.size());
+        const std::string item = text.substr(start, comma - start);
+        const char* begin = item.c_str();
+        char* end = nullptr;
+        errno = 0;
+        const double value = std::strtod(begin, &end);
+        while (end && (*end == ' ' || *end == '\t')) ++end;
+        if (end == begin || *end != '\0' || errno == ERANGE || !std::isfinite(value) ||
+            out.size() == ConfigSnapshot::kMaxLadderLevels) {
+            error = std::string(key) + ": '" + text + "' is not a list of up to 64 numbers";
+            return false;
+        }
+        out.push_back(value);
+        start = comma + 1;
+    }
+    return true;
+}
+
+template<typename Enum, size_t N>
+bool readChoice(const std::map<std::string, std::string>& values, const char* key,
+                const std::pair<const char*, Enum> (&choices)[N], Enum& out, std::string& error) {
+    auto it = values.find(key);
+    if (it == values.end()) return true;
+    std::string allowed;
+    for (const auto& choice : choices) {
+        if (it->second == choice.first) {
+            out = choice.second;
+            return true;
+        }
+        allowed += allowed.empty() ? choice.first : std::string(", ") + choice.first;
+    }
+    error = std::string(key) + " must be one of " + allowed;
+    return false;
+}
+
+constexpr std::pair<const char*, LadderSpacing> kLadderSpacings[] = {
+    {"linear", LadderSpacing::LINEAR}, {"geometric", LadderSpacing::GEOMETRIC}, {"list", LadderSpacing::LIST}};
+constexpr std::pair<const char*, LadderSizeCurve> kLadderSizeCurves[] = {
+    {"linear", LadderSizeCurve::LINEAR}, {"exponential", LadderSizeCurve::EXPONENTIAL},
+    {"list", LadderSizeCurve::LIST}};
+
+// Level i's distance from the quote in ticks, before snapping.
+double rawOffsetTicks(LadderSpacing spacing, size_t level, double step, double growth,
+                      const std::vector<double>& offsets) {
+    switch (spacing) {
+        case LadderSpacing::GEOMETRIC:
+            return growth == 1.0 ? level * step : step * (std::pow(growth, level) - 1.0) / (growth - 1.0);
+        case LadderSpacing::LIST: {
+            const size_t last = offsets.size() - 1;
+            if (level <= last) return offsets[level];
+            const double gap = last > 0 ? offsets[last] - offsets[last - 1] : step;
+            return offsets[last] + (level - last) * gap;
+        }
+        case LadderSpacing::LINEAR:
+            break;
+    }
+    return level * step;
+}
+
+}  // namespace
+
+bool ConfigSnapshot::build(const std::map<std::string, std::string>& values, ConfigSnapshot& snapshot,
+                           std::string& error) {
+    ConfigSnapshot result;
+    double spread_offset_ticks = 0.25;
+    double min_spread_ticks = 0.5;
+    double ladder_levels = result.order_ladder_levels;
+    double rate_limit = static_cast<double>(result.order_rate_limit);
+    double ladder_step_ticks = 1.0;
+    double ladder_step_growth = 1.5;
+    double ladder_size_step = 0.1;
+    double ladder_size_decay = 0.8;
+    double ladder_size_floor = 0.1;
+    std::vector<double> ladder_offsets_ticks;
+    std::vector<double> ladder_sizes;
+
+    if (!readNumber(values, "ORDER_SIZE", result.order_size, error) ||
+        !readNumber(values, "MAX_INVENTORY", result.max_inventory, error) ||
+        !readNumber(values, "TICK_SIZE", result.tick_size, error) ||
+        !readNumber(values, "SPREAD_OFFSET_TICKS", spread_offset_ticks, error) ||
+        !readNumber(values, "MIN_SPREAD_TICKS", min_spread_ticks, error) ||
+        !readNumber(values, "MAX_NEUTRAL_POSITION", result.max_neutral_position, error) ||
+        !readNumber(values, "INVENTORY_CEILING", result.inventory_ceiling, error) ||
+        !readNumber(values, "ORDER_LADDER_LEVELS", ladder_levels, error) ||
+        !readNumber(values, "ORDER_RATE_LIMIT", rate_limit, error) ||
+        !readNumber(values, "FAIR_VALUE_LEVEL_DECAY", result.fair_value_level_decay, error) ||
+        !readNumber(values, "FAIR_VALUE_DEPTH_WEIGHT", result.fair_value_depth_weight, error) ||
+        !readNumber(values, "FAIR_VALUE_SKEW", result.fair_value_skew, error) ||
+        !readNumber(values, "AS_RISK_AVERSION", result.as_risk_aversion, error) ||
+        !readNumber(values, "AS_HORIZON_SECONDS", result.as_horizon_seconds, error) ||
+        !readNumber(values, "AS_HALF_LIFE_SECONDS", result.as_half_life_seconds, error) ||
+        !readNumber(values, "MAX_DAILY_LOSS_LIMIT", result.max_daily_loss, error) ||
+        !readNumber(values, "MAX_DRAWDOWN_LIMIT", result.max_drawdown, error) ||
+        !readNumber(values, "MAX_GROSS_NOTIONAL", result.max_gross_notional, error) ||
+        !readNumber(values, "MAX_NET_NOTIONAL", result.max_net_notional, error) ||
+        !readChoice(values, "LADDER_SPACING", kLadderSpacings, result.ladder_spacing, error) ||
+        !readNumber(values, "LADDER_STEP_TICKS", ladder_step_ticks, error) ||
+        !readNumber(values, "LADDER_STEP_GROWTH", ladder_step_growth, error) ||
+        !readList(values, "LADDER_OFFSETS_TICKS", ladder_offsets_ticks, error) ||
+        !readChoice(values, "LADDER_SIZE_CURVE", kLadderSizeCurves, result.ladder_size_curve, error) ||
+        !readNumber(values, "LADDER_SIZE_STEP", ladder_size_step, error) ||
+        !readNumber(values, "LADDER_SIZE_DECAY", ladder_size_decay, error) ||
+        !readNumber(values, "LADDER_SIZE_FLOOR", ladder_size_floor, error) ||
+        !readList(values, "LADDER_SIZES", ladder_sizes, error)) {
+        return false;
+    }
+
+    if (!check(result.order_size > 0.0, "ORDER_SIZE", "positive", error) ||
+        !check(result.max_inventory > 0.0, "MAX_INVENTORY", "positive", error) ||
+        !check(result.tick_size > 0.0, "TICK_SIZE", "positive", error) ||
+        !check(spread_offset_ticks >= 0.0, "SPREAD_OFFSET_TICKS", "zero or more", error) ||
+        !check(min_spread_ticks >= 0.0, "MIN_SPREAD_TICKS", "zero or more", error) ||
+        !check(result.max_neutral_position >= 0.0, "MAX_NEUTRAL_POSITION", "zero or more", error) ||
+        !check(result.inventory_ceiling > 0.0, "INVENTORY_CEILING", "positive", error) ||
+        !check(ladder_levels >= 1.0 && ladder_levels <= 64.0 && ladder_levels == std::floor(ladder_levels),
+               "ORDER_LADDER_LEVELS", "a whole number from 1 to 64", error) ||
+        !check(rate_limit >= 1.0 && rate_limit == std::floor(rate_limit), "ORDER_RATE_LIMIT",
+               "a whole number of at least 1", error) ||
+        !check(result.fair_value_level_decay > 0.0 && result.fair_value_level_decay <= 1.0,
+               "FAIR_VALUE_LEVEL_DECAY", "in (0, 1]", error) ||
+        !check(result.fair_value_depth_weight >= 0.0 && result.fair_value_depth_weight <= 1.0,
+               "FAIR_VALUE_DEPTH_WEIGHT", "in [0, 1]", error) ||
+        !check(result.fair_value_skew >= 0.0 && result.fair_value_skew <= 1.0, "FAIR_VALUE_SKEW", "in [0, 1]", error) ||
+        !check(result.as_risk_aversion > 0.0, "AS_RISK_AVERSION", "positive", error) ||
+        !check(result.as_horizon_seconds >= 0.0, "AS_HORIZON_SECONDS", "zero or more", error) ||
+        !check(result.as_half_life_seconds > 0.0, "AS_HALF_LIFE_SECONDS", "positive", error) ||
+        !check(ladder_step_ticks > 0.0, "LADDER_STEP_TICKS", "positive", error) ||
+        !check(ladder_step_growth >= 1.0 && ladder_step_growth <= 10.0, "LADDER_STEP_GROWTH", "from 1 to 10", error) ||
+        !check(result.ladder_spacing != LadderSpacing::LIST || !ladder_offsets_ticks.empty(),
+               "LADDER_OFFSETS_TICKS", "set when LADDER_SPACING=list", error) ||
+        !check(std::all_of(ladder_offsets_ticks.begin(), ladder_offsets_ticks.end(), [](double v) { return v >= 0.0; }) &&
+               std::is_sorted(ladder_offsets_ticks.begin(), ladder_offsets_ticks.end()),
+               "LADDER_OFFSETS_TICKS", "zero or more and increasing", error) ||
+        !check(ladder_size_step >= 0.0 && ladder_size_step <= 1.0, "LADDER_SIZE_STEP", "in [0, 1]", error) ||
+        !check(ladder_size_decay > 0.0 && ladder_size_decay <= 1.0, "LADDER_SIZE_DECAY", "in (0, 1]", error) ||
+        !check(ladder_size_floor >= 0.0 && ladder_size_floor <= 1.0, "LADDER_SIZE_FLOOR", "in [0, 1]", error) ||
+        !check(result.ladder_size_curve != LadderSizeCurve::LIST || !ladder_sizes.empty(),
+               "LADDER_SIZES", "set when LADDER_SIZE_CURVE=list", error) ||
+        !check(std::all_of(ladder_sizes.begin(), ladder_sizes.end(), [](double v) { return v > 0.0; }),
+               "LADDER_SIZES", "positive", error)) {
+        return false;
+    }
+
+    result.spread_offset = spread_offset_ticks * result.tick_size;
+    result.min_spread = min_spread_ticks * result.tick_size;
+    result.order_ladder_levels = static_cast<uint32_t>(ladder_levels);
+    result.order_rate_limit = static_cast<uint64_t>(rate_limit);
+    result.max_daily_loss = std::abs(result.max_daily_loss);
+    result.max_drawdown = std::abs(result.max_drawdown);
+    result.max_gross_notional = std::abs(result.max_gross_notional);
+    result.max_net_notional = std::abs(result.max_net_notional);
+
+    // Offsets are rounded to whole ticks; a level that would land on the previous one's price
+    // moves out a tick, so every level is a distinct, valid price.
+    double previous_ticks = -1.0;
+    for (size_t level = 0; level < kMaxLadderLevels; ++level) {
+        double ticks = std::round(rawOffsetTicks(result.ladder_spacing, level, ladder_step_ticks,
+                                                 ladder_step_growth, ladder_offsets_ticks));
+        ticks = std::max(ticks, previous_ticks + 1.0);
+        result.ladder_offset[level] = ticks * result.tick_size;
+        previous_ticks = ticks;
+
+        double size = 1.0 - level * ladder_size_step;
+        if (result.ladder_size_curve == LadderSizeCurve::EXPONENTIAL) {
+            size = std::pow(ladder_size_decay, static_cast<double>(level));
+        } else if (result.ladder_size_curve == LadderSizeCurve::LIST) {
+            size = ladder_sizes[std::min(level, ladder_sizes.size() - 1)];
+        }
+        result.ladder_size_factor[level] = std::max(ladder_size_floor, size);
+    }
+
+    snapshot = result;
+    return true;
+}
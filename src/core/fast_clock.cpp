@@ -0,0 +1,176 @@
+#include "core/fast_clock.h"
+#include <iostream>
+#include <time.h>
+#if defined(__x86_64__) || defined(_M_X64)
+#  include <cpuid.h>
+#endif
+
+namespace {
+
+struct Sample {
+    uint64_t ticks;
+    uint64_t mono_ns;
+};
+
+// Brackets a CLOCK_MONOTONIC read with two tick reads and keeps the tightest of a few tries.
+template<typename ReadMono>
+Sample take_sample(ReadMono read_mono) {
+    Sample best{0, 0};
+    uint64_t best_width = UINT64_MAX;
+    for (int i = 0; i < 5; ++i) {
+        uint64_t before = FastClock::now();
+        uint64_t mono = read_mono();
+        uint64_t after = FastClock::now();
+        if (after - before < best_width) {
+            best_width = after - before;
+            best = {before + (after - before) / 2, mono};
+        }
+    }
+    return best;
+}
+
+}  // namespace
+
+FastClock& FastClock::getInstance() {
+    static FastClock instance;
+    return instance;
+}
+
+FastClock::FastClock() {
+    Sample first = take_sample(steadyNanos);
+    anchor_ticks_ = first.ticks;
+    anchor_mono_ns_ = first.mono_ns;
+
+    Calibration calibration;
+    if (use_tsc_) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        Sample second = take_sample(steadyNanos);
+        if (second.ticks > first.ticks) {
+            calibration.ns_per_tick = static_cast<double>(second.mono_ns - first.mono_ns) /
+                                      static_cast<double>(second.ticks - first.ticks);
+        }
+        first = second;
+    } else {
+        std::cout << "FastClock: invariant TSC not available, using steady_clock" << std::endl;
+    }
+    calibration.ticks = first.ticks;
+    calibration.mono_ns = first.mono_ns;
+    calibration.wall_ns = wallNanos();
+    publish(calibration);
+}
+
+FastClock::~FastClock() {
+    stop();
+}
+
+bool FastClock::detectInvariantTsc() {
+#if defined(__x86_64__) || defined(_M_X64)
+    unsigned int eax = 0, ebx = 0, ecx = 0, edx = 0;
+    if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) == 0 || eax < 0x80000007) return false;
+    __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx);
+    return (edx & (1u << 8)) != 0;  // CPUID.80000007H:EDX[8] = invariant TSC
+#elif defined(__aarch64__) || defined(__arm64__)
+    return true;  // the generic timer runs at a fixed frequency
+#else
+    return false;
+#endif
+}
+
+uint64_t FastClock::steadyNanos() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+uint64_t FastClock::wallNanos() {
+    struct timespec ts{};
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+FastClock::Calibration FastClock::load() const {
+    Calibration calibration;
+    uint64_t seq_before, seq_after;
+    do {
+        seq_before = sequence_.load(std::memory_order_acquire);
+        calibration.ticks = ticks_.load(std::memory_order_relaxed);
+        calibration.mono_ns = mono_ns_.load(std::memory_order_relaxed);
+        calibration.wall_ns = wall_ns_.load(std::memory_order_relaxed);
+        calibration.ns_per_tick = ns_per_tick_.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        seq_after = sequence_.load(std::memory_order_relaxed);
+    } while ((seq_before & 1) || seq_before != seq_after);
+    return calibration;
+}
+
+void FastClock::publish(const Calibration& calibration) {
+    uint64_t seq = sequence_.load(std::memory_order_relaxed);
+    sequence_.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    ticks_.store(calibration.ticks, std::memory_order_relaxed);
+    mono_ns_.store(calibration.mono_ns, std::memory_order_relaxed);
+    wall_ns_.store(calibration.wall_ns, std::memory_order_relaxed);
+    ns_per_tick_.store(calibration.ns_per_tick, std::memory_order_relaxed);
+    sequence_.store(seq + 2, std::memory_order_release);
+}
+
+uint64_t FastClock::ticksToNanos(uint64_t ticks) const {
+    if (!use_tsc_) return ticks;
+    return static_cast<uint64_t>(static_cast<double>(ticks) * nanosPerTick());
+}
+
+uint64_t FastClock::nanosToTicks(uint64_t nanos) const {
+    if (!use_tsc_) return nanos;
+    return static_cast<uint64_t>(static_cast<double>(nanos) / nanosPerTick());
+}
+
+double FastClock::nanosPerTick() const {
+    return ns_per_tick_.load(std::memory_order_relaxed);
+}
+
+uint64_t FastClock::toMonotonicNanos(uint64_t ticks) const {
+    if (!use_tsc_) return ticks;
+    Calibration c = load();
+    auto delta = static_cast<double>(static_cast<int64_t>(ticks - c.ticks)) * c.ns_per_tick;
+    return static_cast<uint64_t>(static_cast<int64_t>(c.mono_ns) + static_cast<int64_t>(delta));
+}
+
+uint64_t FastClock::toWallNanos(uint64_t ticks) const {
+    Calibration c = load();
+    auto delta = static_cast<double>(static_cast<int64_t>(ticks - c.ticks)) * c.ns_per_tick;
+    return static_cast<uint64_t>(static_cast<int64_t>(c.wall_ns) + static_cast<int64_t>(delta));
+}
+
+void FastClock::recalibrate() {
+    Sample sample = take_sample(steadyNanos);
+    Calibration calibration = load();
+    if (use_tsc_ && sample.ticks > anchor_ticks_ && sample.mono_ns > anchor_mono_ns_) {
+        calibration.ns_per_tick = static_cast<double>(sample.mono_ns - anchor_mono_ns_) /
+                                  static_cast<double>(sample.ticks - anchor_ticks_);
+    }
+    calibration.ticks = sample.ticks;
+    calibration.mono_ns = sample.mono_ns;
+    calibration.wall_ns = wallNanos();
+    publish(calibration);
+}
+
+void FastClock::start(std::chrono::milliseconds interval) {
+    if (running_.exchange(true)) return;
+    recalibration_thread_ = std::thread(&FastClock::recalibrationLoop, this, interval);
+}
+
+void FastClock::stop() {
+    if (!running_.exchange(false)) return;
+    if (recalibration_thread_.joinable()) recalibration_thread_.join();
+}
+
+void FastClock::recalibrationLoop(std::chrono::milliseconds interval) {
+    auto next = std::chrono::steady_clock::now() + interval;
+    while (running_.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        if (std::chrono::steady_clock::now() >= next) {
+            recalibrate();
+            next += interval;
+        }
+    }
+}
@@ -0,0 +1,241 @@
+#include "core/flight_recorder.h"
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <sys/stat.h>
+
+namespace {
+
+// Marks this thread's ring retired on thread exit; the ring itself lives on in the registry
+// until its events have aged out of the dump window.
+struct FlightRingHandle {
+    std::shared_ptr<void> ring;
+    std::atomic<bool>* retired = nullptr;
+    ~FlightRingHandle() {
+        if (retired) retired->store(true, std::memory_order_release);
+    }
+};
+
+thread_local FlightRingHandle tls_flight_ring;
+
+void copy_name(char* dest, size_t size, const char* src) {
+    std::strncpy(dest, src, size - 1);
+    dest[size - 1] = '\0';
+}
+
+}  // namespace
+
+const char* to_string(FlightEventType type) {
+    switch (type) {
+        case FlightEventType::BBO:             return "BBO";
+        case FlightEventType::SIGNAL:          return "SIGNAL";
+        case FlightEventType::ORDER_SENT:      return "ORDER_SENT";
+        case FlightEventType::FILL:            return "FILL";
+        case FlightEventType::RISK:            return "RISK";
+        case FlightEventType::CIRCUIT_BREAKER: return "CIRCUIT_BREAKER";
+        case FlightEventType::EMERGENCY_STOP:  return "EMERGENCY_STOP";
+        case FlightEventType::ORDER_REJECT:    return "ORDER_REJECT";
+        case FlightEventType::CANCEL_ALL:      return "CANCEL_ALL";
+    }
+    return "UNKNOWN";
+}
+
+FlightRecorder& FlightRecorder::getInstance() {
+    static FlightRecorder instance;
+    return instance;
+}
+
+FlightRecorder::~FlightRecorder() {
+    stop();
+}
+
+void FlightRecorder::configure(size_t events_per_thread, std::chrono::seconds window,
+                               const std::string& dump_dir) {
+    size_t capacity = 1024;
+    while (capacity < events_per_thread) capacity <<= 1;
+
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+    ring_capacity_ = capacity;
+    window_ = window;
+    dump_dir_ = dump_dir;
+}
+
+void FlightRecorder::setThreadName(const char* name) {
+    FlightRing* ring = tls_ring_;
+    if (ring == nullptr) {
+        getInstance().registerThread(name);
+        return;
+    }
+    copy_name(ring->name, sizeof(ring->name), name);
+}
+
+FlightRecorder::FlightRing* FlightRecorder::registerThread(const char* name) {
+    auto ring = std::make_shared<FlightRing>();
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        ring->events.reset(new FlightEvent[ring_capacity_]);
+        ring->mask = ring_capacity_ - 1;
+        if (name) {
+            copy_name(ring->name, sizeof(ring->name), name);
+        } else {
+            std::snprintf(ring->name, sizeof(ring->name), "thread-%zu", rings_.size());
+        }
+        rings_.push_back(ring);
+    }
+    tls_flight_ring.retired = &ring->retired;
+    tls_flight_ring.ring = ring;
+    tls_ring_ = ring.get();
+    return ring.get();
+}
+
+void FlightRecorder::start() {
+    if (running_.exchange(true)) return;
+    dump_thread_ = std::thread(&FlightRecorder::dumpLoop, this);
+}
+
+void FlightRecorder::stop() {
+    if (!running_.exchange(false)) return;
+    if (dump_thread_.joinable()) dump_thread_.join();
+}
+
+void FlightRecorder::requestDump(const char* reason) {
+    // Coalesce: the first request's timestamp anchors the window.
+    if (pending_reason_.load(std::memory_order_acquire) != nullptr) return;
+    pending_tsc_.store(FastClock::now(), std::memory_order_relaxed);
+    pending_reason_.store(reason, std::memory_order_release);
+}
+
+std::string FlightRecorder::dumpNow(const char* reason) {
+    return writeDump(reason, FastClock::now());
+}
+
+void FlightRecorder::dumpLoop() {
+    bool running = true;
+    while (running) {
+        // Read the flag first so a request raised just before stop() is still written.
+        running = running_.load(std::memory_order_acquire);
+        const char* reason = pending_reason_.exchange(nullptr, std::memory_order_acq_rel);
+        if (reason) {
+            writeDump(reason, pending_tsc_.load(std::memory_order_relaxed));
+        } else if (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    }
+}
+
+std::string FlightRecorder::writeDump(const char* reason, uint64_t trigger_tsc) {
+    std::lock_guard<std::mutex> dump_lock(dump_mutex_);
+
+    std::vector<std::shared_ptr<FlightRing>> rings;
+    std::chrono::seconds window;
+    std::string dump_dir;
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        rings = rings_;
+        window = window_;
+        dump_dir = dump_dir_;
+    }
+
+    FastClock& clock = FastClock::getInstance();
+    const uint64_t now = FastClock::now();
+    const double ns_per_tick = clock.nanosPerTick();
+    const uint64_t window_ns = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(window).count());
+    const auto window_ticks = static_cast<uint64_t>(static_cast<double>(window_ns) / ns_per_tick);
+    const uint64_t cutoff = trigger_tsc > window_ticks ? trigger_tsc - window_ticks : 0;
+
+    FlightDumpHeader header{};
+    std::memcpy(header.magic, FLIGHT_DUMP_MAGIC, sizeof(header.magic));
+    header.version = FLIGHT_DUMP_VERSION;
+    header.header_size = sizeof(FlightDumpHeader);
+    header.event_size = sizeof(FlightEvent);
+    header.trigger_tsc = trigger_tsc;
+    header.anchor_tsc = now;
+    header.anchor_wall_ns = clock.toWallNanos(now);
+    header.ns_per_tick = ns_per_tick;
+    header.window_ns = window_ns;
+    copy_name(header.reason, sizeof(header.reason), reason);
+
+    std::vector<FlightEvent> events;
+    std::vector<FlightEvent> scratch;
+    for (const auto& ring : rings) {
+        if (header.thread_count == FLIGHT_MAX_THREADS) break;
+
+        // Copy optimistically, then drop every slot the writer may have lapped meanwhile
+        // (including the one it is writing now) -- the same validation as a seqlock read.
+        const uint64_t capacity = ring->mask + 1;
+        const uint64_t end = ring->head.load(std::memory_order_acquire);
+        const uint64_t begin = end > capacity ? end - capacity : 0;
+        scratch.clear();
+        for (uint64_t i = begin; i < end; ++i) scratch.push_back(ring->events[i & ring->mask]);
+        const uint64_t after = ring->head.load(std::memory_order_acquire);
+        const uint64_t valid_from = after + 1 > capacity ? after + 1 - capacity : 0;
+
+        const auto thread = static_cast<uint8_t>(header.thread_count);
+        size_t kept = 0;
+        for (uint64_t i = std::max(begin, valid_from); i < end; ++i) {
+            FlightEvent event = scratch[i - begin];
+            if (event.tsc < cutoff) continue;
+            event.thread = thread;
+            events.push_back(event);
+            ++kept;
+        }
+        if (kept == 0) continue;
+        if (begin > 0 && scratch[std::max(begin, valid_from) - begin].tsc >= cutoff) {
+            ++header.truncated_threads;
+        }
+        copy_name(header.thread_names[thread], FLIGHT_NAME_LEN, ring->name);
+        ++header.thread_count;
+    }
+
+    std::stable_sort(events.begin(), events.end(),
+        [](const FlightEvent& a, const FlightEvent& b) { return a.tsc < b.tsc; });
+    header.event_count = events.size();
+
+    // Retired threads stay dumpable until their last event leaves the window.
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+            [cutoff](const std::shared_ptr<FlightRing>& ring) {
+                if (!ring->retired.load(std::memory_order_acquire)) return false;
+                const uint64_t head = ring->head.load(std::memory_order_acquire);
+                return head == 0 || ring->events[(head - 1) & ring->mask].tsc < cutoff;
+            }),
+            rings_.end());
+    }
+
+    mkdir(dump_dir.c_str(), 0755);
+    const auto wall_ns = header.anchor_wall_ns;
+    const auto wall_s = static_cast<time_t>(wall_ns / 1000000000ULL);
+    struct tm tm_buf{};
+    localtime_r(&wall_s, &tm_buf);
+    char stamp[32];
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d_%H%M%S", &tm_buf);
+    char millis[8];
+    std::snprintf(millis, sizeof(millis), "%03u", static_cast<unsigned>(wall_ns / 1000000ULL % 1000));
+    std::string path = dump_dir + "/flight_" + stamp + "_" + millis + "_" + header.reason + ".bin";
+
+    FILE* file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Flight recorder: cannot open " << path << std::endl;
+        return "";
+    }
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              (events.empty() || std::fwrite(events.data(), sizeof(FlightEvent), events.size(), file) == events.size());
+    ok = (std::fclose(file) == 0) && ok;
+    if (!ok) {
+        std::cerr << "Flight recorder: short write to " << path << std::endl;
+        return "";
+    }
+
+    dumps_.fetch_add(1, std::memory_order_relaxed);
+    std::cout << "Flight recorder: " << events.size() << " events from " << header.thread_count
+              << " threads (" << reason << ") -> " << path << std::endl;
+    if (header.truncated_threads > 0) {
+        std::cout << "Flight recorder: " << header.truncated_threads
+                  << " ring(s) wrapped inside the window; raise FLIGHT_RECORDER_EVENTS" << std::endl;
+    }
+    return path;
+}
@@ -0,0 +1,61 @@
+#include "core/idle_strategy.h"
+#include <climits>
+
+#if defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex word must be a plain 32-bit int");
+
+bool WakeSignal::wait(uint32_t epoch, std::chrono::nanoseconds timeout) {
+    if (seq_.load(std::memory_order_acquire) != epoch) return true;
+
+    // Register first, then re-check: notify() bumps seq_ before it looks at waiters_.
+    waiters_.fetch_add(1, std::memory_order_seq_cst);
+    if (seq_.load(std::memory_order_seq_cst) == epoch) {
+#if defined(__linux__)
+        struct timespec relative{};
+        relative.tv_sec = static_cast<time_t>(timeout.count() / 1000000000LL);
+        relative.tv_nsec = static_cast<long>(timeout.count() % 1000000000LL);
+        // The kernel re-checks the word, so a notify after the load above still wakes us.
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAIT_PRIVATE, epoch,
+                &relative, nullptr, 0);
+#else
+        // No futex: poll in short sleeps.
+        const auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (seq_.load(std::memory_order_acquire) == epoch && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+#endif
+    }
+    waiters_.fetch_sub(1, std::memory_order_release);
+    return seq_.load(std::memory_order_acquire) != epoch;
+}
+
+void WakeSignal::wakeAll() {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+const char* to_string(IdleMode mode) {
+    switch (mode) {
+        case IdleMode::BUSY_SPIN:  return "busy_spin";
+        case IdleMode::SPIN_YIELD: return "spin_yield";
+        case IdleMode::SPIN_PARK:  return "spin_park";
+    }
+    return "unknown";
+}
+
+bool parseIdleMode(const std::string& text, IdleMode& mode) {
+    for (IdleMode candidate : {IdleMode::BUSY_SPIN, IdleMode::SPIN_YIELD, IdleMode::SPIN_PARK}) {
+        if (text == to_string(candidate)) {
+            mode = candidate;
+            return true;
+        }
+    }
+    return false;
+}
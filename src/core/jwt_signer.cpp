@@ -0,0 +1,201 @@
+#include "core/jwt_signer.h"
+#include <iostream>
+#include <cstring>
+#include <pthread.h>
+#include <openssl/bio.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/rand.h>
+
+namespace {
+
+constexpr char BASE64URL[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+constexpr size_t ES256_COMPONENT_BYTES = 32;
+
+// Unpadded base64url of `data` appended at `out`; returns the bytes written.
+size_t base64url(const unsigned char* data, size_t length, char* out) {
+    char* p = out;
+    size_t i = 0;
+    for (; i + 3 <= length; i += 3) {
+        const uint32_t v = (uint32_t{data[i]} << 16) | (uint32_t{data[i + 1]} << 8) | data[i + 2];
+        *p++ = BASE64URL[(v >> 18) & 63];
+        *p++ = BASE64URL[(v >> 12) & 63];
+        *p++ = BASE64URL[(v >> 6) & 63];
+        *p++ = BASE64URL[v & 63];
+    }
+    if (length - i == 1) {
+        const uint32_t v = uint32_t{data[i]} << 16;
+        *p++ = BASE64URL[(v >> 18) & 63];
+        *p++ = BASE64URL[(v >> 12) & 63];
+    } else if (length - i == 2) {
+        const uint32_t v = (uint32_t{data[i]} << 16) | (uint32_t{data[i + 1]} << 8);
+        *p++ = BASE64URL[(v >> 18) & 63];
+        *p++ = BASE64URL[(v >> 12) & 63];
+        *p++ = BASE64URL[(v >> 6) & 63];
+    }
+    return static_cast<size_t>(p - out);
+}
+
+size_t base64url(const std::string& text, char* out) {
+    return base64url(reinterpret_cast<const unsigned char*>(text.data()), text.size(), out);
+}
+
+int64_t unix_now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+JwtSigner::~JwtSigner() {
+    stop();
+    if (pkey_) EVP_PKEY_free(pkey_);
+}
+
+bool JwtSigner::setKey(const std::string& api_key, const std::string& pem_key) {
+    // Both are spliced into the JSON claims as-is.
+    if (api_key.empty() || api_key.find_first_of("\"\\") != std::string::npos) {
+        std::cerr << "JWT signer: missing or invalid API key name" << std::endl;
+        return false;
+    }
+
+    std::string pem = pem_key;
+    size_t pos = 0;
+    while ((pos = pem.find("\\n", pos)) != std::string::npos) {
+        pem.replace(pos, 2, "\n");
+        pos += 1;
+    }
+
+    BIO* bio = BIO_new_mem_buf(pem.data(), static_cast<int>(pem.size()));
+    EVP_PKEY* pkey = bio ? PEM_read_bio_PrivateKey(bio, nullptr, nullptr, nullptr) : nullptr;
+    BIO_free(bio);
+    if (!pkey || EVP_PKEY_get_base_id(pkey) != EVP_PKEY_EC || EVP_PKEY_get_bits(pkey) != 256) {
+        std::cerr << "JWT signer: COINBASE_SECRET_KEY is not a P-256 EC private key" << std::endl;
+        EVP_PKEY_free(pkey);
+        return false;
+    }
+
+    if (pkey_) EVP_PKEY_free(pkey_);
+    pkey_ = pkey;
+    api_key_ = api_key;
+    return true;
+}
+
+int JwtSigner::track(const std::string& uri) {
+    if (!pkey_) return -1;
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < slot_count_; ++i) {
+        if (slots_[i].uri == uri) return static_cast<int>(i);
+    }
+    if (slot_count_ == kMaxUris) {
+        std::cerr << "JWT signer: more than " << kMaxUris << " request paths" << std::endl;
+        return -1;
+    }
+    Slot& slot = slots_[slot_count_];
+    slot.uri = uri;
+    if (!resign(slot, unix_now())) return -1;
+    return static_cast<int>(slot_count_++);
+}
+
+std::string JwtSigner::sign(const std::string& uri) const {
+    std::string token(kMaxTokenBytes, '\0');
+    token.resize(signInto(uri, unix_now(), &token[0], token.size()));
+    return token;
+}
+
+void JwtSigner::start() {
+    if (running_.exchange(true)) return;
+    thread_ = std::thread(&JwtSigner::refreshLoop, this);
+}
+
+void JwtSigner::stop() {
+    if (!running_.exchange(false)) return;
+    wake_.notify();
+    if (thread_.joinable()) thread_.join();
+}
+
+void JwtSigner::refreshLoop() {
+    pthread_setname_np(pthread_self(), "hft-jwt");
+    while (running_.load(std::memory_order_relaxed)) {
+        const uint32_t epoch = wake_.epoch();
+        refreshDue();
+        wake_.wait(epoch, std::chrono::seconds(1));
+    }
+}
+
+void JwtSigner::refreshDue(bool force) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const int64_t now = unix_now();
+    for (size_t i = 0; i < slot_count_; ++i) {
+        Slot& slot = slots_[i];
+        const Token* current = slot.current.load(std::memory_order_relaxed);
+        // A failed re-sign keeps the old token and is retried on the next pass.
+        if (force || current->expires_at - now <= kRefreshAhead.count()) resign(slot, now);
+    }
+}
+
+bool JwtSigner::resign(Slot& slot, int64_t now) {
+    Token& token = slot.buffers[slot.next];
+    const size_t length = signInto(slot.uri, now, token.text.data(), token.text.size());
+    if (length == 0) return false;
+    token.length = static_cast<uint32_t>(length);
+    token.expires_at = now + kLifetime.count();
+    slot.current.store(&token, std::memory_order_release);
+    slot.next = (slot.next + 1) % kBuffersPerUri;
+    return true;
+}
+
+size_t JwtSigner::signInto(const std::string& uri, int64_t now, char* out, size_t capacity) const {
+    if (!pkey_ || uri.find_first_of("\"\\") != std::string::npos) return 0;
+
+    unsigned char nonce_raw[16];
+    if (RAND_bytes(nonce_raw, sizeof(nonce_raw)) != 1) return 0;
+    char nonce[2 * sizeof(nonce_raw)];
+    for (size_t i = 0; i < sizeof(nonce_raw); ++i) {
+        static constexpr char HEX[] = "0123456789abcdef";
+        nonce[2 * i] = HEX[nonce_raw[i] >> 4];
+        nonce[2 * i + 1] = HEX[nonce_raw[i] & 15];
+    }
+
+    const std::string header = "{\"alg\":\"ES256\",\"kid\":\"" + api_key_ + "\",\"nonce\":\"" +
+                               std::string(nonce, sizeof(nonce)) + "\",\"typ\":\"JWT\"}";
+    const std::string payload = "{\"iss\":\"cdp\",\"sub\":\"" + api_key_ + "\",\"nbf\":" + std::to_string(now) +
+                                ",\"exp\":" + std::to_string(now + kLifetime.count()) +
+                                ",\"uri\":\"" + uri + "\"}";
+    // base64url grows 3 bytes to 4; the signature part is 86 characters.
+    if ((header.size() + payload.size()) * 4 / 3 + 8 + 90 > capacity) return 0;
+
+    size_t n = base64url(header, out);
+    out[n++] = '.';
+    n += base64url(payload, out + n);
+    const size_t signing_input = n;
+
+    unsigned char der[80];
+    size_t der_length = sizeof(der);
+    EVP_MD_CTX* ctx = EVP_MD_CTX_new();
+    const bool signed_ok = ctx &&
+        EVP_DigestSignInit(ctx, nullptr, EVP_sha256(), nullptr, pkey_) == 1 &&
+        EVP_DigestSign(ctx, der, &der_length, reinterpret_cast<const unsigned char*>(out), signing_input) == 1;
+    EVP_MD_CTX_free(ctx);
+    if (!signed_ok) return 0;
+
+    // JWS wants r || s, each 32 bytes, where OpenSSL produces DER.
+    const unsigned char* der_ptr = der;
+    ECDSA_SIG* sig = d2i_ECDSA_SIG(nullptr, &der_ptr, static_cast<long>(der_length));
+    if (!sig) return 0;
+    unsigned char raw[2 * ES256_COMPONENT_BYTES];
+    const BIGNUM* r = nullptr;
+    const BIGNUM* s = nullptr;
+    ECDSA_SIG_get0(sig, &r, &s);
+    const bool raw_ok = BN_bn2binpad(r, raw, ES256_COMPONENT_BYTES) == ES256_COMPONENT_BYTES &&
+                        BN_bn2binpad(s, raw + ES256_COMPONENT_BYTES, ES256_COMPONENT_BYTES) == ES256_COMPONENT_BYTES;
+    ECDSA_SIG_free(sig);
+    if (!raw_ok) return 0;
+
+    out[n++] = '.';
+    n += base64url(raw, sizeof(raw), out + n);
+    signatures_.fetch_add(1, std::memory_order_relaxed);
+    return n;
+}
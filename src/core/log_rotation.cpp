@@ -0,0 +1,247 @@
+#include "core/log_rotation.h"
+#include <iostream>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <cerrno>
+#include <cstdio>
+#include <ctime>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace {
+
+constexpr size_t COMPRESSION_SLICE_BYTES = 256 * 1024;
+
+bool write_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool file_exists(const std::string& path) {
+    struct stat st{};
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+// Age key of a rotated segment name <base>.<YYYYmmdd-HHMMSS>[-N][.gz], given the part after
+// "<base>.". Plain string order gets this wrong: '.' sorts after '-', and "-10" before "-2".
+struct SegmentAge {
+    std::string stamp;
+    unsigned long seq = 0;
+
+    bool operator<(const SegmentAge& other) const {
+        return stamp != other.stamp ? stamp < other.stamp : seq < other.seq;
+    }
+};
+
+bool parse_segment_age(std::string suffix, SegmentAge& age) {
+    constexpr size_t STAMP_LEN = 15;  // YYYYmmdd-HHMMSS
+    const std::string gz = ".gz";
+    if (suffix.size() > gz.size() && suffix.compare(suffix.size() - gz.size(), gz.size(), gz) == 0) {
+        suffix.resize(suffix.size() - gz.size());
+    }
+    if (suffix.size() < STAMP_LEN || suffix[8] != '-') return false;
+    for (size_t i = 0; i < STAMP_LEN; ++i) {
+        if (i != 8 && (suffix[i] < '0' || suffix[i] > '9')) return false;
+    }
+    age.stamp = suffix.substr(0, STAMP_LEN);
+    age.seq = 0;
+    if (suffix.size() == STAMP_LEN) return true;
+    if (suffix[STAMP_LEN] != '-' || suffix.size() == STAMP_LEN + 1) return false;
+    for (size_t i = STAMP_LEN + 1; i < suffix.size(); ++i) {
+        if (suffix[i] < '0' || suffix[i] > '9') return false;
+        age.seq = age.seq * 10 + static_cast<unsigned long>(suffix[i] - '0');
+    }
+    return true;
+}
+
+}  // namespace
+
+struct RotatingLogFile::CompressionJob {
+    std::string source;
+    std::string target;
+    int in_fd = -1;
+    gzFile out = nullptr;
+
+    ~CompressionJob() {
+        if (in_fd >= 0) ::close(in_fd);
+        if (out) gzclose(out);
+    }
+};
+
+RotatingLogFile::RotatingLogFile(std::string dir, std::string base_name, LogRotationPolicy policy)
+    : dir_(std::move(dir))
+    , base_name_(std::move(base_name))
+    , path_(dir_ + "/" + base_name_)
+    , policy_(policy)
+{
+}
+
+RotatingLogFile::~RotatingLogFile() {
+    // Finish outstanding compression so no half-written .gz is left behind.
+    while (compressSlice(COMPRESSION_SLICE_BYTES)) {}
+    close();
+}
+
+bool RotatingLogFile::open() {
+    fd_ = ::open(path_.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (fd_ < 0) {
+        std::cerr << "Failed to open log file: " << path_ << std::endl;
+        return false;
+    }
+    struct stat st{};
+    file_bytes_ = (fstat(fd_, &st) == 0) ? static_cast<uint64_t>(st.st_size) : 0;
+    opened_at_ = std::chrono::system_clock::now();
+    return true;
+}
+
+void RotatingLogFile::close() {
+    if (fd_ >= 0) {
+        ::fsync(fd_);
+        ::close(fd_);
+        fd_ = -1;
+    }
+}
+
+bool RotatingLogFile::write(const char* data, size_t len) {
+    if (fd_ < 0) return false;
+    if (policy_.max_file_bytes > 0 && file_bytes_ > 0 &&
+        file_bytes_ + len > policy_.max_file_bytes) {
+        rotate();
+        if (fd_ < 0) return false;
+    }
+    if (!write_all(fd_, data, len)) return false;
+    file_bytes_ += len;
+    return true;
+}
+
+bool RotatingLogFile::maintenance() {
+    if (fd_ >= 0 && file_bytes_ > 0 && policy_.max_file_age.count() > 0 &&
+        std::chrono::system_clock::now() - opened_at_ >= policy_.max_file_age) {
+        rotate();
+    }
+    return compressSlice(COMPRESSION_SLICE_BYTES);
+}
+
+void RotatingLogFile::rotate() {
+    close();
+
+    std::string segment = nextSegmentPath();
+    if (std::rename(path_.c_str(), segment.c_str()) == 0) {
+        if (policy_.compress) {
+            pending_compression_.push_back(segment);
+        }
+    }
+
+    open();
+    enforceRetention();
+}
+
+std::string RotatingLogFile::nextSegmentPath() const {
+    char stamp[32];
+    std::time_t now = std::time(nullptr);
+    struct tm tm_buf{};
+    localtime_r(&now, &tm_buf);
+    std::strftime(stamp, sizeof(stamp), "%Y%m%d-%H%M%S", &tm_buf);
+
+    std::string segment = path_ + "." + stamp;
+    for (int i = 1; file_exists(segment) || file_exists(segment + ".gz"); ++i) {
+        segment = path_ + "." + stamp + "-" + std::to_string(i);
+    }
+    return segment;
+}
+
+bool RotatingLogFile::compressSlice(size_t budget_bytes) {
+    if (!active_job_) {
+        if (pending_compression_.empty()) return false;
+
+        auto job = std::make_unique<CompressionJob>();
+        job->source = pending_compression_.front();
+        job->target = job->source + ".gz";
+        pending_compression_.pop_front();
+
+        job->in_fd = ::open(job->source.c_str(), O_RDONLY | O_CLOEXEC);
+        job->out = gzopen(job->target.c_str(), "wb6");
+        if (job->in_fd < 0 || !job->out) {
+            std::cerr << "Log compression failed to open: " << job->source << std::endl;
+            return !pending_compression_.empty();
+        }
+        active_job_ = std::move(job);
+    }
+
+    char chunk[64 * 1024];
+    size_t processed = 0;
+    while (processed < budget_bytes) {
+        ssize_t n = ::read(active_job_->in_fd, chunk, sizeof(chunk));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            bool ok = (n == 0);
+            std::string source = active_job_->source;
+            std::string target = active_job_->target;
+            ::close(active_job_->in_fd);
+            active_job_->in_fd = -1;
+            ok = (gzclose(active_job_->out) == Z_OK) && ok;
+            active_job_->out = nullptr;
+            active_job_.reset();
+
+            if (ok) {
+                ::unlink(source.c_str());
+            } else {
+                std::cerr << "Log compression failed, keeping uncompressed segment: " << source << std::endl;
+                ::unlink(target.c_str());
+            }
+            enforceRetention();
+            return !pending_compression_.empty();
+        }
+        if (gzwrite(active_job_->out, chunk, static_cast<unsigned>(n)) != static_cast<int>(n)) {
+            std::cerr << "Log compression write failed: " << active_job_->target << std::endl;
+            ::unlink(active_job_->target.c_str());
+            active_job_.reset();
+            return !pending_compression_.empty();
+        }
+        processed += static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void RotatingLogFile::enforceRetention() {
+    DIR* dir = ::opendir(dir_.c_str());
+    if (!dir) return;
+
+    // Names that do not parse as rotated segments are left alone.
+    const std::string prefix = base_name_ + ".";
+    std::vector<std::pair<SegmentAge, std::string>> segments;
+    while (struct dirent* entry = ::readdir(dir)) {
+        std::string name = entry->d_name;
+        SegmentAge age;
+        if (name.compare(0, prefix.size(), prefix) == 0 && parse_segment_age(name.substr(prefix.size()), age)) {
+            segments.emplace_back(std::move(age), std::move(name));
+        }
+    }
+    ::closedir(dir);
+
+    if (segments.size() <= policy_.max_segments) return;
+
+    // Oldest first; a segment and its .gz (mid-compression) tie and keep readdir order.
+    std::stable_sort(segments.begin(), segments.end(),
+                     [](const auto& a, const auto& b) { return a.first < b.first; });
+    size_t excess = segments.size() - policy_.max_segments;
+    for (size_t i = 0; i < excess; ++i) {
+        std::string full = dir_ + "/" + segments[i].second;
+        if (active_job_ && (full == active_job_->source || full == active_job_->target)) continue;
+        auto pending = std::find(pending_compression_.begin(), pending_compression_.end(), full);
+        if (pending != pending_compression_.end()) pending_compression_.erase(pending);
+        ::unlink(full.c_str());
+    }
+}
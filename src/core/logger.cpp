@@ -1,27 +1,94 @@
 #include "core/logger.h"
 #include <iostream>
 #include <chrono>
-#include <iomanip>
-#include <sstream>
+#include <cstdio>
 #include <ctime>
+#include <cerrno>
 #include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t WRITE_BATCH_BYTES = 64 * 1024;
+constexpr size_t MAX_RECORDS_PER_DRAIN = 256;
+// Upper bound between maintenance passes while records keep arriving.
+constexpr uint64_t MAINTENANCE_INTERVAL_NS = 50ULL * 1000 * 1000;
+
+// Owns this thread's ring; marks it retired on thread exit so the logger thread can free it
+// once drained.
+struct ThreadBufferHandle {
+    std::shared_ptr<void> buffer;
+    std::atomic<bool>* retired = nullptr;
+    ~ThreadBufferHandle() {
+        if (retired) retired->store(true, std::memory_order_release);
+    }
+};
+
+thread_local ThreadBufferHandle tls_log_buffer;
+
+bool write_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::write(fd, data, len);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
 
 Logger& Logger::getInstance() {
     static Logger instance;
     return instance;
 }
 
+Logger::Logger() {
+    // Format id 0 is reserved for the string API: the payload is the message itself.
+    formats_[0].store("{}", std::memory_order_relaxed);
+    format_count_.store(1, std::memory_order_relaxed);
+    write_buffer_.reserve(2 * WRITE_BATCH_BYTES);
+}
+
 Logger::~Logger() {
-    closeLogFile();
+    shutdown();
 }
 
 bool Logger::initialize(const std::string& log_dir) {
+    if (backend_running_.load()) return true;
+
     log_dir_ = log_dir;
     struct stat st{};
     if (stat(log_dir_.c_str(), &st) != 0) {
         mkdir(log_dir_.c_str(), 0755);
     }
-    return openLogFile();
+
+    FastClock::getInstance();  // calibrate before the first record is formatted
+    bool opened = openLogFiles();
+
+    {
+        std::lock_guard<std::mutex> lock(block_mutex_);
+        accepting_blocks_ = true;
+    }
+    backend_running_.store(true);
+    backend_thread_ = std::thread(&Logger::backendLoop, this);
+    return opened;
+}
+
+void Logger::shutdown() {
+    if (!backend_running_.exchange(false)) return;
+    if (backend_thread_.joinable()) {
+        backend_thread_.join();
+    }
+    closeLogFiles();
+
+    uint64_t dropped = dropped_records_.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::cerr << "Logger dropped " << dropped << " records (thread ring full)" << std::endl;
+    }
 }
 
 void Logger::debug(const std::string& message) {
@@ -49,34 +116,251 @@ void Logger::log(LogLevel level, const std::string& message) {
         return;
     }
 
-    std::string timestamp = getCurrentTimestamp();
-    std::string level_str = logLevelToString(level);
-    std::string formatted_message = timestamp + " [" + level_str + "] " + message;
+    // Split long messages across continuation records; the logger thread stitches them
+    // back into a single line.
+    const uint64_t tsc = FastClock::now();
+    size_t offset = 0;
+    do {
+        LogRecord record;
+        record.tsc = tsc;
+        record.format_id = 0;
+        record.level = static_cast<uint8_t>(level);
+        size_t chunk = std::min(message.size() - offset, LogRecord::PAYLOAD_SIZE);
+        std::memcpy(record.payload, message.data() + offset, chunk);
+        record.payload_size = static_cast<uint16_t>(chunk);
+        offset += chunk;
+        if (offset < message.size()) {
+            record.flags = LogRecord::FLAG_CONTINUED;
+        }
+        enqueue(record);
+    } while (offset < message.size());
+}
 
-    std::lock_guard<std::mutex> lock(log_mutex_);
+bool Logger::writeBlock(LogStream stream, std::string text) {
+    std::lock_guard<std::mutex> lock(block_mutex_);
+    if (!accepting_blocks_) return false;
+    pending_blocks_.emplace_back(stream, std::move(text));
+    return true;
+}
 
-    if (console_output_) {
-        std::cout << formatted_message << std::endl;
+uint16_t Logger::registerFormat(const char* format) {
+    std::lock_guard<std::mutex> lock(format_mutex_);
+    uint16_t id = format_count_.load(std::memory_order_relaxed);
+    if (HFT_UNLIKELY(id >= MAX_FORMATS)) {
+        return 0;
+    }
+    formats_[id].store(format, std::memory_order_release);
+    format_count_.store(static_cast<uint16_t>(id + 1), std::memory_order_release);
+    return id;
+}
+
+void Logger::enqueue(const LogRecord& record) {
+    if (HFT_UNLIKELY(!threadBuffer().queue.push(record))) {
+        dropped_records_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+Logger::ThreadBuffer& Logger::threadBuffer() {
+    if (HFT_LIKELY(tls_log_buffer.buffer != nullptr)) {
+        return *static_cast<ThreadBuffer*>(tls_log_buffer.buffer.get());
     }
 
-    if (file_output_ && main_log_file_ && *main_log_file_) {
-        *main_log_file_ << formatted_message << std::endl;
+    auto buffer = std::make_shared<ThreadBuffer>();
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        buffers_.push_back(buffer);
+        registry_version_.fetch_add(1, std::memory_order_release);
     }
+    tls_log_buffer.retired = &buffer->retired;
+    tls_log_buffer.buffer = buffer;
+    return *buffer;
 }
 
-std::string Logger::getCurrentTimestamp() {
-    auto now = std::chrono::system_clock::now();
-    auto time_t_val = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+void Logger::backendLoop() {
+    const uint64_t maintenance_ticks = FastClock::getInstance().nanosToTicks(MAINTENANCE_INTERVAL_NS);
+    uint64_t last_maintenance = FastClock::now();
+    bool running = true;
+    while (running) {
+        // Read the flag before draining so records logged ahead of shutdown are written.
+        running = backend_running_.load();
+
+        bool did_work = drainBuffers();
+        if (!did_work || write_buffer_.size() >= WRITE_BATCH_BYTES) {
+            flushOutput();
+        }
+        did_work |= writePendingBlocks();
 
+        // Rotation, compression and retention run here, between drains, so no trading
+        // thread ever waits on open/rename/fsync. Idle passes run it every loop; under
+        // sustained logging it still runs once per interval so rotation is never starved.
+        const uint64_t now = FastClock::now();
+        if (!did_work || now - last_maintenance >= maintenance_ticks) {
+            last_maintenance = now;
+            if (main_log_) did_work |= main_log_->maintenance();
+            if (session_log_) did_work |= session_log_->maintenance();
+            if (risk_log_) did_work |= risk_log_->maintenance();
+        }
+
+        if (!did_work && running) {
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+        }
+    }
+    flushOutput();
+    {
+        std::lock_guard<std::mutex> lock(block_mutex_);
+        accepting_blocks_ = false;
+    }
+    writePendingBlocks();
+}
+
+bool Logger::drainBuffers() {
+    uint64_t version = registry_version_.load(std::memory_order_acquire);
+    if (version != backend_registry_version_) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        backend_buffers_ = buffers_;
+        backend_registry_version_ = version;
+    }
+
+    bool did_work = false;
+    bool reclaim_pending = false;
+    for (auto& buffer : backend_buffers_) {
+        // A buffer retired before this drain that we emptied will never see another record.
+        const bool retired = buffer->retired.load(std::memory_order_acquire);
+        LogRecord record;
+        size_t drained = 0;
+        while (drained < MAX_RECORDS_PER_DRAIN && buffer->queue.pop(record)) {
+            formatRecord(*buffer, record);
+            ++drained;
+        }
+        did_work |= drained > 0;
+        buffer->reclaimable = retired && drained < MAX_RECORDS_PER_DRAIN && !buffer->line_open;
+        reclaim_pending |= buffer->reclaimable;
+    }
+
+    if (reclaim_pending) {
+        std::lock_guard<std::mutex> lock(registry_mutex_);
+        buffers_.erase(std::remove_if(buffers_.begin(), buffers_.end(),
+            [](const std::shared_ptr<ThreadBuffer>& b) { return b->reclaimable; }),
+            buffers_.end());
+        backend_buffers_ = buffers_;
+        backend_registry_version_ = registry_version_.fetch_add(1, std::memory_order_release) + 1;
+    }
+    return did_work;
+}
+
+void Logger::formatRecord(ThreadBuffer& buffer, const LogRecord& record) {
+    if (!buffer.line_open) {
+        appendTimestamp(record.tsc);
+        write_buffer_ += " [";
+        write_buffer_ += logLevelToString(static_cast<LogLevel>(record.level));
+        write_buffer_ += "] ";
+    }
+
+    if (record.format_id == 0) {
+        write_buffer_.append(record.payload, record.payload_size);
+    } else {
+        const char* format = formats_[record.format_id].load(std::memory_order_acquire);
+        if (HFT_UNLIKELY(format == nullptr)) format = "<unregistered format>";
+        size_t pos = 0;
+        char number[64];
+        for (const char* p = format; *p; ++p) {
+            if (p[0] != '{' || p[1] != '}' || pos >= record.payload_size) {
+                write_buffer_ += *p;
+                continue;
+            }
+            ++p;
+            auto type = static_cast<log_detail::ArgType>(record.payload[pos++]);
+            int n = 0;
+            switch (type) {
+                case log_detail::ArgType::INT64: {
+                    int64_t v;
+                    std::memcpy(&v, record.payload + pos, sizeof(v));
+                    pos += sizeof(v);
+                    n = std::snprintf(number, sizeof(number), "%lld", static_cast<long long>(v));
+                    break;
+                }
+                case log_detail::ArgType::UINT64: {
+                    uint64_t v;
+                    std::memcpy(&v, record.payload + pos, sizeof(v));
+                    pos += sizeof(v);
+                    n = std::snprintf(number, sizeof(number), "%llu", static_cast<unsigned long long>(v));
+                    break;
+                }
+                case log_detail::ArgType::DOUBLE: {
+                    double v;
+                    std::memcpy(&v, record.payload + pos, sizeof(v));
+                    pos += sizeof(v);
+                    n = std::snprintf(number, sizeof(number), "%.10g", v);
+                    break;
+                }
+                case log_detail::ArgType::BOOL:
+                    write_buffer_ += record.payload[pos++] ? "true" : "false";
+                    break;
+                case log_detail::ArgType::CHAR:
+                    write_buffer_ += record.payload[pos++];
+                    break;
+                case log_detail::ArgType::STRING: {
+                    auto len = static_cast<uint8_t>(record.payload[pos++]);
+                    write_buffer_.append(record.payload + pos, len);
+                    pos += len;
+                    break;
+                }
+            }
+            if (n > 0) write_buffer_.append(number, std::min(static_cast<size_t>(n), sizeof(number) - 1));
+        }
+    }
+
+    buffer.line_open = (record.flags & LogRecord::FLAG_CONTINUED) != 0;
+    if (!buffer.line_open) {
+        write_buffer_ += '\n';
+    }
+}
+
+void Logger::appendTimestamp(uint64_t tsc) {
+    const uint64_t wall_ns = FastClock::getInstance().toWallNanos(tsc);
+
+    auto seconds = static_cast<std::time_t>(wall_ns / 1000000000ULL);
+    auto millis = static_cast<unsigned>((wall_ns / 1000000ULL) % 1000ULL);
     struct tm tm_buf{};
-    localtime_r(&time_t_val, &tm_buf);
+    localtime_r(&seconds, &tm_buf);
 
-    std::ostringstream oss;
-    oss << std::put_time(&tm_buf, "%Y-%m-%d %H:%M:%S");
-    oss << '.' << std::setfill('0') << std::setw(3) << ms.count();
-    return oss.str();
+    char stamp[40];
+    size_t len = std::strftime(stamp, sizeof(stamp), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    int n = std::snprintf(stamp + len, sizeof(stamp) - len, ".%03u", millis);
+    if (n > 0) len += static_cast<size_t>(n);
+    write_buffer_.append(stamp, std::min(len, sizeof(stamp) - 1));
+}
+
+void Logger::flushOutput() {
+    if (write_buffer_.empty()) return;
+
+    if (console_output_) {
+        write_all(STDOUT_FILENO, write_buffer_.data(), write_buffer_.size());
+    }
+
+    if (file_output_ && main_log_) {
+        main_log_->write(write_buffer_.data(), write_buffer_.size());
+    }
+
+    write_buffer_.clear();
+}
+
+bool Logger::writePendingBlocks() {
+    {
+        std::lock_guard<std::mutex> lock(block_mutex_);
+        if (pending_blocks_.empty()) return false;
+        backend_blocks_.swap(pending_blocks_);
+    }
+    for (const auto& [stream, text] : backend_blocks_) {
+        RotatingLogFile* file = main_log_.get();
+        if (stream == LogStream::SESSION_SUMMARY) file = session_log_.get();
+        if (stream == LogStream::RISK_EVENTS) file = risk_log_.get();
+        if (file) {
+            file->write(text.data(), text.size());
+        }
+    }
+    backend_blocks_.clear();
+    return true;
 }
 
 std::string Logger::logLevelToString(LogLevel level) {
@@ -90,16 +374,19 @@ std::string Logger::logLevelToString(LogLevel level) {
     }
 }
 
-bool Logger::openLogFile() {
-    try {
-        main_log_file_ = std::make_unique<std::ofstream>(log_dir_ + "/main.log", std::ios::app);
-        return main_log_file_->is_open();
-    } catch (const std::exception& e) {
-        std::cerr << "Failed to open log file: " << e.what() << std::endl;
-        return false;
-    }
+bool Logger::openLogFiles() {
+    main_log_ = std::make_unique<RotatingLogFile>(log_dir_, "main.log", rotation_policy_);
+    session_log_ = std::make_unique<RotatingLogFile>(log_dir_, "session_summary.log", rotation_policy_);
+    risk_log_ = std::make_unique<RotatingLogFile>(log_dir_, "risk_events.log", rotation_policy_);
+    bool main_ok = main_log_->open();
+    bool session_ok = session_log_->open();
+    bool risk_ok = risk_log_->open();
+    return main_ok && session_ok && risk_ok;
 }
 
-void Logger::closeLogFile() {
-    main_log_file_.reset();
+void Logger::closeLogFiles() {
+    // Destruction finishes any in-flight segment compression.
+    main_log_.reset();
+    session_log_.reset();
+    risk_log_.reset();
 }
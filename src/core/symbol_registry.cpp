@@ -0,0 +1,75 @@
+#include "core/symbol_registry.h"
+#include <cctype>
+
+SymbolRegistry& SymbolRegistry::getInstance() {
+    static SymbolRegistry instance;
+    return instance;
+}
+
+uint32_t SymbolRegistry::intern(const std::string& symbol) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = symbol_ids_.find(symbol);
+    if (it != symbol_ids_.end()) return it->second;
+
+    const uint32_t id = symbol_count_.load(std::memory_order_relaxed);
+    if (id >= kMaxSymbols) return kInvalidId;
+
+    std::string base;
+    std::string quote;
+    splitSymbol(symbol, base, quote);
+    Entry& entry = symbols_[id];
+    entry.name = symbol;
+    entry.base_asset = internAsset(base);
+    entry.quote_asset = quote.empty() ? kInvalidId : internAsset(quote);
+
+    symbol_ids_.emplace(symbol, id);
+    // Publishes the entry to lock-free readers.
+    symbol_count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+uint32_t SymbolRegistry::find(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = symbol_ids_.find(symbol);
+    return it != symbol_ids_.end() ? it->second : kInvalidId;
+}
+
+uint32_t SymbolRegistry::findAsset(const std::string& asset) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = asset_ids_.find(asset);
+    return it != asset_ids_.end() ? it->second : kInvalidId;
+}
+
+uint32_t SymbolRegistry::internAsset(const std::string& asset) {
+    auto it = asset_ids_.find(asset);
+    if (it != asset_ids_.end()) return it->second;
+
+    // Each symbol adds at most two assets, so this cannot overflow before kMaxSymbols does.
+    const uint32_t id = asset_count_.load(std::memory_order_relaxed);
+    asset_names_[id] = asset;
+    asset_ids_.emplace(asset, id);
+    asset_count_.store(id + 1, std::memory_order_release);
+    return id;
+}
+
+void SymbolRegistry::splitSymbol(const std::string& symbol, std::string& base, std::string& quote) {
+    const size_t separator = symbol.find_first_of("-/_");
+    if (separator == std::string::npos) {
+        base = symbol;
+        quote.clear();
+        return;
+    }
+    base = symbol.substr(0, separator);
+    quote = symbol.substr(separator + 1);
+}
+
+std::string SymbolRegistry::configKey(const std::string& symbol) {
+    std::string key;
+    key.reserve(symbol.size());
+    for (char c : symbol) {
+        if (std::isalnum(static_cast<unsigned char>(c))) {
+            key.push_back(static_cast<char>(std::toupper(static_cast<unsigned char>(c))));
+        }
+    }
+    return key;
+}
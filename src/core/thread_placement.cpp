@@ -0,0 +1,359 @@
+#include "core/thread_placement.h"
+#include "core/config.h"
+#include <iostream>
+#include <sstream>
+#include <fstream>
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#if defined(__linux__)
+#include <sys/syscall.h>
+#endif
+
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+
+namespace {
+
+const char* SYS_CPU = "/sys/devices/system/cpu";
+const char* SYS_NODE = "/sys/devices/system/node";
+
+bool read_line(const std::string& path, std::string& line) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::getline(file, line);
+    return true;
+}
+
+std::vector<int> read_cpu_list(const std::string& path) {
+    std::string line;
+    std::vector<int> cpus;
+    if (read_line(path, line)) ThreadPlacer::parseCpuList(line, cpus);
+    return cpus;
+}
+
+int read_int(const std::string& path, int fallback) {
+    std::string line;
+    if (!read_line(path, line) || line.empty()) return fallback;
+    return std::atoi(line.c_str());
+}
+
+bool contains(const std::vector<int>& list, int value) {
+    return std::find(list.begin(), list.end(), value) != list.end();
+}
+
+template<typename T>
+T at_or(const std::vector<T>& values, int index, T fallback) {
+    return (index >= 0 && static_cast<size_t>(index) < values.size()) ? values[index] : fallback;
+}
+
+std::string upper(std::string text) {
+    std::transform(text.begin(), text.end(), text.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+    return text;
+}
+
+}  // namespace
+
+CpuTopology CpuTopology::detect() {
+    CpuTopology topology;
+    const std::string cpu_dir = SYS_CPU;
+
+    topology.online = read_cpu_list(cpu_dir + "/online");
+    if (topology.online.empty()) {
+        for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i) {
+            topology.online.push_back(static_cast<int>(i));
+        }
+    }
+    topology.isolated = read_cpu_list(cpu_dir + "/isolated");
+    topology.nohz_full = read_cpu_list(cpu_dir + "/nohz_full");
+
+#if defined(__linux__)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &mask)) topology.allowed.push_back(cpu);
+        }
+    }
+#endif
+    if (topology.allowed.empty()) topology.allowed = topology.online;
+
+    const int cpu_count = topology.online.back() + 1;
+    topology.package.assign(cpu_count, -1);
+    topology.node.assign(cpu_count, -1);
+    topology.siblings.assign(cpu_count, {});
+    for (int cpu : topology.online) {
+        const std::string base = cpu_dir + "/cpu" + std::to_string(cpu) + "/topology/";
+        topology.package[cpu] = read_int(base + "physical_package_id", -1);
+        topology.siblings[cpu] = read_cpu_list(base + "thread_siblings_list");
+        if (topology.siblings[cpu].empty()) topology.siblings[cpu] = {cpu};
+    }
+
+    if (DIR* dir = opendir(SYS_NODE)) {
+        while (struct dirent* entry = readdir(dir)) {
+            const char* name = entry->d_name;
+            if (std::strncmp(name, "node", 4) != 0 || !std::isdigit(static_cast<unsigned char>(name[4]))) continue;
+            const int node = std::atoi(name + 4);
+            for (int cpu : read_cpu_list(std::string(SYS_NODE) + "/" + name + "/cpulist")) {
+                if (cpu < cpu_count) topology.node[cpu] = node;
+            }
+        }
+        closedir(dir);
+    }
+    return topology;
+}
+
+bool CpuTopology::isOnline(int cpu) const { return contains(online, cpu); }
+bool CpuTopology::isAllowed(int cpu) const { return contains(allowed, cpu); }
+bool CpuTopology::isIsolated(int cpu) const { return contains(isolated, cpu); }
+bool CpuTopology::isNohzFull(int cpu) const { return contains(nohz_full, cpu); }
+int CpuTopology::packageOf(int cpu) const { return at_or(package, cpu, -1); }
+int CpuTopology::nodeOf(int cpu) const { return at_or(node, cpu, -1); }
+
+std::vector<int> CpuTopology::siblingsOf(int cpu) const {
+    return at_or(siblings, cpu, std::vector<int>{cpu});
+}
+
+std::vector<int> CpuTopology::nodeCpus(int target) const {
+    std::vector<int> cpus;
+    for (int cpu : online) {
+        if (nodeOf(cpu) == target) cpus.push_back(cpu);
+    }
+    return cpus;
+}
+
+bool ThreadPlacer::parseCpuList(const std::string& text, std::vector<int>& cpus) {
+    cpus.clear();
+    std::stringstream ss(text);
+    std::string range;
+    while (std::getline(ss, range, ',')) {
+        range.erase(std::remove_if(range.begin(), range.end(),
+                                   [](unsigned char c) { return std::isspace(c); }), range.end());
+        if (range.empty()) continue;
+
+        char* end = nullptr;
+        const long first = std::strtol(range.c_str(), &end, 10);
+        long last = first;
+        if (end == range.c_str() || first < 0) return false;
+        if (*end == '-') {
+            const char* second = end + 1;
+            last = std::strtol(second, &end, 10);
+            if (end == second || last < first) return false;
+        }
+        if (*end != '\0' || last >= CPU_SETSIZE) return false;
+        for (long cpu = first; cpu <= last; ++cpu) cpus.push_back(static_cast<int>(cpu));
+    }
+    std::sort(cpus.begin(), cpus.end());
+    cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+    return true;
+}
+
+std::string ThreadPlacer::formatCpuList(const std::vector<int>& cpus) {
+    std::string out;
+    for (size_t i = 0; i < cpus.size();) {
+        size_t j = i;
+        while (j + 1 < cpus.size() && cpus[j + 1] == cpus[j] + 1) ++j;
+        if (!out.empty()) out += ',';
+        out += std::to_string(cpus[i]);
+        if (j > i) out += '-' + std::to_string(cpus[j]);
+        i = j + 1;
+    }
+    return out;
+}
+
+ThreadPlacement ThreadPlacer::fromConfig(const std::string& name, bool latency_critical) {
+    Config& config = Config::getInstance();
+    const std::string prefix = "THREAD_" + upper(name) + "_";
+
+    ThreadPlacement placement;
+    placement.name = name;
+    placement.latency_critical = latency_critical;
+
+    const std::string cpus = config.getConfig(prefix + "CPUS", "");
+    if (!parseCpuList(cpus, placement.cpus)) {
+        std::cerr << "Invalid " << prefix << "CPUS '" << cpus << "' - thread left unpinned" << std::endl;
+        placement.cpus.clear();
+    }
+    placement.fifo_priority = std::atoi(config.getConfig(prefix + "PRIORITY", "0").c_str());
+    placement.numa_node = std::atoi(config.getConfig(prefix + "NUMA", "-1").c_str());
+    return placement;
+}
+
+std::vector<std::string> ThreadPlacer::validate(const std::vector<ThreadPlacement>& placements,
+                                                const CpuTopology& topology) {
+    std::vector<std::string> warnings;
+
+    for (const ThreadPlacement& p : placements) {
+        const std::string& name = p.name;
+        if (p.fifo_priority < 0 || p.fifo_priority > 99) {
+            warnings.push_back(name + ": SCHED_FIFO priority " + std::to_string(p.fifo_priority) +
+                               " is outside 1-99");
+        }
+        if (p.numa_node >= 0 && topology.nodeCpus(p.numa_node).empty()) {
+            warnings.push_back(name + ": NUMA node " + std::to_string(p.numa_node) + " has no online CPUs");
+        }
+
+        for (int cpu : p.cpus) {
+            const std::string cpu_name = "cpu " + std::to_string(cpu);
+            if (!topology.isOnline(cpu)) {
+                warnings.push_back(name + ": " + cpu_name + " is offline");
+                continue;
+            }
+            if (!topology.isAllowed(cpu)) {
+                warnings.push_back(name + ": " + cpu_name + " is outside the process affinity mask");
+            }
+            if (p.numa_node >= 0 && topology.nodeOf(cpu) >= 0 && topology.nodeOf(cpu) != p.numa_node) {
+                warnings.push_back(name + ": " + cpu_name + " is on NUMA node " +
+                                   std::to_string(topology.nodeOf(cpu)) + ", not node " +
+                                   std::to_string(p.numa_node));
+            }
+            if (!p.latency_critical) continue;
+
+            if (!topology.isIsolated(cpu)) {
+                warnings.push_back(name + ": " + cpu_name + " is not in isolcpus; other tasks may be scheduled there");
+            }
+            if (!topology.isNohzFull(cpu)) {
+                warnings.push_back(name + ": " + cpu_name + " is not nohz_full; the scheduler tick still interrupts it");
+            }
+            std::vector<int> others;
+            for (int sibling : topology.siblingsOf(cpu)) {
+                if (!contains(p.cpus, sibling) && topology.isOnline(sibling)) others.push_back(sibling);
+            }
+            if (!others.empty()) {
+                warnings.push_back(name + ": " + cpu_name + " shares a physical core with cpu " +
+                                   formatCpuList(others) + " (SMT sibling)");
+            }
+        }
+
+        if (p.latency_critical && !p.pinned()) {
+            warnings.push_back(name + ": not pinned; the scheduler may migrate it mid-burst");
+        }
+    }
+
+    for (size_t i = 0; i < placements.size(); ++i) {
+        for (size_t j = i + 1; j < placements.size(); ++j) {
+            const ThreadPlacement& a = placements[i];
+            const ThreadPlacement& b = placements[j];
+            if (!a.latency_critical && !b.latency_critical) continue;
+            std::vector<int> shared;
+            std::set_intersection(a.cpus.begin(), a.cpus.end(), b.cpus.begin(), b.cpus.end(),
+                                  std::back_inserter(shared));
+            if (shared.empty()) continue;
+            std::string warning = a.name + " and " + b.name + " share cpu " + formatCpuList(shared);
+            if ((a.latency_critical && a.fifo_priority > 0) || (b.latency_critical && b.fifo_priority > 0)) {
+                warning += "; a SCHED_FIFO spinner there will starve the other thread";
+            }
+            warnings.push_back(warning);
+        }
+    }
+
+    // The feed hands every tick to the order engine: keep both on one socket.
+    const ThreadPlacement* feed = nullptr;
+    const ThreadPlacement* engine = nullptr;
+    for (const ThreadPlacement& p : placements) {
+        if (p.name == "market_data") feed = &p;
+        if (p.name == "order_engine") engine = &p;
+    }
+    if (feed && engine && feed->pinned() && engine->pinned()) {
+        std::vector<int> sockets;
+        for (const ThreadPlacement* p : {feed, engine}) {
+            for (int cpu : p->cpus) {
+                const int package = topology.packageOf(cpu);
+                if (package >= 0 && !contains(sockets, package)) sockets.push_back(package);
+            }
+        }
+        if (sockets.size() > 1) {
+            std::sort(sockets.begin(), sockets.end());
+            warnings.push_back("market_data and order_engine span sockets " + formatCpuList(sockets) +
+                               "; every tick crosses the socket interconnect");
+        }
+    }
+    return warnings;
+}
+
+bool ThreadPlacer::applyToCurrentThread(const ThreadPlacement& placement) {
+    bool ok = true;
+#if defined(__linux__)
+    const std::string thread_name = ("hft-" + placement.name).substr(0, 15);
+    pthread_setname_np(pthread_self(), thread_name.c_str());
+
+    std::vector<int> cpus = placement.cpus;
+    if (cpus.empty() && placement.numa_node >= 0) {
+        cpus = CpuTopology::detect().nodeCpus(placement.numa_node);
+    }
+    if (!cpus.empty()) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) CPU_SET(cpu, &set);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        if (rc != 0) {
+            std::cerr << "Thread " << placement.name << ": cannot pin to cpu " << formatCpuList(cpus)
+                      << ": " << std::strerror(rc) << std::endl;
+            ok = false;
+        }
+    }
+
+    if (placement.numa_node >= 0 && placement.numa_node < 64) {
+        unsigned long nodemask = 1UL << placement.numa_node;
+        if (syscall(SYS_set_mempolicy, MPOL_PREFERRED, &nodemask, sizeof(nodemask) * 8) != 0) {
+            std::cerr << "Thread " << placement.name << ": cannot prefer NUMA node " << placement.numa_node
+                      << ": " << std::strerror(errno) << std::endl;
+            ok = false;
+        }
+    }
+
+    if (placement.fifo_priority > 0) {
+        sched_param param{};
+        param.sched_priority = std::min(placement.fifo_priority, 99);
+        int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+        if (rc != 0) {
+            std::cerr << "Thread " << placement.name << ": SCHED_FIFO " << param.sched_priority
+                      << " refused (" << std::strerror(rc) << "); needs CAP_SYS_NICE or RLIMIT_RTPRIO" << std::endl;
+            ok = false;
+        }
+    }
+#else
+    if (placement.pinned() || placement.fifo_priority > 0 || placement.numa_node >= 0) {
+        std::cerr << "Thread " << placement.name << ": placement is only supported on Linux" << std::endl;
+        ok = false;
+    }
+#endif
+    std::cout << "   " << placement.name << ": " << describeCurrentThread() << std::endl;
+    return ok;
+}
+
+std::string ThreadPlacer::describeCurrentThread() {
+    std::string out;
+#if defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    std::vector<int> cpus;
+    if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+    int policy = SCHED_OTHER;
+    sched_param param{};
+    pthread_getschedparam(pthread_self(), &policy, &param);
+
+    out = "cpus " + formatCpuList(cpus);
+    out += (policy == SCHED_FIFO) ? " | SCHED_FIFO " + std::to_string(param.sched_priority)
+         : (policy == SCHED_RR)   ? " | SCHED_RR " + std::to_string(param.sched_priority)
+                                  : std::string(" | SCHED_OTHER");
+    out += " | on cpu " + std::to_string(sched_getcpu());
+#else
+    out = "placement unavailable";
+#endif
+    return out;
+}
@@ -2,6 +2,9 @@
 #include "data/websocket_client.h"
 #include "metrics/metrics.h"
 #include "core/spsc_queue.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
+#include "core/idle_strategy.h"
 #include "core/types.h"
 #include <iostream>
 #include <algorithm>
@@ -10,36 +13,77 @@ MarketDataFeed::MarketDataFeed(WebSocketClient& ws_client, AtomicHFTMetrics& met
     : ws_client_(ws_client)
     , metrics_(metrics)
 {
-    last_ws_message_time_ = std::chrono::high_resolution_clock::now();
 }
 
-void MarketDataFeed::trimBook() {
-    while (bid_book_.size() > MAX_BOOK_LEVELS) {
-        bid_book_.erase(std::prev(bid_book_.end()));
+void MarketDataFeed::trimBook(SymbolBook& book) {
+    while (book.bids.size() > MAX_BOOK_LEVELS) {
+        book.bids.erase(std::prev(book.bids.end()));
     }
-    while (ask_book_.size() > MAX_BOOK_LEVELS) {
-        ask_book_.erase(std::prev(ask_book_.end()));
+    while (book.asks.size() > MAX_BOOK_LEVELS) {
+        book.asks.erase(std::prev(book.asks.end()));
     }
 }
 
+void MarketDataFeed::snapshotDepth(const SymbolBook& book, DepthSnapshot& depth) {
+    uint8_t level = 0;
+    for (auto it = book.bids.begin(); it != book.bids.end() && level < DepthSnapshot::kLevels; ++it, ++level) {
+        depth.bid_price[level] = it->first;
+        depth.bid_quantity[level] = it->second;
+    }
+    depth.bid_levels = level;
+    level = 0;
+    for (auto it = book.asks.begin(); it != book.asks.end() && level < DepthSnapshot::kLevels; ++it, ++level) {
+        depth.ask_price[level] = it->first;
+        depth.ask_quantity[level] = it->second;
+    }
+    depth.ask_levels = level;
+}
+
 void MarketDataFeed::start(const std::string& trading_symbol,
-                           SPSCQueue<HFTMarketData, 1024>& queue) {
-    trading_symbol_ = trading_symbol;
+                           SPSCQueue<HFTMarketData, 1024>& queue, WakeSignal* wake) {
+    start(trading_symbol, [this, &queue, wake](HFTMarketData& market_data) {
+        LatencyTrace& trace = market_data.trace;
+        trace.enqueued_tsc = FastClock::now();
+        queue.push(market_data);
+        if (wake) wake->notify();
+        metrics_.latency(LatencyStage::QUEUE_PUBLISH).record(trace.enqueued_tsc - trace.book_updated_tsc);
+    });
+}
+
+void MarketDataFeed::start(const std::string& trading_symbol, TickHandler on_tick) {
+    start(std::vector<std::string>{trading_symbol}, std::move(on_tick));
+}
 
-    ws_client_.setMessageCallback([this, &queue](const nlohmann::json& message) {
+void MarketDataFeed::start(const std::vector<std::string>& symbols, TickHandler on_tick) {
+    books_.clear();
+    book_index_.clear();
+    for (const auto& symbol : symbols) {
+        if (book_index_.count(symbol)) continue;
+        book_index_.emplace(symbol, static_cast<uint32_t>(books_.size()));
+        books_.push_back(std::make_unique<SymbolBook>());
+        books_.back()->symbol = symbol;
+    }
+    on_tick_ = std::move(on_tick);
+
+    ws_client_.setMessageCallback([this](const nlohmann::json& message, const LatencyTrace& rx_trace) {
         try {
             if (HFT_UNLIKELY(!message.contains("channel") || message["channel"] != "l2_data" ||
                 !message.contains("events") || !message["events"].is_array())) {
                 return;
             }
 
+            metrics_.latency(LatencyStage::WS_PARSE).record(rx_trace.parsed_tsc - rx_trace.recv_tsc);
+
             for (const auto& event : message["events"]) {
                 if (!event.contains("type") || !event.contains("product_id") || !event.contains("updates")) {
                     continue;
                 }
 
                 const auto& product_id = event["product_id"].get_ref<const std::string&>();
-                if (product_id != trading_symbol_) continue;
+                auto found = book_index_.find(product_id);
+                if (found == book_index_.end()) continue;
+                const uint32_t index = found->second;
+                SymbolBook& book = *books_[index];
 
                 const auto& type = event["type"].get_ref<const std::string&>();
                 if (!event["updates"].is_array()) continue;
@@ -48,8 +92,8 @@ void MarketDataFeed::start(const std::string& trading_symbol,
                 if (!is_snapshot && type != "update") continue;
 
                 if (is_snapshot) {
-                    bid_book_.clear();
-                    ask_book_.clear();
+                    book.bids.clear();
+                    book.asks.clear();
                 }
 
                 for (const auto& update : event["updates"]) {
@@ -63,58 +107,62 @@ void MarketDataFeed::start(const std::string& trading_symbol,
 
                     if (side == "bid") {
                         if (qty > 0.0) {
-                            bid_book_[price] = qty;
+                            book.bids[price] = qty;
                         } else {
-                            bid_book_.erase(price);
+                            book.bids.erase(price);
                         }
                     } else if (side == "offer") {
                         if (qty > 0.0) {
-                            ask_book_[price] = qty;
+                            book.asks[price] = qty;
                         } else {
-                            ask_book_.erase(price);
+                            book.asks.erase(price);
                         }
                     }
                 }
 
-                trimBook();
+                trimBook(book);
 
-                if (bid_book_.empty() || ask_book_.empty()) continue;
+                if (book.bids.empty() || book.asks.empty()) continue;
 
-                double best_bid = bid_book_.begin()->first;
-                double bid_qty = bid_book_.begin()->second;
-                double best_ask = ask_book_.begin()->first;
-                double ask_qty = ask_book_.begin()->second;
+                double best_bid = book.bids.begin()->first;
+                double bid_qty = book.bids.begin()->second;
+                double best_ask = book.asks.begin()->first;
+                double ask_qty = book.asks.begin()->second;
 
                 if (HFT_UNLIKELY(best_bid >= best_ask)) continue;
 
-                auto current_time = std::chrono::high_resolution_clock::now();
-                auto processing_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
-                    current_time - last_ws_message_time_).count();
-
-                uint64_t display_latency_ns = static_cast<uint64_t>(
-                    std::min(processing_time_ns, static_cast<int64_t>(50000000)));
-                metrics_.websocket_latency_ns.store(display_latency_ns, std::memory_order_relaxed);
-                last_ws_message_time_ = current_time;
-
                 HFTMarketData market_data{};
-                set_symbol(market_data.symbol, trading_symbol_);
+                market_data.trace = rx_trace;
+                market_data.trace.book_updated_tsc = FastClock::now();
+                set_symbol(market_data.symbol, book.symbol);
                 market_data.bid_price = best_bid;
                 market_data.ask_price = best_ask;
                 market_data.bid_quantity = bid_qty;
                 market_data.ask_quantity = ask_qty;
-                market_data.timestamp = current_time;
+                snapshotDepth(book, market_data.depth);
                 market_data.sequence_number = ++sequence_counter_;
+                market_data.symbol_index = index;
 
-                current_bid_.store(best_bid, std::memory_order_relaxed);
-                current_ask_.store(best_ask, std::memory_order_relaxed);
+                if (best_bid != book.bid.load(std::memory_order_relaxed) ||
+                    best_ask != book.ask.load(std::memory_order_relaxed)) {
+                    FlightRecorder::record(FlightEventType::BBO, best_bid, best_ask,
+                                           static_cast<uint32_t>(market_data.sequence_number));
+                }
+                book.bid.store(best_bid, std::memory_order_relaxed);
+                book.ask.store(best_ask, std::memory_order_relaxed);
                 double spread_bps = ((best_ask - best_bid) / best_bid) * 10000.0;
-                current_spread_bps_.store(spread_bps, std::memory_order_relaxed);
-                last_market_update_.store(static_cast<uint64_t>(
-                    std::chrono::duration_cast<std::chrono::nanoseconds>(
-                        current_time.time_since_epoch()).count()), std::memory_order_relaxed);
+                book.spread_bps.store(spread_bps, std::memory_order_relaxed);
+                book.last_update_tsc.store(market_data.trace.book_updated_tsc, std::memory_order_relaxed);
+                book.updates.fetch_add(1, std::memory_order_relaxed);
 
-                queue.push(market_data);
+                const LatencyTrace& trace = market_data.trace;
+                metrics_.latency(LatencyStage::BOOK_UPDATE).record(trace.book_updated_tsc - trace.parsed_tsc);
+                on_tick_(market_data);
                 metrics_.market_data_updates.fetch_add(1, std::memory_order_relaxed);
+
+                // Receive -> hand-off: the queue push, or the book update when handled inline.
+                const uint64_t handoff_tsc = trace.enqueued_tsc ? trace.enqueued_tsc : trace.book_updated_tsc;
+                metrics_.websocket_latency_ticks.store(handoff_tsc - trace.recv_tsc, std::memory_order_relaxed);
             }
         } catch (const std::exception& e) {
             std::cerr << "WebSocket message parsing error: " << e.what() << std::endl;
@@ -1,9 +1,10 @@
 #include "data/websocket_client.h"
+#include "core/jwt_signer.h"
 #include "core/cpu_hints.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
 #include <iostream>
 #include <cstring>
-#include <openssl/rand.h>
-#include <jwt-cpp/jwt.h>
 
 static WebSocketClient* client_instance = nullptr;
 
@@ -35,11 +36,6 @@ WebSocketClient::~WebSocketClient() {
     }
 }
 
-void WebSocketClient::setApiCredentials(const std::string& api_key, const std::string& secret_key) {
-    api_key_ = api_key;
-    secret_key_ = secret_key;
-}
-
 bool WebSocketClient::connect(const std::string& url) {
     if (running_) {
         std::cout << "WebSocket already running, stopping first..." << std::endl;
@@ -62,6 +58,43 @@ bool WebSocketClient::connect(const std::string& url) {
     return running_.load();
 }
 
+bool WebSocketClient::connectPolled(const std::string& url) {
+    if (running_) {
+        std::cout << "WebSocket already running, stopping first..." << std::endl;
+        stop();
+    }
+
+    url_ = url;
+
+    if (!parseUrl(url, host_, path_, port_)) {
+        std::cout << "Failed to parse WebSocket URL: " << url << std::endl;
+        return false;
+    }
+
+    std::cout << "Connecting to WebSocket (polled): " << host_ << ":" << port_ << path_ << std::endl;
+
+    running_ = true;
+    if (!openConnection()) {
+        running_ = false;
+        connected_ = false;
+        return false;
+    }
+    return true;
+}
+
+int WebSocketClient::poll() {
+    if (HFT_UNLIKELY(!context_ || !running_.load(std::memory_order_relaxed))) return -1;
+
+    const uint64_t delivered = message_count_.load(std::memory_order_relaxed);
+    // A negative timeout makes lws poll with a zero timeout instead of sleeping.
+    if (HFT_UNLIKELY(lws_service(context_, -1) < 0)) {
+        std::cerr << "lws_service error in polled mode" << '\n';
+        return -1;
+    }
+    flushTxQueue();
+    return static_cast<int>(message_count_.load(std::memory_order_relaxed) - delivered);
+}
+
 void WebSocketClient::disconnect() {
     connected_ = false;
     std::cout << "WebSocket disconnecting..." << std::endl;
@@ -72,22 +105,39 @@ void WebSocketClient::disconnect() {
     }
 }
 
+void WebSocketClient::setWorkerInitHook(WorkerInitHook hook) {
+    worker_init_hook_ = std::move(hook);
+}
+
 void WebSocketClient::setMessageCallback(MessageCallback callback) {
     message_callback_ = callback;
 }
 
+void WebSocketClient::setChannelHandler(const std::string& channel, MessageCallback handler) {
+    channel_handlers_.emplace_back(channel, std::move(handler));
+}
+
 bool WebSocketClient::subscribeOrderBook(const std::string& symbol, int /*depth*/, int /*update_speed_ms*/) {
-    if (api_key_.empty() || secret_key_.empty()) {
-        std::cout << "ERROR: Advanced Trade API credentials required for Level 2 data" << std::endl;
+    return subscribe("level2", {symbol});
+}
+
+bool WebSocketClient::subscribeUser(const std::vector<std::string>& symbols) {
+    return subscribe("user", symbols);
+}
+
+bool WebSocketClient::subscribe(const std::string& channel, const std::vector<std::string>& symbols) {
+    const int jwt_handle = jwt_signer_ ? jwt_signer_->track("GET api.coinbase.com") : -1;
+    if (jwt_handle < 0) {
+        std::cout << "ERROR: Advanced Trade API credentials required for the " << channel << " channel" << std::endl;
         return false;
     }
 
-    std::string jwt_token = createJwtToken();
+    const std::string jwt_token(jwt_signer_->token(jwt_handle));
 
     nlohmann::json subscription = {
         {"type", "subscribe"},
-        {"product_ids", {symbol}},
-        {"channel", "level2"},
+        {"product_ids", symbols},
+        {"channel", channel},
         {"jwt", jwt_token}
     };
 
@@ -131,43 +181,50 @@ void WebSocketClient::stop() {
     std::cout << "WebSocket client stopped" << std::endl;
 }
 
+bool WebSocketClient::openConnection() {
+    memset(&info_, 0, sizeof(info_));
+    info_.port = CONTEXT_PORT_NO_LISTEN;
+    info_.protocols = protocols_;
+    info_.gid = -1;
+    info_.uid = -1;
+    info_.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
+    info_.ka_time = 30;
+    info_.ka_probes = 5;
+    info_.ka_interval = 5;
+
+    context_ = lws_create_context(&info_);
+    if (!context_) {
+        std::cout << "Failed to create libwebsockets context" << std::endl;
+        handleError("Failed to create libwebsockets context");
+        return false;
+    }
+
+    struct lws_client_connect_info ccinfo = {};
+    ccinfo.context = context_;
+    ccinfo.address = host_.c_str();
+    ccinfo.port = port_;
+    ccinfo.path = path_.c_str();
+    ccinfo.host = ccinfo.address;
+    ccinfo.origin = ccinfo.address;
+    ccinfo.protocol = protocols_[0].name;
+    ccinfo.ssl_connection = (port_ == 443) ? LCCSCF_USE_SSL : 0;
+
+    wsi_ = lws_client_connect_via_info(&ccinfo);
+    if (!wsi_) {
+        std::cout << "Failed to create WebSocket connection" << std::endl;
+        handleError("Failed to create WebSocket connection");
+        return false;
+    }
+    return true;
+}
+
 void WebSocketClient::workerLoop() {
     running_ = true;
+    if (worker_init_hook_) worker_init_hook_();
+    FlightRecorder::setThreadName("market_data");
 
     try {
-        memset(&info_, 0, sizeof(info_));
-        info_.port = CONTEXT_PORT_NO_LISTEN;
-        info_.protocols = protocols_;
-        info_.gid = -1;
-        info_.uid = -1;
-        info_.options = LWS_SERVER_OPTION_DO_SSL_GLOBAL_INIT;
-        info_.ka_time = 30;
-        info_.ka_probes = 5;
-        info_.ka_interval = 5;
-
-        context_ = lws_create_context(&info_);
-        if (!context_) {
-            std::cout << "Failed to create libwebsockets context" << std::endl;
-            handleError("Failed to create libwebsockets context");
-            running_ = false;
-            connected_ = false;
-            return;
-        }
-
-        struct lws_client_connect_info ccinfo = {};
-        ccinfo.context = context_;
-        ccinfo.address = host_.c_str();
-        ccinfo.port = port_;
-        ccinfo.path = path_.c_str();
-        ccinfo.host = ccinfo.address;
-        ccinfo.origin = ccinfo.address;
-        ccinfo.protocol = protocols_[0].name;
-        ccinfo.ssl_connection = (port_ == 443) ? LCCSCF_USE_SSL : 0;
-
-        wsi_ = lws_client_connect_via_info(&ccinfo);
-        if (!wsi_) {
-            std::cout << "Failed to create WebSocket connection" << std::endl;
-            handleError("Failed to create WebSocket connection");
+        if (!openConnection()) {
             running_ = false;
             connected_ = false;
             return;
@@ -211,11 +268,14 @@ void WebSocketClient::handleDisconnect() {
     connected_ = false;
 }
 
-void WebSocketClient::handleMessage(const std::string& message) {
+void WebSocketClient::handleMessage(const std::string& message, uint64_t recv_tsc) {
     message_count_++;
 
     try {
         nlohmann::json json_msg = nlohmann::json::parse(message);
+        LatencyTrace trace;
+        trace.recv_tsc = recv_tsc;
+        trace.parsed_tsc = FastClock::now();
 
         if (json_msg.contains("type") && json_msg["type"] == "error") {
             std::cerr << "ERROR MESSAGE RECEIVED: " << message.substr(0, 500) << '\n';
@@ -224,8 +284,20 @@ void WebSocketClient::handleMessage(const std::string& message) {
             }
         }
 
+        if (!channel_handlers_.empty()) {
+            auto channel = json_msg.find("channel");
+            if (channel != json_msg.end() && channel->is_string()) {
+                for (const auto& handler : channel_handlers_) {
+                    if (handler.first == channel->get_ref<const std::string&>()) {
+                        handler.second(json_msg, trace);
+                        return;
+                    }
+                }
+            }
+        }
+
         if (message_callback_) {
-            message_callback_(json_msg);
+            message_callback_(json_msg, trace);
         }
 
     } catch (const std::exception& e) {
@@ -283,11 +355,15 @@ int WebSocketClient::lwsCallback(struct lws* wsi, enum lws_callback_reasons reas
 
         case LWS_CALLBACK_CLIENT_RECEIVE:
             if (in && len > 0) {
-                std::string fragment(static_cast<char*>(in), len);
-                client_instance->rx_buffer_ += fragment;
+                // Receive time of a message is the arrival of its first fragment.
+                if (client_instance->rx_buffer_.empty()) {
+                    client_instance->rx_started_tsc_ = FastClock::now();
+                }
+                client_instance->rx_buffer_.append(static_cast<char*>(in), len);
 
                 if (lws_is_final_fragment(wsi)) {
-                    client_instance->handleMessage(client_instance->rx_buffer_);
+                    client_instance->handleMessage(client_instance->rx_buffer_,
+                                                   client_instance->rx_started_tsc_);
                     client_instance->rx_buffer_.clear();
                 }
             }
@@ -346,39 +422,3 @@ void WebSocketClient::flushTxQueue() {
         lws_callback_on_writable(wsi_);
     }
 }
-
-std::string WebSocketClient::createJwtToken() const {
-    try {
-        std::string private_key = secret_key_;
-        size_t pos = 0;
-        while ((pos = private_key.find("\\n", pos)) != std::string::npos) {
-            private_key.replace(pos, 2, "\n");
-            pos += 1;
-        }
-
-        unsigned char nonce_raw[16];
-        if (RAND_bytes(nonce_raw, sizeof(nonce_raw)) != 1) {
-            std::cerr << "RAND_bytes failed for JWT nonce" << std::endl;
-            return "";
-        }
-        std::string nonce(reinterpret_cast<char*>(nonce_raw), sizeof(nonce_raw));
-
-        std::string uri = "GET api.coinbase.com";
-
-        auto token = jwt::create()
-            .set_subject(api_key_)
-            .set_issuer("cdp")
-            .set_not_before(std::chrono::system_clock::now())
-            .set_expires_at(std::chrono::system_clock::now() + std::chrono::seconds{120})
-            .set_payload_claim("uri", jwt::claim(uri))
-            .set_header_claim("kid", jwt::claim(api_key_))
-            .set_header_claim("nonce", jwt::claim(nonce))
-            .sign(jwt::algorithm::es256("", private_key));
-
-        return token;
-
-    } catch (const std::exception& e) {
-        std::cerr << "WebSocket JWT token creation failed: " << e.what() << std::endl;
-        return "";
-    }
-}
@@ -1,16 +1,25 @@
 #include "engine.h"
 #include "core/config.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
+#include "core/jwt_signer.h"
 #include "core/logger.h"
 #include "core/types.h"
 #include "data/websocket_client.h"
 #include "data/market_data.h"
-#include "strategy/market_maker.h"
+#include "execution/coinbase_gateway.h"
 #include "execution/executor.h"
+#include "execution/sim_gateway.h"
 #include "order/order_manager.h"
 #include "risk/risk_manager.h"
 #include "metrics/metrics.h"
+#include "metrics/metrics_exporter.h"
 #include <iostream>
+#include <algorithm>
 #include <cmath>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
 
 HFTEngine::HFTEngine() = default;
 HFTEngine::~HFTEngine() { stop(); }
@@ -22,7 +31,22 @@ bool HFTEngine::initialize(const std::string& config_file) {
         return false;
     }
 
+    LogRotationPolicy log_policy;
+    log_policy.max_file_bytes = static_cast<uint64_t>(std::max(0, config.getLogMaxFileMb())) * 1024 * 1024;
+    log_policy.max_file_age = std::chrono::hours(std::max(0, config.getLogRotateHours()));
+    log_policy.compress = config.getLogCompress();
+    log_policy.max_segments = static_cast<size_t>(std::max(1, config.getLogRetainSegments()));
+
+    FastClock::getInstance().start();
+
+    FlightRecorder& flight_recorder = FlightRecorder::getInstance();
+    flight_recorder.configure(static_cast<size_t>(std::max(1024, config.getFlightRecorderEvents())),
+                              std::chrono::seconds(std::max(1, config.getFlightRecorderWindowSeconds())),
+                              config.getFlightRecorderDir());
+    flight_recorder.start();
+
     logger_ = &Logger::getInstance();
+    logger_->setRotationPolicy(log_policy);
     logger_->initialize("logs");
     logger_->info("HFT Engine initialization started");
 
@@ -40,25 +64,191 @@ bool HFTEngine::initialize(const std::string& config_file) {
         return false;
     }
 
+    jwt_signer_ = std::make_unique<JwtSigner>();
+    if (!jwt_signer_->setKey(config.getCoinbaseApiKey(), config.getCoinbaseSecretKey())) {
+        logger_->warning("Coinbase API credentials missing or invalid - authenticated channels unavailable");
+    }
     websocket_client_ = std::make_unique<WebSocketClient>();
-    websocket_client_->setApiCredentials(config.getCoinbaseApiKey(), config.getCoinbaseSecretKey());
+    websocket_client_->setJwtSigner(jwt_signer_.get());
 
-    metrics_ = std::make_unique<MetricsCollector>(*order_manager_);
+    metrics_ = std::make_unique<MetricsCollector>(*order_manager_, config.getMetricsShmName(), trading_symbol_);
     market_data_feed_ = std::make_unique<MarketDataFeed>(*websocket_client_, metrics_->metrics());
-    strategy_ = std::make_unique<MarketMakingStrategy>();
     executor_ = std::make_unique<OrderExecutor>(
         trading_symbol_, *order_manager_, metrics_->metrics(),
         current_position_, risk_breach_, max_position_);
+    // Fills reach the risk thread as deltas; a limit breach raises risk_breach_ directly.
+    risk_manager_->setBreachFlag(&risk_breach_);
+    executor_->set_risk_deltas(&risk_manager_->riskDeltas());
+
+    int metrics_port = config.getMetricsHttpPort();
+    if (metrics_port > 0) {
+        metrics_exporter_ = std::make_unique<MetricsExporter>(
+            config.getMetricsHttpBind(), metrics_port, [this](MetricsSnapshot& snapshot) {
+                const AtomicHFTMetrics& m = metrics_->metrics();
+                snapshot.orders_placed = m.orders_placed.load(std::memory_order_relaxed);
+                snapshot.orders_filled = m.orders_filled.load(std::memory_order_relaxed);
+                snapshot.quotes_marketable = m.quotes_marketable.load(std::memory_order_relaxed);
+                snapshot.quotes_self_cross = m.quotes_self_cross.load(std::memory_order_relaxed);
+                snapshot.market_data_updates = m.market_data_updates.load(std::memory_order_relaxed);
+                snapshot.orders_per_second = m.orders_per_second.load(std::memory_order_relaxed);
+                snapshot.position = m.current_position.load(std::memory_order_relaxed);
+                snapshot.websocket_latency_seconds = static_cast<double>(FastClock::getInstance().ticksToNanos(
+                    m.websocket_latency_ticks.load(std::memory_order_relaxed))) * 1e-9;
+
+                if (shards_.empty()) {
+                    snapshot.pnl = order_manager_->getCurrentPnL();
+                    snapshot.total_trades = order_manager_->getTotalTrades();
+                } else {
+                    const ShardSnapshot totals = aggregate_shards();
+                    snapshot.pnl = totals.pnl;
+                    snapshot.total_trades = totals.fills;
+                }
+                snapshot.circuit_breaker_active = risk_manager_->isCircuitBreakerActive();
+                snapshot.risk_status = static_cast<int>(risk_manager_->getCurrentRiskStatus());
+                snapshot.dropped_risk_events = risk_manager_->getDroppedRiskEvents();
+                snapshot.dropped_log_records = logger_->droppedRecords();
+                snapshot.uptime_seconds = metrics_->uptime_seconds();
+
+                for (size_t i = 0; i < market_data_feed_->symbol_count(); ++i) {
+                    SymbolFeedStats feed;
+                    feed.symbol = market_data_feed_->symbol(i);
+                    feed.bid = market_data_feed_->bid(i);
+                    feed.ask = market_data_feed_->ask(i);
+                    feed.spread_bps = market_data_feed_->spread_bps(i);
+                    feed.updates = market_data_feed_->updates(i);
+                    uint64_t last_tsc = market_data_feed_->last_update_tsc(i);
+                    if (last_tsc != 0) {
+                        feed.last_update_age_seconds = static_cast<double>(
+                            FastClock::getInstance().ticksToNanos(FastClock::now() - last_tsc)) * 1e-9;
+                    }
+                    snapshot.feeds.push_back(std::move(feed));
+                }
 
-    order_size_.store(config.getOrderSize());
-    max_position_.store(config.getMaxInventory());
+                for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+                    metrics_->capture_latency(static_cast<LatencyStage>(i), snapshot.stage_latency[i]);
+                }
+            });
+    }
+
+    applied_config_ = Config::snapshot();
+    order_size_.store(applied_config_->order_size);
+    max_position_.store(applied_config_->max_inventory);
     order_engine_hz_ = config.getOrderEngineHz();
 
+    const std::string engine_mode = config.getEngineMode();
+    if (engine_mode == "hot_loop") {
+        engine_mode_ = EngineMode::HOT_LOOP;
+    } else if (engine_mode == "sharded") {
+        engine_mode_ = EngineMode::SHARDED;
+    } else {
+        if (engine_mode != "pipeline") {
+            logger_->warning("Unknown ENGINE_MODE '" + engine_mode + "' - using pipeline");
+        }
+        engine_mode_ = EngineMode::PIPELINE;
+    }
+
+    const std::string strategy = config.getStrategy();
+    if (!parseStrategyKind(strategy, strategy_kind_)) {
+        logger_->warning("Unknown STRATEGY '" + strategy + "' - using fixed_spread");
+        strategy_kind_ = StrategyKind::FIXED_SPREAD;
+    }
+    strategy_ = makeStrategy(strategy_kind_);
+
+    const std::string idle_mode = config.getOrderEngineIdle();
+    if (!parseIdleMode(idle_mode, order_engine_idle_)) {
+        logger_->warning("Unknown ORDER_ENGINE_IDLE '" + idle_mode + "' - using spin_yield");
+        order_engine_idle_ = IdleMode::SPIN_YIELD;
+    }
+    if (engine_mode_ == EngineMode::HOT_LOOP && order_engine_idle_ == IdleMode::SPIN_PARK) {
+        // The hot loop owns the socket; nothing could wake it from a park.
+        logger_->warning("ORDER_ENGINE_IDLE=spin_park is not supported by the hot loop - using spin_yield");
+        order_engine_idle_ = IdleMode::SPIN_YIELD;
+    }
+
+    trading_symbols_ = {trading_symbol_};
+    if (engine_mode_ == EngineMode::SHARDED) {
+        // Orders go through the shards' order managers; the engine summarises them at stop.
+        order_manager_->setSessionSummary(false);
+        trading_symbols_ = config.getTradingSymbols();
+        const auto shard_count = static_cast<uint32_t>(std::max(1, std::min(
+            config.getEngineShards(), static_cast<int>(trading_symbols_.size()))));
+        for (uint32_t id = 0; id < shard_count; ++id) {
+            shards_.push_back(std::make_unique<EngineShard>(
+                id, shard_count, EngineShard::partition(trading_symbols_, id, shard_count),
+                risk_breach_, max_position_, order_size_, order_engine_hz_, strategy_kind_));
+            shards_.back()->set_risk_deltas(&risk_manager_->riskDeltas());
+            shard_placements_.push_back(ThreadPlacer::fromConfig("shard" + std::to_string(id), true));
+            for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+                metrics_->register_latency_source(static_cast<LatencyStage>(i),
+                                                  shards_.back()->metrics().stage_latency[i]);
+            }
+        }
+        metrics_->set_totals_source([this] {
+            const ShardSnapshot totals = aggregate_shards();
+            MetricsCollector::TradingTotals result;
+            result.trades = totals.fills;
+            result.pnl = totals.pnl;
+            result.position = totals.net_position;
+            return result;
+        });
+    }
+
+    const std::string order_gateway = config.getOrderGateway();
+    if (!parseGatewayKind(order_gateway, gateway_kind_)) {
+        logger_->warning("Unknown ORDER_GATEWAY '" + order_gateway + "' - using sim");
+    }
+    if (gateway_kind_ != GatewayKind::SIMULATED && engine_mode_ == EngineMode::SHARDED) {
+        // Shard executors are per symbol and have no user channel routing yet.
+        logger_->warning("ORDER_GATEWAY '" + order_gateway + "' is not supported in sharded mode - using sim");
+        gateway_kind_ = GatewayKind::SIMULATED;
+    }
+    if (gateway_kind_ == GatewayKind::REPLAY) {
+        executor_->set_gateway(std::make_unique<ReplayGateway>());
+    } else if (gateway_kind_ == GatewayKind::COINBASE) {
+        CoinbaseGatewayOptions options;
+        options.url = config.getOrderGatewayUrl();
+        options.product_id = trading_symbol_;
+        options.tick_size = applied_config_->tick_size;
+        auto gateway = std::make_unique<CoinbaseGateway>(options, jwt_signer_.get());
+        coinbase_gateway_ = gateway.get();
+        executor_->set_gateway(std::move(gateway));
+        websocket_client_->setChannelHandler("user", [this](const nlohmann::json& message, const LatencyTrace&) {
+            coinbase_gateway_->on_user_message(message);
+        });
+    }
+
+    for (const auto& symbol : trading_symbols_) {
+        trading_symbol_ids_.push_back(risk_manager_->registerSymbol(symbol));
+    }
+
+    order_engine_placement_ = ThreadPlacer::fromConfig("order_engine", true);
+    market_data_placement_ = ThreadPlacer::fromConfig("market_data", true);
+    risk_placement_ = ThreadPlacer::fromConfig("risk", false);
+    metrics_placement_ = ThreadPlacer::fromConfig("metrics", false);
+    // The hot loop runs on the order engine placement; there is no separate market data thread.
+    // Shards replace the order engine thread.
+    std::vector<ThreadPlacement> placements = {risk_placement_, metrics_placement_};
+    if (engine_mode_ != EngineMode::SHARDED) placements.push_back(order_engine_placement_);
+    if (engine_mode_ != EngineMode::HOT_LOOP) placements.push_back(market_data_placement_);
+    placements.insert(placements.end(), shard_placements_.begin(), shard_placements_.end());
+    std::vector<std::string> placement_warnings = ThreadPlacer::validate(placements, CpuTopology::detect());
+    for (const auto& warning : placement_warnings) {
+        std::cout << "   Placement warning: " << warning << std::endl;
+        logger_->warning("Thread placement: " + warning);
+    }
+
     logger_->info("HFT Engine initialized - config ready");
     std::cout << "HFT Engine Ready" << std::endl;
-    std::cout << "   Symbol: " << trading_symbol_
-              << " | Size: " << order_size_.load() << " ETH"
-              << " | Max Pos: " << max_position_.load() << " ETH" << std::endl;
+    if (engine_mode_ == EngineMode::SHARDED) {
+        std::cout << "   Symbols: " << trading_symbols_.size() << " over " << shards_.size() << " shards";
+    } else {
+        std::cout << "   Symbol: " << trading_symbol_;
+    }
+    std::cout << " | Size: " << order_size_.load() << " ETH"
+              << " | Max Pos: " << max_position_.load() << " ETH"
+              << " | Mode: " << engine_mode << " | Idle: " << to_string(order_engine_idle_)
+              << " | Strategy: " << to_string(strategy_kind_)
+              << " | Orders: " << to_string(gateway_kind_) << std::endl;
 
     return true;
 }
@@ -67,20 +257,82 @@ void HFTEngine::start() {
     if (running_.load()) return;
     running_.store(true);
 
+    // Re-signs tracked tokens ahead of expiry; subscriptions and orders only read them.
+    jwt_signer_->start();
+
     std::string ws_url = Config::getInstance().getCoinbaseWsUrl();
-    if (!websocket_client_->connect(ws_url)) {
+    std::cout << "Thread placement:" << std::endl;
+    const bool hot_loop = engine_mode_ == EngineMode::HOT_LOOP;
+    bool connected;
+    if (hot_loop) {
+        // The hot loop thread services the socket itself.
+        connected = websocket_client_->connectPolled(ws_url);
+    } else {
+        websocket_client_->setWorkerInitHook([this] {
+            ThreadPlacer::applyToCurrentThread(market_data_placement_);
+        });
+        connected = websocket_client_->connect(ws_url);
+    }
+    if (!connected) {
         logger_->error("Failed to connect WebSocket for market data");
         running_.store(false);
         return;
     }
 
-    websocket_client_->subscribeOrderBook(trading_symbol_, 10, 100);
-    market_data_feed_->start(trading_symbol_, market_data_queue_);
-    std::cout << trading_symbol_ << " market data connected" << std::endl;
-
-    order_engine_thread_ = std::thread(&HFTEngine::order_engine_worker, this);
+    for (const auto& symbol : trading_symbols_) {
+        websocket_client_->subscribeOrderBook(symbol, 10, 100);
+    }
+    if (coinbase_gateway_) {
+        if (!coinbase_gateway_->start()) {
+            logger_->error("Failed to start the Coinbase order gateway");
+            websocket_client_->disconnect();
+            running_.store(false);
+            return;
+        }
+        websocket_client_->subscribeUser({trading_symbol_});
+    }
+    if (hot_loop) {
+        std::visit([this](auto& strategy) {
+            market_data_feed_->start(trading_symbol_, [this, &strategy](HFTMarketData& market_data) {
+                handle_tick(strategy, market_data, market_data.trace.book_updated_tsc);
+            });
+        }, strategy_);
+    } else if (!shards_.empty()) {
+        session_start_ = std::chrono::system_clock::now();
+        for (size_t i = 0; i < shards_.size(); ++i) {
+            shards_[i]->start(shard_placements_[i], order_engine_idle_, &risk_wake_);
+        }
+        // Feed dispatcher: each tick goes to the queue of the shard that owns its symbol.
+        const auto shard_count = static_cast<uint32_t>(shards_.size());
+        market_data_feed_->start(trading_symbols_, [this, shard_count](HFTMarketData& market_data) {
+            shards_[EngineShard::shard_of(market_data.symbol_index, shard_count)]->publish(market_data);
+            const LatencyTrace& trace = market_data.trace;
+            metrics_->metrics().latency(LatencyStage::QUEUE_PUBLISH).record(trace.enqueued_tsc - trace.book_updated_tsc);
+        });
+    } else {
+        market_data_feed_->start(trading_symbol_, market_data_queue_,
+                                 order_engine_idle_ == IdleMode::SPIN_PARK ? &order_engine_wake_ : nullptr);
+    }
+    std::cout << trading_symbols_.size() << " symbol(s) market data connected" << std::endl;
+
+    if (shards_.empty()) {
+        order_engine_thread_ = std::thread([this, hot_loop] {
+            std::visit([this, hot_loop](auto& strategy) {
+                if (hot_loop) {
+                    hot_loop_worker(strategy);
+                } else {
+                    order_engine_worker(strategy);
+                }
+            }, strategy_);
+        });
+    }
     risk_thread_ = std::thread(&HFTEngine::risk_management_worker, this);
     metrics_thread_ = std::thread(&HFTEngine::metrics_worker, this);
+    Config::getInstance().startWatcher();
+
+    if (metrics_exporter_ && !metrics_exporter_->start()) {
+        logger_->warning("Metrics exporter failed to start - continuing without HTTP metrics");
+    }
 
     logger_->info("HFT Engine started - All worker threads running");
     std::cout << "Trading Engine Active" << std::endl;
@@ -92,89 +344,201 @@ void HFTEngine::stop() {
     std::cout << "Stopping HFT Engine..." << std::endl;
     logger_->info("HFT Engine shutdown initiated");
     running_.store(false);
+    stop_wake_.notify();
+    risk_wake_.notify();
+    order_engine_wake_.notify();
 
+    Config::getInstance().stopWatcher();
     if (websocket_client_) websocket_client_->disconnect();
+    if (metrics_exporter_) metrics_exporter_->stop();
 
     if (order_engine_thread_.joinable()) order_engine_thread_.join();
+    for (auto& shard : shards_) shard->stop();
+    // Cancels whatever is still working on the exchange.
+    if (coinbase_gateway_) coinbase_gateway_->stop();
+    if (jwt_signer_) jwt_signer_->stop();
     if (risk_thread_.joinable()) risk_thread_.join();
     if (metrics_thread_.joinable()) metrics_thread_.join();
 
     if (order_manager_) order_manager_->shutdown();
+    if (!shards_.empty()) write_shard_session_summary();
     metrics_->print_performance_stats();
 
     std::cout << "HFT Engine stopped" << std::endl;
     logger_->info("HFT Engine shutdown completed");
+    logger_->shutdown();
+    FlightRecorder::getInstance().stop();
+    FastClock::getInstance().stop();
 }
 
-void HFTEngine::order_engine_worker() {
+template<typename StrategyT>
+void HFTEngine::order_engine_worker(StrategyT& strategy) {
+    ThreadPlacer::applyToCurrentThread(order_engine_placement_);
     std::cout << "Order engine worker started" << std::endl;
+    FlightRecorder::setThreadName("order_engine");
     logger_->info("Order engine worker started");
 
-    auto last_order_time = std::chrono::high_resolution_clock::now();
     const auto target_interval = std::chrono::microseconds(1000000 / order_engine_hz_);
-    int idle_count = 0;
+    const uint64_t interval_ticks = FastClock::getInstance().nanosToTicks(1000000000ULL / order_engine_hz_);
+    uint64_t last_order_tsc = FastClock::now();
+    // Parking wakes on a market data push or after one requote interval.
+    IdleStrategy idle(order_engine_idle_, &order_engine_wake_, target_interval);
 
     while (running_.load(std::memory_order_relaxed)) {
-        auto now = std::chrono::high_resolution_clock::now();
+        const uint64_t now_tsc = FastClock::now();
         bool did_work = false;
-        const double order_size = order_size_.load(std::memory_order_relaxed);
-        const double pos = current_position_.load(std::memory_order_relaxed);
 
         HFTMarketData market_data{};
         if (market_data_queue_.pop(market_data)) {
             did_work = true;
-            HFTSignal signal = strategy_->generate_signal(
-                market_data.bid_price, market_data.ask_price, pos, order_size);
-            if (signal.place_bid || signal.place_ask) {
-                executor_->place_order_ladder(signal);
-            }
+            LatencyTrace& trace = market_data.trace;
+            trace.dequeued_tsc = FastClock::now();
+            metrics_->metrics().latency(LatencyStage::QUEUE_WAIT).record(trace.dequeued_tsc - trace.enqueued_tsc);
+            handle_tick(strategy, market_data, trace.dequeued_tsc);
         }
 
-        if (now - last_order_time >= target_interval) {
-            did_work = true;
-            double bid = market_data_feed_->bid();
-            double ask = market_data_feed_->ask();
-            if (bid > 0 && ask > 0) {
-                HFTSignal signal = strategy_->generate_signal(bid, ask, pos, order_size);
-                if (signal.place_bid || signal.place_ask) {
-                    executor_->place_order_ladder(signal);
-                }
+        did_work |= requote_on_timer(strategy, now_tsc, last_order_tsc, interval_ticks);
+        did_work |= drain_order_responses();
+
+        idle.idle(did_work);
+    }
+}
+
+template<typename StrategyT>
+void HFTEngine::hot_loop_worker(StrategyT& strategy) {
+    ThreadPlacer::applyToCurrentThread(order_engine_placement_);
+    std::cout << "Hot loop worker started" << std::endl;
+    FlightRecorder::setThreadName("hot_loop");
+    logger_->info("Hot loop worker started");
+
+    // Timer checked in FastClock ticks: no clock syscall per poll.
+    const uint64_t interval_ticks = FastClock::getInstance().nanosToTicks(1000000000ULL / order_engine_hz_);
+    uint64_t last_order_tsc = FastClock::now();
+    IdleStrategy idle(order_engine_idle_);
+    bool socket_ok = true;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        const uint64_t now_tsc = FastClock::now();
+        bool did_work = false;
+
+        // Ticks are traded inside poll(): parse, book update, signal and send all run here.
+        if (HFT_LIKELY(socket_ok)) {
+            const int delivered = websocket_client_->poll();
+            if (HFT_UNLIKELY(delivered < 0)) {
+                // Same as the pipeline losing its websocket thread: keep working orders serviced.
+                logger_->error("Market data socket failed - hot loop no longer polling");
+                socket_ok = false;
             }
-            last_order_time = now;
+            did_work = delivered > 0;
         }
 
-        HFTOrder response{};
-        while (executor_->pop_response(response)) {
-            did_work = true;
-            executor_->process_order_response(response);
-        }
+        did_work |= requote_on_timer(strategy, now_tsc, last_order_tsc, interval_ticks);
+        did_work |= drain_order_responses();
 
-        if (!did_work) {
-            if (++idle_count < kIdleSpinFallbackThreshold) {
-                for (int i = 0; i < kIdleSpinCount; ++i) HFT_CPU_RELAX();
-            } else {
-                std::this_thread::yield();
-            }
-        } else {
-            idle_count = 0;
+        idle.idle(did_work);
+    }
+}
+
+// Strategy and execution for one tick; strategy_start_tsc is where the SIGNAL stage begins
+// (the dequeue in pipeline mode, the book update in hot-loop mode).
+template<typename StrategyT>
+void HFTEngine::handle_tick(StrategyT& strategy, HFTMarketData& market_data, uint64_t strategy_start_tsc) {
+    LatencyTrace& trace = market_data.trace;
+    executor_->on_book(market_data.bid_price, market_data.ask_price);
+    StrategyInput input;
+    input.bid = market_data.bid_price;
+    input.ask = market_data.ask_price;
+    input.fair_value = fair_value_.update(market_data);
+    input.position = current_position_.load(std::memory_order_relaxed);
+    input.order_size = order_size_.load(std::memory_order_relaxed);
+    input.book_tsc = trace.book_updated_tsc;
+    input.config = Config::snapshot();
+    HFTSignal signal = strategy.on_tick(input);
+    trace.signal_tsc = FastClock::now();
+    metrics_->metrics().latency(LatencyStage::SIGNAL).record(trace.signal_tsc - strategy_start_tsc);
+
+    if (signal.place_bid || signal.place_ask) {
+        executor_->place_order_ladder(signal, trace);
+    }
+}
+
+template<typename StrategyT>
+bool HFTEngine::requote_on_timer(StrategyT& strategy, uint64_t now_tsc, uint64_t& last_order_tsc,
+                                 uint64_t interval_ticks) {
+    if (now_tsc - last_order_tsc < interval_ticks) return false;
+
+    double bid = market_data_feed_->bid();
+    double ask = market_data_feed_->ask();
+    if (bid > 0 && ask > 0) {
+        StrategyInput input;
+        input.bid = bid;
+        input.ask = ask;
+        input.fair_value = fair_value_.center(bid, ask);
+        input.position = current_position_.load(std::memory_order_relaxed);
+        input.order_size = order_size_.load(std::memory_order_relaxed);
+        input.config = Config::snapshot();
+        HFTSignal signal = strategy.requote(input);
+        if (signal.place_bid || signal.place_ask) {
+            // Timer-driven requote: no tick to trace back to the socket.
+            LatencyTrace trace;
+            trace.signal_tsc = FastClock::now();
+            executor_->place_order_ladder(signal, trace);
         }
     }
+    last_order_tsc = now_tsc;
+    return true;
+}
+
+bool HFTEngine::drain_order_responses() {
+    // Every pass, so a breach pulls the working orders within one loop iteration.
+    bool did_work = executor_->check_breach();
+    HFTOrder response{};
+    bool fills = false;
+    while (executor_->pop_response(response)) {
+        did_work = true;
+        fills |= response.status == 'F';
+        executor_->process_order_response(response);
+    }
+    // Only fills move risk; acks, rejects and cancels leave it to the timer.
+    if (fills) risk_wake_.notify();
+    return did_work;
 }
 
 void HFTEngine::risk_management_worker() {
+    ThreadPlacer::applyToCurrentThread(risk_placement_);
     std::cout << "Risk management worker started" << std::endl;
+    FlightRecorder::setThreadName("risk");
     logger_->info("Risk management worker started");
 
-    double last_pnl = 0.0;
-
+    // Taken before each round of checks so a fill or stop during them cuts the wait short.
+    uint32_t wake_epoch = risk_wake_.epoch();
+    bool breach_notified = false;
     while (running_.load()) {
-        double pos = current_position_.load();
+        // Reloaded sizing applies to the next ladder; strategy, executor and risk limits read
+        // the snapshot themselves.
+        const ConfigSnapshot* config = Config::snapshot();
+        if (HFT_UNLIKELY(config != applied_config_)) {
+            applied_config_ = config;
+            order_size_.store(config->order_size);
+            max_position_.store(config->max_inventory);
+            HFT_LOG_INFO("Config snapshot v{} applied: order size {}, max position {}",
+                         config->version, config->order_size, config->max_inventory);
+        }
+
+        // Positions and PnL arrive as per-fill deltas; limits are checked as each one is applied.
+        risk_manager_->processRiskDeltas();
+
+        // Shards are read through their published snapshots and position atomics only.
+        const double pos = shards_.empty() ? current_position_.load() : aggregate_shards().net_position;
         metrics_->metrics().current_position.store(pos);
-        risk_manager_->updatePosition(trading_symbol_, pos);
 
         if (risk_manager_->isCircuitBreakerActive()) {
             logger_->error("Circuit breaker is active - stopping trading");
             std::cout << "RISK BREACH: Circuit breaker active!" << std::endl;
+            if (risk_manager_->getBreachDeltaIndex() != 0) {
+                HFT_LOG_ERROR("Circuit breaker tripped {} ns after the fill that breached",
+                              FastClock::getInstance().ticksToNanos(risk_manager_->getBreachLatencyTicks()));
+            }
             emergency_stop();
             break;
         }
@@ -187,40 +551,129 @@ void HFTEngine::risk_management_worker() {
             break;
         }
 
+        // Trading stops only when no symbol can be traded in either direction.
         std::string rejection_reason;
-        bool can_buy = risk_manager_->canPlaceOrder(trading_symbol_, "BUY",
-            market_data_feed_->ask(), order_size_.load(), rejection_reason);
-        bool can_sell = risk_manager_->canPlaceOrder(trading_symbol_, "SELL",
-            market_data_feed_->bid(), order_size_.load(), rejection_reason);
+        bool tradeable = false;
+        for (size_t i = 0; i < trading_symbols_.size(); ++i) {
+            bool can_buy = risk_manager_->canTrade(trading_symbol_ids_[i], Side::BUY,
+                market_data_feed_->ask(i), order_size_.load(), rejection_reason);
+            bool can_sell = risk_manager_->canTrade(trading_symbol_ids_[i], Side::SELL,
+                market_data_feed_->bid(i), order_size_.load(), rejection_reason);
+            tradeable |= can_buy || can_sell;
+        }
 
-        if (!can_buy && !can_sell) {
-            logger_->warning("Risk limits preventing all trading: " + rejection_reason);
+        if (!tradeable) {
+            HFT_LOG_WARNING("Risk limits preventing all trading: {}", rejection_reason);
             risk_breach_.store(true);
         } else {
             risk_breach_.store(false);
         }
 
-        double current_pnl = order_manager_->getCurrentPnL();
-        double pnl_delta = current_pnl - last_pnl;
-        if (std::abs(pnl_delta) > 0.001) {
-            risk_manager_->updatePnL(pnl_delta);
-            last_pnl = current_pnl;
-        }
+        // A parked order engine wakes to cancel at once rather than at its next requote.
+        const bool breached = risk_breach_.load();
+        if (breached && !breach_notified) order_engine_wake_.notify();
+        breach_notified = breached;
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        // Fills wake the thread at once; the timeout keeps the time-based checks running.
+        risk_wake_.wait(wake_epoch, std::chrono::milliseconds(100));
+        wake_epoch = risk_wake_.epoch();
     }
 }
 
 void HFTEngine::metrics_worker() {
+    ThreadPlacer::applyToCurrentThread(metrics_placement_);
+    uint32_t wake_epoch = stop_wake_.epoch();
     while (running_.load()) {
+        if (!shards_.empty()) {
+            // Shards count into their own blocks; fold them into the exported one.
+            const ShardSnapshot totals = aggregate_shards();
+            AtomicHFTMetrics& metrics = metrics_->metrics();
+            metrics.orders_placed.store(totals.orders_placed, std::memory_order_relaxed);
+            metrics.quotes_marketable.store(totals.quotes_marketable, std::memory_order_relaxed);
+            metrics.quotes_self_cross.store(totals.quotes_self_cross, std::memory_order_relaxed);
+            metrics.orders_filled.store(totals.fills, std::memory_order_relaxed);
+            metrics.total_pnl.store(totals.pnl, std::memory_order_relaxed);
+        }
         metrics_->tick();
-        std::this_thread::sleep_for(std::chrono::seconds(1));
+        stop_wake_.wait(wake_epoch, std::chrono::seconds(1));
+        wake_epoch = stop_wake_.epoch();
     }
 }
 
 void HFTEngine::emergency_stop() {
     std::cout << "EMERGENCY STOP TRIGGERED!" << std::endl;
     logger_->error("Emergency stop triggered");
+    FlightRecorder::record(FlightEventType::EMERGENCY_STOP);
+    // A breach has already requested its own dump.
+    if (!risk_manager_->isCircuitBreakerActive()) {
+        FlightRecorder::getInstance().requestDump("emergency_stop");
+    }
     risk_breach_.store(true);
+    for (auto& shard : shards_) shard->request_stop();
     running_.store(false);
+    order_engine_wake_.notify();
+    stop_wake_.notify();
+}
+
+ShardSnapshot HFTEngine::aggregate_shards() const {
+    ShardSnapshot totals;
+    for (const auto& shard : shards_) totals.add(shard->snapshot());
+    return totals;
+}
+
+void HFTEngine::write_shard_session_summary() const {
+    // Shards publish a final snapshot on exit, so this runs after they are joined.
+    const ShardSnapshot totals = aggregate_shards();
+    const auto session_end = std::chrono::system_clock::now();
+    const double duration_seconds = static_cast<double>(
+        std::chrono::duration_cast<std::chrono::seconds>(session_end - session_start_).count());
+
+    const auto start_time_t = std::chrono::system_clock::to_time_t(session_start_);
+    const auto end_time_t = std::chrono::system_clock::to_time_t(session_end);
+    struct tm start_tm{};
+    struct tm end_tm{};
+    localtime_r(&start_time_t, &start_tm);
+    localtime_r(&end_time_t, &end_tm);
+
+    std::ostringstream summary;
+    summary << "\n" << std::string(80, '=') << std::endl;
+    summary << "                    HFT TRADING SESSION SUMMARY" << std::endl;
+    summary << std::string(80, '=') << std::endl;
+    summary << std::put_time(&start_tm, "Session Start: %Y-%m-%d %H:%M:%S") << std::endl;
+    summary << std::put_time(&end_tm, "Session End:   %Y-%m-%d %H:%M:%S") << std::endl;
+    summary << "Duration: " << duration_seconds << " seconds ("
+            << std::fixed << std::setprecision(2) << duration_seconds / 60.0 << " minutes)" << std::endl;
+    summary << "Symbols: " << trading_symbols_.size() << " over " << shards_.size() << " shards" << std::endl;
+
+    summary << "\nTRADING PERFORMANCE:" << std::endl;
+    summary << "  Total Trades: " << totals.fills << std::endl;
+    summary << "  Ticks:        " << totals.ticks << std::endl;
+    if (duration_seconds > 0) {
+        summary << "  Trade Rate:   " << std::fixed << std::setprecision(2)
+                << (totals.fills / duration_seconds) << " trades/sec" << std::endl;
+    }
+
+    summary << "\nPROFIT & LOSS:" << std::endl;
+    summary << "  Net Position:     " << std::fixed << std::setprecision(8) << totals.net_position << std::endl;
+    summary << "  Gross Position:   " << std::fixed << std::setprecision(8) << totals.gross_position << std::endl;
+    summary << "  Cumulative PnL:   $" << std::fixed << std::setprecision(4) << totals.pnl << std::endl;
+    if (totals.fills > 0) {
+        summary << "  PnL per Trade:    $" << std::fixed << std::setprecision(6)
+                << (totals.pnl / totals.fills) << std::endl;
+    }
+
+    summary << "\nSYSTEM STATS:" << std::endl;
+    summary << "  Orders Placed: " << totals.orders_placed << std::endl;
+    summary << "  Orders Filled: " << totals.fills << std::endl;
+    if (totals.orders_placed > 0) {
+        summary << "  Fill Rate:     " << std::fixed << std::setprecision(1)
+                << (totals.fills * 100.0 / totals.orders_placed) << "%" << std::endl;
+    }
+    summary << "  Marketable Quotes: " << totals.quotes_marketable
+            << " | Self-Cross Quotes: " << totals.quotes_self_cross << std::endl;
+    summary << std::string(80, '=') << std::endl;
+
+    OrderManager::writeSessionSummary(summary.str());
+    std::cout << "Total Trades: " << totals.fills << " | PnL: $" << std::fixed << std::setprecision(4) << totals.pnl
+              << " | Duration: " << duration_seconds << "s" << std::endl;
 }
@@ -0,0 +1,209 @@
+#include "engine_shard.h"
+#include "core/config.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
+#include "execution/executor.h"
+#include "metrics/metrics.h"
+#include "order/order_manager.h"
+#include <iostream>
+#include <cmath>
+
+EngineShard::EngineShard(uint32_t id, uint32_t shard_count, std::vector<std::string> symbols,
+                         std::atomic<bool>& risk_breach, std::atomic<double>& max_position,
+                         std::atomic<double>& order_size, int order_engine_hz, StrategyKind strategy)
+    : id_(id)
+    , shard_count_(shard_count)
+    , symbols_(std::move(symbols))
+    , metrics_(std::make_unique<AtomicHFTMetrics>())
+    , strategies_(withStrategyType(strategy, [count = symbols_.size()](auto tag) {
+          return RegisteredStrategies::VariantOf<std::vector>(std::vector<typename decltype(tag)::type>(count));
+      }))
+    , order_size_(order_size)
+    , requote_interval_(1000000 / std::max(1, order_engine_hz))
+    , queue_(std::make_unique<SPSCQueue<HFTMarketData, 1024>>())
+{
+    for (const auto& symbol : symbols_) {
+        auto slot = std::make_unique<SymbolSlot>();
+        slot->symbol = symbol;
+        slot->order_manager = std::make_unique<OrderManager>();
+        // The engine writes one summary over all shards at stop.
+        slot->order_manager->setSessionSummary(false);
+        slot->executor = std::make_unique<OrderExecutor>(
+            symbol, *slot->order_manager, *metrics_, slot->position, risk_breach, max_position);
+        books_.push_back(std::move(slot));
+    }
+}
+
+EngineShard::~EngineShard() {
+    stop();
+}
+
+std::vector<std::string> EngineShard::partition(const std::vector<std::string>& symbols,
+                                                uint32_t id, uint32_t shard_count) {
+    std::vector<std::string> owned;
+    for (size_t i = id; i < symbols.size(); i += shard_count) owned.push_back(symbols[i]);
+    return owned;
+}
+
+void EngineShard::set_risk_deltas(RiskDeltaQueue* risk_deltas) {
+    for (auto& slot : books_) slot->executor->set_risk_deltas(risk_deltas);
+}
+
+bool EngineShard::publish(HFTMarketData& market_data) {
+    market_data.trace.enqueued_tsc = FastClock::now();
+    if (HFT_UNLIKELY(!queue_->push(market_data))) return false;
+    if (parking_) wake_.notify();
+    return true;
+}
+
+void EngineShard::start(const ThreadPlacement& placement, IdleMode idle_mode, WakeSignal* fill_signal) {
+    if (running_.exchange(true)) return;
+    idle_mode_ = idle_mode;
+    parking_ = idle_mode == IdleMode::SPIN_PARK;
+    fill_signal_ = fill_signal;
+    placement_ = placement;
+    if (placement_.name.empty()) placement_.name = "shard" + std::to_string(id_);
+    thread_ = std::thread(&EngineShard::run, this);
+}
+
+void EngineShard::stop() {
+    request_stop();
+    if (thread_.joinable()) thread_.join();
+}
+
+void EngineShard::run() {
+    ThreadPlacer::applyToCurrentThread(placement_);
+    const std::string name = "shard" + std::to_string(id_);
+    FlightRecorder::setThreadName(name.c_str());
+    std::cout << "Engine shard " << id_ << " started (" << symbols_.size() << " symbols)" << std::endl;
+    std::visit([this](auto& strategies) { run_loop(strategies); }, strategies_);
+}
+
+template<typename StrategyT>
+void EngineShard::run_loop(std::vector<StrategyT>& strategies) {
+    // Timer checked in FastClock ticks: no clock syscall per pass.
+    const uint64_t requote_ticks = FastClock::getInstance().nanosToTicks(
+        static_cast<uint64_t>(std::chrono::nanoseconds(requote_interval_).count()));
+    uint64_t last_requote = FastClock::now();
+    // Parking wakes on publish() or after one requote interval.
+    IdleStrategy idle(idle_mode_, &wake_, requote_interval_);
+    bool published = true;
+
+    while (running_.load(std::memory_order_relaxed)) {
+        const uint64_t now = FastClock::now();
+        bool did_work = false;
+
+        HFTMarketData market_data{};
+        if (queue_->pop(market_data)) {
+            did_work = true;
+            handle_tick(strategies, market_data);
+        }
+
+        if (now - last_requote >= requote_ticks) {
+            did_work = true;
+            requote_all(strategies);
+            publish_snapshot();
+            last_requote = now;
+        }
+
+        did_work |= drain_order_responses();
+
+        // Publish once the queue drains so readers see totals without waiting for the timer.
+        if (!did_work && !published) {
+            publish_snapshot();
+            published = true;
+        } else if (did_work) {
+            published = false;
+        }
+        idle.idle(did_work);
+    }
+    drain_order_responses();
+    publish_snapshot();
+}
+
+template<typename StrategyT>
+void EngineShard::handle_tick(std::vector<StrategyT>& strategies, HFTMarketData& market_data) {
+    LatencyTrace& trace = market_data.trace;
+    trace.dequeued_tsc = FastClock::now();
+    metrics_->latency(LatencyStage::QUEUE_WAIT).record(trace.dequeued_tsc - trace.enqueued_tsc);
+    ++ticks_;
+
+    const uint32_t slot_index = slot_of(market_data.symbol_index, shard_count_);
+    if (HFT_UNLIKELY(slot_index >= books_.size())) return;
+    SymbolSlot& slot = *books_[slot_index];
+    slot.last_bid = market_data.bid_price;
+    slot.last_ask = market_data.ask_price;
+
+    StrategyInput input;
+    input.bid = market_data.bid_price;
+    input.ask = market_data.ask_price;
+    input.fair_value = slot.fair_value.update(market_data);
+    input.position = slot.position.load(std::memory_order_relaxed);
+    input.order_size = order_size_.load(std::memory_order_relaxed);
+    input.book_tsc = trace.book_updated_tsc;
+    input.config = Config::snapshot();
+    HFTSignal signal = strategies[slot_index].on_tick(input);
+    trace.signal_tsc = FastClock::now();
+    metrics_->latency(LatencyStage::SIGNAL).record(trace.signal_tsc - trace.dequeued_tsc);
+
+    if (signal.place_bid || signal.place_ask) {
+        slot.executor->place_order_ladder(signal, trace);
+    }
+}
+
+// Timer-driven requote of every symbol that has a book; no tick to trace back to the socket.
+template<typename StrategyT>
+void EngineShard::requote_all(std::vector<StrategyT>& strategies) {
+    StrategyInput input;
+    input.order_size = order_size_.load(std::memory_order_relaxed);
+    input.config = Config::snapshot();
+    for (size_t i = 0; i < books_.size(); ++i) {
+        SymbolSlot* slot = books_[i].get();
+        if (slot->last_bid <= 0.0 || slot->last_ask <= 0.0) continue;
+        input.bid = slot->last_bid;
+        input.ask = slot->last_ask;
+        input.fair_value = slot->fair_value.center(slot->last_bid, slot->last_ask);
+        input.position = slot->position.load(std::memory_order_relaxed);
+        HFTSignal signal = strategies[i].requote(input);
+        if (signal.place_bid || signal.place_ask) {
+            LatencyTrace trace;
+            trace.signal_tsc = FastClock::now();
+            slot->executor->place_order_ladder(signal, trace);
+        }
+    }
+}
+
+bool EngineShard::drain_order_responses() {
+    bool did_work = false;
+    bool fills = false;
+    HFTOrder response{};
+    for (auto& slot : books_) {
+        // Every pass, so a breach pulls the working orders within one loop iteration.
+        did_work |= slot->executor->check_breach();
+        while (slot->executor->pop_response(response)) {
+            did_work = true;
+            fills |= response.status == 'F';
+            slot->executor->process_order_response(response);
+        }
+    }
+    // Only fills move risk; acks, rejects and cancels leave it to the timer.
+    if (fills && fill_signal_) fill_signal_->notify();
+    return did_work;
+}
+
+void EngineShard::publish_snapshot() {
+    ShardSnapshot snapshot;
+    for (const auto& slot : books_) {
+        const double position = slot->position.load(std::memory_order_relaxed);
+        snapshot.pnl += slot->order_manager->getCurrentPnL();
+        snapshot.net_position += position;
+        snapshot.gross_position += std::abs(position);
+    }
+    snapshot.ticks = ticks_;
+    snapshot.orders_placed = metrics_->orders_placed.load(std::memory_order_relaxed);
+    snapshot.fills = metrics_->orders_filled.load(std::memory_order_relaxed);
+    snapshot.quotes_marketable = metrics_->quotes_marketable.load(std::memory_order_relaxed);
+    snapshot.quotes_self_cross = metrics_->quotes_self_cross.load(std::memory_order_relaxed);
+    snapshot.published_tsc = FastClock::now();
+    snapshot_.store(snapshot);
+}
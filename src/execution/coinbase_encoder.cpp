@@ -0,0 +1,109 @@
+#include "execution/coinbase_encoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+constexpr uint64_t POW10[] = {
+    1ull, 10ull, 100ull, 1000ull, 10000ull, 100000ull, 1000000ull, 10000000ull,
+    100000000ull, 1000000000ull, 10000000000ull, 100000000000ull, 1000000000000ull
+};
+constexpr int MAX_DECIMALS = 12;
+
+char* append(char* out, const std::string& piece) {
+    std::memcpy(out, piece.data(), piece.size());
+    return out + piece.size();
+}
+
+}  // namespace
+
+CoinbaseOrderEncoder::CoinbaseOrderEncoder(const std::string& product_id, double tick_size,
+                                           const std::string& session_prefix, bool post_only)
+    : product_id_(product_id)
+    , session_prefix_(session_prefix)
+{
+    // Enough places to write any multiple of the tick exactly: 0.01 -> 2, 0.5 -> 1, 5 -> 0.
+    int decimals = 0;
+    while (decimals < MAX_DECIMALS &&
+           std::abs(tick_size * POW10[decimals] - std::round(tick_size * POW10[decimals])) > 1e-9) {
+        ++decimals;
+    }
+    price_decimals_ = decimals;
+
+    head_ = "{\"client_order_id\":\"" + session_prefix_;
+    const std::string product = "\",\"product_id\":\"" + product_id_ + "\",\"side\":\"";
+    const std::string config = "\",\"order_configuration\":{\"limit_limit_gtc\":{\"base_size\":\"";
+    buy_side_ = product + "BUY" + config;
+    sell_side_ = product + "SELL" + config;
+    price_key_ = "\",\"limit_price\":\"";
+    tail_ = std::string("\",\"post_only\":") + (post_only ? "true" : "false") + "}}}";
+}
+
+size_t CoinbaseOrderEncoder::encode_create(const HFTOrder& order, char* out) const {
+    char* p = append(out, head_);
+    p += format_uint(order.client_order_id, p);
+    p = append(p, order.side == 'B' ? buy_side_ : sell_side_);
+    p += format_fixed(order.quantity, kSizeDecimals, p);
+    p = append(p, price_key_);
+    p += format_fixed(order.price, price_decimals_, p);
+    p = append(p, tail_);
+    return static_cast<size_t>(p - out);
+}
+
+void CoinbaseOrderEncoder::encode_cancel(const std::string* order_ids, size_t count, std::string& out) const {
+    out.assign("{\"order_ids\":[");
+    for (size_t i = 0; i < count; ++i) {
+        if (i != 0) out += ',';
+        out += '"';
+        out += order_ids[i];
+        out += '"';
+    }
+    out += "]}";
+}
+
+uint64_t CoinbaseOrderEncoder::parse_client_order_id(const char* text, size_t length) const {
+    if (length <= session_prefix_.size() ||
+        std::memcmp(text, session_prefix_.data(), session_prefix_.size()) != 0) {
+        return 0;
+    }
+    uint64_t value = 0;
+    for (size_t i = session_prefix_.size(); i < length; ++i) {
+        if (text[i] < '0' || text[i] > '9') return 0;
+        value = value * 10 + static_cast<uint64_t>(text[i] - '0');
+    }
+    return value;
+}
+
+size_t CoinbaseOrderEncoder::format_uint(uint64_t value, char* out) {
+    char digits[20];
+    size_t n = 0;
+    do {
+        digits[n++] = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    for (size_t i = 0; i < n; ++i) out[i] = digits[n - 1 - i];
+    return n;
+}
+
+size_t CoinbaseOrderEncoder::format_fixed(double value, int decimals, char* out) {
+    decimals = std::clamp(decimals, 0, MAX_DECIMALS);
+    size_t n = 0;
+    if (value < 0.0) {
+        out[n++] = '-';
+        value = -value;
+    }
+    const uint64_t scale = POW10[decimals];
+    const auto scaled = static_cast<uint64_t>(std::llround(value * static_cast<double>(scale)));
+    n += format_uint(scaled / scale, out + n);
+    if (decimals > 0) {
+        out[n++] = '.';
+        uint64_t fraction = scaled % scale;
+        for (int i = decimals - 1; i >= 0; --i) {
+            out[n + static_cast<size_t>(i)] = static_cast<char>('0' + fraction % 10);
+            fraction /= 10;
+        }
+        n += static_cast<size_t>(decimals);
+    }
+    return n;
+}
@@ -0,0 +1,347 @@
+#include "execution/coinbase_gateway.h"
+#include "core/fast_clock.h"
+#include <iostream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+
+namespace {
+
+constexpr uint64_t MAX_LOGGED_REJECTS = 10;
+constexpr double QUANTITY_EPSILON = 1e-12;
+
+// The API sends sizes and prices as strings.
+double json_number(const nlohmann::json& object, const char* key) {
+    auto it = object.find(key);
+    if (it == object.end()) return 0.0;
+    if (it->is_number()) return it->get<double>();
+    if (it->is_string()) return std::strtod(it->get_ref<const std::string&>().c_str(), nullptr);
+    return 0.0;
+}
+
+bool is_terminal(const std::string& status) {
+    return status == "FILLED" || status == "CANCELLED" || status == "EXPIRED" || status == "FAILED";
+}
+
+std::string default_session_prefix() {
+    return "hft" + std::to_string(static_cast<long long>(std::time(nullptr))) + "-";
+}
+
+}  // namespace
+
+CoinbaseGateway::CoinbaseGateway(CoinbaseGatewayOptions options, JwtSigner* signer)
+    : options_(std::move(options))
+    , signer_(signer)
+    , encoder_(options_.product_id, options_.tick_size,
+               options_.session_prefix.empty() ? default_session_prefix() : options_.session_prefix,
+               options_.post_only)
+{
+    cancel_ids_.reserve(kSlots);
+}
+
+CoinbaseGateway::~CoinbaseGateway() {
+    stop();
+}
+
+bool CoinbaseGateway::start() {
+    if (running_.load()) return true;
+    if (!connection_.open(options_.url)) return false;
+
+    if (signer_ && !signer_->hasKey()) {
+        std::cerr << "Order gateway: no API key - requests are unauthenticated" << std::endl;
+        signer_ = nullptr;
+    }
+    if (signer_) {
+        orders_token_ = signer_->track("POST " + connection_.host() + kOrdersPath);
+        cancel_token_ = signer_->track("POST " + connection_.host() + kBatchCancelPath);
+        if (orders_token_ < 0 || cancel_token_ < 0) {
+            std::cerr << "Order gateway: cannot sign request tokens" << std::endl;
+            return false;
+        }
+    }
+
+    running_.store(true);
+    sender_thread_ = std::thread(&CoinbaseGateway::sender_loop, this);
+    std::cout << "Order gateway: Coinbase order entry for " << options_.product_id << " via "
+              << options_.url << std::endl;
+    return true;
+}
+
+void CoinbaseGateway::stop() {
+    if (!running_.exchange(false)) return;
+    wake_.notify();
+    if (sender_thread_.joinable()) sender_thread_.join();
+    connection_.close();
+}
+
+bool CoinbaseGateway::send(const HFTOrder& order) {
+    if (HFT_UNLIKELY(!outbound_.push(order))) return false;
+    wake_.notify();
+    return true;
+}
+
+bool CoinbaseGateway::submit(const OrderBatch& batch) {
+    bool taken = true;
+    for (uint32_t i = 0; i < batch.count; ++i) taken &= outbound_.push(*batch.orders[i]);
+    // After the orders, so the sender has them all when it drops the levels left out.
+    if (batch.replace) {
+        HFTOrder marker;
+        marker.status = kReplaceMarker;
+        marker.order_id = batch.count > 0 ? batch.orders[0]->order_id : UINT64_MAX;
+        taken &= outbound_.push(marker);
+    }
+    wake_.notify();
+    return taken;
+}
+
+bool CoinbaseGateway::cancel_all(char side) {
+    HFTOrder marker;
+    marker.status = kCancelMarker;
+    marker.side = side;
+    if (HFT_UNLIKELY(!outbound_.push(marker))) return false;
+    wake_.notify();
+    return true;
+}
+
+bool CoinbaseGateway::poll(HFTOrder& response) {
+    return fills_.pop(response) || acks_.pop(response);
+}
+
+CoinbaseGatewayStats CoinbaseGateway::stats() const {
+    CoinbaseGatewayStats s;
+    s.requests = requests_.load(std::memory_order_relaxed);
+    s.orders_sent = orders_sent_.load(std::memory_order_relaxed);
+    s.orders_acked = orders_acked_.load(std::memory_order_relaxed);
+    s.orders_rejected = orders_rejected_.load(std::memory_order_relaxed);
+    s.cancels_sent = cancels_sent_.load(std::memory_order_relaxed);
+    s.skipped_unchanged = skipped_unchanged_.load(std::memory_order_relaxed);
+    s.coalesced = coalesced_.load(std::memory_order_relaxed);
+    s.cancel_alls = cancel_alls_.load(std::memory_order_relaxed);
+    s.fills = fills_count_.load(std::memory_order_relaxed);
+    s.send_errors = send_errors_.load(std::memory_order_relaxed);
+    s.connects = connects_.load(std::memory_order_relaxed);
+    return s;
+}
+
+void CoinbaseGateway::sender_loop() {
+    pthread_setname_np(pthread_self(), "hft-orders");
+
+    while (running_.load(std::memory_order_relaxed)) {
+        // Taken before the work check (see WakeSignal).
+        const uint32_t epoch = wake_.epoch();
+        drain_closed();
+        const bool have_orders = drain_outbound();
+        if (have_orders) flush_pending();
+        if (!have_orders) wake_.wait(epoch, kIdleWake);
+    }
+
+    // Nothing is left working on the exchange once stopped.
+    cancel_ids_.clear();
+    for (WorkingOrder& working : working_) {
+        if (!working.live) continue;
+        cancel_ids_.push_back(working.exchange_id);
+        working.live = false;
+    }
+    send_cancels();
+}
+
+bool CoinbaseGateway::drain_outbound() {
+    bool any = false;
+    HFTOrder order;
+    while (outbound_.pop(order)) {
+        if (HFT_UNLIKELY(order.status == kCancelMarker)) {
+            drop_slots(order.side, UINT64_MAX);
+            cancel_alls_.fetch_add(1, std::memory_order_relaxed);
+            return true;  // flush now; what is queued behind it waits for the next pass
+        }
+        if (order.status == kReplaceMarker) {
+            drop_slots(0, order.order_id);
+            any = true;
+            continue;
+        }
+        if (HFT_UNLIKELY(order.priority >= OrderLadder::kMaxLevels)) continue;
+        const size_t slot = 2 * order.priority + (order.side == 'S' ? 1 : 0);
+        if (has_pending_[slot]) coalesced_.fetch_add(1, std::memory_order_relaxed);
+        pending_[slot] = order;
+        has_pending_[slot] = true;
+        last_queued_[slot] = order.order_id;
+        cancel_mark_[slot] = false;
+        any = true;
+    }
+    return any;
+}
+
+// Slots on `side` whose newest order is older than `older_than` lose their pending order
+// and have their working order cancelled at the next flush.
+void CoinbaseGateway::drop_slots(char side, uint64_t older_than) {
+    for (size_t slot = 0; slot < kSlots; ++slot) {
+        if (side != 0 && side != (slot % 2 == 0 ? 'B' : 'S')) continue;
+        if (last_queued_[slot] >= older_than) continue;
+        if (has_pending_[slot]) {
+            coalesced_.fetch_add(1, std::memory_order_relaxed);
+            has_pending_[slot] = false;
+        }
+        cancel_mark_[slot] = true;
+    }
+}
+
+void CoinbaseGateway::flush_pending() {
+    const double price_epsilon = options_.tick_size * 1e-6;
+
+    cancel_ids_.clear();
+    for (size_t slot = 0; slot < kSlots; ++slot) {
+        WorkingOrder& working = working_[slot];
+        if (!has_pending_[slot]) {
+            if (cancel_mark_[slot] && working.live) {
+                cancel_ids_.push_back(working.exchange_id);
+                working.live = false;
+            }
+            cancel_mark_[slot] = false;
+            continue;
+        }
+        if (!working.live) continue;
+        const HFTOrder& order = pending_[slot];
+        if (std::abs(order.price - working.order.price) < price_epsilon &&
+            std::abs(order.quantity - working.order.quantity) < QUANTITY_EPSILON) {
+            skipped_unchanged_.fetch_add(1, std::memory_order_relaxed);
+            has_pending_[slot] = false;
+            continue;
+        }
+        cancel_ids_.push_back(working.exchange_id);
+        working.live = false;
+    }
+
+    // Cancels first, all in one request, so a replaced ladder never works twice over.
+    send_cancels();
+
+    for (size_t slot = 0; slot < kSlots; ++slot) {
+        if (!has_pending_[slot]) continue;
+        has_pending_[slot] = false;
+        send_create(pending_[slot], slot);
+    }
+    connects_.store(connection_.connects(), std::memory_order_relaxed);
+}
+
+void CoinbaseGateway::send_cancels() {
+    if (cancel_ids_.empty()) return;
+    encoder_.encode_cancel(cancel_ids_.data(), cancel_ids_.size(), cancel_body_);
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    cancels_sent_.fetch_add(cancel_ids_.size(), std::memory_order_relaxed);
+    if (!connection_.request("POST", kBatchCancelPath, authorization(cancel_token_),
+                             cancel_body_.data(), cancel_body_.size(), response_) ||
+        response_.status != 200) {
+        send_errors_.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void CoinbaseGateway::send_create(const HFTOrder& order, size_t slot) {
+    char body[CoinbaseOrderEncoder::kMaxBodyBytes];
+    const size_t length = encoder_.encode_create(order, body);
+    requests_.fetch_add(1, std::memory_order_relaxed);
+    orders_sent_.fetch_add(1, std::memory_order_relaxed);
+
+    if (!connection_.request("POST", kOrdersPath, authorization(orders_token_), body, length, response_)) {
+        send_errors_.fetch_add(1, std::memory_order_relaxed);
+        push_ack(order, 'R');
+        return;
+    }
+
+    // {"success":true,"success_response":{"order_id":"...",...}} or
+    // {"success":false,"error_response":{...}}; only these two fields are needed.
+    const std::string& r = response_.body;
+    const bool success = response_.status == 200 && r.find("\"success\":true") != std::string::npos;
+    const size_t id_key = r.find("\"order_id\":\"");
+    if (!success || id_key == std::string::npos) {
+        const uint64_t rejects = orders_rejected_.fetch_add(1, std::memory_order_relaxed) + 1;
+        if (rejects <= MAX_LOGGED_REJECTS) {
+            std::cerr << "Order gateway: order " << order.client_order_id << " rejected (HTTP "
+                      << response_.status << "): " << r.substr(0, 300) << std::endl;
+        }
+        push_ack(order, 'R');
+        return;
+    }
+
+    const size_t id_start = id_key + 12;
+    WorkingOrder& working = working_[slot];
+    working.order = order;
+    working.exchange_id.assign(r, id_start, r.find('"', id_start) - id_start);
+    drain_closed();
+    working.live = std::find(recently_closed_.begin(), recently_closed_.end(), order.client_order_id) ==
+                   recently_closed_.end();
+    orders_acked_.fetch_add(1, std::memory_order_relaxed);
+    push_ack(order, 'A');
+}
+
+void CoinbaseGateway::push_ack(HFTOrder order, char status) {
+    order.status = status;
+    // A full ring loses only the notice; working state is tracked here, not by the executor.
+    acks_.push(order);
+}
+
+void CoinbaseGateway::drain_closed() {
+    uint64_t client_order_id;
+    while (closed_.pop(client_order_id)) {
+        bool found = false;
+        for (WorkingOrder& working : working_) {
+            if (working.live && working.order.client_order_id == client_order_id) {
+                working.live = false;
+                found = true;
+            }
+        }
+        // The user channel can report an order done before its create response is read.
+        if (!found) recently_closed_[closed_count_++ % recently_closed_.size()] = client_order_id;
+    }
+}
+
+std::string_view CoinbaseGateway::authorization(int token) const {
+    return signer_ ? signer_->token(token) : std::string_view{};
+}
+
+void CoinbaseGateway::on_user_message(const nlohmann::json& message) {
+    auto events = message.find("events");
+    if (events == message.end() || !events->is_array()) return;
+    for (const auto& event : *events) {
+        auto orders = event.find("orders");
+        if (orders == event.end() || !orders->is_array()) continue;
+        const bool snapshot = event.value("type", "") == "snapshot";
+        for (const auto& update : *orders) on_order_update(update, snapshot);
+    }
+}
+
+void CoinbaseGateway::on_order_update(const nlohmann::json& update, bool snapshot) {
+    if (update.value("product_id", options_.product_id) != options_.product_id) return;
+    const std::string client_id = update.value("client_order_id", "");
+    const uint64_t client_order_id = encoder_.parse_client_order_id(client_id.data(), client_id.size());
+    if (client_order_id == 0) return;  // placed by something else
+
+    // Fills are reported as cumulative size and average price; each update's fill is the
+    // difference from the previous one. A snapshot only sets the starting point.
+    const double cumulative = json_number(update, "cumulative_quantity");
+    const double notional = cumulative * json_number(update, "avg_price");
+    FillState& state = fill_state_[client_id];
+    const double filled = cumulative - state.quantity;
+    if (!snapshot && filled > QUANTITY_EPSILON) {
+        HFTOrder fill;
+        fill.order_id = fill.client_order_id = client_order_id;
+        set_symbol(fill.symbol, options_.product_id);
+        fill.side = update.value("order_side", "") == "SELL" ? 'S' : 'B';
+        fill.price = (notional - state.notional) / filled;
+        fill.quantity = cumulative + json_number(update, "leaves_quantity");
+        fill.filled_quantity = filled;
+        fill.status = 'F';
+        fill.fill_tsc = FastClock::now();
+        // On a full ring the fill is kept in the difference and goes out with the next update.
+        if (HFT_UNLIKELY(!fills_.push(fill))) return;
+        fills_count_.fetch_add(1, std::memory_order_relaxed);
+    }
+    state.quantity = cumulative;
+    state.notional = notional;
+
+    if (is_terminal(update.value("status", ""))) {
+        fill_state_.erase(client_id);
+        closed_.push(client_order_id);
+    }
+}
@@ -1,8 +1,12 @@
 #include "execution/executor.h"
+#include "execution/sim_gateway.h"
 #include "strategy/market_maker.h"
 #include "order/order_manager.h"
 #include "metrics/metrics.h"
 #include "core/config.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
+#include "core/symbol_registry.h"
 #include "core/types.h"
 #include <iostream>
 #include <cmath>
@@ -15,143 +19,239 @@ OrderExecutor::OrderExecutor(const std::string& trading_symbol,
                              std::atomic<bool>& risk_breach,
                              std::atomic<double>& max_position)
     : trading_symbol_(trading_symbol)
+    , symbol_id_(SymbolRegistry::getInstance().intern(trading_symbol))
     , order_manager_(order_manager)
     , metrics_(metrics)
     , current_position_(current_position)
     , risk_breach_(risk_breach)
     , max_position_(max_position)
+    , gateway_(std::make_unique<SimulatedGateway>(current_position))
 {
-    std::random_device rd;
-    rng_ = std::mt19937(rd());
-    tick_size_ = Config::getInstance().getTickSize();
+    for (size_t slot = 0; slot < ladder_orders_.size(); ++slot) {
+        HFTOrder& order = ladder_orders_[slot];
+        set_symbol(order.symbol, trading_symbol_);
+        order.side = (slot % 2 == 0) ? 'B' : 'S';
+        order.status = 'N';
+        order.priority = static_cast<uint32_t>(slot / 2);
+    }
 }
 
-void OrderExecutor::place_order_ladder(const HFTSignal& signal) {
-    auto start_time = std::chrono::high_resolution_clock::now();
+void OrderExecutor::place_order_ladder(const HFTSignal& signal, const LatencyTrace& trace) {
+    dispatch_ladder(signal, trace, true);
+}
 
-    const bool breached = risk_breach_.load(std::memory_order_relaxed);
-    const double pos = current_position_.load(std::memory_order_relaxed);
-    const double max_pos = max_position_.load(std::memory_order_relaxed);
-
-    for (uint32_t level = 0; level < signal.num_levels; ++level) {
-        double level_offset = level * tick_size_ * 0.1;
-        double level_size_factor = std::max(0.1, 1.0 - level * 0.1);
-
-        if (signal.place_bid && HFT_LIKELY(!breached)) {
-            double qty = signal.bid_quantity * level_size_factor;
-            if (qty >= MIN_ORDER_QTY) {
-                HFTOrder bid = build_order('B',
-                    signal.bid_price - level_offset, qty, level);
-                if (check_position_limit(bid, pos, max_pos) && send_order(bid)) {
-                    metrics_.orders_placed.fetch_add(1, std::memory_order_relaxed);
-                }
-            }
-        }
+void OrderExecutor::submit_ladder(const HFTSignal& signal, const LatencyTrace& trace) {
+    dispatch_ladder(signal, trace, false);
+}
 
-        if (signal.place_ask && HFT_LIKELY(!breached)) {
-            double qty = signal.ask_quantity * level_size_factor;
-            if (qty >= MIN_ORDER_QTY) {
-                HFTOrder ask = build_order('S',
-                    signal.ask_price + level_offset, qty, level);
-                if (check_position_limit(ask, pos, max_pos) && send_order(ask)) {
-                    metrics_.orders_placed.fetch_add(1, std::memory_order_relaxed);
-                }
+void OrderExecutor::dispatch_ladder(const HFTSignal& signal, const LatencyTrace& trace, bool replace) {
+    const auto signal_flags = static_cast<uint16_t>(
+        (signal.place_bid ? 1u : 0u) | (signal.place_ask ? 2u : 0u) | (signal.num_levels << 2));
+    FlightRecorder::record(FlightEventType::SIGNAL, signal.bid_price, signal.ask_price, 0, signal_flags);
+
+    const uint64_t start_tsc = FastClock::now();
+    const uint32_t count = build_ladder(signal, replace);
+    const OrderLadder& ladder = ladder_builder_.ladder();
+    if (HFT_UNLIKELY((ladder.marketable | ladder.self_crosses) != 0)) {
+        metrics_.quotes_marketable.fetch_add(ladder.marketable, std::memory_order_relaxed);
+        metrics_.quotes_self_cross.fetch_add(ladder.self_crosses, std::memory_order_relaxed);
+    }
+
+    // An empty additive batch has nothing to do; an empty replacing one still cancels.
+    batch_.count = 0;
+    batch_.replace = replace;
+    if (count > 0) {
+        // Stamped here rather than in build_ladder, which then reads no clock at all.
+        const uint64_t built_tsc = FastClock::now();
+        for (uint32_t level = 0; level < ladder.levels; ++level) {
+            for (uint32_t side = 0; side < 2; ++side) {
+                if (!(side == 0 ? ladder.bid_at(level) : ladder.ask_at(level))) continue;
+                HFTOrder& order = ladder_orders_[2 * level + side];
+                order.built_tsc = built_tsc;
+                stamp_sent(order, trace);
+                batch_.orders[batch_.count++] = &order;
             }
         }
     }
+    if (count > 0 || replace) {
+        const bool taken = gateway_->submit(batch_);
+        // Tracked even if the gateway took only part of it: an order we are unsure of still
+        // keeps the other side off its price.
+        track_batch(replace);
+        if (taken && count > 0) {
+            metrics_.orders_placed.fetch_add(count, std::memory_order_relaxed);
+            record_send_latency(*batch_.orders[0]);
+        }
+    }
 
-    auto end_time = std::chrono::high_resolution_clock::now();
-    auto latency_ns = static_cast<uint64_t>(
-        std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
-    update_latency_metrics(latency_ns);
+    metrics_.latency(LatencyStage::ORDER_LADDER).record(FastClock::now() - start_tsc);
 }
 
-void OrderExecutor::process_order_response(const HFTOrder& response) {
-    if (HFT_UNLIKELY(response.status != 'F')) return;
-
-    Side side = (response.side == 'B') ? Side::BUY : Side::SELL;
-    auto result = order_manager_.placeOrder(
-        response.symbol.data(), side, response.price, response.filled_quantity);
-
-    if (HFT_UNLIKELY(!result.success)) return;
+uint32_t OrderExecutor::build_ladder(const HFTSignal& signal, bool replace) {
+    // A replacing ladder has its gateway cancel every level it does not quote before any of
+    // its orders go out, so only an additive one can meet our own working orders.
+    QuoteBounds bounds;
+    bounds.book_bid = book_bid_;
+    bounds.book_ask = book_ask_;
+    if (!replace) {
+        bounds.own_bid = working_bid();
+        bounds.own_ask = working_ask();
+    }
+    const OrderLadder& ladder = ladder_builder_.build(signal, *Config::snapshot(),
+        !risk_breach_.load(std::memory_order_relaxed),
+        current_position_.load(std::memory_order_relaxed),
+        max_position_.load(std::memory_order_relaxed), MIN_ORDER_QTY, bounds);
+    const uint32_t count = ladder.order_count();
+    if (HFT_UNLIKELY(count == 0)) return 0;
 
-    metrics_.orders_filled.fetch_add(1, std::memory_order_relaxed);
+    uint64_t order_id = next_order_id_.fetch_add(count);
+    for (uint32_t level = 0; level < ladder.levels; ++level) {
+        if (ladder.bid_at(level)) {
+            HFTOrder& bid = ladder_orders_[2 * level];
+            bid.order_id = bid.client_order_id = order_id++;
+            bid.price = ladder.bid_price[level];
+            bid.quantity = ladder.bid_quantity[level];
+        }
+        if (ladder.ask_at(level)) {
+            HFTOrder& ask = ladder_orders_[2 * level + 1];
+            ask.order_id = ask.client_order_id = order_id++;
+            ask.price = ladder.ask_price[level];
+            ask.quantity = ladder.ask_quantity[level];
+        }
+    }
+    return count;
+}
 
-    double position_change = (response.side == 'B') ? response.filled_quantity : -response.filled_quantity;
-    double old_pos = current_position_.load();
-    while (!current_position_.compare_exchange_weak(old_pos, old_pos + position_change)) {}
+// Stage latencies are taken from the first order of a ladder that reaches the wire.
+void OrderExecutor::record_send_latency(const HFTOrder& order) {
+    if (order.trace.signal_tsc != 0) {
+        metrics_.latency(LatencyStage::ORDER_BUILD).record(order.built_tsc - order.trace.signal_tsc);
+        metrics_.latency(LatencyStage::ORDER_SEND).record(order.sent_tsc - order.built_tsc);
+    }
+    if (order.trace.recv_tsc != 0) {
+        metrics_.latency(LatencyStage::TICK_TO_TRADE).record(order.sent_tsc - order.trace.recv_tsc);
+    }
+}
 
-    metrics_.total_pnl.store(order_manager_.getCurrentPnL(), std::memory_order_relaxed);
+void OrderExecutor::set_gateway(std::unique_ptr<OrderGateway> gateway) {
+    if (gateway) gateway_ = std::move(gateway);
 }
 
-bool OrderExecutor::pop_response(HFTOrder& response) {
-    return inbound_order_queue_.pop(response);
+void OrderExecutor::track_batch(bool replace) {
+    if (replace) {
+        for (uint32_t slot = 0; slot < 2 * working_levels_; ++slot) working_[slot].remaining = 0.0;
+        working_levels_ = 0;
+    }
+    for (uint32_t i = 0; i < batch_.count; ++i) {
+        const HFTOrder& order = *batch_.orders[i];
+        WorkingQuote& quote = working_[2 * order.priority + (order.side == 'S' ? 1 : 0)];
+        quote.order_id = order.order_id;
+        quote.price = order.price;
+        quote.remaining = order.quantity;
+        working_levels_ = std::max(working_levels_, order.priority + 1);
+    }
 }
 
-bool OrderExecutor::check_position_limit(const HFTOrder& order,
-                                       double current_pos,
-                                       double max_pos) const {
-    double position_change = (order.side == 'B') ? order.quantity : -order.quantity;
-    return std::abs(current_pos + position_change) <= max_pos;
+// Fills from a venue may not carry the level, so the order is found by id.
+void OrderExecutor::track_response(const HFTOrder& response) {
+    for (uint32_t slot = 0; slot < 2 * working_levels_; ++slot) {
+        WorkingQuote& quote = working_[slot];
+        if (quote.remaining <= 0.0 || quote.order_id != response.order_id) continue;
+        quote.remaining = response.status == 'F' ? quote.remaining - response.filled_quantity : 0.0;
+        if (quote.remaining < MIN_ORDER_QTY * 1e-6) quote.remaining = 0.0;
+        return;
+    }
 }
 
-HFTOrder OrderExecutor::build_order(char side, double price, double quantity, uint32_t level) {
-    HFTOrder order{};
-    order.order_id = generate_order_id();
-    order.client_order_id = order.order_id;
-    set_symbol(order.symbol, trading_symbol_);
-    order.side = side;
-    order.price = price;
-    order.quantity = quantity;
-    order.filled_quantity = 0.0;
-    order.status = 'N';
-    order.timestamp = std::chrono::high_resolution_clock::now();
-    order.order_sent_time = order.timestamp;
-    order.priority = level;
-    return order;
+void OrderExecutor::clear_working(char side) {
+    for (uint32_t slot = 0; slot < 2 * working_levels_; ++slot) {
+        if (side == 0 || side == (slot % 2 == 0 ? 'B' : 'S')) working_[slot].remaining = 0.0;
+    }
 }
 
-bool OrderExecutor::send_order(HFTOrder& order) {
-    double current_pos = current_position_.load();
-    double base_fill_probability = 0.3;
+double OrderExecutor::working_bid() const {
+    double best = 0.0;
+    for (uint32_t slot = 0; slot < 2 * working_levels_; slot += 2) {
+        if (working_[slot].remaining > 0.0) best = std::max(best, working_[slot].price);
+    }
+    return best;
+}
 
-    if ((order.side == 'S' && current_pos > 0.01) ||
-        (order.side == 'B' && current_pos < -0.01)) {
-        base_fill_probability *= 1.8;
+double OrderExecutor::working_ask() const {
+    double best = 0.0;
+    for (uint32_t slot = 1; slot < 2 * working_levels_; slot += 2) {
+        if (working_[slot].remaining > 0.0 && (best == 0.0 || working_[slot].price < best)) {
+            best = working_[slot].price;
+        }
     }
+    return best;
+}
 
-    if ((order.side == 'B' && current_pos > 0.01) ||
-        (order.side == 'S' && current_pos < -0.01)) {
-        base_fill_probability *= 0.4;
+void OrderExecutor::process_order_response(const HFTOrder& response) {
+    if (response.status == 'R' || response.status == 'C' || response.status == 'F') track_response(response);
+    if (HFT_UNLIKELY(response.status == 'R')) {
+        ++rejected_orders_;
+        FlightRecorder::record(FlightEventType::ORDER_REJECT, response.price, response.quantity,
+                               static_cast<uint32_t>(response.order_id), static_cast<uint16_t>(response.side));
+        return;
+    }
+    if (response.status == 'C') {
+        ++cancelled_orders_;
+        return;
     }
+    if (response.status != 'F') return;
 
-    base_fill_probability = std::min(base_fill_probability, 0.65);
+    Side side = (response.side == 'B') ? Side::BUY : Side::SELL;
+    auto result = order_manager_.placeOrder(
+        response.symbol.data(), side, response.price, response.filled_quantity);
 
-    if (fill_distribution_(rng_) < base_fill_probability) {
-        HFTOrder filled_order = order;
-        filled_order.status = 'F';
-        filled_order.filled_quantity = filled_order.quantity;
-        filled_order.fill_time = std::chrono::high_resolution_clock::now();
-        inbound_order_queue_.push(filled_order);
-    }
+    if (HFT_UNLIKELY(!result.success)) return;
+
+    metrics_.orders_filled.fetch_add(1, std::memory_order_relaxed);
+    FlightRecorder::record(FlightEventType::FILL, response.price, response.filled_quantity,
+                           static_cast<uint32_t>(response.order_id), static_cast<uint16_t>(response.side));
+
+    double position_change = (response.side == 'B') ? response.filled_quantity : -response.filled_quantity;
+    double old_pos = current_position_.load();
+    while (!current_position_.compare_exchange_weak(old_pos, old_pos + position_change)) {}
+
+    const double pnl = order_manager_.getCurrentPnL();
+    metrics_.total_pnl.store(pnl, std::memory_order_relaxed);
 
-    return true;
+    if (risk_deltas_ && symbol_id_ != SymbolRegistry::kInvalidId) {
+        RiskDelta delta;
+        delta.symbol_id = symbol_id_;
+        delta.position = old_pos + position_change;
+        delta.price = response.price;
+        delta.realized_pnl = pnl;
+        delta.fill_tsc = response.fill_tsc != 0 ? response.fill_tsc : FastClock::now();
+        // A full ring only delays risk: the next delta carries the same absolute values.
+        if (HFT_UNLIKELY(!risk_deltas_->push(delta))) ++dropped_risk_deltas_;
+    }
 }
 
-uint64_t OrderExecutor::generate_order_id() {
-    return next_order_id_.fetch_add(1);
+bool OrderExecutor::pop_response(HFTOrder& response) {
+    return gateway_->poll(response);
 }
 
-void OrderExecutor::update_latency_metrics(uint64_t latency_ns) {
-    uint64_t current_min = metrics_.min_order_latency_ns.load();
-    while (latency_ns < current_min && !metrics_.min_order_latency_ns.compare_exchange_weak(current_min, latency_ns)) {}
+void OrderExecutor::stamp_sent(HFTOrder& order, const LatencyTrace& trace) {
+    order.trace = trace;
+    order.sent_tsc = FastClock::now();
+    FlightRecorder::record(FlightEventType::ORDER_SENT, order.price, order.quantity,
+                           static_cast<uint32_t>(order.order_id), static_cast<uint16_t>(order.side));
+}
 
-    uint64_t current_max = metrics_.max_order_latency_ns.load();
-    while (latency_ns > current_max && !metrics_.max_order_latency_ns.compare_exchange_weak(current_max, latency_ns)) {}
+bool OrderExecutor::cancel_all(char side) {
+    FlightRecorder::record(FlightEventType::CANCEL_ALL, 0.0, 0.0, 0, static_cast<uint16_t>(side));
+    clear_working(side);
+    return gateway_->cancel_all(side);
+}
 
-    uint64_t current_avg = metrics_.avg_order_latency_ns.load();
-    uint64_t new_avg = current_avg == 0
-        ? latency_ns
-        : static_cast<uint64_t>(current_avg * 0.95 + latency_ns * 0.05);
-    metrics_.avg_order_latency_ns.store(new_avg);
+bool OrderExecutor::check_breach() {
+    const bool breached = risk_breach_.load(std::memory_order_relaxed);
+    if (HFT_LIKELY(breached == breach_cancelled_)) return false;
+    // A gateway that could not take the cancel is asked again on the next pass.
+    if (breached && !cancel_all(0)) return false;
+    breach_cancelled_ = breached;
+    return breached;
 }
@@ -0,0 +1,258 @@
+#include "execution/https_connection.h"
+#include <iostream>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int IO_TIMEOUT_SECONDS = 5;
+constexpr size_t MAX_RESPONSE_BYTES = 1 << 20;
+
+bool iequals_prefix(const char* text, const char* prefix) {
+    for (; *prefix; ++text, ++prefix) {
+        if (std::tolower(static_cast<unsigned char>(*text)) != std::tolower(static_cast<unsigned char>(*prefix))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+HttpsConnection::~HttpsConnection() {
+    close();
+    if (ssl_ctx_) SSL_CTX_free(ssl_ctx_);
+}
+
+bool HttpsConnection::open(const std::string& url) {
+    close();
+    std::string remaining;
+    if (url.rfind("https://", 0) == 0) {
+        tls_ = true;
+        port_ = 443;
+        remaining = url.substr(8);
+    } else if (url.rfind("http://", 0) == 0) {
+        tls_ = false;
+        port_ = 80;
+        remaining = url.substr(7);
+    } else {
+        std::cerr << "Order gateway: unsupported URL " << url << std::endl;
+        return false;
+    }
+
+    remaining = remaining.substr(0, remaining.find('/'));
+    const size_t colon = remaining.find(':');
+    if (colon != std::string::npos) {
+        port_ = std::atoi(remaining.c_str() + colon + 1);
+        remaining.resize(colon);
+    }
+    host_ = remaining;
+    if (host_.empty() || port_ <= 0 || port_ > 65535) {
+        std::cerr << "Order gateway: invalid URL " << url << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void HttpsConnection::close() {
+    if (ssl_) {
+        SSL_shutdown(ssl_);
+        SSL_free(ssl_);
+        ssl_ = nullptr;
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    rx_.clear();
+}
+
+bool HttpsConnection::connect() {
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* result = nullptr;
+    const std::string port = std::to_string(port_);
+    if (::getaddrinfo(host_.c_str(), port.c_str(), &hints, &result) != 0) {
+        std::cerr << "Order gateway: cannot resolve " << host_ << std::endl;
+        return false;
+    }
+
+    for (addrinfo* ai = result; ai != nullptr && fd_ < 0; ai = ai->ai_next) {
+        int fd = ::socket(ai->ai_family, ai->ai_socktype | SOCK_CLOEXEC, ai->ai_protocol);
+        if (fd < 0) continue;
+        if (::connect(fd, ai->ai_addr, ai->ai_addrlen) == 0) {
+            fd_ = fd;
+        } else {
+            ::close(fd);
+        }
+    }
+    ::freeaddrinfo(result);
+    if (fd_ < 0) {
+        std::cerr << "Order gateway: cannot connect to " << host_ << ":" << port_ << std::endl;
+        return false;
+    }
+
+    int nodelay = 1;
+    ::setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    timeval timeout{IO_TIMEOUT_SECONDS, 0};
+    ::setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    ::setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    if (tls_) {
+        if (!ssl_ctx_) {
+            ssl_ctx_ = SSL_CTX_new(TLS_client_method());
+            if (!ssl_ctx_) return false;
+            SSL_CTX_set_min_proto_version(ssl_ctx_, TLS1_2_VERSION);
+            SSL_CTX_set_default_verify_paths(ssl_ctx_);
+            SSL_CTX_set_verify(ssl_ctx_, SSL_VERIFY_PEER, nullptr);
+        }
+        ssl_ = SSL_new(ssl_ctx_);
+        SSL_set_fd(ssl_, fd_);
+        SSL_set_tlsext_host_name(ssl_, host_.c_str());
+        SSL_set1_host(ssl_, host_.c_str());
+        if (SSL_connect(ssl_) != 1) {
+            char error[256];
+            ERR_error_string_n(ERR_get_error(), error, sizeof(error));
+            std::cerr << "Order gateway: TLS handshake with " << host_ << " failed: " << error << std::endl;
+            close();
+            return false;
+        }
+    }
+
+    keep_alive_ = true;
+    ++connects_;
+    return true;
+}
+
+bool HttpsConnection::request(const char* method, const std::string& path, std::string_view authorization,
+                              const char* body, size_t body_length, HttpResponse& response) {
+    ++requests_;
+    const bool reused = connected();
+    if (!reused && !connect()) return false;
+    if (exchange(method, path, authorization, body, body_length, response)) return true;
+
+    close();
+    // Order creates are idempotent on client_order_id, so resending after a stale
+    // keep-alive connection cannot double an order.
+    if (!reused || !connect()) return false;
+    if (exchange(method, path, authorization, body, body_length, response)) return true;
+    close();
+    return false;
+}
+
+bool HttpsConnection::exchange(const char* method, const std::string& path, std::string_view authorization,
+                               const char* body, size_t body_length, HttpResponse& response) {
+    tx_.clear();
+    tx_ += method; tx_ += ' '; tx_ += path; tx_ += " HTTP/1.1\r\n";
+    tx_ += "Host: "; tx_ += host_; tx_ += "\r\n";
+    if (!authorization.empty()) {
+        tx_ += "Authorization: Bearer "; tx_ += authorization; tx_ += "\r\n";
+    }
+    tx_ += "Content-Type: application/json\r\nAccept: application/json\r\nConnection: keep-alive\r\n";
+    tx_ += "Content-Length: "; tx_ += std::to_string(body_length); tx_ += "\r\n\r\n";
+    tx_.append(body, body_length);
+
+    if (!write_all(tx_.data(), tx_.size()) || !read_response(response)) return false;
+    if (!keep_alive_) close();
+    return true;
+}
+
+bool HttpsConnection::write_all(const char* data, size_t length) {
+    while (length > 0) {
+        ssize_t n;
+        if (ssl_) {
+            n = SSL_write(ssl_, data, static_cast<int>(length));
+        } else {
+            n = ::send(fd_, data, length, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+        }
+        if (n <= 0) return false;
+        data += n;
+        length -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+bool HttpsConnection::read_more() {
+    char buf[8192];
+    ssize_t n;
+    do {
+        n = ssl_ ? SSL_read(ssl_, buf, sizeof(buf)) : ::recv(fd_, buf, sizeof(buf), 0);
+    } while (n < 0 && !ssl_ && errno == EINTR);
+    if (n <= 0 || rx_.size() + static_cast<size_t>(n) > MAX_RESPONSE_BYTES) return false;
+    rx_.append(buf, static_cast<size_t>(n));
+    return true;
+}
+
+bool HttpsConnection::read_response(HttpResponse& response) {
+    size_t header_end;
+    while ((header_end = rx_.find("\r\n\r\n")) == std::string::npos) {
+        if (!read_more()) return false;
+    }
+
+    // "HTTP/1.1 200 OK"
+    const size_t space = rx_.find(' ');
+    if (space == std::string::npos || space > header_end) return false;
+    response.status = std::atoi(rx_.c_str() + space + 1);
+
+    long long content_length = -1;
+    bool chunked = false;
+    keep_alive_ = rx_.compare(0, 8, "HTTP/1.0") != 0;
+    for (size_t line = rx_.find("\r\n") + 2; line < header_end; line = rx_.find("\r\n", line) + 2) {
+        const char* header = rx_.c_str() + line;
+        if (iequals_prefix(header, "content-length:")) {
+            content_length = std::atoll(header + 15);
+        } else if (iequals_prefix(header, "transfer-encoding:")) {
+            chunked = rx_.find("chunked", line) < rx_.find("\r\n", line);
+        } else if (iequals_prefix(header, "connection:")) {
+            const size_t end = rx_.find("\r\n", line);
+            if (rx_.find("close", line) < end) keep_alive_ = false;
+            if (rx_.find("keep-alive", line) < end) keep_alive_ = true;
+        }
+    }
+
+    size_t pos = header_end + 4;
+    response.body.clear();
+    if (chunked) {
+        for (;;) {
+            size_t line_end;
+            while ((line_end = rx_.find("\r\n", pos)) == std::string::npos) {
+                if (!read_more()) return false;
+            }
+            const size_t chunk = std::strtoul(rx_.c_str() + pos, nullptr, 16);
+            pos = line_end + 2;
+            while (rx_.size() < pos + chunk + 2) {
+                if (!read_more()) return false;
+            }
+            response.body.append(rx_, pos, chunk);
+            pos += chunk + 2;
+            if (chunk == 0) break;  // trailers are not used by the API
+        }
+    } else if (content_length >= 0) {
+        while (rx_.size() < pos + static_cast<size_t>(content_length)) {
+            if (!read_more()) return false;
+        }
+        response.body.assign(rx_, pos, static_cast<size_t>(content_length));
+        pos += static_cast<size_t>(content_length);
+    } else {
+        // No length: the body runs to the end of the connection.
+        while (read_more()) {}
+        response.body.assign(rx_, pos, std::string::npos);
+        pos = rx_.size();
+        keep_alive_ = false;
+    }
+
+    rx_.erase(0, pos);
+    return true;
+}
@@ -0,0 +1,212 @@
+#include "execution/mock_gateway_server.h"
+#include <iostream>
+#include <cctype>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr int ACCEPT_POLL_MS = 100;
+constexpr size_t MAX_REQUEST_BYTES = 1 << 16;
+
+bool send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+// Value of a header in `headers` (case-insensitive name), or empty.
+std::string header_value(const std::string& headers, const char* name) {
+    std::string lower(headers.size(), '\0');
+    for (size_t i = 0; i < headers.size(); ++i) {
+        lower[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(headers[i])));
+    }
+    const size_t at = lower.find(std::string("\r\n") + name + ":");
+    if (at == std::string::npos) return "";
+    size_t start = at + 3 + std::strlen(name);
+    while (start < headers.size() && headers[start] == ' ') ++start;
+    return headers.substr(start, headers.find("\r\n", start) - start);
+}
+
+// The quoted string after `"key":"` in `json`, or empty.
+std::string string_field(const std::string& json, const char* key) {
+    const std::string pattern = std::string("\"") + key + "\":\"";
+    const size_t at = json.find(pattern);
+    if (at == std::string::npos) return "";
+    const size_t start = at + pattern.size();
+    return json.substr(start, json.find('"', start) - start);
+}
+
+}  // namespace
+
+MockGatewayServer::MockGatewayServer(std::string bind_address, int port)
+    : bind_address_(std::move(bind_address))
+    , port_(port)
+{
+}
+
+MockGatewayServer::~MockGatewayServer() {
+    stop();
+}
+
+bool MockGatewayServer::start() {
+    if (running_.load()) return true;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Mock gateway: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (::inet_pton(AF_INET, bind_address_.c_str(), &addr.sin_addr) != 1 ||
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 8) != 0) {
+        std::cerr << "Mock gateway: cannot listen on " << bind_address_ << ":" << port_
+                  << ": " << std::strerror(errno) << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    bound_port_ = ntohs(addr.sin_port);
+
+    running_.store(true);
+    server_thread_ = std::thread(&MockGatewayServer::server_loop, this);
+    return true;
+}
+
+void MockGatewayServer::stop() {
+    if (!running_.exchange(false)) return;
+    if (server_thread_.joinable()) server_thread_.join();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+std::string MockGatewayServer::last_order_body() const {
+    std::lock_guard<std::mutex> lock(last_mutex_);
+    return last_order_body_;
+}
+
+std::string MockGatewayServer::last_authorization() const {
+    std::lock_guard<std::mutex> lock(last_mutex_);
+    return last_authorization_;
+}
+
+void MockGatewayServer::server_loop() {
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    while (running_.load(std::memory_order_relaxed)) {
+        if (::poll(&pfd, 1, ACCEPT_POLL_MS) <= 0) continue;
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        connections_.fetch_add(1);
+        handle_connection(fd);
+        ::close(fd);
+    }
+}
+
+void MockGatewayServer::handle_connection(int fd) {
+    std::string rx;
+    std::string response;
+    pollfd pfd{fd, POLLIN, 0};
+    char buf[8192];
+
+    // Requests are served until the client closes the connection or the server stops.
+    while (running_.load(std::memory_order_relaxed)) {
+        size_t header_end = rx.find("\r\n\r\n");
+        if (header_end != std::string::npos) {
+            const std::string headers = rx.substr(0, header_end + 2);
+            const size_t body_length = std::strtoul(header_value(headers, "content-length").c_str(), nullptr, 10);
+            if (rx.size() >= header_end + 4 + body_length) {
+                const std::string body = rx.substr(header_end + 4, body_length);
+                rx.erase(0, header_end + 4 + body_length);
+
+                std::string auth = header_value(headers, "authorization");
+                std::string out;
+                const bool found = respond(headers.substr(0, headers.find("\r\n")), auth, body, out);
+                response = found ? "HTTP/1.1 200 OK\r\n" : "HTTP/1.1 404 Not Found\r\n";
+                response += "Content-Type: application/json\r\nContent-Length: ";
+                response += std::to_string(out.size());
+                response += "\r\nConnection: keep-alive\r\n\r\n";
+                response += out;
+                if (!send_all(fd, response.data(), response.size())) return;
+                continue;
+            }
+        }
+        if (rx.size() > MAX_REQUEST_BYTES) return;
+
+        if (::poll(&pfd, 1, ACCEPT_POLL_MS) <= 0) continue;
+        ssize_t n = ::recv(fd, buf, sizeof(buf), 0);
+        if (n <= 0) return;
+        rx.append(buf, static_cast<size_t>(n));
+    }
+}
+
+bool MockGatewayServer::respond(const std::string& request_line, const std::string& authorization,
+                                const std::string& body, std::string& out) {
+    if (request_line.rfind("POST /api/v3/brokerage/orders/batch_cancel ", 0) == 0) {
+        cancel_requests_.fetch_add(1);
+        out = "{\"results\":[";
+        bool first = true;
+        const size_t list = body.find('[');
+        for (size_t pos = body.find('"', list); list != std::string::npos && pos != std::string::npos;
+             pos = body.find('"', pos)) {
+            const size_t end = body.find('"', pos + 1);
+            if (end == std::string::npos) break;
+            if (!first) out += ',';
+            out += "{\"success\":true,\"failure_reason\":\"UNKNOWN_CANCEL_FAILURE_REASON\",\"order_id\":\"";
+            out.append(body, pos + 1, end - pos - 1);
+            out += "\"}";
+            first = false;
+            cancels_.fetch_add(1);
+            pos = end + 1;
+        }
+        out += "]}";
+        return true;
+    }
+
+    if (request_line.rfind("POST /api/v3/brokerage/orders ", 0) == 0) {
+        const uint64_t n = orders_.fetch_add(1) + 1;
+        {
+            std::lock_guard<std::mutex> lock(last_mutex_);
+            last_order_body_ = body;
+            last_authorization_ = authorization;
+        }
+        const std::string client_order_id = string_field(body, "client_order_id");
+        if (reject_.load()) {
+            out = "{\"success\":false,\"error_response\":{\"error\":\"INSUFFICIENT_FUND\","
+                  "\"message\":\"Insufficient balance in source account\"}}";
+        } else {
+            out = "{\"success\":true,\"success_response\":{\"order_id\":\"mock-" + std::to_string(n) +
+                  "\",\"product_id\":\"" + string_field(body, "product_id") +
+                  "\",\"side\":\"" + string_field(body, "side") +
+                  "\",\"client_order_id\":\"" + client_order_id + "\"}}";
+        }
+        return true;
+    }
+
+    out = "{\"error\":\"NOT_FOUND\"}";
+    return false;
+}
@@ -0,0 +1,119 @@
+#include "execution/order_ladder.h"
+#include "strategy/strategy.h"
+#include "core/cpu_hints.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static_assert(OrderLadder::kMaxLevels % 2 == 0, "levels are built two at a time");
+static_assert(OrderLadder::kMaxLevels <= 64, "one mask bit per level");
+
+uint32_t OrderLadder::order_count() const {
+    return static_cast<uint32_t>(__builtin_popcountll(bid_mask) + __builtin_popcountll(ask_mask));
+}
+
+const OrderLadder& LadderBuilder::build(const HFTSignal& signal, const ConfigSnapshot& config, bool place,
+                                        double position, double max_position, double min_quantity,
+                                        const QuoteBounds& bounds) {
+    OrderLadder& ladder = ladder_;
+    ladder.levels = std::min<uint32_t>(signal.num_levels, OrderLadder::kMaxLevels);
+    ladder.bid_mask = ladder.ask_mask = 0;
+    ladder.marketable = ladder.self_crosses = 0;
+    if (HFT_UNLIKELY(!place || ladder.levels == 0)) return ladder;
+
+    // The epsilon keeps prices already on the grid from moving a tick on representation error.
+    const double tick_size = config.tick_size;
+    const double base_bid = std::floor(signal.bid_price / tick_size + 1e-9) * tick_size;
+    const double base_ask = std::ceil(signal.ask_price / tick_size - 1e-9) * tick_size;
+    const double* level_offset = config.ladder_offset.data();
+    const double* level_size_factor = config.ladder_size_factor.data();
+
+    // Pairs past `levels` are computed too and masked off below.
+    const size_t count = (ladder.levels + 1) & ~size_t{1};
+    uint64_t bid_mask = 0;
+    uint64_t ask_mask = 0;
+#if defined(__SSE2__)
+    const __m128d bid_price = _mm_set1_pd(base_bid);
+    const __m128d ask_price = _mm_set1_pd(base_ask);
+    const __m128d bid_size = _mm_set1_pd(signal.bid_quantity);
+    const __m128d ask_size = _mm_set1_pd(signal.ask_quantity);
+    const __m128d pos = _mm_set1_pd(position);
+    const __m128d max_pos = _mm_set1_pd(max_position);
+    const __m128d min_qty = _mm_set1_pd(min_quantity);
+    const __m128d sign = _mm_set1_pd(-0.0);
+    for (size_t i = 0; i < count; i += 2) {
+        const __m128d offset = _mm_load_pd(&level_offset[i]);
+        const __m128d factor = _mm_load_pd(&level_size_factor[i]);
+        const __m128d bid_qty = _mm_mul_pd(bid_size, factor);
+        const __m128d ask_qty = _mm_mul_pd(ask_size, factor);
+        _mm_store_pd(&ladder.bid_price[i], _mm_sub_pd(bid_price, offset));
+        _mm_store_pd(&ladder.ask_price[i], _mm_add_pd(ask_price, offset));
+        _mm_store_pd(&ladder.bid_quantity[i], bid_qty);
+        _mm_store_pd(&ladder.ask_quantity[i], ask_qty);
+
+        const __m128d bid_ok = _mm_and_pd(_mm_cmpge_pd(bid_qty, min_qty),
+            _mm_cmple_pd(_mm_andnot_pd(sign, _mm_add_pd(pos, bid_qty)), max_pos));
+        const __m128d ask_ok = _mm_and_pd(_mm_cmpge_pd(ask_qty, min_qty),
+            _mm_cmple_pd(_mm_andnot_pd(sign, _mm_sub_pd(pos, ask_qty)), max_pos));
+        bid_mask |= static_cast<uint64_t>(_mm_movemask_pd(bid_ok)) << i;
+        ask_mask |= static_cast<uint64_t>(_mm_movemask_pd(ask_ok)) << i;
+    }
+#else
+    for (size_t i = 0; i < count; ++i) {
+        const double bid_qty = signal.bid_quantity * level_size_factor[i];
+        const double ask_qty = signal.ask_quantity * level_size_factor[i];
+        ladder.bid_price[i] = base_bid - level_offset[i];
+        ladder.ask_price[i] = base_ask + level_offset[i];
+        ladder.bid_quantity[i] = bid_qty;
+        ladder.ask_quantity[i] = ask_qty;
+        const bool bid_ok = bid_qty >= min_quantity && std::abs(position + bid_qty) <= max_position;
+        const bool ask_ok = ask_qty >= min_quantity && std::abs(position - ask_qty) <= max_position;
+        bid_mask |= static_cast<uint64_t>(bid_ok) << i;
+        ask_mask |= static_cast<uint64_t>(ask_ok) << i;
+    }
+#endif
+
+    const uint64_t level_mask = ladder.levels == 64 ? ~uint64_t{0} : (uint64_t{1} << ladder.levels) - 1;
+    ladder.bid_mask = signal.place_bid ? (bid_mask & level_mask) : 0;
+    ladder.ask_mask = signal.place_ask ? (ask_mask & level_mask) : 0;
+    guard(bounds, tick_size);
+    return ladder;
+}
+
+void LadderBuilder::guard(const QuoteBounds& bounds, double tick_size) {
+    OrderLadder& ladder = ladder_;
+    // Ladder prices are on the grid; the book's are snapped onto it before stepping back.
+    const double slack = tick_size * 0.5;
+    const double bid_cap = bounds.book_ask > 0.0
+        ? std::ceil(bounds.book_ask / tick_size - 1e-9) * tick_size - tick_size : 0.0;
+    const double ask_floor = bounds.book_bid > 0.0
+        ? std::floor(bounds.book_bid / tick_size + 1e-9) * tick_size + tick_size : 0.0;
+
+    for (uint64_t bits = ladder.bid_mask; bits != 0; bits &= bits - 1) {
+        const uint32_t level = static_cast<uint32_t>(__builtin_ctzll(bits));
+        double& price = ladder.bid_price[level];
+        if (HFT_UNLIKELY(bid_cap > 0.0 && price > bid_cap + slack)) {
+            price = bid_cap;
+            ++ladder.marketable;
+        }
+        if (HFT_UNLIKELY(bounds.own_ask > 0.0 && price > bounds.own_ask - slack)) {
+            ladder.bid_mask &= ~(uint64_t{1} << level);
+            ++ladder.self_crosses;
+        }
+    }
+    for (uint64_t bits = ladder.ask_mask; bits != 0; bits &= bits - 1) {
+        const uint32_t level = static_cast<uint32_t>(__builtin_ctzll(bits));
+        double& price = ladder.ask_price[level];
+        if (HFT_UNLIKELY(ask_floor > 0.0 && price < ask_floor - slack)) {
+            price = ask_floor;
+            ++ladder.marketable;
+        }
+        if (HFT_UNLIKELY(bounds.own_bid > 0.0 && price < bounds.own_bid + slack)) {
+            ladder.ask_mask &= ~(uint64_t{1} << level);
+            ++ladder.self_crosses;
+        }
+    }
+}
@@ -0,0 +1,123 @@
+#include "execution/sim_gateway.h"
+#include "core/cpu_hints.h"
+#include "core/fast_clock.h"
+#include <algorithm>
+
+const char* to_string(GatewayKind kind) {
+    switch (kind) {
+        case GatewayKind::SIMULATED: return "sim";
+        case GatewayKind::REPLAY:    return "replay";
+        case GatewayKind::COINBASE:  return "coinbase";
+    }
+    return "unknown";
+}
+
+bool parseGatewayKind(const std::string& text, GatewayKind& kind) {
+    for (GatewayKind candidate : {GatewayKind::SIMULATED, GatewayKind::REPLAY, GatewayKind::COINBASE}) {
+        if (text == to_string(candidate)) {
+            kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+SimulatedGateway::SimulatedGateway(const std::atomic<double>& position)
+    : position_(position)
+{
+    std::random_device rd;
+    rng_ = std::mt19937(rd());
+}
+
+bool SimulatedGateway::send(const HFTOrder& order) {
+    double current_pos = position_.load();
+    double base_fill_probability = 0.3;
+
+    if ((order.side == 'S' && current_pos > 0.01) ||
+        (order.side == 'B' && current_pos < -0.01)) {
+        base_fill_probability *= 1.8;
+    }
+
+    if ((order.side == 'B' && current_pos > 0.01) ||
+        (order.side == 'S' && current_pos < -0.01)) {
+        base_fill_probability *= 0.4;
+    }
+
+    base_fill_probability = std::min(base_fill_probability, 0.65);
+
+    if (fill_distribution_(rng_) < base_fill_probability) {
+        HFTOrder filled_order = order;
+        filled_order.status = 'F';
+        filled_order.filled_quantity = filled_order.quantity;
+        filled_order.fill_tsc = FastClock::now();
+        responses_.push(filled_order);
+    }
+
+    return true;
+}
+
+bool ReplayGateway::send(const HFTOrder& order) {
+    if (HFT_UNLIKELY(order.priority >= OrderLadder::kMaxLevels)) return false;
+    Slot& slot = slots_[2 * order.priority + (order.side == 'S' ? 1 : 0)];
+    slot.order = order;
+    slot.live = true;
+    levels_used_ = std::max(levels_used_, order.priority + 1);
+    return true;
+}
+
+bool ReplayGateway::submit(const OrderBatch& batch) {
+    if (batch.replace) {
+        std::array<bool, 2 * OrderLadder::kMaxLevels> kept{};
+        for (uint32_t i = 0; i < batch.count; ++i) {
+            const HFTOrder& order = *batch.orders[i];
+            if (HFT_LIKELY(order.priority < OrderLadder::kMaxLevels)) {
+                kept[2 * order.priority + (order.side == 'S' ? 1 : 0)] = true;
+            }
+        }
+        for (uint32_t i = 0; i < 2 * levels_used_; ++i) {
+            if (slots_[i].live && !kept[i]) cancel(slots_[i]);
+        }
+    }
+    bool taken = true;
+    for (uint32_t i = 0; i < batch.count; ++i) taken &= send(*batch.orders[i]);
+    return taken;
+}
+
+bool ReplayGateway::cancel_all(char side) {
+    for (uint32_t i = 0; i < 2 * levels_used_; ++i) {
+        Slot& slot = slots_[i];
+        if (slot.live && (side == 0 || slot.order.side == side)) cancel(slot);
+    }
+    return true;
+}
+
+void ReplayGateway::cancel(Slot& slot) {
+    slot.live = false;
+    HFTOrder cancelled = slot.order;
+    cancelled.status = 'C';
+    // A full ring loses only the notice; the order is gone either way.
+    responses_.push(cancelled);
+}
+
+void ReplayGateway::on_book(double bid, double ask) {
+    for (uint32_t i = 0; i < 2 * levels_used_; ++i) {
+        Slot& slot = slots_[i];
+        if (!slot.live) continue;
+        const HFTOrder& order = slot.order;
+        const bool crossed = order.side == 'B' ? ask <= order.price : bid >= order.price;
+        if (!crossed) continue;
+
+        HFTOrder fill = order;
+        fill.status = 'F';
+        fill.filled_quantity = order.quantity;
+        fill.fill_tsc = FastClock::now();
+        // A full ring keeps the order resting; it fills on a later book.
+        if (responses_.push(fill)) slot.live = false;
+    }
+}
+
+uint32_t ReplayGateway::resting() const {
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < 2 * levels_used_; ++i) count += slots_[i].live ? 1 : 0;
+    return count;
+}
@@ -1,13 +1,28 @@
 #include "engine.h"
+#include "core/config.h"
+#include "core/flight_recorder.h"
 #include <iostream>
 #include <csignal>
 #include <atomic>
 #include <thread>
 
 static volatile std::sig_atomic_t signal_received = 0;
+static std::atomic<WakeSignal*> shutdown_wake{nullptr};
 
+// Async-signal-safe: WakeSignal::notify is an atomic add plus a futex wake.
 void signalHandler(int /*signum*/) {
     signal_received = 1;
+    if (WakeSignal* wake = shutdown_wake.load()) wake->notify();
+}
+
+// Async-signal-safe: only stores atomics; the recorder thread writes the file.
+void flightDumpHandler(int /*signum*/) {
+    FlightRecorder::getInstance().requestDump("sigusr1");
+}
+
+// Async-signal-safe: sets a flag and wakes the config watcher, which does the reload.
+void reloadHandler(int /*signum*/) {
+    Config::getInstance().requestReload();
 }
 
 int main(int argc, char* argv[]) {
@@ -25,13 +40,20 @@ int main(int argc, char* argv[]) {
             return 1;
         }
 
+        std::signal(SIGUSR1, flightDumpHandler);
+        std::signal(SIGHUP, reloadHandler);
+        shutdown_wake.store(&engine.stop_signal());
         engine.start();
 
         std::cout << "Trading active - Press Ctrl+C to stop" << std::endl;
 
+        // Woken by SIGINT/SIGTERM or an emergency stop; the timeout is only a safety net.
+        uint32_t wake_epoch = engine.stop_signal().epoch();
         while (!signal_received && engine.is_running()) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            engine.stop_signal().wait(wake_epoch, std::chrono::seconds(1));
+            wake_epoch = engine.stop_signal().epoch();
         }
+        shutdown_wake.store(nullptr);
 
         std::cout << "\nInitiating graceful shutdown..." << std::endl;
         auto shutdown_start = std::chrono::steady_clock::now();
@@ -1,15 +1,89 @@
 #include "metrics/metrics.h"
+#include "metrics/shm_metrics.h"
 #include "order/order_manager.h"
+#include "core/fast_clock.h"
 #include <iostream>
 #include <iomanip>
 #include <algorithm>
 
-MetricsCollector::MetricsCollector(OrderManager& order_manager)
+namespace {
+
+// Histograms hold FastClock ticks; conversion happens only here, on the reporting path.
+double ticks_to_us(uint64_t ticks) {
+    return static_cast<double>(FastClock::getInstance().ticksToNanos(ticks)) / 1000.0;
+}
+
+}  // namespace
+
+MetricsCollector::MetricsCollector(OrderManager& order_manager,
+                                   const std::string& shm_name,
+                                   const std::string& symbol)
     : order_manager_(order_manager)
 {
+    if (!shm_name.empty()) {
+        auto segment = std::make_unique<ShmMetricsSegment>();
+        if (segment->create(shm_name, symbol)) {
+            metrics_ = segment->metrics();
+            segment->header()->ns_per_tick.store(FastClock::getInstance().nanosPerTick(),
+                                                 std::memory_order_relaxed);
+            shm_segment_ = std::move(segment);
+            std::cout << "Metrics shared memory: /dev/shm" << shm_name << std::endl;
+        } else {
+            std::cerr << "Metrics shared memory unavailable, using process memory" << std::endl;
+        }
+    }
+    if (!metrics_) {
+        heap_metrics_ = std::make_unique<AtomicHFTMetrics>();
+        metrics_ = heap_metrics_.get();
+    }
+
     engine_start_time_ = std::chrono::high_resolution_clock::now();
     last_summary_ = std::chrono::steady_clock::now();
     last_print_ = last_summary_;
+
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        latency_sources_[i].push_back(&metrics_->stage_latency[i]);
+    }
+}
+
+MetricsCollector::~MetricsCollector() = default;
+
+double MetricsCollector::uptime_seconds() const {
+    return std::chrono::duration<double>(
+        std::chrono::high_resolution_clock::now() - engine_start_time_).count();
+}
+
+void MetricsCollector::register_latency_source(LatencyStage stage, const LatencyHistogram& histogram) {
+    latency_sources_[static_cast<size_t>(stage)].push_back(&histogram);
+}
+
+void MetricsCollector::set_totals_source(std::function<TradingTotals()> source) {
+    totals_source_ = std::move(source);
+}
+
+MetricsCollector::TradingTotals MetricsCollector::totals() const {
+    if (totals_source_) return totals_source_();
+    TradingTotals totals;
+    totals.trades = order_manager_.getTotalTrades();
+    totals.pnl = order_manager_.getCurrentPnL();
+    totals.position = order_manager_.getCurrentPosition();
+    return totals;
+}
+
+void MetricsCollector::capture_latency(LatencyStage stage, HistogramSnapshot& out) const {
+    out.clear();
+    for (const LatencyHistogram* source : latency_sources_[static_cast<size_t>(stage)]) {
+        out.accumulate(*source);
+    }
+}
+
+void MetricsCollector::roll_latency_windows() {
+    HistogramSnapshot current;
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        capture_latency(static_cast<LatencyStage>(i), current);
+        latency_window_[i].set_interval(current, latency_cumulative_[i]);
+        latency_cumulative_[i] = current;
+    }
 }
 
 void MetricsCollector::tick() {
@@ -17,20 +91,34 @@ void MetricsCollector::tick() {
 
     update_trading_rate();
 
+    if (shm_segment_) {
+        ShmMetricsHeader* header = shm_segment_->header();
+        header->ns_per_tick.store(FastClock::getInstance().nanosPerTick(), std::memory_order_relaxed);
+        header->heartbeat_wall_ns.store(FastClock::getInstance().toWallNanos(FastClock::now()),
+                                        std::memory_order_relaxed);
+    }
+
     if (now - last_summary_ >= std::chrono::seconds(5)) {
-        uint64_t current_total_trades = order_manager_.getTotalTrades();
-        double current_pnl = order_manager_.getCurrentPnL();
-        double current_position = order_manager_.getCurrentPosition();
+        roll_latency_windows();
+
+        const TradingTotals current = totals();
+        uint64_t current_total_trades = current.trades;
+        double current_pnl = current.pnl;
+        double current_position = current.position;
 
         uint64_t trades_delta = current_total_trades - last_orders_filled_;
         double pnl_delta = current_pnl - last_pnl_;
 
-        double avg_latency_ms = metrics_.avg_order_latency_ns.load(std::memory_order_relaxed) / 1000000.0;
+        const HistogramSnapshot& ladder = latency_window(LatencyStage::ORDER_LADDER);
+        const HistogramSnapshot& tick_to_trade = latency_window(LatencyStage::TICK_TO_TRADE);
 
         std::cout << "5s: " << trades_delta << " trades"
                   << " | PnL: $" << std::fixed << std::setprecision(6) << pnl_delta
                   << " | Pos: " << std::setprecision(6) << current_position << " ETH"
-                  << " | Order: " << std::setprecision(3) << avg_latency_ms << "ms"
+                  << " | Order p50/p99: " << std::setprecision(2) << ticks_to_us(ladder.percentile(50.0))
+                  << "/" << ticks_to_us(ladder.percentile(99.0)) << "us"
+                  << " | T2T p50/p99: " << ticks_to_us(tick_to_trade.percentile(50.0))
+                  << "/" << ticks_to_us(tick_to_trade.percentile(99.0)) << "us"
                   << " | Total: " << current_total_trades
                   << " | Cumulative PnL: $" << std::setprecision(6) << current_pnl << std::endl;
 
@@ -49,9 +137,10 @@ void MetricsCollector::print_performance_stats() const {
     auto runtime = std::chrono::high_resolution_clock::now() - engine_start_time_;
     auto runtime_seconds = std::chrono::duration_cast<std::chrono::seconds>(runtime).count();
 
-    uint64_t total_trades = order_manager_.getTotalTrades();
-    double current_pnl = order_manager_.getCurrentPnL();
-    double current_position = order_manager_.getCurrentPosition();
+    const TradingTotals current = totals();
+    uint64_t total_trades = current.trades;
+    double current_pnl = current.pnl;
+    double current_position = current.position;
 
     std::cout << "\nPERFORMANCE (10s Update)" << std::endl;
     std::cout << "=========================================" << std::endl;
@@ -61,6 +150,20 @@ void MetricsCollector::print_performance_stats() const {
     std::cout << "PnL: $" << std::setprecision(6) << current_pnl << std::endl;
     std::cout << "Avg Trades/sec: " << std::setprecision(2)
               << (total_trades / std::max(1LL, static_cast<long long>(runtime_seconds))) << std::endl;
+
+    std::cout << "Latency (us)      count      p50      p90      p99    p99.9      max" << std::endl;
+    HistogramSnapshot snapshot;
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        auto stage = static_cast<LatencyStage>(i);
+        capture_latency(stage, snapshot);
+        std::cout << std::left << std::setw(14) << to_string(stage) << std::right
+                  << std::setw(9) << snapshot.total << std::setprecision(2)
+                  << std::setw(9) << ticks_to_us(snapshot.percentile(50.0))
+                  << std::setw(9) << ticks_to_us(snapshot.percentile(90.0))
+                  << std::setw(9) << ticks_to_us(snapshot.percentile(99.0))
+                  << std::setw(9) << ticks_to_us(snapshot.percentile(99.9))
+                  << std::setw(9) << ticks_to_us(snapshot.max) << std::endl;
+    }
     std::cout << "=========================================\n" << std::endl;
 }
 
@@ -69,13 +172,13 @@ void MetricsCollector::update_trading_rate() {
     auto now_ms = static_cast<uint64_t>(
         std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()).count());
 
-    uint64_t current_orders = metrics_.orders_placed.load(std::memory_order_relaxed);
+    uint64_t current_orders = metrics_->orders_placed.load(std::memory_order_relaxed);
     uint64_t orders_delta = current_orders - last_rate_orders_;
     uint64_t time_delta = now_ms - last_rate_time_ms_;
 
     if (time_delta >= 1000) {
         uint64_t rate = (orders_delta * 1000) / time_delta;
-        metrics_.orders_per_second.store(rate, std::memory_order_relaxed);
+        metrics_->orders_per_second.store(rate, std::memory_order_relaxed);
         last_rate_orders_ = current_orders;
         last_rate_time_ms_ = now_ms;
     }
@@ -0,0 +1,296 @@
+#include "metrics/metrics_exporter.h"
+#include "core/fast_clock.h"
+#include <iostream>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t MAX_REQUEST_BYTES = 4096;
+constexpr int ACCEPT_POLL_MS = 250;
+
+// Fixed bucket boundaries (seconds) so the series set is identical on every scrape.
+constexpr std::array<double, 22> LATENCY_BOUNDS_SECONDS = {
+    100e-9, 250e-9, 500e-9,
+    1e-6, 2.5e-6, 5e-6, 10e-6, 25e-6, 50e-6, 100e-6, 250e-6, 500e-6,
+    1e-3, 2.5e-3, 5e-3, 10e-3, 25e-3, 50e-3, 100e-3, 250e-3, 500e-3,
+    1.0
+};
+
+void append_number(std::string& out, double value) {
+    char buf[32];
+    int n = std::snprintf(buf, sizeof(buf), "%.9g", value);
+    if (n > 0) out.append(buf, static_cast<size_t>(n));
+}
+
+void append_number(std::string& out, uint64_t value) {
+    out += std::to_string(value);
+}
+
+template<typename T>
+void append_metric(std::string& out, const char* name, const char* type, const char* help, T value) {
+    out += "# TYPE "; out += name; out += ' '; out += type; out += '\n';
+    out += "# HELP "; out += name; out += ' '; out += help; out += '\n';
+    out += name;
+    if (std::strcmp(type, "counter") == 0) out += "_total";
+    out += ' ';
+    append_number(out, value);
+    out += '\n';
+}
+
+bool send_all(int fd, const char* data, size_t len) {
+    while (len > 0) {
+        ssize_t n = ::send(fd, data, len, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        data += n;
+        len -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+}  // namespace
+
+MetricsExporter::MetricsExporter(std::string bind_address, int port, SnapshotProvider provider)
+    : bind_address_(std::move(bind_address))
+    , port_(port)
+    , provider_(std::move(provider))
+{
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start() {
+    if (running_.load()) return true;
+
+    listen_fd_ = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listen_fd_ < 0) {
+        std::cerr << "Metrics exporter: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    int reuse = 1;
+    ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(static_cast<uint16_t>(port_));
+    if (::inet_pton(AF_INET, bind_address_.c_str(), &addr.sin_addr) != 1) {
+        std::cerr << "Metrics exporter: invalid bind address " << bind_address_ << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    if (::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+        ::listen(listen_fd_, 8) != 0) {
+        std::cerr << "Metrics exporter: cannot listen on " << bind_address_ << ":" << port_
+                  << ": " << std::strerror(errno) << std::endl;
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+        return false;
+    }
+
+    socklen_t addr_len = sizeof(addr);
+    ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &addr_len);
+    bound_port_ = ntohs(addr.sin_port);
+
+    running_.store(true);
+    server_thread_ = std::thread(&MetricsExporter::server_loop, this);
+    std::cout << "Metrics exporter listening on http://" << bind_address_ << ":" << bound_port_
+              << "/metrics" << std::endl;
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running_.exchange(false)) return;
+    if (server_thread_.joinable()) server_thread_.join();
+    if (listen_fd_ >= 0) {
+        ::close(listen_fd_);
+        listen_fd_ = -1;
+    }
+}
+
+void MetricsExporter::server_loop() {
+    // Scrapes must never compete with trading threads for a core.
+#ifdef SCHED_IDLE
+    sched_param param{};
+    pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+#endif
+    pthread_setname_np(pthread_self(), "hft-metrics");
+
+    pollfd pfd{listen_fd_, POLLIN, 0};
+    while (running_.load(std::memory_order_relaxed)) {
+        int ready = ::poll(&pfd, 1, ACCEPT_POLL_MS);
+        if (ready <= 0) continue;
+
+        int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_CLOEXEC);
+        if (fd < 0) continue;
+        handle_connection(fd);
+        ::close(fd);
+    }
+}
+
+void MetricsExporter::handle_connection(int fd) {
+    timeval timeout{1, 0};
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    char request[MAX_REQUEST_BYTES];
+    size_t received = 0;
+    while (received < sizeof(request) - 1) {
+        ssize_t n = ::recv(fd, request + received, sizeof(request) - 1 - received, 0);
+        if (n <= 0) break;
+        received += static_cast<size_t>(n);
+        request[received] = '\0';
+        if (std::strstr(request, "\r\n\r\n")) break;
+    }
+    request[received] = '\0';
+
+    const bool is_metrics = std::strncmp(request, "GET /metrics ", 13) == 0 ||
+                            std::strncmp(request, "GET /metrics?", 13) == 0;
+    if (!is_metrics) {
+        static const char not_found[] =
+            "HTTP/1.0 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+        send_all(fd, not_found, sizeof(not_found) - 1);
+        return;
+    }
+
+    snapshot_.feeds.clear();
+    provider_(snapshot_);
+    render(snapshot_, body_);
+    scrapes_.fetch_add(1, std::memory_order_relaxed);
+
+    std::string header = "HTTP/1.0 200 OK\r\n"
+                         "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+                         "Content-Length: " + std::to_string(body_.size()) + "\r\n"
+                         "Connection: close\r\n\r\n";
+    if (send_all(fd, header.data(), header.size())) {
+        send_all(fd, body_.data(), body_.size());
+    }
+}
+
+void MetricsExporter::render(const MetricsSnapshot& s, std::string& out) {
+    out.clear();
+
+    append_metric(out, "hft_orders_placed", "counter", "Orders sent by the executor.", s.orders_placed);
+    append_metric(out, "hft_orders_filled", "counter", "Fills processed by the executor.", s.orders_filled);
+    append_metric(out, "hft_quotes_marketable", "counter",
+                  "Ladder levels clamped one tick behind the touch instead of taking.", s.quotes_marketable);
+    append_metric(out, "hft_quotes_self_cross", "counter",
+                  "Ladder levels dropped for crossing our own working orders.", s.quotes_self_cross);
+    append_metric(out, "hft_market_data_updates", "counter", "Top-of-book updates published by the feed.",
+                  s.market_data_updates);
+    append_metric(out, "hft_trades", "counter", "Trades booked by the order manager.", s.total_trades);
+    append_metric(out, "hft_log_records_dropped", "counter", "Log records dropped on full thread rings.",
+                  s.dropped_log_records);
+    append_metric(out, "hft_risk_events_dropped", "counter", "Risk events dropped on a full ring.",
+                  s.dropped_risk_events);
+
+    append_metric(out, "hft_pnl_usd", "gauge", "Cumulative session PnL.", s.pnl);
+    append_metric(out, "hft_position", "gauge", "Current net position in base currency.", s.position);
+    append_metric(out, "hft_orders_per_second", "gauge", "Order rate over the last second.", s.orders_per_second);
+    append_metric(out, "hft_websocket_latency_seconds", "gauge", "Last socket receive to queue push.",
+                  s.websocket_latency_seconds);
+    append_metric(out, "hft_circuit_breaker_active", "gauge", "1 while the risk circuit breaker is tripped.",
+                  static_cast<uint64_t>(s.circuit_breaker_active));
+    append_metric(out, "hft_risk_status", "gauge", "0=normal 1=warning 2=critical 3=emergency.",
+                  static_cast<uint64_t>(s.risk_status));
+    append_metric(out, "hft_uptime_seconds", "gauge", "Seconds since engine start.", s.uptime_seconds);
+
+    if (!s.feeds.empty()) {
+        static const char* const feed_metrics[][2] = {
+            {"hft_feed_bid", "Best bid."},
+            {"hft_feed_ask", "Best ask."},
+            {"hft_feed_spread_bps", "Top-of-book spread in basis points."},
+            {"hft_feed_updates", "Book updates for the symbol."},
+            {"hft_feed_last_update_age_seconds", "Seconds since the last book update."},
+        };
+        for (size_t m = 0; m < 5; ++m) {
+            const bool is_counter = (m == 3);
+            out += "# TYPE "; out += feed_metrics[m][0]; out += is_counter ? " counter\n" : " gauge\n";
+            out += "# HELP "; out += feed_metrics[m][0]; out += ' '; out += feed_metrics[m][1]; out += '\n';
+            for (const auto& feed : s.feeds) {
+                out += feed_metrics[m][0];
+                if (is_counter) out += "_total";
+                out += "{symbol=\""; out += feed.symbol; out += "\"} ";
+                switch (m) {
+                    case 0: append_number(out, feed.bid); break;
+                    case 1: append_number(out, feed.ask); break;
+                    case 2: append_number(out, feed.spread_bps); break;
+                    case 3: append_number(out, feed.updates); break;
+                    default: append_number(out, feed.last_update_age_seconds); break;
+                }
+                out += '\n';
+            }
+        }
+    }
+
+    // Histogram buckets are re-binned onto fixed bounds; ticks are converted here only.
+    const FastClock& clock = FastClock::getInstance();
+    out += "# TYPE hft_stage_latency_seconds histogram\n"
+           "# HELP hft_stage_latency_seconds Per-stage pipeline latency since engine start.\n";
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        const HistogramSnapshot& h = s.stage_latency[i];
+        const char* stage = to_string(static_cast<LatencyStage>(i));
+
+        std::array<uint64_t, LATENCY_BOUNDS_SECONDS.size()> bins{};
+        for (size_t b = 0; b < h.counts.size(); ++b) {
+            if (h.counts[b] == 0) continue;
+            double upper = static_cast<double>(clock.ticksToNanos(LatencyHistogram::bucket_upper_bound(b))) * 1e-9;
+            for (size_t k = 0; k < bins.size(); ++k) {
+                if (upper <= LATENCY_BOUNDS_SECONDS[k]) {
+                    bins[k] += h.counts[b];
+                    break;
+                }
+            }
+        }
+
+        uint64_t cumulative = 0;
+        for (size_t k = 0; k < bins.size(); ++k) {
+            cumulative += bins[k];
+            out += "hft_stage_latency_seconds_bucket{stage=\""; out += stage; out += "\",le=\"";
+            append_number(out, LATENCY_BOUNDS_SECONDS[k]);
+            out += "\"} ";
+            append_number(out, cumulative);
+            out += '\n';
+        }
+        out += "hft_stage_latency_seconds_bucket{stage=\""; out += stage; out += "\",le=\"+Inf\"} ";
+        append_number(out, h.total);
+        out += "\nhft_stage_latency_seconds_count{stage=\""; out += stage; out += "\"} ";
+        append_number(out, h.total);
+        out += "\nhft_stage_latency_seconds_sum{stage=\""; out += stage; out += "\"} ";
+        append_number(out, static_cast<double>(clock.ticksToNanos(h.sum)) * 1e-9);
+        out += '\n';
+    }
+
+    static const std::array<std::pair<double, const char*>, 4> quantiles = {{
+        {50.0, "50"}, {90.0, "90"}, {99.0, "99"}, {99.9, "99.9"}
+    }};
+    out += "# TYPE hft_stage_latency_quantile_seconds gauge\n"
+           "# HELP hft_stage_latency_quantile_seconds Per-stage latency quantiles since engine start.\n";
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        const HistogramSnapshot& h = s.stage_latency[i];
+        const char* stage = to_string(static_cast<LatencyStage>(i));
+        for (const auto& [pct, label] : quantiles) {
+            out += "hft_stage_latency_quantile_seconds{stage=\""; out += stage;
+            out += "\",percentile=\""; out += label; out += "\"} ";
+            append_number(out, static_cast<double>(clock.ticksToNanos(h.percentile(pct))) * 1e-9);
+            out += '\n';
+        }
+    }
+
+    out += "# EOF\n";
+}
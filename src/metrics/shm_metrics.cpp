@@ -0,0 +1,236 @@
+#include "metrics/shm_metrics.h"
+#include <iostream>
+#include <chrono>
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free, "shm metrics need address-free atomics");
+static_assert(std::atomic<double>::is_always_lock_free, "shm metrics need address-free atomics");
+static_assert(LATENCY_STAGE_COUNT <= SHM_METRICS_MAX_STAGES, "raise SHM_METRICS_MAX_STAGES");
+
+namespace {
+
+constexpr size_t align_up(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void copy_name(char (&dest)[SHM_METRICS_NAME_LEN], const char* src) {
+    std::strncpy(dest, src, SHM_METRICS_NAME_LEN - 1);
+    dest[SHM_METRICS_NAME_LEN - 1] = '\0';
+}
+
+uint64_t wall_clock_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+}  // namespace
+
+#define HFT_SHM_FIELD(header, member, field_type)                                      \
+    do {                                                                             \
+        ShmFieldDesc& desc = (header).fields[(header).field_count++];                \
+        copy_name(desc.name, #member);                                               \
+        desc.offset = static_cast<uint32_t>(offsetof(AtomicHFTMetrics, member));     \
+        desc.type = field_type;                                                      \
+    } while (0)
+
+ShmMetricsSegment::~ShmMetricsSegment() {
+    destroy();
+}
+
+bool ShmMetricsSegment::create(const std::string& name, const std::string& symbol) {
+    const size_t metrics_offset = align_up(sizeof(ShmMetricsHeader), alignof(AtomicHFTMetrics));
+    const size_t size = align_up(metrics_offset + sizeof(AtomicHFTMetrics), 4096);
+
+    // A previous run that crashed may have left a stale segment behind.
+    shm_unlink(name.c_str());
+    int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Metrics shm: cannot create " << name << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "Metrics shm: ftruncate failed: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+    void* base = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        std::cerr << "Metrics shm: mmap failed: " << std::strerror(errno) << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    name_ = name;
+    base_ = base;
+    size_ = size;
+    header_ = new (base) ShmMetricsHeader{};
+    metrics_ = new (static_cast<char*>(base) + metrics_offset) AtomicHFTMetrics{};
+
+    ShmMetricsHeader& h = *header_;
+    h.version = SHM_METRICS_VERSION;
+    h.header_size = sizeof(ShmMetricsHeader);
+    h.segment_size = static_cast<uint32_t>(size);
+    h.metrics_offset = static_cast<uint32_t>(metrics_offset);
+    h.metrics_size = sizeof(AtomicHFTMetrics);
+    h.writer_pid = static_cast<int32_t>(getpid());
+
+    HFT_SHM_FIELD(h, orders_placed, ShmFieldType::U64);
+    HFT_SHM_FIELD(h, orders_filled, ShmFieldType::U64);
+    HFT_SHM_FIELD(h, total_pnl, ShmFieldType::F64);
+    HFT_SHM_FIELD(h, current_position, ShmFieldType::F64);
+    HFT_SHM_FIELD(h, market_data_updates, ShmFieldType::U64);
+    HFT_SHM_FIELD(h, websocket_latency_ticks, ShmFieldType::U64);
+    HFT_SHM_FIELD(h, orders_per_second, ShmFieldType::U64);
+    HFT_SHM_FIELD(h, quotes_marketable, ShmFieldType::U64);
+    HFT_SHM_FIELD(h, quotes_self_cross, ShmFieldType::U64);
+
+    h.stage_count = static_cast<uint32_t>(LATENCY_STAGE_COUNT);
+    h.histogram_offset = static_cast<uint32_t>(offsetof(AtomicHFTMetrics, stage_latency));
+    h.histogram_stride = sizeof(LatencyHistogram);
+    h.histogram_bucket_count = static_cast<uint32_t>(LatencyHistogram::BUCKET_COUNT);
+    h.histogram_sum_offset = static_cast<uint32_t>(LatencyHistogram::sum_offset());
+    h.histogram_max_offset = static_cast<uint32_t>(LatencyHistogram::max_offset());
+    h.sub_bucket_bits = LatencyHistogram::SUB_BUCKET_BITS;
+    h.max_value_bits = LatencyHistogram::MAX_VALUE_BITS;
+    for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+        copy_name(h.stage_names[i], to_string(static_cast<LatencyStage>(i)));
+    }
+
+    copy_name(h.symbol, symbol.c_str());
+    h.start_wall_ns = wall_clock_ns();
+    h.ns_per_tick.store(1.0, std::memory_order_relaxed);
+    h.heartbeat_wall_ns.store(h.start_wall_ns, std::memory_order_relaxed);
+
+    h.magic.store(SHM_METRICS_MAGIC, std::memory_order_release);
+    return true;
+}
+
+void ShmMetricsSegment::destroy() {
+    if (!base_) return;
+    header_->magic.store(0, std::memory_order_release);
+    metrics_->~AtomicHFTMetrics();
+    header_->~ShmMetricsHeader();
+    munmap(base_, size_);
+    shm_unlink(name_.c_str());
+    base_ = nullptr;
+    header_ = nullptr;
+    metrics_ = nullptr;
+}
+
+ShmMetricsReader::~ShmMetricsReader() {
+    detach();
+}
+
+bool ShmMetricsReader::attach(const std::string& name, std::string& error) {
+    detach();
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        error = "cannot open " + name + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(ShmMetricsHeader)) {
+        ::close(fd);
+        error = "segment " + name + " is too small";
+        return false;
+    }
+    void* base = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        error = std::string("mmap failed: ") + std::strerror(errno);
+        return false;
+    }
+
+    base_ = base;
+    size_ = static_cast<size_t>(st.st_size);
+    header_ = static_cast<const ShmMetricsHeader*>(base);
+
+    const ShmMetricsHeader& h = *header_;
+    if (h.magic.load(std::memory_order_acquire) != SHM_METRICS_MAGIC) {
+        error = "segment not initialized (bad magic)";
+    } else if (h.version != SHM_METRICS_VERSION) {
+        error = "layout version " + std::to_string(h.version) + ", expected " +
+                std::to_string(SHM_METRICS_VERSION);
+    } else if (h.header_size != sizeof(ShmMetricsHeader) || h.segment_size > size_ ||
+               h.metrics_offset + h.metrics_size > h.segment_size ||
+               h.field_count > SHM_METRICS_MAX_FIELDS || h.stage_count > SHM_METRICS_MAX_STAGES ||
+               h.histogram_offset + static_cast<uint64_t>(h.stage_count) * h.histogram_stride > h.metrics_size) {
+        error = "inconsistent segment header";
+    } else {
+        metrics_ = static_cast<const char*>(base) + h.metrics_offset;
+        return true;
+    }
+    detach();
+    return false;
+}
+
+void ShmMetricsReader::detach() {
+    if (base_) munmap(const_cast<void*>(base_), size_);
+    base_ = nullptr;
+    header_ = nullptr;
+    metrics_ = nullptr;
+    size_ = 0;
+}
+
+const ShmFieldDesc* ShmMetricsReader::find(const char* field) const {
+    for (uint32_t i = 0; i < header_->field_count; ++i) {
+        if (std::strncmp(header_->fields[i].name, field, SHM_METRICS_NAME_LEN) == 0) {
+            return &header_->fields[i];
+        }
+    }
+    return nullptr;
+}
+
+bool ShmMetricsReader::read_u64(const char* field, uint64_t& value) const {
+    const ShmFieldDesc* desc = find(field);
+    if (!desc || desc->type != ShmFieldType::U64) return false;
+    value = __atomic_load_n(reinterpret_cast<const uint64_t*>(metrics_ + desc->offset), __ATOMIC_RELAXED);
+    return true;
+}
+
+bool ShmMetricsReader::read_f64(const char* field, double& value) const {
+    const ShmFieldDesc* desc = find(field);
+    if (!desc || desc->type != ShmFieldType::F64) return false;
+    uint64_t bits = __atomic_load_n(reinterpret_cast<const uint64_t*>(metrics_ + desc->offset), __ATOMIC_RELAXED);
+    std::memcpy(&value, &bits, sizeof(value));
+    return true;
+}
+
+uint64_t ShmMetricsReader::bucket_count(uint32_t stage, uint32_t bucket) const {
+    const char* histogram = metrics_ + header_->histogram_offset + stage * header_->histogram_stride;
+    return __atomic_load_n(reinterpret_cast<const uint64_t*>(histogram) + bucket, __ATOMIC_RELAXED);
+}
+
+uint64_t ShmMetricsReader::histogram_sum(uint32_t stage) const {
+    const char* histogram = metrics_ + header_->histogram_offset + stage * header_->histogram_stride;
+    return __atomic_load_n(reinterpret_cast<const uint64_t*>(histogram + header_->histogram_sum_offset),
+                           __ATOMIC_RELAXED);
+}
+
+uint64_t ShmMetricsReader::histogram_max(uint32_t stage) const {
+    const char* histogram = metrics_ + header_->histogram_offset + stage * header_->histogram_stride;
+    return __atomic_load_n(reinterpret_cast<const uint64_t*>(histogram + header_->histogram_max_offset),
+                           __ATOMIC_RELAXED);
+}
+
+// Same log-linear mapping as LatencyHistogram, driven by the published geometry.
+uint64_t ShmMetricsReader::bucket_upper_bound(uint32_t bucket) const {
+    const uint32_t sub_bits = header_->sub_bucket_bits;
+    const uint32_t sub_count = 1u << sub_bits;
+    const uint32_t half = sub_count / 2;
+    if (bucket < sub_count) return bucket;
+    const uint32_t offset = bucket - sub_count;
+    const uint32_t msb = offset / half + sub_bits;
+    const uint32_t shift = msb - (sub_bits - 1);
+    const uint64_t lower = static_cast<uint64_t>(half + offset % half) << shift;
+    return lower + (uint64_t{1} << shift) - 1;
+}
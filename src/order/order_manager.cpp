@@ -1,9 +1,12 @@
 #include "order/order_manager.h"
+#include "core/logger.h"
+#include "core/fast_clock.h"
 #include <iostream>
 #include <random>
 #include <chrono>
 #include <fstream>
 #include <iomanip>
+#include <sstream>
 #include <cmath>
 #include <ctime>
 
@@ -23,6 +26,7 @@ bool OrderManager::initialize() {
 void OrderManager::shutdown() {
     if (shutdown_called_) return;
     shutdown_called_ = true;
+    if (!session_summary_) return;
 
     generateSessionSummary();
     std::cout << "Order Manager shutdown complete" << std::endl;
@@ -52,9 +56,7 @@ std::string OrderManager::generateClientOrderId() {
     static std::mt19937 gen(rd());
     static std::uniform_int_distribution<> dis(100000, 999999);
 
-    auto now = std::chrono::system_clock::now();
-    auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()).count();
+    auto timestamp = FastClock::getInstance().toWallNanos(FastClock::now()) / 1000000ULL;
 
     return "HFT_" + std::to_string(timestamp) + "_" + std::to_string(dis(gen));
 }
@@ -79,8 +81,8 @@ OrderResponse OrderManager::executeOrder(const std::string& symbol, Side side, d
     order.quantity = quantity;
     order.price = price;
     order.status = OrderStatus::NEW;
-    order.create_time = std::chrono::system_clock::now();
-    order.update_time = order.create_time;
+    order.create_tsc = FastClock::now();
+    order.update_tsc = order.create_tsc;
 
     orders_placed_++;
 
@@ -109,7 +111,7 @@ bool OrderManager::validateOrder(const std::string& symbol, Side /*side*/, doubl
 void OrderManager::simulateOrderFill(Order& order) {
     order.status = OrderStatus::FILLED;
     order.filled_quantity = order.quantity;
-    order.update_time = std::chrono::system_clock::now();
+    order.update_tsc = FastClock::now();
 
     orders_filled_++;
     updatePositionAndPnL(order);
@@ -209,8 +211,7 @@ void OrderManager::generateSessionSummary() {
     localtime_r(&start_time_t, &start_tm);
     localtime_r(&end_time_t, &end_tm);
 
-    std::ofstream summary_file("logs/session_summary.log", std::ios::app);
-    if (!summary_file.is_open()) return;
+    std::ostringstream summary_file;
 
     uint64_t placed = orders_placed_.load();
     uint64_t filled = orders_filled_.load();
@@ -260,9 +261,19 @@ void OrderManager::generateSessionSummary() {
     }
 
     summary_file << std::string(80, '=') << std::endl;
-    summary_file.close();
 
-    std::cout << "\nSession Summary Generated: logs/session_summary.log" << std::endl;
+    writeSessionSummary(summary_file.str());
     std::cout << "Total Trades: " << total_trades << " | PnL: $" << std::fixed << std::setprecision(4) << final_pnl
               << " | Duration: " << duration_seconds << "s" << std::endl;
 }
+
+void OrderManager::writeSessionSummary(const std::string& summary) {
+    // Rotation and fsync of session_summary.log belong to the logger thread; write directly
+    // only when it is not running (e.g. standalone tools and tests).
+    if (!Logger::getInstance().writeBlock(LogStream::SESSION_SUMMARY, summary)) {
+        std::ofstream direct("logs/session_summary.log", std::ios::app);
+        if (!direct.is_open()) return;
+        direct << summary;
+    }
+    std::cout << "\nSession Summary Generated: logs/session_summary.log" << std::endl;
+}
@@ -1,11 +1,87 @@
 #include "risk/risk_manager.h"
 #include "core/config.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
+#include "core/logger.h"
+#include "core/types.h"
 #include <iostream>
+#include <fstream>
 #include <iomanip>
 #include <algorithm>
 #include <cmath>
+#include <cstdio>
 #include <ctime>
 
+namespace {
+
+// Limits are magnitudes; an empty or unparsable value keeps the default.
+double configLimit(const Config& config, const std::string& key, double default_val) {
+    const std::string value = config.getConfig(key);
+    if (value.empty()) return default_val;
+    try {
+        return std::abs(std::stod(value));
+    } catch (const std::exception&) {
+        std::cerr << "Warning: invalid limit for config key '" << key << "'" << std::endl;
+        return default_val;
+    }
+}
+
+uint64_t wall_clock_ns() {
+    return FastClock::getInstance().toWallNanos(FastClock::now());
+}
+
+}  // namespace
+
+const char* to_string(RiskMessage message) {
+    switch (message) {
+        case RiskMessage::NONE:                          return "";
+        case RiskMessage::RISK_MANAGER_INITIALIZED:      return "Risk Manager initialized successfully";
+        case RiskMessage::RISK_MANAGER_SHUTDOWN:         return "Risk Manager shutting down";
+        case RiskMessage::ORDER_REJECTED_POSITION_LIMIT: return "Order rejected: Position limit exceeded";
+        case RiskMessage::ORDER_REJECTED_RATE_LIMIT:     return "Order rejected: Rate limit exceeded";
+        case RiskMessage::DAILY_LOSS_LIMIT_EXCEEDED:     return "Daily loss limit exceeded";
+        case RiskMessage::DRAWDOWN_LIMIT_EXCEEDED:       return "Drawdown limit exceeded";
+        case RiskMessage::APPROACHING_DAILY_LOSS_LIMIT:  return "Approaching daily loss limit";
+        case RiskMessage::FILL_EXCEEDED_POSITION_LIMIT:  return "Fill took position past its limit";
+        case RiskMessage::ORDER_REJECTED_NOTIONAL_LIMIT: return "Order rejected: Notional limit exceeded";
+        case RiskMessage::ORDER_REJECTED_EXPOSURE_LIMIT: return "Order rejected: Exposure limit exceeded";
+        case RiskMessage::ORDER_REJECTED_SYMBOL_HALTED:  return "Order rejected: Symbol halted after loss limit";
+        case RiskMessage::FILL_EXCEEDED_NOTIONAL_LIMIT:  return "Fill took notional past its limit";
+        case RiskMessage::FILL_EXCEEDED_ASSET_LIMIT:     return "Fill took asset exposure past its limit";
+        case RiskMessage::FILL_EXCEEDED_GROSS_NOTIONAL:  return "Fill took gross notional past its limit";
+        case RiskMessage::FILL_EXCEEDED_NET_NOTIONAL:    return "Fill took net notional past its limit";
+        case RiskMessage::SYMBOL_LOSS_LIMIT_EXCEEDED:    return "Symbol loss limit exceeded";
+    }
+    return "UNKNOWN";
+}
+
+const char* to_string(RiskEventType type) {
+    switch (type) {
+        case RiskEventType::POSITION_LIMIT_EXCEEDED:   return "POSITION_LIMIT_EXCEEDED";
+        case RiskEventType::NOTIONAL_LIMIT_EXCEEDED:   return "NOTIONAL_LIMIT_EXCEEDED";
+        case RiskEventType::SYMBOL_LOSS_LIMIT_EXCEEDED: return "SYMBOL_LOSS_LIMIT_EXCEEDED";
+        case RiskEventType::EXPOSURE_LIMIT_EXCEEDED:   return "EXPOSURE_LIMIT_EXCEEDED";
+        case RiskEventType::DAILY_LOSS_LIMIT_EXCEEDED: return "DAILY_LOSS_LIMIT_EXCEEDED";
+        case RiskEventType::DRAWDOWN_LIMIT_EXCEEDED:   return "DRAWDOWN_LIMIT_EXCEEDED";
+        case RiskEventType::ORDER_RATE_LIMIT_EXCEEDED: return "ORDER_RATE_LIMIT_EXCEEDED";
+        case RiskEventType::CIRCUIT_BREAKER_TRIGGERED: return "CIRCUIT_BREAKER_TRIGGERED";
+        case RiskEventType::SYSTEM_INFO:               return "SYSTEM_INFO";
+        case RiskEventType::POSITION_WARNING:          return "POSITION_WARNING";
+        case RiskEventType::PNL_WARNING:               return "PNL_WARNING";
+    }
+    return "UNKNOWN";
+}
+
+const char* to_string(RiskLevel level) {
+    switch (level) {
+        case RiskLevel::INFO:      return "INFO";
+        case RiskLevel::WARNING:   return "WARNING";
+        case RiskLevel::CRITICAL:  return "CRITICAL";
+        case RiskLevel::EMERGENCY: return "EMERGENCY";
+    }
+    return "UNKNOWN";
+}
+
 RiskManager::RiskManager() {
     daily_reset_time_ = std::chrono::system_clock::now();
 }
@@ -16,6 +92,7 @@ RiskManager::~RiskManager() {
 
 bool RiskManager::initialize(const std::string& /*config_file*/) {
     loadConfiguration();
+    startEventDrainer();
 
     auto now = std::chrono::system_clock::now();
     auto tt = std::chrono::system_clock::to_time_t(now);
@@ -27,7 +104,7 @@ bool RiskManager::initialize(const std::string& /*config_file*/) {
     daily_reset_time_ = std::chrono::system_clock::from_time_t(std::mktime(&tm_buf));
 
     recordRiskEvent(RiskEventType::SYSTEM_INFO, RiskLevel::INFO,
-                    "Risk Manager initialized successfully");
+                    RiskMessage::RISK_MANAGER_INITIALIZED);
 
     std::cout << "Risk Manager initialized with limits:" << std::endl;
     std::cout << "   Daily Loss Limit: $" << std::abs(max_daily_loss_limit_) << std::endl;
@@ -38,31 +115,62 @@ bool RiskManager::initialize(const std::string& /*config_file*/) {
 }
 
 void RiskManager::shutdown() {
+    if (shutdown_called_) return;
+    shutdown_called_ = true;
+
     recordRiskEvent(RiskEventType::SYSTEM_INFO, RiskLevel::INFO,
-                    "Risk Manager shutting down");
+                    RiskMessage::RISK_MANAGER_SHUTDOWN);
+    stopEventDrainer();
+
+    uint64_t dropped = dropped_risk_events_.load(std::memory_order_relaxed);
+    if (dropped > 0) {
+        std::cout << "Risk event ring overflowed: " << dropped << " events dropped" << std::endl;
+    }
     std::cout << "Risk Manager shutdown complete" << std::endl;
 }
 
 bool RiskManager::canPlaceOrder(const std::string& symbol, const std::string& side,
-                                double /*price*/, double quantity, std::string& rejection_reason) {
+                                double price, double quantity, std::string& rejection_reason) {
+    return canPlaceOrder(SymbolRegistry::getInstance().find(symbol), side == "BUY" ? Side::BUY : Side::SELL,
+                         price, quantity, rejection_reason);
+}
+
+bool RiskManager::canPlaceOrder(uint32_t symbol_id, Side side, double price, double quantity,
+                                std::string& rejection_reason) {
+    refreshConfig();
     rejection_reason.clear();
 
     if (circuit_breaker_active_.load()) {
-        std::lock_guard<std::mutex> lock(financial_mutex_);
-        rejection_reason = "Circuit breaker active: " + circuit_breaker_reason_;
+        rejection_reason = std::string("Circuit breaker active: ") +
+            to_string(circuit_breaker_reason_.load(std::memory_order_relaxed));
         return false;
     }
 
-    if (!checkPositionLimits(symbol, side, quantity)) {
-        double limit = 0.0;
-        {
-            std::lock_guard<std::mutex> lock(position_mutex_);
-            auto it = position_limits_.find(symbol);
-            if (it != position_limits_.end()) limit = it->second;
+    // Unregistered symbols carry no per-symbol limits.
+    const bool registered = symbol_id < SymbolRegistry::getInstance().symbolCount();
+    static const std::string kNoSymbol;
+    const std::string& symbol = registered ? SymbolRegistry::getInstance().symbolName(symbol_id) : kNoSymbol;
+
+    const RiskMessage violation = registered ? checkPositionLimits(symbol_id, side, price, quantity)
+                                             : RiskMessage::NONE;
+    if (violation != RiskMessage::NONE) {
+        rejection_reason = std::string(to_string(violation)) + " for " + symbol;
+        switch (violation) {
+            case RiskMessage::ORDER_REJECTED_POSITION_LIMIT:
+                recordRiskEvent(RiskEventType::POSITION_LIMIT_EXCEEDED, RiskLevel::CRITICAL, violation,
+                                symbol, quantity, symbol_risk_[symbol_id].position_limit);
+                break;
+            case RiskMessage::ORDER_REJECTED_NOTIONAL_LIMIT:
+                recordRiskEvent(RiskEventType::NOTIONAL_LIMIT_EXCEEDED, RiskLevel::CRITICAL, violation,
+                                symbol, quantity * price, symbol_risk_[symbol_id].notional_limit);
+                break;
+            case RiskMessage::ORDER_REJECTED_EXPOSURE_LIMIT:
+                recordRiskEvent(RiskEventType::EXPOSURE_LIMIT_EXCEEDED, RiskLevel::CRITICAL, violation,
+                                symbol, quantity * price);
+                break;
+            default:
+                break;  // halted: recorded once when the symbol hit its loss limit
         }
-        rejection_reason = "Position limit exceeded for " + symbol;
-        recordRiskEvent(RiskEventType::POSITION_LIMIT_EXCEEDED, RiskLevel::CRITICAL,
-                        "Order rejected: Position limit exceeded", symbol, quantity, limit);
         return false;
     }
 
@@ -74,13 +182,38 @@ bool RiskManager::canPlaceOrder(const std::string& symbol, const std::string& si
     if (!checkOperationalLimits()) {
         rejection_reason = "Order rate limit exceeded";
         recordRiskEvent(RiskEventType::ORDER_RATE_LIMIT_EXCEEDED, RiskLevel::WARNING,
-                        "Order rejected: Rate limit exceeded");
+                        RiskMessage::ORDER_REJECTED_RATE_LIMIT, symbol);
         return false;
     }
 
     return true;
 }
 
+bool RiskManager::canTrade(uint32_t symbol_id, Side side, double price, double quantity,
+                           std::string& rejection_reason) {
+    refreshConfig();
+    rejection_reason.clear();
+
+    if (circuit_breaker_active_.load()) {
+        rejection_reason = std::string("Circuit breaker active: ") +
+            to_string(circuit_breaker_reason_.load(std::memory_order_relaxed));
+        return false;
+    }
+    if (symbol_id < SymbolRegistry::getInstance().symbolCount()) {
+        const RiskMessage violation = checkPositionLimits(symbol_id, side, price, quantity);
+        if (violation != RiskMessage::NONE) {
+            rejection_reason = std::string(to_string(violation)) + " for " +
+                SymbolRegistry::getInstance().symbolName(symbol_id);
+            return false;
+        }
+    }
+    if (!checkFinancialLimits(0.0)) {
+        rejection_reason = "Financial risk limits exceeded";
+        return false;
+    }
+    return true;
+}
+
 void RiskManager::updatePnL(double pnl_change) {
     std::lock_guard<std::mutex> lock(financial_mutex_);
 
@@ -93,26 +226,149 @@ void RiskManager::updatePnL(double pnl_change) {
 
     if (daily_pnl_ <= max_daily_loss_limit_) {
         recordRiskEvent(RiskEventType::DAILY_LOSS_LIMIT_EXCEEDED, RiskLevel::EMERGENCY,
-                        "Daily loss limit exceeded: $" + std::to_string(daily_pnl_));
-        triggerCircuitBreaker("Daily loss limit exceeded");
+                        RiskMessage::DAILY_LOSS_LIMIT_EXCEEDED, "", daily_pnl_, max_daily_loss_limit_);
+        triggerCircuitBreaker(RiskMessage::DAILY_LOSS_LIMIT_EXCEEDED);
     }
 
     double current_drawdown = peak_pnl_ - current_pnl_;
     if (current_drawdown >= std::abs(max_drawdown_limit_)) {
         recordRiskEvent(RiskEventType::DRAWDOWN_LIMIT_EXCEEDED, RiskLevel::EMERGENCY,
-                        "Drawdown limit exceeded: $" + std::to_string(current_drawdown));
-        triggerCircuitBreaker("Drawdown limit exceeded");
+                        RiskMessage::DRAWDOWN_LIMIT_EXCEEDED, "", current_drawdown, std::abs(max_drawdown_limit_));
+        triggerCircuitBreaker(RiskMessage::DRAWDOWN_LIMIT_EXCEEDED);
     }
 
     if (daily_pnl_ <= max_daily_loss_limit_ * 0.7) {
         recordRiskEvent(RiskEventType::PNL_WARNING, RiskLevel::WARNING,
-                        "Approaching daily loss limit: $" + std::to_string(daily_pnl_));
+                        RiskMessage::APPROACHING_DAILY_LOSS_LIMIT, "", daily_pnl_, max_daily_loss_limit_);
     }
 }
 
 void RiskManager::updatePosition(const std::string& symbol, double position) {
+    uint32_t symbol_id = SymbolRegistry::getInstance().find(symbol);
+    if (symbol_id == SymbolRegistry::kInvalidId) symbol_id = registerSymbol(symbol);
+    if (symbol_id == SymbolRegistry::kInvalidId) return;
+
+    std::lock_guard<std::mutex> lock(position_mutex_);
+    setPosition(symbol_id, position, symbol_risk_[symbol_id].mark_price);
+}
+
+double RiskManager::getPosition(uint32_t symbol_id) const {
+    std::lock_guard<std::mutex> lock(position_mutex_);
+    return symbol_id < SymbolRegistry::kMaxSymbols ? symbol_risk_[symbol_id].position : 0.0;
+}
+
+double RiskManager::getSymbolPnL(uint32_t symbol_id) const {
+    std::lock_guard<std::mutex> lock(position_mutex_);
+    return symbol_id < SymbolRegistry::kMaxSymbols ? symbol_risk_[symbol_id].realized_pnl : 0.0;
+}
+
+double RiskManager::getAssetExposure(uint32_t asset_id) const {
+    std::lock_guard<std::mutex> lock(position_mutex_);
+    return asset_id < SymbolRegistry::kMaxAssets ? asset_risk_[asset_id].exposure : 0.0;
+}
+
+double RiskManager::getGrossNotional() const {
+    std::lock_guard<std::mutex> lock(position_mutex_);
+    return gross_notional_;
+}
+
+double RiskManager::getNetNotional() const {
     std::lock_guard<std::mutex> lock(position_mutex_);
-    positions_[symbol] = position;
+    return net_notional_;
+}
+
+size_t RiskManager::processRiskDeltas() {
+    refreshConfig();
+    size_t applied = 0;
+    RiskDelta delta;
+    while (risk_deltas_.pop(delta)) {
+        applyRiskDelta(delta);
+        ++applied;
+    }
+    return applied;
+}
+
+void RiskManager::applyRiskDelta(const RiskDelta& delta) {
+    ++deltas_applied_;
+    const uint32_t id = delta.symbol_id;
+    if (HFT_UNLIKELY(id >= SymbolRegistry::getInstance().symbolCount())) return;
+    const bool was_active = circuit_breaker_active_.load(std::memory_order_relaxed);
+    const SymbolRegistry& registry = SymbolRegistry::getInstance();
+    const uint32_t base = registry.baseAsset(id);
+    const uint32_t quote = registry.quoteAsset(id);
+
+    // Array slots only; everything below is O(1) in the number of symbols.
+    double pnl_change = 0.0;
+    SymbolRisk symbol_state;
+    AssetRisk base_state;
+    AssetRisk quote_state;
+    double gross_notional = 0.0;
+    double net_notional = 0.0;
+    bool hit_loss_limit = false;
+    {
+        std::lock_guard<std::mutex> lock(position_mutex_);
+        SymbolRisk& state = symbol_risk_[id];
+        setPosition(id, delta.position, delta.price > 0.0 ? delta.price : state.mark_price);
+        pnl_change = delta.realized_pnl - state.realized_pnl;
+        state.realized_pnl = delta.realized_pnl;
+        if (state.loss_limit > 0.0 && !state.halted && state.realized_pnl <= -state.loss_limit) {
+            state.halted = true;
+            hit_loss_limit = true;
+        }
+        symbol_state = state;
+        base_state = asset_risk_[base];
+        if (quote != SymbolRegistry::kInvalidId) quote_state = asset_risk_[quote];
+        gross_notional = gross_notional_;
+        net_notional = net_notional_;
+    }
+
+    // Orders are checked before they are sent; these catch fills that overshoot anyway. An
+    // overshoot trips the breaker: probes would still find the reducing side tradeable, so
+    // the breach flag would otherwise never go up.
+    const std::string& symbol = registry.symbolName(id);
+    const double notional = symbol_state.position * symbol_state.mark_price;
+    RiskMessage overshoot = RiskMessage::NONE;
+    const auto exceeded = [&](RiskEventType type, RiskMessage message, const std::string& name,
+                              double value, double limit) {
+        recordRiskEvent(type, RiskLevel::CRITICAL, message, name, value, limit);
+        if (overshoot == RiskMessage::NONE) overshoot = message;
+    };
+    if (symbol_state.position_limit > 0.0 && std::abs(symbol_state.position) > symbol_state.position_limit) {
+        exceeded(RiskEventType::POSITION_LIMIT_EXCEEDED, RiskMessage::FILL_EXCEEDED_POSITION_LIMIT, symbol,
+                 symbol_state.position, symbol_state.position_limit);
+    }
+    if (symbol_state.notional_limit > 0.0 && std::abs(notional) > symbol_state.notional_limit) {
+        exceeded(RiskEventType::NOTIONAL_LIMIT_EXCEEDED, RiskMessage::FILL_EXCEEDED_NOTIONAL_LIMIT, symbol,
+                 notional, symbol_state.notional_limit);
+    }
+    if (base_state.limit > 0.0 && std::abs(base_state.exposure) > base_state.limit) {
+        exceeded(RiskEventType::EXPOSURE_LIMIT_EXCEEDED, RiskMessage::FILL_EXCEEDED_ASSET_LIMIT,
+                 registry.assetName(base), base_state.exposure, base_state.limit);
+    }
+    if (quote_state.limit > 0.0 && std::abs(quote_state.exposure) > quote_state.limit) {
+        exceeded(RiskEventType::EXPOSURE_LIMIT_EXCEEDED, RiskMessage::FILL_EXCEEDED_ASSET_LIMIT,
+                 registry.assetName(quote), quote_state.exposure, quote_state.limit);
+    }
+    if (max_gross_notional_ > 0.0 && gross_notional > max_gross_notional_) {
+        exceeded(RiskEventType::EXPOSURE_LIMIT_EXCEEDED, RiskMessage::FILL_EXCEEDED_GROSS_NOTIONAL, "",
+                 gross_notional, max_gross_notional_);
+    }
+    if (max_net_notional_ > 0.0 && std::abs(net_notional) > max_net_notional_) {
+        exceeded(RiskEventType::EXPOSURE_LIMIT_EXCEEDED, RiskMessage::FILL_EXCEEDED_NET_NOTIONAL, "",
+                 net_notional, max_net_notional_);
+    }
+    if (overshoot != RiskMessage::NONE) triggerCircuitBreaker(overshoot);
+    if (hit_loss_limit) {
+        recordRiskEvent(RiskEventType::SYMBOL_LOSS_LIMIT_EXCEEDED, RiskLevel::CRITICAL,
+                        RiskMessage::SYMBOL_LOSS_LIMIT_EXCEEDED, symbol, symbol_state.realized_pnl,
+                        -symbol_state.loss_limit);
+    }
+    if (pnl_change != 0.0) updatePnL(pnl_change);
+
+    if (!was_active && circuit_breaker_active_.load(std::memory_order_relaxed)) {
+        if (delta.fill_tsc != 0) breach_latency_ticks_.store(FastClock::now() - delta.fill_tsc, std::memory_order_relaxed);
+        breach_delta_index_.store(deltas_applied_, std::memory_order_release);
+    }
 }
 
 RiskStatus RiskManager::getCurrentRiskStatus() const {
@@ -120,22 +376,13 @@ RiskStatus RiskManager::getCurrentRiskStatus() const {
         return RiskStatus::EMERGENCY;
     }
 
-    std::lock_guard<std::mutex> lock(events_mutex_);
-    auto now = std::chrono::system_clock::now();
-    auto five_minutes_ago = now - std::chrono::minutes(5);
-
-    int critical_events = 0;
-    int warning_events = 0;
+    const uint64_t now_ns = wall_clock_ns();
+    const auto level_count = [&](RiskLevel level) {
+        return recent_events_by_level_[static_cast<size_t>(level)].count(now_ns);
+    };
 
-    for (const auto& event : risk_events_) {
-        if (event.timestamp > five_minutes_ago) {
-            if (event.level == RiskLevel::CRITICAL || event.level == RiskLevel::EMERGENCY) {
-                critical_events++;
-            } else if (event.level == RiskLevel::WARNING) {
-                warning_events++;
-            }
-        }
-    }
+    uint64_t critical_events = level_count(RiskLevel::CRITICAL) + level_count(RiskLevel::EMERGENCY);
+    uint64_t warning_events = level_count(RiskLevel::WARNING);
 
     if (critical_events > 0) return RiskStatus::CRITICAL;
     if (warning_events > 3) return RiskStatus::WARNING;
@@ -149,46 +396,127 @@ bool RiskManager::isCircuitBreakerActive() const {
 
 void RiskManager::loadConfiguration() {
     Config& config = Config::getInstance();
+    registerSymbol(config.getConfig("TRADING_SYMBOL", "ETH-USD"));
+    for (const auto& symbol : config.getTradingSymbols()) registerSymbol(symbol);
+    refreshConfig();
+}
 
-    std::string trading_symbol = config.getConfig("TRADING_SYMBOL", "ETH-USD");
-    double position_limit = std::stod(config.getConfig("POSITION_LIMIT_ETHUSDT", "1.0"));
-    double daily_loss_limit = std::stod(config.getConfig("MAX_DAILY_LOSS_LIMIT", "100.0"));
-    double drawdown_limit = std::stod(config.getConfig("MAX_DRAWDOWN_LIMIT", "50.0"));
-    uint64_t order_rate_limit = static_cast<uint64_t>(config.getOrderRateLimit());
+void RiskManager::refreshConfig() {
+    const ConfigSnapshot* config = Config::snapshot();
+    if (HFT_LIKELY(config == applied_config_.load(std::memory_order_relaxed))) return;
+    if (applied_config_.exchange(config) == config) return;
 
-    {
-        std::lock_guard<std::mutex> lock(position_mutex_);
-        position_limits_[trading_symbol] = position_limit;
-    }
     {
         std::lock_guard<std::mutex> lock(financial_mutex_);
-        max_daily_loss_limit_ = -std::abs(daily_loss_limit);
-        max_drawdown_limit_ = -std::abs(drawdown_limit);
+        max_daily_loss_limit_ = -config->max_daily_loss;
+        max_drawdown_limit_ = -config->max_drawdown;
     }
     {
         std::lock_guard<std::mutex> lock(operational_mutex_);
-        max_orders_per_second_ = order_rate_limit;
+        max_orders_per_second_ = config->order_rate_limit;
+    }
+    {
+        std::lock_guard<std::mutex> lock(position_mutex_);
+        max_gross_notional_ = config->max_gross_notional;
+        max_net_notional_ = config->max_net_notional;
     }
+    // Per-symbol keys are open-ended, so they are re-read from the loaded values; this only
+    // runs when a new snapshot was published.
+    const uint32_t symbol_count = SymbolRegistry::getInstance().symbolCount();
+    for (uint32_t id = 0; id < symbol_count; ++id) loadSymbolLimits(id);
 }
 
-bool RiskManager::checkPositionLimits(const std::string& symbol, const std::string& side, double quantity) const {
-    std::lock_guard<std::mutex> lock(position_mutex_);
+uint32_t RiskManager::registerSymbol(const std::string& symbol) {
+    const uint32_t id = SymbolRegistry::getInstance().intern(symbol);
+    if (id == SymbolRegistry::kInvalidId) {
+        std::cerr << "Risk: symbol table full, " << symbol << " has no per-symbol limits" << std::endl;
+        return id;
+    }
+    loadSymbolLimits(id);
+    return id;
+}
 
-    auto limit_it = position_limits_.find(symbol);
-    if (limit_it == position_limits_.end()) {
-        return true;
+void RiskManager::loadSymbolLimits(uint32_t symbol_id) {
+    Config& config = Config::getInstance();
+    const SymbolRegistry& registry = SymbolRegistry::getInstance();
+    const std::string& symbol = registry.symbolName(symbol_id);
+    const std::string key = SymbolRegistry::configKey(symbol);
+    double position_limit = configLimit(config, "POSITION_LIMIT_" + key, 0.0);
+    if (position_limit == 0.0 && symbol == config.getConfig("TRADING_SYMBOL", "ETH-USD")) {
+        // Single-symbol key from before per-symbol limits.
+        position_limit = configLimit(config, "POSITION_LIMIT_ETHUSDT", 1.0);
+    }
+    const double notional_limit = configLimit(config, "NOTIONAL_LIMIT_" + key, 0.0);
+    const double loss_limit = configLimit(config, "LOSS_LIMIT_" + key, 0.0);
+
+    std::lock_guard<std::mutex> lock(position_mutex_);
+    SymbolRisk& state = symbol_risk_[symbol_id];
+    state.position_limit = position_limit;
+    state.notional_limit = notional_limit;
+    state.loss_limit = loss_limit;
+    for (uint32_t asset : {registry.baseAsset(symbol_id), registry.quoteAsset(symbol_id)}) {
+        if (asset == SymbolRegistry::kInvalidId) continue;
+        asset_risk_[asset].limit = configLimit(
+            config, "ASSET_LIMIT_" + SymbolRegistry::configKey(registry.assetName(asset)), 0.0);
     }
+}
+
+void RiskManager::setPosition(uint32_t symbol_id, double position, double mark_price) {
+    SymbolRisk& state = symbol_risk_[symbol_id];
+    const double old_notional = state.position * state.mark_price;
+    const double new_notional = position * mark_price;
+
+    gross_notional_ += std::abs(new_notional) - std::abs(old_notional);
+    net_notional_ += new_notional - old_notional;
+    const SymbolRegistry& registry = SymbolRegistry::getInstance();
+    asset_risk_[registry.baseAsset(symbol_id)].exposure += position - state.position;
+    const uint32_t quote = registry.quoteAsset(symbol_id);
+    if (quote != SymbolRegistry::kInvalidId) asset_risk_[quote].exposure -= new_notional - old_notional;
+
+    state.position = position;
+    state.mark_price = mark_price;
+}
+
+RiskMessage RiskManager::checkPositionLimits(uint32_t symbol_id, Side side, double price, double quantity) const {
+    std::lock_guard<std::mutex> lock(position_mutex_);
+
+    const SymbolRisk& state = symbol_risk_[symbol_id];
+    if (state.halted) return RiskMessage::ORDER_REJECTED_SYMBOL_HALTED;
 
-    double current_position = 0.0;
-    auto pos_it = positions_.find(symbol);
-    if (pos_it != positions_.end()) {
-        current_position = pos_it->second;
+    const double position_change = (side == Side::BUY) ? quantity : -quantity;
+    const double new_position = state.position + position_change;
+    if (state.position_limit > 0.0 && std::abs(new_position) > state.position_limit) {
+        return RiskMessage::ORDER_REJECTED_POSITION_LIMIT;
+    }
+    if (state.notional_limit > 0.0 && std::abs(new_position * price) > state.notional_limit) {
+        return RiskMessage::ORDER_REJECTED_NOTIONAL_LIMIT;
     }
 
-    double position_change = (side == "BUY") ? quantity : -quantity;
-    double new_position = current_position + position_change;
+    // Exposure limits only block orders that would grow an exposure already past its limit.
+    const auto breaches = [](double current, double projected, double limit) {
+        return limit > 0.0 && std::abs(projected) > limit && std::abs(projected) > std::abs(current);
+    };
+    const SymbolRegistry& registry = SymbolRegistry::getInstance();
+    const AssetRisk& base = asset_risk_[registry.baseAsset(symbol_id)];
+    if (breaches(base.exposure, base.exposure + position_change, base.limit)) {
+        return RiskMessage::ORDER_REJECTED_EXPOSURE_LIMIT;
+    }
+    const uint32_t quote_id = registry.quoteAsset(symbol_id);
+    if (quote_id != SymbolRegistry::kInvalidId) {
+        const AssetRisk& quote = asset_risk_[quote_id];
+        if (breaches(quote.exposure, quote.exposure - position_change * price, quote.limit)) {
+            return RiskMessage::ORDER_REJECTED_EXPOSURE_LIMIT;
+        }
+    }
 
-    return std::abs(new_position) <= limit_it->second;
+    const double old_notional = state.position * state.mark_price;
+    const double new_notional = new_position * price;
+    const double gross = gross_notional_ - std::abs(old_notional) + std::abs(new_notional);
+    const double net = net_notional_ - old_notional + new_notional;
+    if (breaches(gross_notional_, gross, max_gross_notional_) || breaches(net_notional_, net, max_net_notional_)) {
+        return RiskMessage::ORDER_REJECTED_EXPOSURE_LIMIT;
+    }
+    return RiskMessage::NONE;
 }
 
 bool RiskManager::checkFinancialLimits(double estimated_pnl_impact) const {
@@ -211,60 +539,133 @@ bool RiskManager::checkFinancialLimits(double estimated_pnl_impact) const {
 bool RiskManager::checkOperationalLimits() {
     std::lock_guard<std::mutex> lock(operational_mutex_);
 
-    auto now = std::chrono::system_clock::now();
+    const uint64_t now = FastClock::now();
     recent_orders_.push_back(now);
 
-    cleanupOldOrders();
+    cleanupOldOrders(now);
 
-    auto one_second_ago = now - std::chrono::seconds(1);
+    const uint64_t one_second = FastClock::getInstance().nanosToTicks(1000000000ULL);
     uint64_t orders_last_second = std::count_if(recent_orders_.begin(), recent_orders_.end(),
-        [one_second_ago](const auto& timestamp) {
-            return timestamp > one_second_ago;
+        [now, one_second](uint64_t timestamp) {
+            return now - timestamp < one_second;
         });
 
     return orders_last_second < max_orders_per_second_;
 }
 
-void RiskManager::triggerCircuitBreaker(const std::string& reason) {
-    circuit_breaker_reason_ = reason;
-    circuit_breaker_active_.store(true);
+void RiskManager::triggerCircuitBreaker(RiskMessage reason) {
+    circuit_breaker_reason_.store(reason, std::memory_order_relaxed);
+    const bool was_active = circuit_breaker_active_.exchange(true);
+    if (breach_flag_) breach_flag_->store(true);
 
-    recordRiskEvent(RiskEventType::CIRCUIT_BREAKER_TRIGGERED, RiskLevel::EMERGENCY,
-                    "Circuit breaker triggered: " + reason);
-
-    std::cout << "CIRCUIT BREAKER TRIGGERED: " << reason << std::endl;
+    recordRiskEvent(RiskEventType::CIRCUIT_BREAKER_TRIGGERED, RiskLevel::EMERGENCY, reason);
+    if (!was_active) {
+        FlightRecorder::record(FlightEventType::CIRCUIT_BREAKER, 0.0, 0.0, static_cast<uint32_t>(reason));
+        FlightRecorder::getInstance().requestDump("circuit_breaker");
+    }
 }
 
-void RiskManager::recordRiskEvent(RiskEventType type, RiskLevel level, const std::string& message,
+void RiskManager::recordRiskEvent(RiskEventType type, RiskLevel level, RiskMessage message,
                                   const std::string& symbol, double value, double limit) {
-    std::lock_guard<std::mutex> lock(events_mutex_);
-
     RiskEvent event;
     event.type = type;
     event.level = level;
     event.message = message;
-    event.timestamp = std::chrono::system_clock::now();
-    event.symbol = symbol;
+    event.timestamp_ns = wall_clock_ns();
+    set_symbol(event.symbol, symbol);
     event.value = value;
     event.limit = limit;
 
-    risk_events_.push_back(event);
-
-    if (risk_events_.size() > MAX_RISK_EVENTS) {
-        risk_events_.erase(risk_events_.begin(), risk_events_.begin() + static_cast<long>(risk_events_.size() - MAX_RISK_EVENTS));
-    }
+    recent_events_by_level_[static_cast<size_t>(level)].record(event.timestamp_ns);
+    FlightRecorder::record(FlightEventType::RISK, value, limit, static_cast<uint32_t>(message),
+                           static_cast<uint16_t>(static_cast<unsigned>(type) | static_cast<unsigned>(level) << 8));
 
-    if (level == RiskLevel::CRITICAL || level == RiskLevel::EMERGENCY) {
-        std::cout << "RISK EVENT: " << message << std::endl;
+    if (HFT_UNLIKELY(!risk_events_.push(event))) {
+        dropped_risk_events_.fetch_add(1, std::memory_order_relaxed);
     }
 }
 
-void RiskManager::cleanupOldOrders() {
-    auto five_seconds_ago = std::chrono::system_clock::now() - std::chrono::seconds(5);
+void RiskManager::cleanupOldOrders(uint64_t now) {
+    const uint64_t five_seconds = FastClock::getInstance().nanosToTicks(5000000000ULL);
     recent_orders_.erase(
         std::remove_if(recent_orders_.begin(), recent_orders_.end(),
-            [five_seconds_ago](const auto& timestamp) {
-                return timestamp < five_seconds_ago;
+            [now, five_seconds](uint64_t timestamp) {
+                return now - timestamp > five_seconds;
             }),
         recent_orders_.end());
 }
+
+void RiskManager::startEventDrainer() {
+    if (event_drain_running_.exchange(true)) return;
+    event_drain_thread_ = std::thread(&RiskManager::eventDrainWorker, this);
+}
+
+void RiskManager::stopEventDrainer() {
+    event_drain_running_.store(false);
+    if (event_drain_thread_.joinable()) {
+        event_drain_thread_.join();
+    }
+}
+
+void RiskManager::eventDrainWorker() {
+    std::ofstream event_log;
+    std::string batch;
+    batch.reserve(16384);
+
+    bool running = true;
+    while (running) {
+        // Read the flag before draining so events pushed ahead of shutdown are never lost.
+        running = event_drain_running_.load();
+
+        RiskEvent event;
+        while (risk_events_.pop(event)) {
+            formatRiskEvent(event, batch);
+            if (event.level == RiskLevel::CRITICAL || event.level == RiskLevel::EMERGENCY) {
+                if (event.type == RiskEventType::CIRCUIT_BREAKER_TRIGGERED) {
+                    std::cout << "CIRCUIT BREAKER TRIGGERED: " << to_string(event.message) << '\n';
+                } else {
+                    std::cout << "RISK EVENT: " << to_string(event.message) << '\n';
+                }
+            }
+        }
+
+        if (!batch.empty()) {
+            // Prefer the logger thread (rotation/retention); fall back to a direct append
+            // when it is not running.
+            if (!Logger::getInstance().writeBlock(LogStream::RISK_EVENTS, batch)) {
+                if (!event_log.is_open()) event_log.open("logs/risk_events.log", std::ios::app);
+                if (event_log.is_open()) {
+                    event_log.write(batch.data(), static_cast<std::streamsize>(batch.size()));
+                    event_log.flush();
+                }
+            }
+            batch.clear();
+        } else if (running) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+}
+
+void RiskManager::formatRiskEvent(const RiskEvent& event, std::string& out) {
+    auto seconds = static_cast<std::time_t>(event.timestamp_ns / 1000000000ULL);
+    auto millis = static_cast<unsigned>((event.timestamp_ns / 1000000ULL) % 1000ULL);
+    struct tm tm_buf{};
+    localtime_r(&seconds, &tm_buf);
+
+    char line[256];
+    size_t len = std::strftime(line, sizeof(line), "%Y-%m-%d %H:%M:%S", &tm_buf);
+    int n = std::snprintf(line + len, sizeof(line) - len, ".%03u [%s] %s: %s",
+                          millis, to_string(event.level), to_string(event.type), to_string(event.message));
+    if (n > 0) len = std::min(sizeof(line) - 1, len + static_cast<size_t>(n));
+    out.append(line, len);
+
+    if (event.symbol[0] != '\0') {
+        out.append(" symbol=");
+        out.append(event.symbol.data());
+    }
+    if (event.value != 0.0 || event.limit != 0.0) {
+        n = std::snprintf(line, sizeof(line), " value=%.6f limit=%.6f", event.value, event.limit);
+        if (n > 0) out.append(line, std::min(sizeof(line) - 1, static_cast<size_t>(n)));
+    }
+    out.push_back('\n');
+}
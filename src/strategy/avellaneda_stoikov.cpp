@@ -0,0 +1,37 @@
+#include "strategy/avellaneda_stoikov.h"
+#include "core/fast_clock.h"
+#include <cmath>
+
+namespace {
+constexpr double kLn2 = 0.69314718055994530942;
+}
+
+MarketEstimator::MarketEstimator()
+    : seconds_per_tick_(FastClock::getInstance().nanosPerTick() * 1e-9)
+{
+}
+
+void MarketEstimator::update(double bid, double ask, uint64_t tsc, double half_life_seconds) {
+    if (HFT_UNLIKELY(bid <= 0.0 || ask <= 0.0)) return;
+    const double mid = (bid + ask) * 0.5;
+    if (HFT_UNLIKELY(!primed_)) {
+        last_mid_ = mid;
+        last_tsc_ = tsc;
+        primed_ = true;
+        return;
+    }
+
+    const double dt = tsc > last_tsc_ ? static_cast<double>(tsc - last_tsc_) * seconds_per_tick_ : 0.0;
+    const double decay = std::exp(-dt * (kLn2 / half_life_seconds));
+    const double move = mid - last_mid_;
+    const double moved = move != 0.0 ? 1.0 : 0.0;
+
+    elapsed_ = elapsed_ * decay + dt;
+    squared_moves_ = squared_moves_ * decay + move * move;
+    absolute_moves_ = absolute_moves_ * decay + std::abs(move);
+    moves_ = moves_ * decay + moved;
+    moves_seen_ += static_cast<uint64_t>(moved);
+
+    last_mid_ = mid;
+    if (tsc > last_tsc_) last_tsc_ = tsc;
+}
@@ -0,0 +1,80 @@
+#include "strategy/fair_value.h"
+#include "core/config.h"
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+static_assert(FairValue::kLevels % 2 == 0, "levels are summed two at a time");
+
+void FairValue::rebuildWeights(double decay) {
+    double weight = 1.0;
+    for (auto& w : weights_) {
+        w = weight;
+        weight *= decay;
+    }
+    weights_decay_ = decay;
+}
+
+double FairValue::update(const HFTMarketData& market_data) {
+    const ConfigSnapshot& config = *Config::snapshot();
+    const DepthSnapshot& depth = market_data.depth;
+    const double mid = (market_data.bid_price + market_data.ask_price) * 0.5;
+    const size_t levels = std::min(depth.bid_levels, depth.ask_levels);
+    if (HFT_UNLIKELY(levels == 0)) {
+        value_ = microprice_ = pressure_ = mid;
+        imbalance_ = offset_ = 0.0;
+        return value_;
+    }
+    if (HFT_UNLIKELY(config.fair_value_level_decay != weights_decay_)) {
+        rebuildWeights(config.fair_value_level_decay);
+    }
+
+    // Levels only one side has would pair a price with an empty opposite level; weight them 0.
+    alignas(16) std::array<double, kLevels> weights = weights_;
+    for (size_t i = levels; i < kLevels; ++i) weights[i] = 0.0;
+
+    double bid_sum;
+    double ask_sum;
+    double cross_sum;
+#if defined(__SSE2__)
+    __m128d bid_acc = _mm_setzero_pd();
+    __m128d ask_acc = _mm_setzero_pd();
+    __m128d cross_acc = _mm_setzero_pd();
+    for (size_t i = 0; i < kLevels; i += 2) {
+        const __m128d w = _mm_load_pd(&weights[i]);
+        const __m128d bid_qty = _mm_mul_pd(w, _mm_load_pd(&depth.bid_quantity[i]));
+        const __m128d ask_qty = _mm_mul_pd(w, _mm_load_pd(&depth.ask_quantity[i]));
+        bid_acc = _mm_add_pd(bid_acc, bid_qty);
+        ask_acc = _mm_add_pd(ask_acc, ask_qty);
+        cross_acc = _mm_add_pd(cross_acc, _mm_add_pd(_mm_mul_pd(_mm_load_pd(&depth.bid_price[i]), ask_qty),
+                                                     _mm_mul_pd(_mm_load_pd(&depth.ask_price[i]), bid_qty)));
+    }
+    bid_sum = _mm_cvtsd_f64(_mm_add_sd(bid_acc, _mm_unpackhi_pd(bid_acc, bid_acc)));
+    ask_sum = _mm_cvtsd_f64(_mm_add_sd(ask_acc, _mm_unpackhi_pd(ask_acc, ask_acc)));
+    cross_sum = _mm_cvtsd_f64(_mm_add_sd(cross_acc, _mm_unpackhi_pd(cross_acc, cross_acc)));
+#else
+    bid_sum = ask_sum = cross_sum = 0.0;
+    for (size_t i = 0; i < kLevels; ++i) {
+        const double bid_qty = weights[i] * depth.bid_quantity[i];
+        const double ask_qty = weights[i] * depth.ask_quantity[i];
+        bid_sum += bid_qty;
+        ask_sum += ask_qty;
+        cross_sum += depth.bid_price[i] * ask_qty + depth.ask_price[i] * bid_qty;
+    }
+#endif
+
+    const double top_total = depth.bid_quantity[0] + depth.ask_quantity[0];
+    const double total = bid_sum + ask_sum;
+    microprice_ = top_total > 0.0
+        ? (depth.bid_price[0] * depth.ask_quantity[0] + depth.ask_price[0] * depth.bid_quantity[0]) / top_total
+        : mid;
+    pressure_ = total > 0.0 ? cross_sum / total : mid;
+    imbalance_ = total > 0.0 ? (bid_sum - ask_sum) / total : 0.0;
+
+    const double depth_weight = config.fair_value_depth_weight;
+    offset_ = config.fair_value_skew * ((1.0 - depth_weight) * (microprice_ - mid) + depth_weight * (pressure_ - mid));
+    value_ = mid + offset_;
+    return value_;
+}
@@ -0,0 +1,24 @@
+#include "strategy/strategy_registry.h"
+
+static_assert(std::is_same<std::variant_alternative_t<static_cast<size_t>(StrategyKind::FIXED_SPREAD), StrategyVariant>,
+                           MarketMakingStrategy>::value, "StrategyKind must index StrategyVariant");
+static_assert(std::is_same<std::variant_alternative_t<static_cast<size_t>(StrategyKind::AVELLANEDA_STOIKOV), StrategyVariant>,
+                           AvellanedaStoikovStrategy>::value, "StrategyKind must index StrategyVariant");
+
+const char* to_string(StrategyKind kind) {
+    switch (kind) {
+        case StrategyKind::FIXED_SPREAD:       return "fixed_spread";
+        case StrategyKind::AVELLANEDA_STOIKOV: return "avellaneda_stoikov";
+    }
+    return "unknown";
+}
+
+bool parseStrategyKind(const std::string& text, StrategyKind& kind) {
+    for (StrategyKind candidate : {StrategyKind::FIXED_SPREAD, StrategyKind::AVELLANEDA_STOIKOV}) {
+        if (text == to_string(candidate)) {
+            kind = candidate;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,656 @@
+#include "engine_shard.h"
+#include "core/logger.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
+#include "core/idle_strategy.h"
+#include "core/jwt_signer.h"
+#include "core/spsc_queue.h"
+#include "data/market_data.h"
+#include "execution/coinbase_encoder.h"
+#include "execution/executor.h"
+#include "execution/sim_gateway.h"
+#include "metrics/latency_histogram.h"
+#include "metrics/metrics.h"
+#include "order/order_manager.h"
+#include "strategy/avellaneda_stoikov.h"
+#include "strategy/fair_value.h"
+#include "strategy/market_maker.h"
+#include "strategy/strategy_registry.h"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <time.h>
+
+namespace {
+
+template<typename Fn>
+double ns_per_call(uint64_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (uint64_t i = 0; i < iterations; ++i) {
+        fn(i);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())
+        / static_cast<double>(iterations);
+}
+
+// MarketMakingStrategy's quote written out by hand: the baseline the CRTP path should match.
+HFTSignal hand_inlined_quote(const StrategyInput& input) {
+    const ConfigSnapshot& config = *input.config;
+    HFTSignal signal{};
+    signal.place_bid = signal.place_ask = true;
+    signal.num_levels = config.order_ladder_levels;
+    const double shift = input.fair_value - (input.bid + input.ask) / 2.0;
+    signal.bid_price = input.bid - config.spread_offset + shift;
+    signal.ask_price = input.ask + config.spread_offset + shift;
+    if ((signal.ask_price - signal.bid_price) < config.min_spread) {
+        signal.bid_price = input.fair_value - (config.min_spread / 2.0);
+        signal.ask_price = input.fair_value + (config.min_spread / 2.0);
+    }
+    signal.bid_quantity = signal.ask_quantity = input.order_size;
+    if (std::abs(input.position) > config.max_neutral_position) {
+        if (input.position > config.max_neutral_position) {
+            signal.bid_quantity *= 0.5;
+            signal.ask_quantity *= 1.5;
+            signal.ask_price = input.ask + (config.tick_size * 1.5) + shift;
+        } else {
+            signal.ask_quantity *= 0.5;
+            signal.bid_quantity *= 1.5;
+            signal.bid_price = input.bid - (config.tick_size * 1.5) + shift;
+        }
+    }
+    signal.bid_price = std::min(signal.bid_price, input.bid);
+    signal.ask_price = std::max(signal.ask_price, input.ask);
+    const double inventory_penalty = std::min(0.8, std::abs(input.position) / config.inventory_ceiling);
+    if (inventory_penalty > 0.2) {
+        signal.bid_quantity *= (1.0 - inventory_penalty);
+        signal.ask_quantity *= (1.0 - inventory_penalty);
+    }
+    return signal;
+}
+
+// What the engines would pay without compile-time dispatch.
+struct VirtualStrategy {
+    virtual ~VirtualStrategy() = default;
+    virtual HFTSignal on_tick(const StrategyInput& input) = 0;
+};
+
+template<typename StrategyT>
+struct VirtualAdapter final : VirtualStrategy {
+    StrategyT strategy;
+    HFTSignal on_tick(const StrategyInput& input) override { return strategy.on_tick(input); }
+};
+
+// The ladder as OrderExecutor built it before LadderBuilder: one order at a time, each with
+// its own id, symbol copy, clock read and position check.
+uint32_t per_order_ladder(const HFTSignal& signal, const std::string& symbol,
+                          std::atomic<uint64_t>& next_id, double pos, double max_pos, HFTOrder* out) {
+    const double tick_size = Config::snapshot()->tick_size;
+    uint32_t count = 0;
+    const auto build = [&](char side, double price, double qty, uint32_t level) {
+        if (qty < 0.001) return;
+        HFTOrder order{};
+        order.order_id = next_id.fetch_add(1);
+        order.client_order_id = order.order_id;
+        set_symbol(order.symbol, symbol);
+        order.side = side;
+        order.price = price;
+        order.quantity = qty;
+        order.status = 'N';
+        order.built_tsc = FastClock::now();
+        order.priority = level;
+        if (std::abs(pos + (side == 'B' ? qty : -qty)) <= max_pos) out[count++] = order;
+    };
+    for (uint32_t level = 0; level < signal.num_levels; ++level) {
+        const double level_offset = level * tick_size * 0.1;
+        const double level_size_factor = std::max(0.1, 1.0 - level * 0.1);
+        if (signal.place_bid) build('B', signal.bid_price - level_offset, signal.bid_quantity * level_size_factor, level);
+        if (signal.place_ask) build('S', signal.ask_price + level_offset, signal.ask_quantity * level_size_factor, level);
+    }
+    return count;
+}
+
+// Strategy + executor for the tick-to-order comparison; one per engine mode so the
+// histograms stay separate.
+struct TickToOrderRig {
+    OrderManager order_manager;
+    std::unique_ptr<AtomicHFTMetrics> metrics = std::make_unique<AtomicHFTMetrics>();
+    std::atomic<double> position{0.0};
+    std::atomic<bool> breach{false};
+    std::atomic<double> max_position{1.0};
+    MarketMakingStrategy strategy;
+    OrderExecutor executor{"ETH-USD", order_manager, *metrics, position, breach, max_position};
+
+    // Same work as HFTEngine::handle_tick; simulated fills are discarded so the position stays flat.
+    void trade(HFTMarketData& market_data) {
+        HFTSignal signal = strategy.generate_signal(market_data.bid_price, market_data.ask_price, 0.0, 0.005);
+        market_data.trace.signal_tsc = FastClock::now();
+        if (signal.place_bid || signal.place_ask) executor.place_order_ladder(signal, market_data.trace);
+        HFTOrder response{};
+        while (executor.pop_response(response)) {}
+    }
+
+    void report(const char* label) const {
+        HistogramSnapshot snapshot;
+        snapshot.accumulate(metrics->latency(LatencyStage::TICK_TO_TRADE));
+        FastClock& clock = FastClock::getInstance();
+        std::cout << label << "p50 " << clock.ticksToNanos(snapshot.percentile(50.0))
+                  << " / p99 " << clock.ticksToNanos(snapshot.percentile(99.0))
+                  << " / p99.9 " << clock.ticksToNanos(snapshot.percentile(99.9))
+                  << " / max " << clock.ticksToNanos(snapshot.max) << " ns" << std::endl;
+    }
+};
+
+// Synthetic tick: the book has just been updated.
+HFTMarketData make_tick(uint64_t i) {
+    HFTMarketData market_data{};
+    set_symbol(market_data.symbol, "ETH-USD");
+    market_data.bid_price = 1850.50 + static_cast<double>(i % 16) * 0.01;
+    market_data.ask_price = market_data.bid_price + 0.10;
+    market_data.sequence_number = i;
+    market_data.trace.recv_tsc = FastClock::now();
+    market_data.trace.parsed_tsc = market_data.trace.recv_tsc;
+    market_data.trace.book_updated_tsc = market_data.trace.recv_tsc;
+    return market_data;
+}
+
+}  // namespace
+
+int main() {
+    std::cout << "=== HFT Latency Benchmarks ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    std::cout << "\n--- Clock reads ---" << std::endl;
+    FastClock& clock = FastClock::getInstance();
+    constexpr uint64_t kClockReads = 10000000;
+    uint64_t sink = 0;
+    double fast_ns = ns_per_call(kClockReads, [&sink](uint64_t) { sink += FastClock::now(); });
+    double steady_ns = ns_per_call(kClockReads, [&sink](uint64_t) {
+        sink += static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    });
+    double hires_ns = ns_per_call(kClockReads, [&sink](uint64_t) {
+        sink += static_cast<uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+    });
+    double system_ns = ns_per_call(kClockReads, [&sink](uint64_t) {
+        sink += static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    });
+    double gettime_ns = ns_per_call(kClockReads, [&sink](uint64_t) {
+        struct timespec ts{};
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        sink += static_cast<uint64_t>(ts.tv_nsec);
+    });
+    double convert_ns = ns_per_call(kClockReads, [&sink, &clock](uint64_t i) {
+        sink += clock.ticksToNanos(i);
+    });
+
+    std::cout << "FastClock::now (" << (FastClock::usesTsc() ? "TSC" : "steady fallback") << "):  "
+              << fast_ns << " ns/call" << std::endl;
+    std::cout << "steady_clock::now:              " << steady_ns << " ns/call" << std::endl;
+    std::cout << "high_resolution_clock::now:     " << hires_ns << " ns/call" << std::endl;
+    std::cout << "system_clock::now:              " << system_ns << " ns/call" << std::endl;
+    std::cout << "clock_gettime(MONOTONIC):       " << gettime_ns << " ns/call" << std::endl;
+    std::cout << "FastClock::ticksToNanos:        " << convert_ns << " ns/call" << std::endl;
+    std::cout << std::setprecision(4) << "ns/tick: " << clock.nanosPerTick()
+              << std::setprecision(1) << " (checksum " << (sink & 0xff) << ")" << std::endl;
+
+    std::cout << "\n--- Logger (per-call cost on the calling thread) ---" << std::endl;
+    Logger& logger = Logger::getInstance();
+    logger.setConsoleOutput(false);
+    logger.initialize("logs");
+
+    // Stay below the per-thread ring capacity so every call measures the enqueue path,
+    // not the drop path.
+    constexpr uint64_t kLogCalls = Logger::THREAD_BUFFER_RECORDS / 2;
+    for (uint64_t i = 0; i < kLogCalls; ++i) {
+        HFT_LOG_DEBUG("warm-up {}", i);
+        HFT_LOG_INFO("warm-up {}", i);
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+
+    double binary_ns = ns_per_call(kLogCalls, [](uint64_t i) {
+        HFT_LOG_INFO("order {} side {} px {} qty {}", i, 'B', 1850.25 + static_cast<double>(i % 7), 0.005);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    const std::string reason = "Order rate limit exceeded";
+    double string_arg_ns = ns_per_call(kLogCalls, [&reason](uint64_t i) {
+        HFT_LOG_WARNING("risk reject #{}: {}", i, reason);
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    double string_api_ns = ns_per_call(kLogCalls, [&logger](uint64_t) {
+        logger.info("Order engine heartbeat");
+    });
+
+    logger.shutdown();
+
+    std::cout << "HFT_LOG_INFO (4 numeric args):  " << binary_ns << " ns/call" << std::endl;
+    std::cout << "HFT_LOG_WARNING (string arg):   " << string_arg_ns << " ns/call" << std::endl;
+    std::cout << "Logger::info(std::string):      " << string_api_ns << " ns/call" << std::endl;
+    std::cout << "Dropped records: " << logger.droppedRecords() << std::endl;
+
+    std::cout << "\n--- Latency histogram ---" << std::endl;
+    auto histogram = std::make_unique<LatencyHistogram>();
+    constexpr uint64_t kRecords = 10000000;
+    double record_ns = ns_per_call(kRecords, [&histogram](uint64_t i) {
+        histogram->record(200 + (i * 2654435761u) % 50000);
+    });
+    HistogramSnapshot snapshot;
+    double capture_us = ns_per_call(1000, [&snapshot, &histogram](uint64_t) {
+        snapshot.clear();
+        snapshot.accumulate(*histogram);
+    }) / 1000.0;
+
+    std::cout << "LatencyHistogram::record:       " << record_ns << " ns/call" << std::endl;
+    std::cout << "Snapshot capture:               " << capture_us << " us" << std::endl;
+    std::cout << "p50/p99/max: " << snapshot.percentile(50.0) << "/" << snapshot.percentile(99.0)
+              << "/" << snapshot.max << " ns" << std::endl;
+
+    std::cout << "\n--- Flight recorder ---" << std::endl;
+    FlightRecorder& recorder = FlightRecorder::getInstance();
+    recorder.configure(1u << 16, std::chrono::seconds(30), "logs");
+    FlightRecorder::setThreadName("bench");
+    constexpr uint64_t kFlightEvents = 10000000;
+    double flight_ns = ns_per_call(kFlightEvents, [](uint64_t i) {
+        FlightRecorder::record(FlightEventType::BBO, 1850.0, 1850.5, static_cast<uint32_t>(i));
+    });
+    auto dump_start = std::chrono::steady_clock::now();
+    std::string dump_path = recorder.dumpNow("bench");
+    double dump_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - dump_start).count();
+    if (!dump_path.empty()) std::remove(dump_path.c_str());
+
+    std::cout << "FlightRecorder::record:         " << flight_ns << " ns/call" << std::endl;
+    std::cout << "Dump (65536-event ring):        " << dump_ms << " ms" << std::endl;
+
+    std::cout << "\n--- Tick-to-order: pipeline vs hot loop ---" << std::endl;
+    // Book update -> first order of the ladder handed to the sender, one tick in flight at a
+    // time so the numbers are the hand-off cost, not queueing behind a backlog.
+    constexpr uint64_t kTicks = 20000;
+    const unsigned cpus = std::thread::hardware_concurrency();
+
+    auto pipeline = std::make_unique<TickToOrderRig>();
+    auto queue = std::make_unique<SPSCQueue<HFTMarketData, 1024>>();
+    std::atomic<uint64_t> traded{0};
+    std::atomic<bool> consuming{true};
+    std::thread consumer([&] {
+        int idle_count = 0;
+        HFTMarketData market_data{};
+        while (consuming.load(std::memory_order_relaxed)) {
+            if (queue->pop(market_data)) {
+                market_data.trace.dequeued_tsc = FastClock::now();
+                pipeline->trade(market_data);
+                traded.fetch_add(1, std::memory_order_release);
+                idle_count = 0;
+            } else if (++idle_count < kIdleSpinFallbackThreshold) {
+                for (int i = 0; i < kIdleSpinCount; ++i) HFT_CPU_RELAX();
+            } else {
+                std::this_thread::yield();
+            }
+        }
+    });
+    for (uint64_t i = 0; i < kTicks; ++i) {
+        HFTMarketData market_data = make_tick(i);
+        market_data.trace.enqueued_tsc = FastClock::now();
+        queue->push(market_data);
+        while (traded.load(std::memory_order_acquire) <= i) std::this_thread::yield();
+    }
+    consuming.store(false);
+    consumer.join();
+
+    auto hot_loop = std::make_unique<TickToOrderRig>();
+    for (uint64_t i = 0; i < kTicks; ++i) {
+        HFTMarketData market_data = make_tick(i);
+        hot_loop->trade(market_data);
+    }
+
+    pipeline->report("Pipeline (queue + 2 threads):   ");
+    hot_loop->report("Hot loop (inline, 1 thread):    ");
+    if (cpus < 2) {
+        std::cout << "Only " << cpus << " CPU: the pipeline threads time-share one core" << std::endl;
+    }
+
+    std::cout << "\n--- Sharded engine throughput (40 symbols) ---" << std::endl;
+    // One dispatcher thread deals ticks round-robin over 40 symbols; each shard runs the
+    // strategy and executor for its symbols on its own thread.
+    std::vector<std::string> shard_symbols;
+    for (int i = 0; i < 40; ++i) shard_symbols.push_back("SYM" + std::to_string(i) + "-USD");
+    constexpr uint64_t kShardTicks = 400000;
+    std::atomic<bool> shard_breach{false};
+    std::atomic<double> shard_max_position{1.0};
+    std::atomic<double> shard_order_size{0.005};
+    double single_shard_rate = 0.0;
+
+    for (uint32_t shard_count : {1u, 2u, 4u}) {
+        std::vector<std::unique_ptr<EngineShard>> shards;
+        for (uint32_t id = 0; id < shard_count; ++id) {
+            shards.push_back(std::make_unique<EngineShard>(
+                id, shard_count, EngineShard::partition(shard_symbols, id, shard_count),
+                shard_breach, shard_max_position, shard_order_size, 100));
+            shards.back()->start(ThreadPlacement{});
+        }
+
+        auto shard_start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < kShardTicks; ++i) {
+            HFTMarketData market_data = make_tick(i / shard_symbols.size());
+            market_data.symbol_index = static_cast<uint32_t>(i % shard_symbols.size());
+            EngineShard& owner = *shards[EngineShard::shard_of(market_data.symbol_index, shard_count)];
+            while (!owner.publish(market_data)) HFT_CPU_RELAX();
+        }
+        uint64_t shard_ticks = 0;
+        while (shard_ticks < kShardTicks) {
+            shard_ticks = 0;
+            for (const auto& shard : shards) shard_ticks += shard->snapshot().ticks;
+            if (shard_ticks < kShardTicks) std::this_thread::yield();
+        }
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - shard_start).count();
+        for (auto& shard : shards) shard->stop();
+
+        const double rate = static_cast<double>(kShardTicks) / seconds;
+        if (shard_count == 1) single_shard_rate = rate;
+        std::cout << shard_count << " shard(s):                     " << std::setprecision(0) << rate
+                  << " ticks/s (" << std::setprecision(2) << rate / single_shard_rate << "x)"
+                  << std::setprecision(1) << std::endl;
+    }
+    if (cpus < 6) {
+        std::cout << "Scaling needs a core per shard plus one for the dispatcher; this machine has "
+                  << cpus << std::endl;
+    }
+
+    std::cout << "\n--- Idle wake-up: yield vs futex park ---" << std::endl;
+    // Producer stamps the TSC and publishes; the consumer, idle in each mode, measures how
+    // long it took to notice. Gaps between rounds let the parking consumer reach the futex.
+    constexpr int kWakeRounds = 2000;
+    WakeSignal bench_wake;
+    std::atomic<uint64_t> posted_tsc{0};
+    std::atomic<int> seen{0};
+    const double notify_ns = ns_per_call(1000000, [&bench_wake](uint64_t) { bench_wake.notify(); });
+    for (IdleMode mode : {IdleMode::SPIN_YIELD, IdleMode::SPIN_PARK}) {
+        auto wake_histogram = std::make_unique<LatencyHistogram>();
+        seen.store(0);
+        std::thread waiter([&, mode] {
+            IdleStrategy idle(mode, &bench_wake, std::chrono::milliseconds(100));
+            int consumed = 0;
+            while (consumed < kWakeRounds) {
+                const uint64_t stamp = posted_tsc.exchange(0, std::memory_order_acquire);
+                if (stamp != 0) {
+                    wake_histogram->record(FastClock::now() - stamp);
+                    seen.store(++consumed, std::memory_order_release);
+                }
+                idle.idle(stamp != 0);
+            }
+        });
+        for (int round = 0; round < kWakeRounds; ++round) {
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+            posted_tsc.store(FastClock::now(), std::memory_order_release);
+            bench_wake.notify();
+            while (seen.load(std::memory_order_acquire) <= round) std::this_thread::yield();
+        }
+        waiter.join();
+
+        HistogramSnapshot wake_snapshot;
+        wake_snapshot.accumulate(*wake_histogram);
+        FastClock& clock = FastClock::getInstance();
+        std::cout << std::left << std::setw(32) << (std::string(to_string(mode)) + ":") << std::right
+                  << "p50 " << clock.ticksToNanos(wake_snapshot.percentile(50.0))
+                  << " / p99 " << clock.ticksToNanos(wake_snapshot.percentile(99.0)) << " ns" << std::endl;
+    }
+    std::cout << "WakeSignal::notify (no waiter):  " << notify_ns << " ns/call" << std::endl;
+
+    std::cout << "\n--- Strategy signal per tick ---" << std::endl;
+    // Mid walks one tick up or down every tick, 100 us apart; prices precomputed so only the
+    // strategy is timed.
+    constexpr uint64_t kSignalTicks = 2000000;
+    constexpr size_t kPathLength = 4096;
+    std::vector<double> path(kPathLength);
+    uint64_t walk = 88172645463325252ULL;
+    double walk_mid = 2000.0;
+    for (auto& mid : path) {
+        walk ^= walk << 13; walk ^= walk >> 7; walk ^= walk << 17;
+        walk_mid += (walk & 1) ? 0.01 : -0.01;
+        mid = walk_mid;
+    }
+    const uint64_t tick_step = static_cast<uint64_t>(100000.0 / FastClock::getInstance().nanosPerTick());
+    MarketMakingStrategy fixed_strategy;
+    AvellanedaStoikovStrategy as_strategy;
+    double signal_sink = 0.0;
+    const double fixed_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        const double mid = path[i % kPathLength];
+        signal_sink += fixed_strategy.generate_signal(mid - 0.005, mid + 0.005, 0.003, 0.005).bid_price;
+    });
+    const double as_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        const double mid = path[i % kPathLength];
+        signal_sink += as_strategy.on_tick(mid - 0.005, mid + 0.005, (i + 1) * tick_step, 0.003, 0.005).bid_price;
+    });
+    // Full book: every depth level on both sides, quantities varying with the walk.
+    HFTMarketData depth_tick{};
+    depth_tick.depth.bid_levels = depth_tick.depth.ask_levels = DepthSnapshot::kLevels;
+    FairValue fair_value;
+    const double fair_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        const double mid = path[i % kPathLength];
+        depth_tick.bid_price = mid - 0.005;
+        depth_tick.ask_price = mid + 0.005;
+        for (size_t level = 0; level < DepthSnapshot::kLevels; ++level) {
+            depth_tick.depth.bid_price[level] = depth_tick.bid_price - 0.01 * static_cast<double>(level);
+            depth_tick.depth.ask_price[level] = depth_tick.ask_price + 0.01 * static_cast<double>(level);
+            depth_tick.depth.bid_quantity[level] = 1.0 + static_cast<double>((i + level) & 7);
+            depth_tick.depth.ask_quantity[level] = 1.0 + static_cast<double>((i * 3 + level) & 7);
+        }
+        signal_sink += fair_value.update(depth_tick);
+    });
+    std::cout << std::setprecision(1) << "MarketMakingStrategy:            " << fixed_ns << " ns/tick" << std::endl;
+    std::cout << "AvellanedaStoikov (update+quote): " << as_ns << " ns/tick (sigma/sqrt(s) "
+              << std::setprecision(4) << std::sqrt(as_strategy.estimator().variance_rate())
+              << ", kappa " << as_strategy.estimator().kappa() << std::setprecision(1)
+              << ", checksum " << (static_cast<int64_t>(signal_sink) & 0xff) << ")" << std::endl;
+    std::cout << "FairValue::update (" << DepthSnapshot::kLevels << " levels, incl. book fill): " << fair_ns
+              << " ns/tick" << std::endl;
+
+    std::cout << "\n--- Strategy dispatch (fixed_spread, per tick) ---" << std::endl;
+    // Same inputs for every variant; the position sweeps through the skew branches.
+    std::vector<StrategyInput> inputs(kPathLength);
+    for (size_t i = 0; i < kPathLength; ++i) {
+        const double position = 0.005 * static_cast<double>(static_cast<int>(i % 9) - 4);
+        inputs[i] = MarketMakingStrategy::make_input(path[i] - 0.005, path[i] + 0.005, path[i] + 0.001, 0,
+                                                     position, 0.005);
+    }
+    MarketMakingStrategy crtp_strategy;
+    StrategyVariant variant_strategy = makeStrategy(StrategyKind::FIXED_SPREAD);
+    // Chosen at run time so the compiler cannot devirtualize.
+    volatile int virtual_choice = 0;
+    std::unique_ptr<VirtualStrategy> virtual_strategy;
+    if (virtual_choice == 0) {
+        virtual_strategy = std::make_unique<VirtualAdapter<MarketMakingStrategy>>();
+    } else {
+        virtual_strategy = std::make_unique<VirtualAdapter<AvellanedaStoikovStrategy>>();
+    }
+    double dispatch_sink = 0.0;
+    const auto crtp_loop = [&](auto& strategy) {
+        return ns_per_call(kSignalTicks, [&](uint64_t i) {
+            dispatch_sink += strategy.on_tick(inputs[i % kPathLength]).bid_price;
+        });
+    };
+    const double hand_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        dispatch_sink += hand_inlined_quote(inputs[i % kPathLength]).bid_price;
+    });
+    const double crtp_ns = crtp_loop(crtp_strategy);
+    // What the engines do: visit once, then run the loop instantiated for the type.
+    const double visit_once_ns = std::visit(crtp_loop, variant_strategy);
+    const double visit_each_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        const StrategyInput& input = inputs[i % kPathLength];
+        dispatch_sink += std::visit([&input](auto& strategy) { return strategy.on_tick(input); },
+                                    variant_strategy).bid_price;
+    });
+    const double virtual_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        dispatch_sink += virtual_strategy->on_tick(inputs[i % kPathLength]).bid_price;
+    });
+    std::cout << "Hand-inlined:                    " << hand_ns << " ns/tick" << std::endl;
+    std::cout << "CRTP (concrete type):            " << crtp_ns << " ns/tick" << std::endl;
+    std::cout << "CRTP (visited once, engine):     " << visit_once_ns << " ns/tick" << std::endl;
+    std::cout << "std::visit per tick:             " << visit_each_ns << " ns/tick" << std::endl;
+    std::cout << "Virtual call per tick:           " << virtual_ns << " ns/tick (checksum "
+              << (static_cast<int64_t>(dispatch_sink) & 0xff) << ")" << std::endl;
+
+    std::cout << "\n--- Order ladder (10 levels, two-sided) ---" << std::endl;
+    TickToOrderRig ladder_rig;
+    HFTSignal ladder_signal;
+    ladder_signal.place_bid = ladder_signal.place_ask = true;
+    ladder_signal.bid_quantity = ladder_signal.ask_quantity = 0.02;
+    ladder_signal.num_levels = 10;
+    const LatencyTrace ladder_trace = make_tick(0).trace;
+    std::vector<HFTOrder> per_order_out(2 * OrderLadder::kMaxLevels);
+    std::atomic<uint64_t> per_order_ids{1};
+    const std::string ladder_symbol = "ETH-USD";
+    uint64_t ladder_sink = 0;
+    const double per_order_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        ladder_signal.bid_price = path[i % kPathLength] - 0.005;
+        ladder_signal.ask_price = path[i % kPathLength] + 0.005;
+        ladder_sink += per_order_ladder(ladder_signal, ladder_symbol, per_order_ids,
+                                        0.0, 1.0, per_order_out.data());
+    });
+    const double batch_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        ladder_signal.bid_price = path[i % kPathLength] - 0.005;
+        ladder_signal.ask_price = path[i % kPathLength] + 0.005;
+        ladder_sink += ladder_rig.executor.build_ladder(ladder_signal);
+    });
+    // With a book to keep off; nothing crosses it, so this is the guard's check alone.
+    const double guarded_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        ladder_signal.bid_price = path[i % kPathLength] - 0.005;
+        ladder_signal.ask_price = path[i % kPathLength] + 0.005;
+        ladder_rig.executor.on_book(path[i % kPathLength] - 0.01, path[i % kPathLength] + 0.01);
+        ladder_sink += ladder_rig.executor.build_ladder(ladder_signal);
+    });
+    ladder_rig.executor.on_book(0.0, 0.0);
+    HFTSignal deep_signal = ladder_signal;
+    deep_signal.num_levels = OrderLadder::kMaxLevels;
+    const double deep_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        deep_signal.bid_price = path[i % kPathLength] - 0.005;
+        deep_signal.ask_price = path[i % kPathLength] + 0.005;
+        ladder_sink += ladder_rig.executor.build_ladder(deep_signal);
+    });
+    // Build plus the simulated exchange hand-off of all 20 orders.
+    constexpr uint64_t kPlacedLadders = 200000;
+    const double place_ns = ns_per_call(kPlacedLadders, [&](uint64_t i) {
+        ladder_signal.bid_price = path[i % kPathLength] - 0.005;
+        ladder_signal.ask_price = path[i % kPathLength] + 0.005;
+        ladder_rig.executor.place_order_ladder(ladder_signal, ladder_trace);
+        HFTOrder response{};
+        while (ladder_rig.executor.pop_response(response)) {}
+    });
+    std::cout << "Order at a time (previous):      " << per_order_ns << " ns/ladder" << std::endl;
+    std::cout << "LadderBuilder + stamped orders:  " << batch_ns << " ns/ladder ("
+              << "checksum " << (ladder_sink & 0xff) << ")" << std::endl;
+    std::cout << "+ quote guard against the BBO:   " << guarded_ns << " ns/ladder" << std::endl;
+    std::cout << "LadderBuilder (" << OrderLadder::kMaxLevels << " levels x 2):   " << deep_ns << " ns/ladder" << std::endl;
+    std::cout << "place_order_ladder (incl. send): " << place_ns << " ns/ladder" << std::endl;
+
+    std::cout << "\n--- Cancel-all on breach (10 levels resting, replay gateway) ---" << std::endl;
+    // From the breach flag going up to the last of the 20 cancels on the gateway's ring, as
+    // the order engine sees it on its next pass; against waiting for the next ladder, which
+    // comes back empty and replaces what is working.
+    ladder_rig.executor.set_gateway(std::make_unique<ReplayGateway>());
+    constexpr int kBreachRounds = 20000;
+    auto check_histogram = std::make_unique<LatencyHistogram>();
+    auto requote_histogram = std::make_unique<LatencyHistogram>();
+    ladder_signal.bid_price = 1850.00;
+    ladder_signal.ask_price = 1850.10;
+    for (int round = 0; round < 2 * kBreachRounds; ++round) {
+        ladder_rig.executor.place_order_ladder(ladder_signal, ladder_trace);
+        const uint64_t breach_tsc = FastClock::now();
+        ladder_rig.breach.store(true);
+        if (round % 2 == 0) {
+            ladder_rig.executor.check_breach();
+            check_histogram->record(FastClock::now() - breach_tsc);
+        } else {
+            ladder_rig.executor.place_order_ladder(ladder_signal, ladder_trace);
+            requote_histogram->record(FastClock::now() - breach_tsc);
+        }
+        HFTOrder response{};
+        uint32_t cancels = 0;
+        while (ladder_rig.executor.pop_response(response)) cancels += response.status == 'C';
+        if (cancels != 20) std::cout << "unexpected cancel count " << cancels << std::endl;
+        ladder_rig.breach.store(false);
+        ladder_rig.executor.check_breach();
+    }
+    for (const auto& row : {std::make_pair("check_breach -> cancel_all:", check_histogram.get()),
+                            std::make_pair("Empty replacing ladder:", requote_histogram.get())}) {
+        HistogramSnapshot breach_snapshot;
+        breach_snapshot.accumulate(*row.second);
+        std::cout << std::left << std::setw(32) << row.first << std::right
+                  << "p50 " << clock.ticksToNanos(breach_snapshot.percentile(50.0))
+                  << " / p99 " << clock.ticksToNanos(breach_snapshot.percentile(99.0)) << " ns" << std::endl;
+    }
+
+    std::cout << "\n--- Order encoding (Coinbase create body) ---" << std::endl;
+    CoinbaseOrderEncoder encoder("ETH-USD", 0.01, "hft1700000000-");
+    HFTOrder encode_order = ladder_rig.executor.ladder_order(0, 'B');
+    char encode_buffer[CoinbaseOrderEncoder::kMaxBodyBytes];
+    uint64_t encode_sink = 0;
+    const double template_ns = ns_per_call(kSignalTicks, [&](uint64_t i) {
+        encode_order.client_order_id = i;
+        encode_order.price = path[i % kPathLength];
+        encode_sink += encoder.encode_create(encode_order, encode_buffer);
+    });
+    constexpr uint64_t kDomOrders = 200000;
+    const double dom_ns = ns_per_call(kDomOrders, [&](uint64_t i) {
+        char price[32];
+        std::snprintf(price, sizeof(price), "%.2f", path[i % kPathLength]);
+        char size[32];
+        std::snprintf(size, sizeof(size), "%.8f", encode_order.quantity);
+        nlohmann::json body = {
+            {"client_order_id", "hft1700000000-" + std::to_string(i)},
+            {"product_id", "ETH-USD"},
+            {"side", "BUY"},
+            {"order_configuration", {{"limit_limit_gtc", {
+                {"base_size", size}, {"limit_price", price}, {"post_only", true}}}}}
+        };
+        encode_sink += body.dump().size();
+    });
+    std::cout << "nlohmann::json DOM + dump:       " << dom_ns << " ns/order" << std::endl;
+    std::cout << "Template encoder:                " << template_ns << " ns/order (checksum "
+              << (encode_sink & 0xff) << ")" << std::endl;
+
+    std::cout << "\n--- JWT signing (ES256) ---" << std::endl;
+    std::string bench_pem;
+    {
+        EVP_PKEY* bench_key = EVP_EC_gen("P-256");
+        BIO* bio = BIO_new(BIO_s_mem());
+        PEM_write_bio_PrivateKey(bio, bench_key, nullptr, nullptr, 0, nullptr, nullptr);
+        char* pem_data = nullptr;
+        const long pem_length = BIO_get_mem_data(bio, &pem_data);
+        bench_pem.assign(pem_data, static_cast<size_t>(pem_length));
+        BIO_free(bio);
+        EVP_PKEY_free(bench_key);
+    }
+    const std::string jwt_uri = "POST api.coinbase.com/api/v3/brokerage/orders";
+    JwtSigner jwt_signer;
+    jwt_signer.setKey("organizations/bench/apiKeys/bench", bench_pem);
+    constexpr uint64_t kSignatures = 5000;
+    uint64_t jwt_sink = 0;
+    // What every token used to cost: parse the PEM key, then sign.
+    const double parse_sign_ns = ns_per_call(kSignatures, [&](uint64_t) {
+        JwtSigner fresh;
+        fresh.setKey("organizations/bench/apiKeys/bench", bench_pem);
+        jwt_sink += fresh.sign(jwt_uri).size();
+    });
+    const double sign_ns = ns_per_call(kSignatures, [&](uint64_t) { jwt_sink += jwt_signer.sign(jwt_uri).size(); });
+    const int jwt_handle = jwt_signer.track(jwt_uri);
+    const double token_ns = ns_per_call(kSignalTicks, [&](uint64_t) { jwt_sink += jwt_signer.token(jwt_handle).size(); });
+    std::cout << "Parse key + sign per token:      " << parse_sign_ns / 1000.0 << " us/token" << std::endl;
+    std::cout << "Sign with parsed EVP_PKEY:       " << sign_ns / 1000.0 << " us/token" << std::endl;
+    std::cout << "Pre-signed token (atomic load):  " << token_ns << " ns/request (checksum "
+              << (jwt_sink & 0xff) << ")" << std::endl;
+
+    std::cout << "\n=== BENCHMARKS COMPLETE ===" << std::endl;
+    return 0;
+}
@@ -1,16 +1,50 @@
+#include "engine_shard.h"
 #include "core/config.h"
+#include "core/fast_clock.h"
+#include "core/flight_recorder.h"
+#include "core/thread_placement.h"
 #include "core/types.h"
 #include "core/spsc_queue.h"
+#include "core/mpsc_queue.h"
+#include "core/seqlock.h"
+#include "core/idle_strategy.h"
+#include "core/jwt_signer.h"
+#include "core/symbol_registry.h"
+#include "core/log_rotation.h"
 #include "data/market_data.h"
+#include "strategy/avellaneda_stoikov.h"
+#include "strategy/fair_value.h"
 #include "strategy/market_maker.h"
+#include "strategy/strategy_registry.h"
+#include "execution/coinbase_gateway.h"
 #include "execution/executor.h"
+#include "execution/mock_gateway_server.h"
+#include "execution/sim_gateway.h"
 #include "order/order_manager.h"
 #include "risk/risk_manager.h"
 #include "metrics/metrics.h"
+#include "metrics/metrics_exporter.h"
+#include "metrics/shm_metrics.h"
 #include <iostream>
+#include <fstream>
 #include <iomanip>
 #include <cmath>
+#include <algorithm>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <dirent.h>
+#include <netinet/in.h>
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 int main() {
     std::cout << "=== HFT Bot Smoke Test ===" << std::endl;
@@ -138,6 +172,111 @@ int main() {
     std::cout << "Pushed 20 into size-16 queue, popped " << popped << std::endl;
     assert(popped == 15 && "Queue capacity is Size-1 = 15 for ring buffer");
 
+    std::cout << "\n--- MPSC Queue Test ---" << std::endl;
+    MPSCQueue<uint64_t, 1024> mpsc;
+    std::vector<std::thread> producers;
+    for (uint64_t t = 0; t < 4; ++t) {
+        producers.emplace_back([&mpsc, t]() {
+            for (uint64_t i = 0; i < 200; ++i) {
+                while (!mpsc.push(t * 1000 + i)) {}
+            }
+        });
+    }
+    for (auto& producer : producers) producer.join();
+    uint64_t mpsc_popped = 0;
+    uint64_t mpsc_sum = 0;
+    uint64_t value = 0;
+    while (mpsc.pop(value)) {
+        mpsc_popped++;
+        mpsc_sum += value;
+    }
+    uint64_t expected_sum = 0;
+    for (uint64_t t = 0; t < 4; ++t) expected_sum += 200 * t * 1000 + 199 * 200 / 2;
+    std::cout << "4 producers x 200 pushes -> popped " << mpsc_popped << std::endl;
+    assert(mpsc_popped == 800 && "MPSC queue should deliver every pushed item");
+    assert(mpsc_sum == expected_sum && "MPSC queue should deliver each item exactly once");
+
+    RiskStatus status = risk_manager.getCurrentRiskStatus();
+    std::cout << "Risk status after smoke run: " << static_cast<int>(status) << std::endl;
+    assert(status != RiskStatus::EMERGENCY && "Smoke run should not trip the circuit breaker");
+
+    std::cout << "\n--- Log Rotation Test ---" << std::endl;
+    const std::string rotation_dir = "logs/rotation_test";
+    mkdir("logs", 0755);
+    mkdir(rotation_dir.c_str(), 0755);
+    {
+        LogRotationPolicy policy;
+        policy.max_file_bytes = 4096;
+        policy.max_file_age = std::chrono::seconds(0);
+        policy.compress = true;
+        policy.max_segments = 3;
+
+        RotatingLogFile rotating(rotation_dir, "test.log", policy);
+        [[maybe_unused]] const bool opened = rotating.open();
+        assert(opened && "Rotating log file should open");
+        const std::string line(1000, 'x');
+        for (int i = 0; i < 40; ++i) {
+            rotating.write(line.data(), line.size());
+            while (rotating.maintenance()) {}
+        }
+    }
+    int gz_segments = 0;
+    int rotated_segments = 0;
+    if (DIR* dir = opendir(rotation_dir.c_str())) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.rfind("test.log.", 0) == 0) {
+                rotated_segments++;
+                if (name.size() > 3 && name.compare(name.size() - 3, 3, ".gz") == 0) gz_segments++;
+            }
+            if (name != "." && name != "..") unlink((rotation_dir + "/" + name).c_str());
+        }
+        closedir(dir);
+    }
+    rmdir(rotation_dir.c_str());
+    std::cout << "40KB through 4KB segments -> " << rotated_segments << " retained, "
+              << gz_segments << " compressed" << std::endl;
+    assert(rotated_segments == 3 && "Retention should keep exactly max_segments rotated files");
+    assert(gz_segments == 3 && "Rotated segments should be gzip-compressed");
+
+    // Retention orders by (timestamp, -N): ".gz" must not sort after "-N", nor "-10" before "-2".
+    mkdir(rotation_dir.c_str(), 0755);
+    const char* stale_segments[] = {"age.log.20200101-000000.gz", "age.log.20200101-000000-2.gz",
+                                    "age.log.20200101-000000-10.gz", "age.log.20200101-000001"};
+    for (const char* name : stale_segments) {
+        std::ofstream(rotation_dir + "/" + name) << "x";
+    }
+    {
+        LogRotationPolicy policy;
+        policy.max_file_bytes = 16;
+        policy.max_file_age = std::chrono::seconds(0);
+        policy.compress = false;
+        policy.max_segments = 3;
+
+        RotatingLogFile rotating(rotation_dir, "age.log", policy);
+        [[maybe_unused]] const bool opened = rotating.open();
+        assert(opened && "Rotating log file should open");
+        const std::string line(16, 'y');
+        rotating.write(line.data(), line.size());
+        rotating.write(line.data(), line.size());  // rotates and enforces retention
+    }
+    auto segment_kept = [&](const char* name) {
+        return access((rotation_dir + "/" + name).c_str(), F_OK) == 0;
+    };
+    const bool oldest_removed = !segment_kept(stale_segments[0]) && !segment_kept(stale_segments[1]);
+    const bool newest_kept = segment_kept(stale_segments[2]) && segment_kept(stale_segments[3]);
+    if (DIR* dir = opendir(rotation_dir.c_str())) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name != "." && name != "..") unlink((rotation_dir + "/" + name).c_str());
+        }
+        closedir(dir);
+    }
+    rmdir(rotation_dir.c_str());
+    std::cout << "Retention by segment age: oldest removed=" << oldest_removed
+              << ", newest kept=" << newest_kept << std::endl;
+    assert(oldest_removed && newest_kept && "Retention should drop segments oldest (timestamp, N) first");
+
     std::cout << "\n--- PnL Correctness Test ---" << std::endl;
     OrderManager pnl_test;
     pnl_test.initialize();
@@ -166,12 +305,1368 @@ int main() {
     assert(std::abs(final_pos) < 1e-9 && "Position should be flat");
 
     std::cout << "\n--- Latency Metrics ---" << std::endl;
-    std::cout << "Avg order latency: "
-              << metrics.metrics().avg_order_latency_ns.load() / 1000.0 << " us" << std::endl;
-    std::cout << "Min order latency: "
-              << metrics.metrics().min_order_latency_ns.load() / 1000.0 << " us" << std::endl;
-    std::cout << "Max order latency: "
-              << metrics.metrics().max_order_latency_ns.load() / 1000.0 << " us" << std::endl;
+    HistogramSnapshot ladder_latency;
+    metrics.capture_latency(LatencyStage::ORDER_LADDER, ladder_latency);
+    std::cout << "Order ladder samples: " << ladder_latency.total << std::endl;
+    std::cout << "p50 order latency: " << FastClock::getInstance().ticksToNanos(ladder_latency.percentile(50.0)) / 1000.0 << " us" << std::endl;
+    std::cout << "p99 order latency: " << FastClock::getInstance().ticksToNanos(ladder_latency.percentile(99.0)) / 1000.0 << " us" << std::endl;
+    std::cout << "Max order latency: " << FastClock::getInstance().ticksToNanos(ladder_latency.max) / 1000.0 << " us" << std::endl;
+    assert(ladder_latency.total == 100 && "Every ladder placement should be recorded once");
+    assert(ladder_latency.percentile(50.0) <= ladder_latency.percentile(99.0) &&
+           ladder_latency.percentile(99.0) <= ladder_latency.max && "Percentiles should be monotonic");
+
+    LatencyHistogram histogram;
+    for (uint64_t v = 1; v <= 100000; ++v) histogram.record(v);
+    HistogramSnapshot uniform;
+    uniform.accumulate(histogram);
+    double p99_error = std::abs(static_cast<double>(uniform.percentile(99.0)) - 99000.0) / 99000.0;
+    std::cout << "Uniform 1..100000 -> p50=" << uniform.percentile(50.0)
+              << " p99=" << uniform.percentile(99.0) << " (error " << p99_error * 100.0 << "%)"
+              << " max=" << uniform.max << std::endl;
+    assert(p99_error < 0.07 && "Log-linear buckets should bound relative error");
+    assert(uniform.max == 100000 && "Max should be exact");
+
+    std::cout << "\n--- Tick-to-Trade Trace Test ---" << std::endl;
+    SPSCQueue<HFTMarketData, 16> traced_queue;
+    HFTMarketData tick{};
+    set_symbol(tick.symbol, "ETH-USD");
+    tick.bid_price = sim_bid;
+    tick.ask_price = sim_ask;
+    tick.trace.recv_tsc = FastClock::now();
+    tick.trace.parsed_tsc = tick.trace.recv_tsc + 1000;
+    tick.trace.book_updated_tsc = tick.trace.parsed_tsc + 500;
+    tick.trace.enqueued_tsc = FastClock::now();
+    traced_queue.push(tick);
+
+    HFTMarketData traced{};
+    [[maybe_unused]] const bool traced_popped = traced_queue.pop(traced);
+    assert(traced_popped && "Traced tick should be queued");
+    traced.trace.dequeued_tsc = FastClock::now();
+    HFTSignal traced_sig = strategy.generate_signal(traced.bid_price, traced.ask_price, 0.0, order_size);
+    traced.trace.signal_tsc = FastClock::now();
+    executor.place_order_ladder(traced_sig, traced.trace);
+
+    HFTOrder traced_fill{};
+    while (executor.pop_response(traced_fill)) {
+        assert(traced_fill.trace.recv_tsc == tick.trace.recv_tsc && "Orders should carry the tick trace");
+        assert(traced_fill.sent_tsc >= traced_fill.built_tsc && traced_fill.built_tsc >= traced.trace.signal_tsc &&
+               "Order stamps should be ordered");
+        executor.process_order_response(traced_fill);
+    }
+
+    HistogramSnapshot t2t;
+    metrics.capture_latency(LatencyStage::TICK_TO_TRADE, t2t);
+    HistogramSnapshot build;
+    metrics.capture_latency(LatencyStage::ORDER_BUILD, build);
+    std::cout << "Tick-to-trade samples: " << t2t.total
+              << " (" << FastClock::getInstance().ticksToNanos(t2t.max) / 1000.0 << " us)" << std::endl;
+    assert(t2t.total == 1 && "Only the traced ladder has a receive stamp");
+    assert(build.total == 1 && "Untraced ladders should not record order build");
+    assert(t2t.max >= traced.trace.signal_tsc - tick.trace.recv_tsc && "Tick-to-trade spans the whole pipeline");
+
+    std::cout << "\n--- Metrics Exporter Test ---" << std::endl;
+    MetricsExporter exporter("127.0.0.1", 0, [&](MetricsSnapshot& snapshot) {
+        snapshot.orders_placed = metrics.metrics().orders_placed.load();
+        snapshot.orders_filled = metrics.metrics().orders_filled.load();
+        snapshot.pnl = order_manager.getCurrentPnL();
+        snapshot.position = current_position.load();
+        snapshot.total_trades = order_manager.getTotalTrades();
+        SymbolFeedStats feed;
+        feed.symbol = "ETH-USD";
+        feed.bid = sim_bid;
+        feed.ask = sim_ask;
+        snapshot.feeds.push_back(feed);
+        for (size_t i = 0; i < LATENCY_STAGE_COUNT; ++i) {
+            metrics.capture_latency(static_cast<LatencyStage>(i), snapshot.stage_latency[i]);
+        }
+    });
+    [[maybe_unused]] const bool exporter_started = exporter.start();
+    assert(exporter_started && "Exporter should bind an ephemeral port");
+
+    int client = ::socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in exporter_addr{};
+    exporter_addr.sin_family = AF_INET;
+    exporter_addr.sin_port = htons(static_cast<uint16_t>(exporter.port()));
+    inet_pton(AF_INET, "127.0.0.1", &exporter_addr.sin_addr);
+    [[maybe_unused]] const int connected =
+        ::connect(client, reinterpret_cast<sockaddr*>(&exporter_addr), sizeof(exporter_addr));
+    assert(connected == 0 && "Scraper should connect to the exporter");
+    const char scrape_request[] = "GET /metrics HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    [[maybe_unused]] const ssize_t request_sent = ::send(client, scrape_request, sizeof(scrape_request) - 1, 0);
+    assert(request_sent > 0 && "Scrape request should be sent");
+    std::string scrape;
+    char scrape_buf[4096];
+    ssize_t scrape_n;
+    while ((scrape_n = ::recv(client, scrape_buf, sizeof(scrape_buf), 0)) > 0) {
+        scrape.append(scrape_buf, static_cast<size_t>(scrape_n));
+    }
+    ::close(client);
+    exporter.stop();
+
+    std::string placed_line = "hft_orders_placed_total " +
+        std::to_string(metrics.metrics().orders_placed.load()) + "\n";
+    std::cout << "Scrape: " << scrape.size() << " bytes, " << exporter.scrapes() << " scrape(s)" << std::endl;
+    assert(scrape.compare(0, 15, "HTTP/1.0 200 OK") == 0 && "Scrape should succeed");
+    assert(scrape.find("application/openmetrics-text") != std::string::npos);
+    assert(scrape.find(placed_line) != std::string::npos && "Counters should reflect the snapshot");
+    assert(scrape.find("hft_feed_bid{symbol=\"ETH-USD\"} 1850.5") != std::string::npos);
+    assert(scrape.find("hft_stage_latency_seconds_count{stage=\"order_ladder\"} 101") != std::string::npos);
+    assert(scrape.size() > 6 && scrape.compare(scrape.size() - 6, 6, "# EOF\n") == 0 &&
+           "OpenMetrics exposition must end with # EOF");
+
+    std::cout << "\n--- Shared Memory Metrics Test ---" << std::endl;
+    const std::string shm_name = "/hft_smoke_" + std::to_string(getpid());
+    {
+        MetricsCollector shm_collector(order_manager, shm_name, "ETH-USD");
+        assert(shm_collector.shared_memory_enabled() && "Segment should be created under /dev/shm");
+        shm_collector.metrics().orders_placed.store(42);
+        shm_collector.metrics().total_pnl.store(12.5);
+        shm_collector.metrics().latency(LatencyStage::ORDER_SEND).record(700);
+        shm_collector.metrics().latency(LatencyStage::ORDER_SEND).record(900);
+        shm_collector.tick();
+
+        ShmMetricsReader reader;
+        std::string shm_error;
+        [[maybe_unused]] const bool attached = reader.attach(shm_name, shm_error);
+        assert(attached && "Reader should attach to a live segment");
+        uint64_t placed = 0;
+        double pnl = 0.0;
+        uint64_t mistyped = 0;
+        [[maybe_unused]] const bool placed_read = reader.read_u64("orders_placed", placed);
+        [[maybe_unused]] const bool pnl_read = reader.read_f64("total_pnl", pnl);
+        [[maybe_unused]] const bool mistyped_read = reader.read_u64("total_pnl", mistyped);
+        assert(placed_read && placed == 42);
+        assert(pnl_read && pnl == 12.5);
+        assert(!mistyped_read && "Field types are checked");
+        assert(std::string(reader.header().symbol) == "ETH-USD");
+        assert(reader.header().writer_pid == getpid());
+
+        const auto send_stage = static_cast<uint32_t>(LatencyStage::ORDER_SEND);
+        assert(std::string(reader.stage_name(send_stage)) == "order_send");
+        uint64_t shm_count = 0;
+        uint64_t p50_bound = 0;
+        for (uint32_t b = 0; b < reader.header().histogram_bucket_count; ++b) {
+            uint64_t n = reader.bucket_count(send_stage, b);
+            if (n && shm_count == 0) p50_bound = reader.bucket_upper_bound(b);
+            shm_count += n;
+        }
+        assert(shm_count == 2 && "Histogram buckets should be visible through the segment");
+        assert(reader.histogram_sum(send_stage) == 1600 && reader.histogram_max(send_stage) == 900);
+        assert(p50_bound == LatencyHistogram::bucket_upper_bound(LatencyHistogram::bucket_index(700)) &&
+               "Reader bucket bounds match the writer");
+        std::cout << "Segment " << shm_name << ": " << reader.header().segment_size << " bytes, "
+                  << reader.header().field_count << " fields, " << reader.stage_count() << " stages" << std::endl;
+        std::cout << "Read back: orders_placed=" << placed << " total_pnl=" << pnl
+                  << " order_send samples=" << shm_count << " (p50 <= " << p50_bound << ")" << std::endl;
+    }
+    {
+        ShmMetricsReader reader;
+        std::string shm_error;
+        [[maybe_unused]] const bool attached = reader.attach(shm_name, shm_error);
+        assert(!attached && "Segment should be unlinked with its collector");
+    }
+
+    std::cout << "\n--- Thread Placement Test ---" << std::endl;
+    std::vector<int> cpu_list;
+    [[maybe_unused]] bool cpus_parsed = ThreadPlacer::parseCpuList("0-2, 5,7-8,1", cpu_list);
+    assert(cpus_parsed);
+    assert((cpu_list == std::vector<int>{0, 1, 2, 5, 7, 8}));
+    assert(ThreadPlacer::formatCpuList(cpu_list) == "0-2,5,7-8");
+    cpus_parsed = ThreadPlacer::parseCpuList("", cpu_list);
+    assert(cpus_parsed && cpu_list.empty());
+    [[maybe_unused]] const bool reversed_parsed = ThreadPlacer::parseCpuList("3-1", cpu_list);
+    [[maybe_unused]] const bool garbage_parsed = ThreadPlacer::parseCpuList("x", cpu_list);
+    assert(!reversed_parsed && !garbage_parsed);
+
+    CpuTopology topology = CpuTopology::detect();
+    assert(!topology.online.empty() && !topology.allowed.empty());
+    const int pin_cpu = topology.allowed.back();
+
+    ThreadPlacement feed_placement;
+    feed_placement.name = "market_data";
+    feed_placement.cpus = {pin_cpu};
+    feed_placement.latency_critical = true;
+    ThreadPlacement engine_placement = feed_placement;
+    engine_placement.name = "order_engine";
+    engine_placement.fifo_priority = 80;
+    ThreadPlacement unpinned;
+    unpinned.name = "order_engine";
+    unpinned.latency_critical = true;
+
+    [[maybe_unused]] auto has_warning = [](const std::vector<std::string>& warnings, const std::string& needle) {
+        return std::any_of(warnings.begin(), warnings.end(),
+                           [&](const std::string& w) { return w.find(needle) != std::string::npos; });
+    };
+    std::vector<std::string> placement_warnings = ThreadPlacer::validate({feed_placement, engine_placement}, topology);
+    for (const auto& warning : placement_warnings) std::cout << "   " << warning << std::endl;
+    assert(has_warning(placement_warnings, "market_data and order_engine share cpu") &&
+           "Two tick-path threads on one CPU must be flagged");
+    assert(has_warning(placement_warnings, "starve"));
+    assert(has_warning(ThreadPlacer::validate({unpinned}, topology), "not pinned"));
+    ThreadPlacement offline = feed_placement;
+    offline.cpus = {CPU_SETSIZE - 1};
+    assert(has_warning(ThreadPlacer::validate({offline}, topology), "offline"));
+
+    ThreadPlacement metrics_placement;
+    metrics_placement.name = "smoke_pinned";
+    metrics_placement.cpus = {pin_cpu};
+    std::string placed_description;
+    std::thread pinned_thread([&] {
+        [[maybe_unused]] const bool applied = ThreadPlacer::applyToCurrentThread(metrics_placement);
+        assert(applied && "Placement should apply to the calling thread");
+        assert(sched_getcpu() == pin_cpu && "Pinned thread should run on its CPU");
+        placed_description = ThreadPlacer::describeCurrentThread();
+    });
+    pinned_thread.join();
+    assert(placed_description.compare(0, 5 + std::to_string(pin_cpu).size(), "cpus " + std::to_string(pin_cpu)) == 0);
+
+    std::cout << "\n--- Flight Recorder Test ---" << std::endl;
+    const std::string flight_dir = "logs/flight_test";
+    FlightRecorder& recorder = FlightRecorder::getInstance();
+    recorder.configure(4096, std::chrono::seconds(30), flight_dir);
+    std::thread flight_feed([] {
+        FlightRecorder::setThreadName("test_feed");
+        for (uint32_t i = 0; i < 500; ++i) {
+            FlightRecorder::record(FlightEventType::BBO, 1850.0 + i * 0.01, 1850.5 + i * 0.01, i);
+        }
+    });
+    flight_feed.join();
+
+    recorder.start();
+    const uint64_t dumps_before = recorder.dumps();
+    {
+        RiskManager breach_risk;
+        breach_risk.initialize("config.txt");
+        breach_risk.updatePnL(-1000000.0);
+        assert(breach_risk.isCircuitBreakerActive() && "Loss past the daily limit should trip the breaker");
+        breach_risk.updatePnL(-1.0);
+        breach_risk.shutdown();
+    }
+    recorder.stop();
+    const uint64_t breach_dumps = recorder.dumps() - dumps_before;
+    std::cout << "Breach dumps: " << breach_dumps << std::endl;
+    assert(breach_dumps == 1 && "A breach should produce exactly one dump");
+
+    std::string flight_path;
+    if (DIR* dir = opendir(flight_dir.c_str())) {
+        while (struct dirent* entry = readdir(dir)) {
+            std::string name = entry->d_name;
+            if (name.find("_circuit_breaker.bin") != std::string::npos) flight_path = flight_dir + "/" + name;
+        }
+        closedir(dir);
+    }
+    assert(!flight_path.empty() && "Breach dump should be written to the dump directory");
+
+    FlightDumpHeader flight_header{};
+    std::vector<FlightEvent> flight_events;
+    if (FILE* file = std::fopen(flight_path.c_str(), "rb")) {
+        if (std::fread(&flight_header, sizeof(flight_header), 1, file) == 1) {
+            flight_events.resize(flight_header.event_count);
+            flight_events.resize(std::fread(flight_events.data(), sizeof(FlightEvent), flight_events.size(), file));
+        }
+        std::fclose(file);
+    }
+    assert(std::memcmp(flight_header.magic, FLIGHT_DUMP_MAGIC, sizeof(FLIGHT_DUMP_MAGIC)) == 0);
+    assert(std::string(flight_header.reason) == "circuit_breaker");
+    assert(flight_events.size() == flight_header.event_count && "Dump should hold every announced event");
+
+    int feed_thread_index = -1;
+    for (uint32_t i = 0; i < flight_header.thread_count; ++i) {
+        if (std::string(flight_header.thread_names[i]) == "test_feed") feed_thread_index = static_cast<int>(i);
+    }
+    assert(feed_thread_index >= 0 && "Exited threads stay in the dump while inside the window");
+
+    size_t feed_bbo = 0, breaker_events = 0, risk_events = 0;
+    bool flight_sorted = true;
+    for (size_t i = 0; i < flight_events.size(); ++i) {
+        const FlightEvent& e = flight_events[i];
+        if (i > 0 && e.tsc < flight_events[i - 1].tsc) flight_sorted = false;
+        if (e.type == FlightEventType::BBO && e.thread == feed_thread_index) feed_bbo++;
+        if (e.type == FlightEventType::CIRCUIT_BREAKER) breaker_events++;
+        if (e.type == FlightEventType::RISK) risk_events++;
+    }
+    std::cout << "Dump " << flight_path << ": " << flight_events.size() << " events, "
+              << flight_header.thread_count << " threads, "
+              << (flight_sorted ? "merged by timestamp" : "out of order") << std::endl;
+    assert(flight_sorted && "Events from all threads should be merged by timestamp");
+    assert(feed_bbo == 500 && "Every recorded BBO of the feed thread should be in the dump");
+    assert(breaker_events == 1 && risk_events > 0);
+
+    unlink(flight_path.c_str());
+    rmdir(flight_dir.c_str());
+
+    std::cout << "\n--- Engine Shard Test ---" << std::endl;
+    SeqLock<ShardSnapshot> seqlock;
+    ShardSnapshot stored;
+    stored.pnl = 1.25;
+    stored.ticks = 42;
+    seqlock.store(stored);
+    assert(seqlock.load().pnl == 1.25 && seqlock.load().ticks == 42 && seqlock.version() == 1);
+
+    const std::vector<std::string> shard_symbols = {"ETH-USD", "BTC-USD", "SOL-USD", "AVAX-USD", "LINK-USD"};
+    assert((EngineShard::partition(shard_symbols, 0, 2) ==
+            std::vector<std::string>{"ETH-USD", "SOL-USD", "LINK-USD"}));
+    assert((EngineShard::partition(shard_symbols, 1, 2) == std::vector<std::string>{"BTC-USD", "AVAX-USD"}));
+
+    std::atomic<bool> shard_breach{false};
+    std::atomic<double> shard_max_position{1.0};
+    std::atomic<double> shard_order_size{order_size};
+    std::vector<std::unique_ptr<EngineShard>> shards;
+    for (uint32_t id = 0; id < 2; ++id) {
+        // 1 Hz requote timer: only ticks drive orders within the test. One loop instantiation each.
+        shards.push_back(std::make_unique<EngineShard>(id, 2, EngineShard::partition(shard_symbols, id, 2),
+                                                       shard_breach, shard_max_position, shard_order_size, 1,
+                                                       id == 0 ? StrategyKind::FIXED_SPREAD
+                                                               : StrategyKind::AVELLANEDA_STOIKOV));
+        shards.back()->start(ThreadPlacement{});
+    }
+
+    constexpr uint32_t kShardTicksPerSymbol = 100;
+    for (uint32_t n = 0; n < kShardTicksPerSymbol; ++n) {
+        for (uint32_t i = 0; i < shard_symbols.size(); ++i) {
+            HFTMarketData tick{};
+            set_symbol(tick.symbol, shard_symbols[i]);
+            tick.bid_price = 100.0 * (i + 1) + 0.01 * (n % 5);
+            tick.ask_price = tick.bid_price + 0.10;
+            tick.symbol_index = i;
+            tick.trace.recv_tsc = FastClock::now();
+            EngineShard& owner = *shards[EngineShard::shard_of(i, 2)];
+            while (!owner.publish(tick)) std::this_thread::yield();
+        }
+    }
+
+    const uint64_t expected_ticks = kShardTicksPerSymbol * shard_symbols.size();
+    ShardSnapshot shard_totals;
+    for (int wait = 0; wait < 500; ++wait) {
+        shard_totals = ShardSnapshot{};
+        for (const auto& shard : shards) shard_totals.add(shard->snapshot());
+        if (shard_totals.ticks == expected_ticks) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    for (auto& shard : shards) shard->stop();
+
+    std::cout << "Shards: " << shards[0]->snapshot().ticks << " + " << shards[1]->snapshot().ticks
+              << " ticks, " << shard_totals.orders_placed << " orders, " << shard_totals.fills << " fills" << std::endl;
+    assert(shard_totals.ticks == expected_ticks && "Every published tick should reach its shard");
+    assert(shards[0]->snapshot().ticks == 3 * kShardTicksPerSymbol && shards[1]->snapshot().ticks == 2 * kShardTicksPerSymbol);
+
+    shard_totals = ShardSnapshot{};
+    for (const auto& shard : shards) {
+        const ShardSnapshot snapshot = shard->snapshot();
+        assert(snapshot.orders_placed > 0 && "Each shard should quote its own symbols");
+        assert(snapshot.fills == shard->metrics().orders_filled.load());
+        HistogramSnapshot queue_wait;
+        queue_wait.accumulate(shard->metrics().latency(LatencyStage::QUEUE_WAIT));
+        assert(queue_wait.total == snapshot.ticks);
+        double net = 0.0;
+        for (size_t slot = 0; slot < shard->symbols().size(); ++slot) net += shard->position(slot);
+        assert(std::abs(net - snapshot.net_position) < 1e-9 && "Final snapshot should match the positions");
+        shard_totals.add(snapshot);
+    }
+    assert(shard_totals.fills > 0);
+
+    // --- Idle Strategy Test ---
+    std::cout << "\n--- Idle Strategy Test ---" << std::endl;
+    IdleMode idle_mode = IdleMode::BUSY_SPIN;
+    for (IdleMode mode : {IdleMode::BUSY_SPIN, IdleMode::SPIN_YIELD, IdleMode::SPIN_PARK}) {
+        [[maybe_unused]] const bool mode_parsed = parseIdleMode(to_string(mode), idle_mode);
+        assert(mode_parsed && idle_mode == mode);
+    }
+    [[maybe_unused]] const bool bad_mode_parsed = parseIdleMode("sleep", idle_mode);
+    assert(!bad_mode_parsed && idle_mode == IdleMode::SPIN_PARK);
+
+    WakeSignal wake;
+    uint32_t wake_epoch = wake.epoch();
+    wake.notify();
+    [[maybe_unused]] bool woke = wake.wait(wake_epoch, std::chrono::seconds(5));
+    assert(woke && "A notify after the epoch must not be lost");
+    wake_epoch = wake.epoch();
+    auto wait_start = std::chrono::steady_clock::now();
+    woke = wake.wait(wake_epoch, std::chrono::milliseconds(20));
+    assert(!woke && "A wait without a notify should time out");
+    assert(std::chrono::steady_clock::now() - wait_start >= std::chrono::milliseconds(15));
+
+    std::atomic<bool> parked_woke{false};
+    wake_epoch = wake.epoch();
+    std::thread parked([&wake, &parked_woke, wake_epoch] {
+        parked_woke.store(wake.wait(wake_epoch, std::chrono::seconds(10)));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    wait_start = std::chrono::steady_clock::now();
+    wake.notify();
+    parked.join();
+    const auto wake_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - wait_start).count();
+    std::cout << "Parked thread woke after " << wake_ms << " ms" << std::endl;
+    assert(parked_woke.load() && wake_ms < 1000);
+
+    IdleStrategy parking(IdleMode::SPIN_PARK, &wake, std::chrono::microseconds(100));
+    for (int i = 0; i < kIdleSpinFallbackThreshold + IdleStrategy::kYieldIterations + 10; ++i) parking.idle(false);
+    assert(parking.mode() == IdleMode::SPIN_PARK && parking.parks() > 0);
+    IdleStrategy no_signal(IdleMode::SPIN_PARK);
+    assert(no_signal.mode() == IdleMode::SPIN_YIELD && "SPIN_PARK needs a WakeSignal");
+    for (int i = 0; i < kIdleSpinFallbackThreshold + IdleStrategy::kYieldIterations + 10; ++i) no_signal.idle(false);
+    assert(no_signal.parks() == 0);
+
+    // A parked shard must pick up ticks promptly and report its fills on the signal.
+    WakeSignal shard_fills;
+    EngineShard parked_shard(0, 1, {"ETH-USD"}, shard_breach, shard_max_position, shard_order_size, 1);
+    parked_shard.start(ThreadPlacement{}, IdleMode::SPIN_PARK, &shard_fills);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));  // let it reach the park phase
+    [[maybe_unused]] const uint32_t fills_epoch = shard_fills.epoch();
+    for (uint32_t n = 0; n < 20; ++n) {
+        HFTMarketData tick{};
+        set_symbol(tick.symbol, "ETH-USD");
+        tick.bid_price = 1850.0 + 0.01 * (n % 5);
+        tick.ask_price = tick.bid_price + 0.10;
+        tick.trace.recv_tsc = FastClock::now();
+        while (!parked_shard.publish(tick)) std::this_thread::yield();
+    }
+    for (int wait = 0; wait < 500 && parked_shard.snapshot().ticks < 20; ++wait) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    assert(parked_shard.snapshot().ticks == 20 && "Publishing must wake a parked shard");
+    if (parked_shard.snapshot().fills > 0) assert(shard_fills.epoch() != fills_epoch);
+    parked_shard.stop();
+
+    // --- Event-Driven Risk Test ---
+    std::cout << "\n--- Event-Driven Risk Test ---" << std::endl;
+    // Round trips bought at 2000 and sold at 1950 lose 0.5 each; the breaker must trip on the
+    // fill that crosses the tighter of the loss and drawdown limits, not at the next poll.
+    const double trip_loss = std::min(std::stod(config.getConfig("MAX_DAILY_LOSS_LIMIT", "100.0")),
+                                       std::stod(config.getConfig("MAX_DRAWDOWN_LIMIT", "50.0")));
+    const int breach_fill = 2 * static_cast<int>(std::ceil(trip_loss / 0.5));
+    const auto loss_fill = [](int n) {
+        HFTOrder fill{};
+        set_symbol(fill.symbol, "ETH-USD");
+        fill.order_id = static_cast<uint64_t>(n + 1);
+        fill.side = (n % 2 == 0) ? 'B' : 'S';
+        fill.price = (n % 2 == 0) ? 2000.0 : 1950.0;
+        fill.quantity = 0.01;
+        fill.filled_quantity = 0.01;
+        fill.status = 'F';
+        fill.fill_tsc = FastClock::now();
+        return fill;
+    };
+
+    for (bool threaded : {false, true}) {
+        RiskManager delta_risk;
+        delta_risk.initialize("config.txt");
+        std::atomic<bool> delta_breach{false};
+        delta_risk.setBreachFlag(&delta_breach);
+
+        OrderManager delta_orders;
+        delta_orders.initialize();
+        AtomicHFTMetrics delta_metrics;
+        std::atomic<double> delta_position{0.0};
+        std::atomic<bool> delta_executor_breach{false};
+        std::atomic<double> delta_max_position{1.0};
+        OrderExecutor delta_executor("ETH-USD", delta_orders, delta_metrics, delta_position,
+                                     delta_executor_breach, delta_max_position);
+        delta_executor.set_risk_deltas(&delta_risk.riskDeltas());
+
+        if (!threaded) {
+            // Inline: the flag must flip on exactly the breaching fill.
+            for (int n = 0; n < breach_fill + 4; ++n) {
+                delta_executor.process_order_response(loss_fill(n));
+                delta_risk.processRiskDeltas();
+                assert(delta_breach.load() == (n + 1 >= breach_fill) && "Breach must be flagged on the crossing fill");
+            }
+        } else {
+            // A risk thread parked like the engine's, fed by a burst of fills.
+            WakeSignal fills_wake;
+            std::atomic<bool> risk_running{true};
+            std::thread risk_thread([&] {
+                uint32_t wake_epoch = fills_wake.epoch();
+                while (risk_running.load()) {
+                    delta_risk.processRiskDeltas();
+                    fills_wake.wait(wake_epoch, std::chrono::milliseconds(100));
+                    wake_epoch = fills_wake.epoch();
+                }
+                delta_risk.processRiskDeltas();
+            });
+            for (int n = 0; n < breach_fill + 4; ++n) {
+                delta_executor.process_order_response(loss_fill(n));
+                fills_wake.notify();
+            }
+            for (int wait = 0; wait < 1000 && !delta_breach.load(); ++wait) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            risk_running.store(false);
+            fills_wake.notify();
+            risk_thread.join();
+        }
+
+        const uint64_t breach_ns = FastClock::getInstance().ticksToNanos(delta_risk.getBreachLatencyTicks());
+        std::cout << (threaded ? "Risk thread: " : "Inline: ") << "breach on fill " << delta_risk.getBreachDeltaIndex()
+                  << " of " << breach_fill + 4 << ", " << breach_ns << " ns after the fill" << std::endl;
+        assert(delta_breach.load() && delta_risk.isCircuitBreakerActive());
+        assert(delta_risk.getBreachDeltaIndex() == static_cast<uint64_t>(breach_fill) &&
+               "The breaker must trip on the fill that crossed the limit");
+        assert(breach_ns < 1000000000ULL);
+        assert(delta_executor.dropped_risk_deltas() == 0);
+        delta_orders.shutdown();
+        delta_risk.shutdown();
+    }
+
+    // --- Config Snapshot Test ---
+    std::cout << "\n--- Config Snapshot Test ---" << std::endl;
+    {
+        ConfigSnapshot rejected;
+        std::string snapshot_error;
+        [[maybe_unused]] bool snapshot_built = ConfigSnapshot::build({{"TICK_SIZE", "0"}}, rejected, snapshot_error);
+        assert(!snapshot_built);
+        std::cout << "Rejected: " << snapshot_error << std::endl;
+        snapshot_built = ConfigSnapshot::build({{"ORDER_SIZE", "abc"}}, rejected, snapshot_error);
+        assert(!snapshot_built);
+        snapshot_built = ConfigSnapshot::build({{"ORDER_LADDER_LEVELS", "2.5"}}, rejected, snapshot_error);
+        assert(!snapshot_built);
+
+        const ConfigSnapshot* loaded = Config::snapshot();
+        assert(loaded != nullptr && loaded->version >= 1);
+        const uint32_t base_levels = loaded->order_ladder_levels;
+        MarketMakingStrategy live_strategy;
+        const uint32_t live_levels = live_strategy.generate_signal(2000.0, 2000.5, 0.0, 0.01).num_levels;
+        std::cout << "Snapshot v" << loaded->version << ": strategy quotes " << live_levels << " levels" << std::endl;
+        assert(live_levels == base_levels);
+
+        const std::string reload_path = "logs/config_reload_test.txt";
+        const auto write_levels = [&reload_path](const std::string& levels) {
+            std::ofstream file(reload_path, std::ios::trunc);
+            file << "ORDER_LADDER_LEVELS=" << levels << "\n";
+        };
+        write_levels(std::to_string(base_levels));
+        [[maybe_unused]] const bool reload_loaded = config.loadFromFile(reload_path);
+        assert(reload_loaded);
+
+        write_levels("3");
+        std::string reload_error;
+        [[maybe_unused]] bool reloaded = config.reload(reload_error);
+        assert(reloaded);
+        assert(Config::snapshot()->version > loaded->version);
+        const uint32_t reloaded_levels = live_strategy.generate_signal(2000.0, 2000.5, 0.0, 0.01).num_levels;
+        std::cout << "Reloaded to snapshot v" << Config::snapshot()->version << ": strategy quotes "
+                  << reloaded_levels << " levels" << std::endl;
+        assert(reloaded_levels == 3 && "The same strategy instance sees the new snapshot");
+        assert(loaded->order_ladder_levels == base_levels && "Old snapshots stay valid and unchanged");
+
+        [[maybe_unused]] const ConfigSnapshot* before_bad = Config::snapshot();
+        write_levels("0");
+        reloaded = config.reload(reload_error);
+        assert(!reloaded);
+        std::cout << "Reload rejected: " << reload_error << std::endl;
+        assert(Config::snapshot() == before_bad && "A rejected reload keeps the running snapshot");
+
+        // Watcher path, as SIGHUP drives it.
+        write_levels(std::to_string(base_levels));
+        config.startWatcher(std::chrono::milliseconds(20));
+        config.requestReload();
+        for (int i = 0; i < 200 && Config::snapshot()->order_ladder_levels != base_levels; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        config.stopWatcher();
+        assert(Config::snapshot()->order_ladder_levels == base_levels);
+        std::cout << "Watcher reloaded to snapshot v" << Config::snapshot()->version << std::endl;
+        std::remove(reload_path.c_str());
+    }
+
+    // --- Avellaneda-Stoikov Test ---
+    std::cout << "\n--- Avellaneda-Stoikov Test ---" << std::endl;
+    {
+        // Mid steps +/-step every 10 ms: sigma^2 = step^2 / 0.01 s, kappa = 1 / step.
+        const uint64_t ten_ms = static_cast<uint64_t>(1e7 / FastClock::getInstance().nanosPerTick());
+        const auto run_walk = [ten_ms](AvellanedaStoikovStrategy& as, double step, int ticks) {
+            double mid = 2000.0;
+            uint64_t tsc = ten_ms;
+            for (int i = 0; i < ticks; ++i) {
+                mid += (i % 4 < 2) ? step : -step;
+                tsc += ten_ms;
+                as.on_tick(mid - 0.005, mid + 0.005, tsc, 0.0, 0.005);
+            }
+        };
+
+        AvellanedaStoikovStrategy quiet;
+        MarketMakingStrategy fixed;
+        const HFTSignal cold = quiet.on_tick(2000.0, 2000.01, ten_ms, 0.0, 0.005);
+        const HFTSignal fixed_signal = fixed.generate_signal(2000.0, 2000.01, 0.0, 0.005);
+        std::cout << "Cold: " << cold.bid_price << " / " << cold.ask_price << " | fixed spread "
+                  << fixed_signal.bid_price << " / " << fixed_signal.ask_price << std::endl;
+        assert(!quiet.estimator().warm());
+        assert(cold.bid_price == fixed_signal.bid_price && cold.ask_price == fixed_signal.ask_price &&
+               "Cold estimator falls back to the fixed spread");
+
+        run_walk(quiet, 0.01, 2000);
+        assert(quiet.estimator().warm());
+        const MarketEstimator& estimate = quiet.estimator();
+        std::cout << "Quiet: sigma^2/s " << estimate.variance_rate() << " | moves/s " << estimate.intensity()
+                  << " | kappa " << estimate.kappa() << std::endl;
+        assert(std::abs(estimate.variance_rate() - 0.01) < 0.0005);
+        assert(std::abs(estimate.intensity() - 100.0) < 5.0);
+        assert(std::abs(estimate.kappa() - 100.0) < 1.0);
+
+        AvellanedaStoikovStrategy volatile_as;
+        run_walk(volatile_as, 0.05, 2000);
+        const double mid = 2000.0;
+        const HFTSignal quiet_flat = quiet.generate_signal(mid - 0.005, mid + 0.005, 0.0, 0.005);
+        const HFTSignal volatile_flat = volatile_as.generate_signal(mid - 0.005, mid + 0.005, 0.0, 0.005);
+        const double quiet_spread = quiet_flat.ask_price - quiet_flat.bid_price;
+        const double volatile_spread = volatile_flat.ask_price - volatile_flat.bid_price;
+        std::cout << "Spread quiet " << quiet_spread << " | volatile " << volatile_spread << std::endl;
+        assert(volatile_spread > 2.0 * quiet_spread && "Spread widens with volatility");
+        assert(std::abs((quiet_flat.bid_price + quiet_flat.ask_price) * 0.5 - mid) < 1e-9 && "Flat quotes center on the mid");
+        assert(quiet_flat.bid_price <= mid - 0.005 && quiet_flat.ask_price >= mid + 0.005 && "Never through the touch");
+
+        const HFTSignal quiet_long = quiet.generate_signal(mid - 0.005, mid + 0.005, 0.01, 0.005);
+        assert(quiet_long.bid_price < quiet_flat.bid_price && quiet_long.ask_price < quiet_flat.ask_price &&
+               "Long inventory lowers the reservation price");
+        assert(quiet_long.bid_quantity < quiet_long.ask_quantity);
+        const HFTSignal quiet_short = quiet.generate_signal(mid - 0.005, mid + 0.005, -0.01, 0.005);
+        std::cout << "Reservation long " << (quiet_long.bid_price + quiet_long.ask_price) * 0.5
+                  << " | short " << (quiet_short.bid_price + quiet_short.ask_price) * 0.5 << std::endl;
+        assert(quiet_short.bid_price > quiet_flat.bid_price && quiet_short.ask_quantity < quiet_short.bid_quantity);
+    }
+
+    // --- Strategy Dispatch Test ---
+    std::cout << "\n--- Strategy Dispatch Test ---" << std::endl;
+    {
+        StrategyKind kind = StrategyKind::FIXED_SPREAD;
+        [[maybe_unused]] bool kind_parsed = parseStrategyKind("avellaneda_stoikov", kind);
+        assert(kind_parsed && kind == StrategyKind::AVELLANEDA_STOIKOV);
+        kind_parsed = parseStrategyKind("martingale", kind);
+        assert(!kind_parsed && kind == StrategyKind::AVELLANEDA_STOIKOV);
+        kind_parsed = parseStrategyKind(to_string(StrategyKind::FIXED_SPREAD), kind);
+        assert(kind_parsed && kind == StrategyKind::FIXED_SPREAD);
+        StrategyVariant selected = makeStrategy(StrategyKind::AVELLANEDA_STOIKOV);
+        assert(std::holds_alternative<AvellanedaStoikovStrategy>(selected));
+        selected = makeStrategy(StrategyKind::FIXED_SPREAD);
+        assert(std::holds_alternative<MarketMakingStrategy>(selected));
+
+        // A loop written once against the interface, as the engines are, quotes exactly like
+        // the concrete type.
+        const StrategyInput input = MarketMakingStrategy::make_input(1850.50, 1850.60, 1850.56, 0, 0.004, 0.005);
+        const HFTSignal visited = std::visit([&input](auto& chosen) { return chosen.on_tick(input); }, selected);
+        const HFTSignal direct = MarketMakingStrategy().generate_signal(1850.50, 1850.60, 1850.56, 0.004, 0.005);
+        assert(visited.bid_price == direct.bid_price && visited.ask_price == direct.ask_price &&
+               visited.bid_quantity == direct.bid_quantity && visited.num_levels == direct.num_levels);
+        std::cout << "Selected " << to_string(kind) << ": " << std::setprecision(4) << visited.bid_price
+                  << " / " << visited.ask_price << " (direct " << direct.bid_price << " / " << direct.ask_price
+                  << ")" << std::endl;
+    }
+
+    // --- Fair Value Test ---
+    std::cout << "\n--- Fair Value Test ---" << std::endl;
+    {
+        HFTMarketData book{};
+        book.bid_price = 100.00;
+        book.ask_price = 100.01;
+        FairValue fair;
+        [[maybe_unused]] const double top_only = fair.update(book);
+        assert(top_only == 100.005 && fair.imbalance() == 0.0 && "No depth: the mid");
+
+        DepthSnapshot& depth = book.depth;
+        depth.bid_price = {100.00, 99.99};
+        depth.bid_quantity = {3.0, 1.0};
+        depth.bid_levels = 2;
+        depth.ask_price = {100.01, 100.02, 100.03};
+        depth.ask_quantity = {1.0, 1.0, 5.0};
+        depth.ask_levels = 3;
+        const ConfigSnapshot& fv_config = *Config::snapshot();
+        const double decay = fv_config.fair_value_level_decay;
+        const double bid_sum = 3.0 + decay * 1.0;
+        const double ask_sum = 1.0 + decay * 1.0;
+        const double expected_micro = (100.00 * 1.0 + 100.01 * 3.0) / 4.0;
+        const double expected_pressure = (100.00 * 1.0 + 100.01 * 3.0 + decay * (99.99 * 1.0 + 100.02 * 1.0))
+                                         / (bid_sum + ask_sum);
+        const double expected_offset = fv_config.fair_value_skew *
+            ((1.0 - fv_config.fair_value_depth_weight) * (expected_micro - 100.005) +
+             fv_config.fair_value_depth_weight * (expected_pressure - 100.005));
+
+        const double value = fair.update(book);
+        std::cout << "Microprice " << std::setprecision(5) << fair.microprice() << " | imbalance "
+                  << fair.imbalance() << " | pressure " << fair.pressure() << " | fair " << value
+                  << " (expected offset " << expected_offset << ")" << std::endl;
+        assert(std::abs(fair.microprice() - expected_micro) < 1e-9);
+        assert(std::abs(fair.imbalance() - (bid_sum - ask_sum) / (bid_sum + ask_sum)) < 1e-12);
+        assert(std::abs(fair.pressure() - expected_pressure) < 1e-9);
+        assert(std::abs(value - (100.005 + expected_offset)) < 1e-9 && value > 100.005 && "Bid-heavy book leans up");
+
+        depth.ask_quantity[2] = 500.0;
+        [[maybe_unused]] const double unmatched_deep = fair.update(book);
+        assert(unmatched_deep == value && "Levels one side lacks are ignored");
+        assert(std::abs(fair.center(100.10, 100.11) - (100.105 + fair.offset())) < 1e-12);
+
+        MarketMakingStrategy centered;
+        const HFTSignal at_mid = centered.generate_signal(100.00, 100.01, 0.0, 0.01);
+        const HFTSignal at_fair = centered.generate_signal(100.00, 100.01, value, 0.0, 0.01);
+        assert(std::abs((at_fair.ask_price - at_mid.ask_price) - fair.offset()) < 1e-9 && "Quotes follow the fair value");
+        assert(at_fair.bid_price <= 100.00 && "Never through the touch");
+        const HFTSignal far = centered.generate_signal(100.00, 100.01, 100.05, 0.0, 0.01);
+        std::cout << "Ask at mid " << at_mid.ask_price << " | at fair " << at_fair.ask_price
+                  << " | far fair " << far.bid_price << " / " << far.ask_price << std::endl;
+        assert(far.bid_price == 100.00 && far.ask_price > 100.05);
+    }
+
+    // --- Order Ladder Test ---
+    std::cout << "\n--- Order Ladder Test ---" << std::endl;
+    {
+        std::atomic<double> ladder_position{0.0};
+        std::atomic<bool> ladder_breach{false};
+        std::atomic<double> ladder_max{1.0};
+        OrderExecutor ladder_executor("ETH-USD", order_manager, metrics.metrics(),
+                                      ladder_position, ladder_breach, ladder_max);
+        HFTSignal ladder_signal;
+        ladder_signal.place_bid = ladder_signal.place_ask = true;
+        ladder_signal.bid_price = 1850.00;
+        ladder_signal.ask_price = 1850.10;
+        ladder_signal.bid_quantity = ladder_signal.ask_quantity = 0.01;
+        ladder_signal.num_levels = 10;
+        [[maybe_unused]] const double tick = Config::snapshot()->tick_size;
+
+        const uint32_t full = ladder_executor.build_ladder(ladder_signal);
+        std::cout << "Full ladder: " << full << " orders" << std::endl;
+        assert(full == 20);
+        [[maybe_unused]] const uint64_t first_id = ladder_executor.ladder_order(0, 'B').order_id;
+        for (uint32_t i = 0; i < 20; ++i) {
+            [[maybe_unused]] const uint32_t level = i / 2;
+            [[maybe_unused]] const char side = (i % 2 == 0) ? 'B' : 'S';
+            [[maybe_unused]] const HFTOrder& order = ladder_executor.ladder_order(level, side);
+            [[maybe_unused]] const double factor = std::max(0.1, 1.0 - level * 0.1);
+            assert(order.side == side && order.priority == level && order.status == 'N');
+            assert(std::abs(order.price - (side == 'B' ? 1850.00 - level * tick : 1850.10 + level * tick)) < 1e-9 &&
+                   "Default shape: one tick per level");
+            assert(order.quantity == 0.01 * factor);
+            assert(order.order_id == first_id + i && order.client_order_id == order.order_id && "Bid then ask per level");
+            assert(std::string(order.symbol.data()) == "ETH-USD");
+        }
+
+        // Each level against the pre-ladder position: buys that would pass 1.0 are masked.
+        ladder_position.store(0.995);
+        uint32_t expected = 0;
+        for (uint32_t level = 0; level < 10; ++level) {
+            const double qty = 0.01 * std::max(0.1, 1.0 - level * 0.1);
+            expected += (std::abs(0.995 + qty) <= 1.0) + (std::abs(0.995 - qty) <= 1.0);
+        }
+        const uint32_t limited = ladder_executor.build_ladder(ladder_signal);
+        std::cout << "Near the limit: " << limited << " of 20 orders" << std::endl;
+        assert(limited == expected && limited > 10 && limited < 20);
+        ladder_position.store(0.0);
+
+        ladder_signal.bid_quantity = 0.0015;
+        ladder_signal.place_ask = false;
+        const uint32_t above_min = ladder_executor.build_ladder(ladder_signal);
+        assert(above_min == 4 && "Levels under MIN_ORDER_QTY are masked");
+        assert(ladder_executor.ladder().bid_mask == 0xF && ladder_executor.ladder().ask_mask == 0);
+
+        ladder_breach.store(true);
+        const uint32_t breached = ladder_executor.build_ladder(ladder_signal);
+        assert(breached == 0 && "A breach empties the ladder");
+        ladder_breach.store(false);
+        std::cout << "Above MIN_ORDER_QTY: " << above_min << " orders | breached: " << breached << std::endl;
+
+        ladder_signal.place_ask = true;
+        ladder_signal.bid_price = 1850.004;
+        ladder_signal.ask_price = 1850.096;
+        ladder_executor.build_ladder(ladder_signal);
+        assert(std::abs(ladder_executor.ladder_order(1, 'B').price - (1850.00 - tick)) < 1e-9 &&
+               std::abs(ladder_executor.ladder_order(1, 'S').price - (1850.10 + tick)) < 1e-9 &&
+               "Off-grid quotes snap away from the touch");
+
+        // The build reads no clock; the whole ladder is stamped once as it is sent.
+        ladder_executor.place_order_ladder(ladder_signal);
+        [[maybe_unused]] const uint64_t built_tsc = ladder_executor.ladder_order(0, 'B').built_tsc;
+        assert(built_tsc != 0 && "Sent orders carry a build stamp");
+        const OrderLadder& sent_ladder = ladder_executor.ladder();
+        for (uint32_t level = 0; level < sent_ladder.levels; ++level) {
+            assert((!sent_ladder.bid_at(level) || ladder_executor.ladder_order(level, 'B').built_tsc == built_tsc) &&
+                   (!sent_ladder.ask_at(level) || ladder_executor.ladder_order(level, 'S').built_tsc == built_tsc) &&
+                   "One stamp per ladder");
+        }
+        HFTOrder ladder_response{};
+        while (ladder_executor.pop_response(ladder_response)) {}
+
+        // Shapes, in ticks: rounded to the grid and never two levels on one price.
+        ConfigSnapshot shape;
+        std::string shape_error;
+        [[maybe_unused]] const auto offset_ticks = [&shape](size_t level) {
+            return std::lround(shape.ladder_offset[level] / shape.tick_size);
+        };
+        [[maybe_unused]] bool shape_built = ConfigSnapshot::build(
+            {{"LADDER_SPACING", "geometric"}, {"LADDER_STEP_GROWTH", "2"},
+             {"LADDER_SIZE_CURVE", "exponential"}, {"LADDER_SIZE_DECAY", "0.5"}}, shape, shape_error);
+        assert(shape_built);
+        assert(offset_ticks(1) == 1 && offset_ticks(2) == 3 && offset_ticks(3) == 7 && offset_ticks(4) == 15);
+        assert(shape.ladder_size_factor[2] == 0.25 && shape.ladder_size_factor[4] == 0.1 && "Floored at 0.1");
+        shape_built = ConfigSnapshot::build({{"LADDER_STEP_TICKS", "0.4"}}, shape, shape_error);
+        assert(shape_built);
+        assert(offset_ticks(1) == 1 && offset_ticks(2) == 2 && offset_ticks(5) == 5);
+        shape_built = ConfigSnapshot::build({{"LADDER_SPACING", "list"}, {"LADDER_OFFSETS_TICKS", "0, 2, 3"},
+                                             {"LADDER_SIZE_CURVE", "list"}, {"LADDER_SIZES", "1,0.5"}},
+                                            shape, shape_error);
+        assert(shape_built);
+        assert(offset_ticks(1) == 2 && offset_ticks(3) == 4 && offset_ticks(63) == 64 && "Last gap repeats");
+        assert(shape.ladder_size_factor[1] == 0.5 && shape.ladder_size_factor[9] == 0.5);
+        shape_built = ConfigSnapshot::build({{"LADDER_SPACING", "list"}}, shape, shape_error);
+        assert(!shape_built);
+        shape_built = ConfigSnapshot::build({{"LADDER_OFFSETS_TICKS", "0,2,1"}}, shape, shape_error);
+        assert(!shape_built);
+        shape_built = ConfigSnapshot::build({{"LADDER_SPACING", "spiral"}}, shape, shape_error);
+        assert(!shape_built);
+        std::cout << "Rejected: " << shape_error << std::endl;
+    }
+
+    // --- JWT Signer Test ---
+    std::cout << "\n--- JWT Signer Test ---" << std::endl;
+    // A throwaway P-256 key, "\n"-escaped the way config.txt holds it.
+    std::string test_pem;
+    {
+        EVP_PKEY* test_key = EVP_EC_gen("P-256");
+        BIO* bio = BIO_new(BIO_s_mem());
+        PEM_write_bio_PrivateKey(bio, test_key, nullptr, nullptr, 0, nullptr, nullptr);
+        char* pem_data = nullptr;
+        const long pem_length = BIO_get_mem_data(bio, &pem_data);
+        for (long i = 0; i < pem_length; ++i) {
+            if (pem_data[i] == '\n') test_pem += "\\n"; else test_pem += pem_data[i];
+        }
+        BIO_free(bio);
+
+        const auto base64url_decode = [](const std::string& in) {
+            std::string out;
+            uint32_t bits = 0;
+            int count = 0;
+            for (char c : in) {
+                const char* table = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+                bits = (bits << 6) | static_cast<uint32_t>(std::strchr(table, c) - table);
+                if ((count += 6) >= 8) {
+                    count -= 8;
+                    out += static_cast<char>((bits >> count) & 0xFF);
+                }
+            }
+            return out;
+        };
+
+        JwtSigner signer;
+        [[maybe_unused]] bool key_set = signer.setKey("organizations/test/apiKeys/smoke", "not a key");
+        assert(!key_set);
+        [[maybe_unused]] const int keyless_handle = signer.track("GET api.coinbase.com");
+        assert(keyless_handle == -1 && "No key, no tokens");
+        key_set = signer.setKey("organizations/test/apiKeys/smoke", test_pem);
+        assert(key_set);
+        const int handle = signer.track("GET api.coinbase.com");
+        [[maybe_unused]] const int same_handle = signer.track("GET api.coinbase.com");
+        assert(handle == 0 && same_handle == 0 && signer.signatures() == 1);
+
+        const std::string token(signer.token(handle));
+        const size_t dot1 = token.find('.');
+        const size_t dot2 = token.find('.', dot1 + 1);
+        assert(dot1 != std::string::npos && dot2 != std::string::npos);
+        const auto header = nlohmann::json::parse(base64url_decode(token.substr(0, dot1)));
+        const auto claims = nlohmann::json::parse(base64url_decode(token.substr(dot1 + 1, dot2 - dot1 - 1)));
+        assert(header["alg"] == "ES256" && header["kid"] == "organizations/test/apiKeys/smoke");
+        assert(header["nonce"].get<std::string>().size() == 32);
+        assert(claims["iss"] == "cdp" && claims["uri"] == "GET api.coinbase.com");
+        assert(claims["exp"].get<int64_t>() - claims["nbf"].get<int64_t>() == 120);
+
+        // The signature verifies against the public key (r || s back to DER for OpenSSL).
+        const std::string raw = base64url_decode(token.substr(dot2 + 1));
+        assert(raw.size() == 64);
+        ECDSA_SIG* sig = ECDSA_SIG_new();
+        ECDSA_SIG_set0(sig, BN_bin2bn(reinterpret_cast<const unsigned char*>(raw.data()), 32, nullptr),
+                       BN_bin2bn(reinterpret_cast<const unsigned char*>(raw.data()) + 32, 32, nullptr));
+        unsigned char* der = nullptr;
+        const int der_length = i2d_ECDSA_SIG(sig, &der);
+        EVP_MD_CTX* verify = EVP_MD_CTX_new();
+        [[maybe_unused]] const int verify_ready = EVP_DigestVerifyInit(verify, nullptr, EVP_sha256(), nullptr, test_key);
+        assert(verify_ready == 1);
+        const int verified = EVP_DigestVerify(verify, der, static_cast<size_t>(der_length),
+                                              reinterpret_cast<const unsigned char*>(token.data()), dot2);
+        std::cout << "ES256 signature " << (verified == 1 ? "verifies" : "does not verify") << std::endl;
+        assert(verified == 1 && "ES256 signature must verify");
+        EVP_MD_CTX_free(verify);
+        OPENSSL_free(der);
+        ECDSA_SIG_free(sig);
+        EVP_PKEY_free(test_key);
+
+        // Fresh tokens are not re-signed; forced ones are, and an old view stays readable.
+        [[maybe_unused]] const std::string_view held = signer.token(handle);
+        signer.refreshDue();
+        assert(signer.signatures() == 1);
+        signer.refreshDue(true);
+        assert(signer.signatures() == 2 && signer.token(handle) != token && held == token);
+        [[maybe_unused]] const std::string one_off = signer.sign("POST api.coinbase.com/api/v3/brokerage/orders");
+        assert(!one_off.empty() && signer.signatures() == 3);
+        std::cout << "Token: " << token.size() << " bytes" << std::endl;
+    }
+
+    // --- Order Gateway Test ---
+    std::cout << "\n--- Order Gateway Test ---" << std::endl;
+    {
+        // Replay: orders rest per level and fill at their own price once the book trades through.
+        std::atomic<double> replay_position{0.0};
+        std::atomic<bool> replay_breach{false};
+        std::atomic<double> replay_max{1.0};
+        OrderExecutor replay_executor("ETH-USD", order_manager, metrics.metrics(),
+                                      replay_position, replay_breach, replay_max);
+        replay_executor.set_gateway(std::make_unique<ReplayGateway>());
+        auto& replay = static_cast<ReplayGateway&>(replay_executor.gateway());
+        assert(std::string(replay.name()) == "replay");
+
+        HFTSignal replay_signal;
+        replay_signal.place_bid = replay_signal.place_ask = true;
+        replay_signal.bid_price = 1850.00;
+        replay_signal.ask_price = 1850.10;
+        replay_signal.bid_quantity = replay_signal.ask_quantity = 0.01;
+        replay_signal.num_levels = 2;
+        replay_executor.place_order_ladder(replay_signal);
+        replay_executor.place_order_ladder(replay_signal);
+        assert(replay.resting() == 4 && "A new ladder replaces the resting one");
+
+        HFTOrder replay_fill;
+        replay_executor.on_book(1849.95, 1850.15);
+        [[maybe_unused]] bool replay_popped = replay_executor.pop_response(replay_fill);
+        assert(!replay_popped && "Nothing fills inside the spread");
+        replay_executor.on_book(1849.90, 1850.00);
+        replay_popped = replay_executor.pop_response(replay_fill);
+        assert(replay_popped);
+        assert(replay_fill.status == 'F' && replay_fill.side == 'B' && replay_fill.price == 1850.00 &&
+               replay_fill.filled_quantity == 0.01 && replay_fill.priority == 0);
+        HFTOrder second_level;
+        replay_popped = replay_executor.pop_response(second_level);
+        assert(!replay_popped && "The second level is a tick lower");
+        replay_executor.process_order_response(replay_fill);
+        std::cout << "Replay gateway: " << replay.resting() << " resting after one fill" << std::endl;
+        assert(std::abs(replay_position.load() - 0.01) < 1e-12);
+        assert(replay.resting() == 3);
+
+        HFTOrder reject;
+        reject.status = 'R';
+        reject.side = 'B';
+        replay_executor.process_order_response(reject);
+        assert(replay_executor.rejected_orders() == 1 && std::abs(replay_position.load() - 0.01) < 1e-12);
+
+        GatewayKind kind;
+        [[maybe_unused]] bool kind_parsed = parseGatewayKind("coinbase", kind);
+        assert(kind_parsed && kind == GatewayKind::COINBASE);
+        kind_parsed = parseGatewayKind("binance", kind);
+        assert(!kind_parsed);
+
+        // Encoder: exact bytes, prices to the tick's decimals, sizes to 8.
+        CoinbaseOrderEncoder encoder("ETH-USD", 0.01, "s1-");
+        HFTOrder encoded;
+        encoded.client_order_id = 42;
+        encoded.side = 'S';
+        encoded.price = 1850.1;
+        encoded.quantity = 0.0125;
+        char body[CoinbaseOrderEncoder::kMaxBodyBytes];
+        const std::string create(body, encoder.encode_create(encoded, body));
+        std::cout << create << std::endl;
+        assert(create == "{\"client_order_id\":\"s1-42\",\"product_id\":\"ETH-USD\",\"side\":\"SELL\","
+                         "\"order_configuration\":{\"limit_limit_gtc\":{\"base_size\":\"0.01250000\","
+                         "\"limit_price\":\"1850.10\",\"post_only\":true}}}");
+        assert(nlohmann::json::parse(create)["order_configuration"]["limit_limit_gtc"]["limit_price"] == "1850.10");
+        assert(CoinbaseOrderEncoder("BTC-USD", 0.5, "x").price_decimals() == 1);
+        assert(CoinbaseOrderEncoder("SHIB-USD", 0.00000001, "x").price_decimals() == 8);
+        assert(encoder.parse_client_order_id("s1-42", 5) == 42 && encoder.parse_client_order_id("s2-42", 5) == 0);
+
+        // Coinbase gateway against the local mock: one keep-alive connection, pre-signed tokens.
+        MockGatewayServer mock("127.0.0.1", 0);
+        [[maybe_unused]] const bool mock_started = mock.start();
+        assert(mock_started);
+        JwtSigner signer;
+        [[maybe_unused]] const bool key_set = signer.setKey("organizations/test/apiKeys/smoke", test_pem);
+        assert(key_set);
+        [[maybe_unused]] const uint64_t signed_before = signer.signatures();
+        CoinbaseGatewayOptions options;
+        options.url = "http://127.0.0.1:" + std::to_string(mock.port());
+        options.product_id = "ETH-USD";
+        options.session_prefix = "s1-";
+        CoinbaseGateway gateway(options, &signer);
+        [[maybe_unused]] const bool gateway_started = gateway.start();
+        assert(gateway_started);
+
+        const auto await = [&gateway](size_t count, std::vector<HFTOrder>& out) {
+            out.clear();
+            HFTOrder response;
+            for (int i = 0; i < 2000 && out.size() < count; ++i) {
+                while (gateway.poll(response)) out.push_back(response);
+                if (out.size() < count) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+            return out.size() == count;
+        };
+
+        std::vector<HFTOrder> quotes(4);
+        for (uint32_t i = 0; i < 4; ++i) {
+            quotes[i].client_order_id = quotes[i].order_id = 100 + i;
+            quotes[i].priority = i / 2;
+            quotes[i].side = (i % 2 == 0) ? 'B' : 'S';
+            quotes[i].price = (i % 2 == 0) ? 1850.00 - 0.01 * (i / 2) : 1850.10 + 0.01 * (i / 2);
+            quotes[i].quantity = 0.01;
+            quotes[i].status = 'N';
+            set_symbol(quotes[i].symbol, "ETH-USD");
+        }
+        std::vector<HFTOrder> responses;
+        [[maybe_unused]] bool sent = true;
+        for (const HFTOrder& quote : quotes) sent &= gateway.send(quote);
+        assert(sent);
+        [[maybe_unused]] bool arrived = await(4, responses);
+        assert(arrived);
+        assert(std::all_of(responses.begin(), responses.end(), [](const HFTOrder& r) { return r.status == 'A'; }));
+        assert(mock.orders() == 4 && mock.connections() == 1 && "Requests share one connection");
+        [[maybe_unused]] const int orders_token = signer.track("POST 127.0.0.1/api/v3/brokerage/orders");
+        assert(mock.last_authorization() == "Bearer " + std::string(signer.token(orders_token)));
+        assert(signer.signatures() == signed_before + 2 && "Signed once per path, at start");
+
+        // The same quotes again: nothing to send.
+        for (HFTOrder quote : quotes) {
+            quote.client_order_id += 10;
+            sent = gateway.send(quote);
+            assert(sent);
+        }
+        for (int i = 0; i < 2000 && gateway.stats().skipped_unchanged < 4; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        assert(gateway.stats().skipped_unchanged == 4 && mock.orders() == 4);
+
+        // A moved level: its working order is cancelled, then the new one created.
+        HFTOrder moved = quotes[0];
+        moved.client_order_id = 200;
+        moved.price = 1850.02;
+        sent = gateway.send(moved);
+        assert(sent);
+        arrived = await(1, responses);
+        assert(arrived && responses[0].status == 'A' && responses[0].client_order_id == 200);
+        assert(mock.orders() == 5 && mock.cancels() == 1);
+        assert(mock.last_order_body().find("\"client_order_id\":\"s1-200\"") != std::string::npos);
+
+        mock.set_reject(true);
+        moved.client_order_id = 201;
+        moved.price = 1850.03;
+        sent = gateway.send(moved);
+        assert(sent);
+        arrived = await(1, responses);
+        assert(arrived && responses[0].status == 'R' && responses[0].client_order_id == 201);
+        assert(gateway.stats().orders_rejected == 1 && mock.cancels() == 2 && "200 was cancelled first");
+        mock.set_reject(false);
+
+        // Fills from the user channel: cumulative updates become per-fill deltas.
+        const auto user_update = [](const char* type, const char* client_id, const char* cumulative,
+                                    const char* avg_price, const char* status) {
+            return nlohmann::json{{"channel", "user"}, {"events", {{{"type", type}, {"orders", {{
+                {"order_id", "mock-2"}, {"client_order_id", client_id}, {"product_id", "ETH-USD"},
+                {"order_side", "SELL"}, {"status", status}, {"cumulative_quantity", cumulative},
+                {"leaves_quantity", "0"}, {"avg_price", avg_price}}}}}}}};
+        };
+        gateway.on_user_message(user_update("snapshot", "s1-101", "0.002", "1850.10", "OPEN"));
+        gateway.on_user_message(user_update("update", "s1-101", "0.006", "1850.10", "OPEN"));
+        gateway.on_user_message(user_update("update", "s1-101", "0.01", "1850.10", "FILLED"));
+        gateway.on_user_message(user_update("update", "other-7", "0.01", "1850.10", "FILLED"));
+        arrived = await(2, responses);
+        assert(arrived);
+        assert(responses[0].status == 'F' && responses[0].side == 'S' && responses[0].client_order_id == 101);
+        assert(std::abs(responses[0].filled_quantity - 0.004) < 1e-12 && "Snapshot only sets the baseline");
+        assert(std::abs(responses[1].filled_quantity - 0.004) < 1e-12 && std::abs(responses[1].price - 1850.10) < 1e-9);
+        assert(gateway.stats().fills == 2);
+
+        // The filled ask is no longer working, so re-quoting it is a create without a cancel.
+        HFTOrder requote = quotes[1];
+        requote.client_order_id = 300;
+        for (int i = 0; i < 100 && !gateway.send(requote); ++i) {}
+        arrived = await(1, responses);
+        assert(arrived && responses[0].status == 'A');
+        assert(mock.cancels() == 2 && mock.orders() == 7);
+
+        assert(signer.signatures() == signed_before + 2 && "No signing on the order path");
+
+        // Stop cancels everything still working in one request.
+        [[maybe_unused]] const uint64_t cancel_requests = mock.cancel_requests();
+        gateway.stop();
+        assert(mock.cancel_requests() == cancel_requests + 1 && mock.cancels() == 5);
+        std::cout << "Gateway: " << gateway.stats().requests << " requests over "
+                  << gateway.stats().connects << " connection(s)" << std::endl;
+        mock.stop();
+    }
+
+    // --- Order Batch Test ---
+    std::cout << "\n--- Order Batch Test ---" << std::endl;
+    {
+        std::atomic<double> batch_position{0.0};
+        std::atomic<bool> batch_breach{false};
+        std::atomic<double> batch_max{1.0};
+        OrderExecutor batch_executor("ETH-USD", order_manager, metrics.metrics(),
+                                     batch_position, batch_breach, batch_max);
+        batch_executor.set_gateway(std::make_unique<ReplayGateway>());
+        auto& replay = static_cast<ReplayGateway&>(batch_executor.gateway());
+        const auto drain = [&batch_executor]() {
+            HFTOrder response;
+            while (batch_executor.pop_response(response)) batch_executor.process_order_response(response);
+        };
+
+        HFTSignal batch_signal;
+        batch_signal.place_bid = batch_signal.place_ask = true;
+        batch_signal.bid_price = 1850.00;
+        batch_signal.ask_price = 1850.10;
+        batch_signal.bid_quantity = batch_signal.ask_quantity = 0.01;
+        batch_signal.num_levels = 3;
+        batch_executor.place_order_ladder(batch_signal);
+        assert(replay.resting() == 6);
+
+        // Replacing with a shorter ladder cancels the levels it leaves out.
+        batch_signal.num_levels = 1;
+        batch_executor.place_order_ladder(batch_signal);
+        drain();
+        assert(replay.resting() == 2 && batch_executor.cancelled_orders() == 4);
+
+        // An additive batch leaves the rest working.
+        batch_signal.num_levels = 2;
+        batch_signal.place_bid = false;
+        batch_executor.submit_ladder(batch_signal);
+        assert(replay.resting() == 3 && batch_executor.cancelled_orders() == 4);
+
+        [[maybe_unused]] const bool asks_cancelled = batch_executor.cancel_all('S');
+        assert(asks_cancelled);
+        drain();
+        assert(replay.resting() == 1 && batch_executor.cancelled_orders() == 6);
+
+        // A breach cancels once, on the first check after it is raised.
+        [[maybe_unused]] bool breach_cancelled = batch_executor.check_breach();
+        assert(!breach_cancelled);
+        batch_breach.store(true);
+        breach_cancelled = batch_executor.check_breach();
+        [[maybe_unused]] bool cancelled_again = batch_executor.check_breach();
+        assert(breach_cancelled && !cancelled_again);
+        drain();
+        std::cout << "Replay after breach: " << replay.resting() << " resting, "
+                  << batch_executor.cancelled_orders() << " cancelled" << std::endl;
+        assert(replay.resting() == 0 && batch_executor.cancelled_orders() == 7);
+        batch_breach.store(false);
+        cancelled_again = batch_executor.check_breach();
+        assert(!cancelled_again);
+
+        // Coinbase: a replacing ladder is one batch_cancel plus creates for the changed levels.
+        MockGatewayServer mock("127.0.0.1", 0);
+        [[maybe_unused]] const bool mock_started = mock.start();
+        assert(mock_started);
+        CoinbaseGatewayOptions options;
+        options.url = "http://127.0.0.1:" + std::to_string(mock.port());
+        options.product_id = "ETH-USD";
+        options.session_prefix = "s2-";
+        batch_executor.set_gateway(std::make_unique<CoinbaseGateway>(options, nullptr));
+        auto& coinbase = static_cast<CoinbaseGateway&>(batch_executor.gateway());
+        [[maybe_unused]] const bool coinbase_started = coinbase.start();
+        assert(coinbase_started);
+        const auto wait_for = [](const auto& done) {
+            for (int i = 0; i < 2000 && !done(); ++i) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            return done();
+        };
+
+        batch_signal.place_bid = true;
+        batch_executor.place_order_ladder(batch_signal);
+        [[maybe_unused]] bool reached = wait_for([&] { return coinbase.stats().orders_acked == 4; });
+        assert(reached && mock.orders() == 4);
+
+        batch_signal.num_levels = 1;
+        batch_executor.place_order_ladder(batch_signal);
+        reached = wait_for([&] { return mock.cancels() == 2; });
+        assert(reached);
+        reached = wait_for([&] { return coinbase.stats().skipped_unchanged == 2; });
+        assert(reached);
+        assert(mock.cancel_requests() == 1 && mock.orders() == 4 && "Level 1 out in one request, level 0 kept");
+
+        batch_signal.num_levels = 2;
+        batch_executor.place_order_ladder(batch_signal);
+        reached = wait_for([&] { return coinbase.stats().orders_acked == 6; });
+        assert(reached && mock.cancels() == 2);
+
+        batch_breach.store(true);
+        breach_cancelled = batch_executor.check_breach();
+        assert(breach_cancelled);
+        reached = wait_for([&] { return mock.cancels() == 6; });
+        assert(reached);
+        std::cout << "Coinbase breach: " << mock.cancels() << " cancelled in " << mock.cancel_requests()
+                  << " request(s)" << std::endl;
+        assert(mock.cancel_requests() == 2 && coinbase.stats().cancel_alls == 1);
+
+        // Nothing is left working for stop() to cancel.
+        coinbase.stop();
+        assert(mock.cancel_requests() == 2);
+        drain();
+        mock.stop();
+    }
+
+    // --- Quote Guard Test ---
+    std::cout << "\n--- Quote Guard Test ---" << std::endl;
+    {
+        std::atomic<double> guard_position{0.0};
+        std::atomic<bool> guard_breach{false};
+        std::atomic<double> guard_max{1.0};
+        OrderExecutor guard_executor("ETH-USD", order_manager, metrics.metrics(),
+                                     guard_position, guard_breach, guard_max);
+        guard_executor.set_gateway(std::make_unique<ReplayGateway>());
+        auto& replay = static_cast<ReplayGateway&>(guard_executor.gateway());
+        const double tick = Config::snapshot()->tick_size;
+        const uint64_t marketable_before = metrics.metrics().quotes_marketable.load();
+        const uint64_t self_cross_before = metrics.metrics().quotes_self_cross.load();
+        const OrderLadder& ladder = guard_executor.ladder();
+
+        // Bids at or through the book's ask are clamped one tick behind it.
+        guard_executor.on_book(1850.00, 1850.00 + 5 * tick);
+        HFTSignal guard_signal;
+        guard_signal.place_bid = guard_signal.place_ask = true;
+        guard_signal.bid_price = 1850.00 + 7 * tick;
+        guard_signal.ask_price = 1850.00 + 10 * tick;
+        guard_signal.bid_quantity = guard_signal.ask_quantity = 0.01;
+        guard_signal.num_levels = 4;
+        guard_executor.place_order_ladder(guard_signal);
+        std::cout << "Through the ask: " << ladder.marketable << " bids clamped, "
+                  << replay.resting() << " orders resting" << std::endl;
+        assert(ladder.marketable == 3 && ladder.self_crosses == 0 && ladder.bid_mask == 0xF);
+        for (uint32_t level = 0; level < 4; ++level) {
+            assert(std::abs(guard_executor.ladder_order(level, 'B').price - (1850.00 + 4 * tick)) < 1e-9);
+        }
+        assert(std::abs(guard_executor.ladder_order(0, 'S').price - guard_signal.ask_price) < 1e-9);
+        assert(metrics.metrics().quotes_marketable.load() == marketable_before + 3);
+
+        // An additive ladder stays off our own working asks; a replacing one cancels them.
+        guard_executor.on_book(1849.00, 1851.00);
+        guard_signal.bid_price = 1850.00;
+        guard_signal.ask_price = 1850.00 + 3 * tick;
+        guard_signal.num_levels = 2;
+        guard_executor.place_order_ladder(guard_signal);
+        assert(replay.resting() == 4);
+        assert(std::abs(guard_executor.working_ask() - (1850.00 + 3 * tick)) < 1e-9 &&
+               std::abs(guard_executor.working_bid() - 1850.00) < 1e-9);
+
+        guard_signal.place_ask = false;
+        guard_signal.bid_price = 1850.00 + 4 * tick;
+        guard_signal.num_levels = 3;
+        guard_executor.submit_ladder(guard_signal);
+        assert(ladder.self_crosses == 2 && ladder.bid_mask == 0x4 && replay.resting() == 5);
+        assert(metrics.metrics().quotes_self_cross.load() == self_cross_before + 2);
+
+        guard_executor.place_order_ladder(guard_signal);
+        assert(ladder.self_crosses == 0 && ladder.bid_mask == 0x7 && replay.resting() == 3);
+        assert(guard_executor.working_ask() == 0.0);
+
+        // Fills and cancels take orders out of the index.
+        guard_executor.on_book(1849.00, 1850.00 + 4 * tick);
+        HFTOrder response;
+        while (guard_executor.pop_response(response)) guard_executor.process_order_response(response);
+        assert(std::abs(guard_executor.working_bid() - (1850.00 + 3 * tick)) < 1e-9);
+        guard_executor.cancel_all('B');
+        assert(guard_executor.working_bid() == 0.0 && replay.resting() == 0);
+        std::cout << "Guard: " << metrics.metrics().quotes_marketable.load() - marketable_before
+                  << " clamped, " << metrics.metrics().quotes_self_cross.load() - self_cross_before
+                  << " self-crosses dropped" << std::endl;
+    }
+
+    // --- Risk Table Test ---
+    std::cout << "\n--- Risk Table Test ---" << std::endl;
+    SymbolRegistry& registry = SymbolRegistry::getInstance();
+    const uint32_t eth_id = registry.intern("ETH-USD");
+    [[maybe_unused]] const uint32_t eth_again = registry.intern("ETH-USD");
+    const uint32_t btc_id = registry.intern("BTC-USD");
+    std::cout << "Interned ETH-USD=" << eth_id << " BTC-USD=" << btc_id << std::endl;
+    assert(eth_again == eth_id && registry.find("ETH-USD") == eth_id);
+    assert(registry.find("NOPE-USD") == SymbolRegistry::kInvalidId);
+    assert(registry.assetName(registry.baseAsset(eth_id)) == "ETH" && registry.assetName(registry.quoteAsset(eth_id)) == "USD");
+    assert(registry.quoteAsset(btc_id) == registry.quoteAsset(eth_id) && "Quote assets are shared");
+    assert(SymbolRegistry::configKey("eth-usd") == "ETHUSD");
+
+    // Test-only products so the limits below cannot leak into the other tests' symbols.
+    const std::string limits_path = "logs/risk_table_test.txt";
+    {
+        std::ofstream limits(limits_path);
+        limits << "POSITION_LIMIT_TSTAUSDX=5\nNOTIONAL_LIMIT_TSTAUSDX=600\nLOSS_LIMIT_TSTBUSDX=1\n"
+               << "ASSET_LIMIT_TSTB=3\nMAX_GROSS_NOTIONAL=500\n";
+    }
+    [[maybe_unused]] const bool limits_loaded = config.loadFromFile(limits_path);
+    std::remove(limits_path.c_str());
+    assert(limits_loaded);
+
+    RiskManager table_risk;
+    table_risk.initialize("config.txt");
+    const uint32_t tsta = table_risk.registerSymbol("TSTA-USDX");
+    const uint32_t tstb = table_risk.registerSymbol("TSTB-USDX");
+    const uint32_t usdx = registry.findAsset("USDX");
+    const auto apply_fill = [&table_risk](uint32_t id, double position, double price, double pnl) {
+        RiskDelta delta;
+        delta.symbol_id = id;
+        delta.position = position;
+        delta.price = price;
+        delta.realized_pnl = pnl;
+        [[maybe_unused]] const bool pushed = table_risk.riskDeltas().push(delta);
+        assert(pushed);
+        return table_risk.processRiskDeltas();
+    };
+
+    apply_fill(tsta, 2.0, 100.0, 0.0);
+    apply_fill(tstb, -1.0, 50.0, 0.0);
+    std::cout << "Gross " << table_risk.getGrossNotional() << " | Net " << table_risk.getNetNotional()
+              << " | USDX " << table_risk.getAssetExposure(usdx) << std::endl;
+    assert(std::abs(table_risk.getGrossNotional() - 250.0) < 1e-9);
+    assert(std::abs(table_risk.getNetNotional() - 150.0) < 1e-9);
+    assert(std::abs(table_risk.getAssetExposure(usdx) + 150.0) < 1e-9);
+    assert(std::abs(table_risk.getAssetExposure(registry.baseAsset(tstb)) + 1.0) < 1e-9);
+    apply_fill(tsta, 2.0, 100.0, 0.0);
+    assert(std::abs(table_risk.getGrossNotional() - 250.0) < 1e-9 && "Absolute deltas must be idempotent");
+
+    std::string table_reason;
+    [[maybe_unused]] bool allowed = table_risk.canPlaceOrder(tsta, Side::BUY, 100.0, 1.0, table_reason);
+    assert(allowed);
+    allowed = table_risk.canPlaceOrder(tsta, Side::BUY, 100.0, 4.0, table_reason);   // position 6 > 5
+    std::cout << "Rejected: " << table_reason << std::endl;
+    assert(!allowed);
+    allowed = table_risk.canPlaceOrder(tsta, Side::BUY, 150.0, 2.5, table_reason);   // notional 675 > 600
+    assert(!allowed);
+    allowed = table_risk.canPlaceOrder(tsta, Side::BUY, 100.0, 2.9, table_reason);   // gross 540 > 500
+    assert(!allowed);
+    allowed = table_risk.canPlaceOrder(tsta, Side::SELL, 100.0, 1.0, table_reason);
+    assert(allowed && "Reducing exposure is allowed");
+    allowed = table_risk.canPlaceOrder(tstb, Side::SELL, 50.0, 2.5, table_reason);   // TSTB -3.5 past 3
+    assert(!allowed);
+    allowed = table_risk.canPlaceOrder("TSTB-USDX", "BUY", 50.0, 0.5, table_reason);
+    assert(allowed);
+
+    apply_fill(tstb, 0.0, 48.5, -1.5);  // closes at a loss past its 1.0 limit
+    assert(std::abs(table_risk.getSymbolPnL(tstb) + 1.5) < 1e-9);
+    allowed = table_risk.canPlaceOrder(tstb, Side::BUY, 50.0, 0.1, table_reason);
+    std::cout << "Rejected: " << table_reason << std::endl;
+    assert(!allowed && "A symbol past its loss limit is halted");
+    allowed = table_risk.canPlaceOrder(tsta, Side::SELL, 100.0, 1.0, table_reason);
+    assert(allowed && "Other symbols keep trading");
+    assert(!table_risk.isCircuitBreakerActive());
+    assert(std::abs(table_risk.getGrossNotional() - 200.0) < 1e-9 && std::abs(table_risk.getAssetExposure(usdx) + 200.0) < 1e-9);
+
+    // The risk thread's tradeability probe counts no orders, however often it runs.
+    int probes_passed = 0;
+    for (int i = 0; i < 1000; ++i) probes_passed += table_risk.canTrade(tsta, Side::BUY, 100.0, 1.0, table_reason);
+    std::cout << "Probes passed: " << probes_passed << " of 1000" << std::endl;
+    assert(probes_passed == 1000);
+    allowed = table_risk.canTrade(tstb, Side::BUY, 50.0, 0.1, table_reason);
+    assert(!allowed && "Same halt as canPlaceOrder");
+    allowed = table_risk.canPlaceOrder(tsta, Side::SELL, 100.0, 1.0, table_reason);
+    assert(allowed && "Rate limit untouched by probes");
+    table_risk.shutdown();
+
+    // A fill past the position limit trips the breaker on that fill, though probes would still pass the sell side.
+    RiskManager overshoot_risk;
+    overshoot_risk.initialize("config.txt");
+    std::atomic<bool> overshoot_breach{false};
+    overshoot_risk.setBreachFlag(&overshoot_breach);
+    const uint32_t overshoot_id = overshoot_risk.registerSymbol("TSTA-USDX");
+    for (double position : {4.0, 6.0}) {   // notional 300 stays under 600, gross under 500
+        RiskDelta delta;
+        delta.symbol_id = overshoot_id;
+        delta.position = position;
+        delta.price = 50.0;
+        [[maybe_unused]] const bool pushed = overshoot_risk.riskDeltas().push(delta);
+        assert(pushed);
+        overshoot_risk.processRiskDeltas();
+        assert(overshoot_breach.load() == (position > 5.0));
+    }
+    std::cout << "Position overshoot: breach on fill " << overshoot_risk.getBreachDeltaIndex()
+              << (overshoot_risk.isCircuitBreakerActive() ? ", breaker active" : ", breaker idle") << std::endl;
+    assert(overshoot_risk.isCircuitBreakerActive() && overshoot_risk.getBreachDeltaIndex() == 2);
+    overshoot_risk.shutdown();
 
     metrics.tick();
     metrics.print_performance_stats();
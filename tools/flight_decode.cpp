@@ -0,0 +1,180 @@
+// flight_decode: prints a flight recorder dump (logs/flight_*.bin) as a merged timeline.
+#include "core/flight_recorder.h"
+#include "risk/risk_manager.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <getopt.h>
+
+namespace {
+
+struct Dump {
+    FlightDumpHeader header{};
+    std::vector<FlightEvent> events;
+};
+
+bool load(const std::string& path, Dump& dump, std::string& error) {
+    FILE* file = std::fopen(path.c_str(), "rb");
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    bool ok = std::fread(&dump.header, sizeof(dump.header), 1, file) == 1;
+    if (!ok || std::memcmp(dump.header.magic, FLIGHT_DUMP_MAGIC, sizeof(FLIGHT_DUMP_MAGIC)) != 0) {
+        error = "not a flight recorder dump";
+    } else if (dump.header.version != FLIGHT_DUMP_VERSION ||
+               dump.header.header_size != sizeof(FlightDumpHeader) ||
+               dump.header.event_size != sizeof(FlightEvent)) {
+        error = "unsupported dump version " + std::to_string(dump.header.version);
+    } else {
+        dump.events.resize(dump.header.event_count);
+        if (std::fread(dump.events.data(), sizeof(FlightEvent), dump.events.size(), file) != dump.events.size()) {
+            error = "truncated dump";
+        } else {
+            std::fclose(file);
+            return true;
+        }
+    }
+    std::fclose(file);
+    return false;
+}
+
+// Signed tick delta -> milliseconds.
+double ticks_to_ms(const FlightDumpHeader& h, uint64_t tsc, uint64_t reference) {
+    const double ticks = tsc >= reference ? static_cast<double>(tsc - reference)
+                                          : -static_cast<double>(reference - tsc);
+    return ticks * h.ns_per_tick / 1e6;
+}
+
+std::string wall_time(const FlightDumpHeader& h, uint64_t tsc, bool with_date) {
+    const double offset_ns = ticks_to_ms(h, tsc, h.anchor_tsc) * 1e6;
+    const auto wall_ns = static_cast<uint64_t>(static_cast<double>(h.anchor_wall_ns) + offset_ns);
+    const auto secs = static_cast<time_t>(wall_ns / 1000000000ULL);
+    struct tm tm_buf{};
+    localtime_r(&secs, &tm_buf);
+    char buf[40];
+    std::strftime(buf, sizeof(buf), with_date ? "%Y-%m-%d %H:%M:%S" : "%H:%M:%S", &tm_buf);
+    char micros[16];
+    std::snprintf(micros, sizeof(micros), ".%06u", static_cast<unsigned>(wall_ns / 1000 % 1000000));
+    return std::string(buf) + micros;
+}
+
+std::string details(const FlightEvent& e) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    switch (e.type) {
+        case FlightEventType::BBO:
+            out << "bid " << e.a << " ask " << e.b << " seq " << e.id;
+            break;
+        case FlightEventType::SIGNAL:
+            if (e.aux & 1u) out << "bid " << e.a; else out << "bid --";
+            if (e.aux & 2u) out << " ask " << e.b; else out << " ask --";
+            out << " levels " << (e.aux >> 2);
+            break;
+        case FlightEventType::ORDER_SENT:
+        case FlightEventType::FILL:
+        case FlightEventType::ORDER_REJECT:
+            out << "#" << e.id << " " << (e.aux == 'B' ? "BUY " : "SELL ") << std::setprecision(6) << e.b
+                << " @ " << std::setprecision(2) << e.a;
+            break;
+        case FlightEventType::RISK: {
+            const auto type = static_cast<RiskEventType>(e.aux & 0xFF);
+            const auto level = static_cast<RiskLevel>(e.aux >> 8);
+            out << to_string(level) << " " << to_string(type);
+            const char* message = to_string(static_cast<RiskMessage>(e.id));
+            if (*message) out << ": " << message;
+            if (e.a != 0.0 || e.b != 0.0) out << std::setprecision(4) << " (value " << e.a << ", limit " << e.b << ")";
+            break;
+        }
+        case FlightEventType::CIRCUIT_BREAKER:
+            out << to_string(static_cast<RiskMessage>(e.id));
+            break;
+        case FlightEventType::CANCEL_ALL:
+            out << (e.aux == 'B' ? "BUY" : e.aux == 'S' ? "SELL" : "both sides");
+            break;
+        case FlightEventType::EMERGENCY_STOP:
+            break;
+    }
+    return out.str();
+}
+
+void usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [-s seconds] [-t type] [-c] dump.bin\n"
+              << "  -s  only the last N seconds before the trigger (default: whole window)\n"
+              << "  -t  only events of this type (BBO, SIGNAL, ORDER_SENT, FILL, RISK, ...)\n"
+              << "  -c  CSV output\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    double last_seconds = 0.0;
+    std::string type_filter;
+    bool csv = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "s:t:ch")) != -1) {
+        switch (opt) {
+            case 's': last_seconds = std::atof(optarg); break;
+            case 't': type_filter = optarg; break;
+            case 'c': csv = true; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+    if (optind >= argc) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    Dump dump;
+    std::string error;
+    if (!load(argv[optind], dump, error)) {
+        std::cerr << "flight_decode: " << argv[optind] << ": " << error << std::endl;
+        return 1;
+    }
+    const FlightDumpHeader& h = dump.header;
+
+    if (csv) {
+        std::cout << "t_ms,wall_time,thread,event,a,b,id,aux\n";
+    } else {
+        std::cout << "Reason:  " << h.reason << "\n"
+                  << "Trigger: " << wall_time(h, h.trigger_tsc, true)
+                  << "   window " << h.window_ns / 1000000000ULL << " s\n"
+                  << "Events:  " << h.event_count << " from " << h.thread_count << " threads (";
+        for (uint32_t i = 0; i < h.thread_count; ++i) {
+            std::cout << (i ? ", " : "") << h.thread_names[i];
+        }
+        std::cout << ")\n";
+        if (h.truncated_threads > 0) {
+            std::cout << "Warning: " << h.truncated_threads
+                      << " ring(s) wrapped inside the window; the oldest events are missing\n";
+        }
+        std::cout << "\n" << std::setw(12) << "t (ms)" << "  " << std::left << std::setw(16) << "wall time"
+                  << std::setw(14) << "thread" << std::setw(17) << "event" << "details" << std::right << "\n";
+    }
+
+    for (const FlightEvent& e : dump.events) {
+        const double t_ms = ticks_to_ms(h, e.tsc, h.trigger_tsc);
+        if (last_seconds > 0.0 && t_ms < -last_seconds * 1000.0) continue;
+        if (!type_filter.empty() && type_filter != to_string(e.type)) continue;
+        const char* thread = e.thread < h.thread_count ? h.thread_names[e.thread] : "?";
+
+        if (csv) {
+            std::cout << std::fixed << std::setprecision(6) << t_ms << "," << wall_time(h, e.tsc, true) << ","
+                      << thread << "," << to_string(e.type) << "," << std::setprecision(8) << e.a << ","
+                      << e.b << "," << e.id << "," << e.aux << "\n";
+        } else {
+            std::cout << std::fixed << std::setprecision(3) << std::setw(12) << t_ms << "  "
+                      << std::left << std::setw(16) << wall_time(h, e.tsc, false)
+                      << std::setw(14) << thread << std::setw(17) << to_string(e.type)
+                      << std::right << details(e) << "\n";
+        }
+    }
+    return 0;
+}
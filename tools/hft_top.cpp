@@ -0,0 +1,218 @@
+// hft_top: live view of a running engine through its shared-memory metrics segment.
+// Attaches read-only; the engine never notices it is being watched.
+#include "metrics/shm_metrics.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdlib>
+#include <deque>
+#include <string>
+#include <thread>
+#include <vector>
+#include <getopt.h>
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handle_signal(int) { g_stop = 1; }
+
+uint64_t wall_clock_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+// A crashed engine leaves its segment initialized but silent; a restarted one replaces it.
+bool heartbeat_stale(const ShmMetricsReader& reader) {
+    uint64_t heartbeat = reader.header().heartbeat_wall_ns.load(std::memory_order_relaxed);
+    uint64_t now = wall_clock_ns();
+    return now > heartbeat && now - heartbeat > 5000000000ULL;
+}
+
+struct Frame {
+    std::chrono::steady_clock::time_point time;
+    uint64_t orders_placed = 0;
+    uint64_t orders_filled = 0;
+    uint64_t market_data_updates = 0;
+    std::vector<uint64_t> buckets;  // stage-major
+};
+
+void capture(const ShmMetricsReader& reader, Frame& frame) {
+    frame.time = std::chrono::steady_clock::now();
+    reader.read_u64("orders_placed", frame.orders_placed);
+    reader.read_u64("orders_filled", frame.orders_filled);
+    reader.read_u64("market_data_updates", frame.market_data_updates);
+
+    const ShmMetricsHeader& h = reader.header();
+    frame.buckets.resize(static_cast<size_t>(h.stage_count) * h.histogram_bucket_count);
+    for (uint32_t s = 0; s < h.stage_count; ++s) {
+        for (uint32_t b = 0; b < h.histogram_bucket_count; ++b) {
+            frame.buckets[static_cast<size_t>(s) * h.histogram_bucket_count + b] = reader.bucket_count(s, b);
+        }
+    }
+}
+
+struct Window {
+    uint64_t count = 0;
+    uint64_t p50 = 0;
+    uint64_t p99 = 0;
+    uint64_t p999 = 0;
+    uint64_t max = 0;
+};
+
+Window window_stats(const ShmMetricsReader& reader, const Frame& now, const Frame& then, uint32_t stage) {
+    const uint32_t buckets = reader.header().histogram_bucket_count;
+    const size_t base = static_cast<size_t>(stage) * buckets;
+
+    Window w;
+    std::vector<uint64_t> delta(buckets);
+    for (uint32_t b = 0; b < buckets; ++b) {
+        delta[b] = now.buckets[base + b] - then.buckets[base + b];
+        w.count += delta[b];
+        if (delta[b]) w.max = reader.bucket_upper_bound(b);
+    }
+    if (w.count == 0) return w;
+
+    auto at = [&](double pct) {
+        auto rank = static_cast<uint64_t>(std::ceil(pct / 100.0 * static_cast<double>(w.count)));
+        uint64_t seen = 0;
+        for (uint32_t b = 0; b < buckets; ++b) {
+            seen += delta[b];
+            if (seen >= rank) return reader.bucket_upper_bound(b);
+        }
+        return w.max;
+    };
+    w.p50 = at(50.0);
+    w.p99 = at(99.0);
+    w.p999 = at(99.9);
+    return w;
+}
+
+void render(const ShmMetricsReader& reader, const Frame& now, const Frame& then, bool clear) {
+    const ShmMetricsHeader& h = reader.header();
+    const double ns_per_tick = h.ns_per_tick.load(std::memory_order_relaxed);
+    const double us = ns_per_tick / 1000.0;
+    const double elapsed = std::max(1e-9, std::chrono::duration<double>(now.time - then.time).count());
+
+    double pnl = 0.0, position = 0.0;
+    uint64_t ws_latency_ticks = 0;
+    reader.read_f64("total_pnl", pnl);
+    reader.read_f64("current_position", position);
+    reader.read_u64("websocket_latency_ticks", ws_latency_ticks);
+
+    const uint64_t wall_now = wall_clock_ns();
+    const uint64_t heartbeat = h.heartbeat_wall_ns.load(std::memory_order_relaxed);
+    const double uptime = static_cast<double>(wall_now - h.start_wall_ns) / 1e9;
+    const double heartbeat_age = wall_now > heartbeat ? static_cast<double>(wall_now - heartbeat) / 1e9 : 0.0;
+
+    std::ostringstream out;
+    if (clear) out << "\033[H\033[2J";
+    out << std::fixed << std::setprecision(1);
+    out << "hft_top  " << h.symbol << "  pid " << h.writer_pid
+        << "  uptime " << uptime << "s  heartbeat " << heartbeat_age << "s ago"
+        << (heartbeat_age > 5.0 ? "  [STALE]" : "") << "\n\n";
+
+    out << std::left << std::setw(22) << "orders placed" << std::right << std::setw(14) << now.orders_placed
+        << std::setw(12) << static_cast<double>(now.orders_placed - then.orders_placed) / elapsed << "/s\n";
+    out << std::left << std::setw(22) << "orders filled" << std::right << std::setw(14) << now.orders_filled
+        << std::setw(12) << static_cast<double>(now.orders_filled - then.orders_filled) / elapsed << "/s\n";
+    out << std::left << std::setw(22) << "market data updates" << std::right << std::setw(14)
+        << now.market_data_updates << std::setw(12)
+        << static_cast<double>(now.market_data_updates - then.market_data_updates) / elapsed << "/s\n";
+    out << std::setprecision(6) << "position " << position << "   pnl $" << pnl
+        << std::setprecision(2) << "   ws recv->queue " << static_cast<double>(ws_latency_ticks) * us << " us\n\n";
+
+    out << std::left << std::setw(16) << "stage (us)" << std::right
+        << std::setw(10) << "count/s" << std::setw(10) << "p50" << std::setw(10) << "p99"
+        << std::setw(10) << "p99.9" << std::setw(10) << "max" << "\n";
+    for (uint32_t s = 0; s < h.stage_count; ++s) {
+        Window w = window_stats(reader, now, then, s);
+        out << std::left << std::setw(16) << reader.stage_name(s) << std::right
+            << std::setw(10) << std::setprecision(0) << static_cast<double>(w.count) / elapsed
+            << std::setprecision(2)
+            << std::setw(10) << static_cast<double>(w.p50) * us
+            << std::setw(10) << static_cast<double>(w.p99) * us
+            << std::setw(10) << static_cast<double>(w.p999) * us
+            << std::setw(10) << static_cast<double>(w.max) * us << "\n";
+    }
+    std::cout << out.str() << std::flush;
+}
+
+void usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [-n shm_name] [-i interval_ms] [-w window_s] [-c frames] [-p]\n"
+              << "  -n  segment name (default /hft_metrics, see METRICS_SHM_NAME)\n"
+              << "  -i  refresh interval in ms (default 100)\n"
+              << "  -w  rate/percentile window in seconds (default 1)\n"
+              << "  -c  exit after this many frames (default 0 = run until Ctrl-C)\n"
+              << "  -p  plain output, no screen clearing\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string name = "/hft_metrics";
+    int interval_ms = 100;
+    double window_s = 1.0;
+    long frames = 0;
+    bool clear = true;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:i:w:c:ph")) != -1) {
+        switch (opt) {
+            case 'n': name = optarg; break;
+            case 'i': interval_ms = std::max(1, std::atoi(optarg)); break;
+            case 'w': window_s = std::max(0.01, std::atof(optarg)); break;
+            case 'c': frames = std::atol(optarg); break;
+            case 'p': clear = false; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    ShmMetricsReader reader;
+    std::string error;
+    std::deque<Frame> history;
+    long rendered = 0;
+    int32_t attached_pid = 0;
+    auto last_attach = std::chrono::steady_clock::now();
+
+    while (!g_stop) {
+        // (Re)attach when the engine starts, restarts or tears the segment down.
+        bool live = attached_pid != 0 &&
+                    reader.header().magic.load(std::memory_order_acquire) == SHM_METRICS_MAGIC;
+        if (live && heartbeat_stale(reader) &&
+            std::chrono::steady_clock::now() - last_attach >= std::chrono::seconds(1)) {
+            live = false;
+        }
+        if (!live) {
+            history.clear();
+            attached_pid = 0;
+            if (!reader.attach(name, error)) {
+                std::cerr << "hft_top: " << error << " (retrying)" << std::endl;
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                continue;
+            }
+            attached_pid = reader.header().writer_pid;
+            last_attach = std::chrono::steady_clock::now();
+        }
+
+        Frame frame;
+        capture(reader, frame);
+        history.push_back(std::move(frame));
+        while (history.size() > 2 &&
+               history.back().time - history[1].time >= std::chrono::duration<double>(window_s)) {
+            history.pop_front();
+        }
+
+        render(reader, history.back(), history.front(), clear);
+        if (frames > 0 && ++rendered >= frames) break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(interval_ms));
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+// mock_gateway: local Advanced Trade order endpoints for running the engine offline with
+// ORDER_GATEWAY=coinbase and ORDER_GATEWAY_URL=http://127.0.0.1:<port>.
+#include "execution/mock_gateway_server.h"
+#include <iostream>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <getopt.h>
+
+namespace {
+
+volatile std::sig_atomic_t g_stop = 0;
+
+void handle_signal(int) { g_stop = 1; }
+
+void usage(const char* argv0) {
+    std::cerr << "Usage: " << argv0 << " [-b address] [-p port] [-r]\n"
+              << "  -b  bind address (default 127.0.0.1)\n"
+              << "  -p  port (default 8090, 0 = any free port)\n"
+              << "  -r  reject every order\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string bind_address = "127.0.0.1";
+    int port = 8090;
+    bool reject = false;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "b:p:rh")) != -1) {
+        switch (opt) {
+            case 'b': bind_address = optarg; break;
+            case 'p': port = std::atoi(optarg); break;
+            case 'r': reject = true; break;
+            default: usage(argv[0]); return opt == 'h' ? 0 : 1;
+        }
+    }
+
+    std::signal(SIGINT, handle_signal);
+    std::signal(SIGTERM, handle_signal);
+
+    MockGatewayServer server(bind_address, port);
+    server.set_reject(reject);
+    if (!server.start()) return 1;
+    std::cout << "Mock order gateway on http://" << bind_address << ":" << server.port()
+              << (reject ? " (rejecting orders)" : "") << std::endl;
+
+    uint64_t last_orders = 0;
+    uint64_t last_cancels = 0;
+    while (!g_stop) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        if (server.orders() == last_orders && server.cancels() == last_cancels) continue;
+        last_orders = server.orders();
+        last_cancels = server.cancels();
+        std::cout << "orders " << last_orders << "  cancels " << last_cancels
+                  << "  connections " << server.connections() << std::endl;
+    }
+
+    server.stop();
+    return 0;
+}